@@ -0,0 +1,123 @@
+#include "BenchHarness.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+// Allocation counting: replace the global allocation functions for the
+// benchmark binary. The counter is thread-local so it needs no atomics.
+// Every form allocates with malloc and frees with free.
+namespace {
+thread_local uint64_t allocations = 0;
+
+void* countedAllocate(std::size_t size) {
+    ++allocations;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+}
+
+uint64_t threadAllocationCount() {
+    return allocations;
+}
+
+void* operator new(std::size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+BenchRunner::BenchRunner(const std::string& benchFilter) : filter(benchFilter) {}
+
+bool BenchRunner::isSelected(const std::string& name) const {
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+void BenchRunner::run(const std::string& name, uint64_t iterations, const std::function<void(uint64_t)>& op) {
+    if (!isSelected(name) || iterations == 0) {
+        return;
+    }
+
+    std::vector<uint64_t> latencies(iterations);  // Allocated before counting starts
+
+    uint64_t allocationsBefore = threadAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        auto opStart = std::chrono::steady_clock::now();
+        op(i);
+        auto opEnd = std::chrono::steady_clock::now();
+        latencies[i] = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(opEnd - opStart).count());
+    }
+    auto end = std::chrono::steady_clock::now();
+    uint64_t allocationsAfter = threadAllocationCount();
+
+    BenchResult result;
+    result.name = name;
+    result.operations = iterations;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.opsPerSecond = result.seconds > 0 ? iterations / result.seconds : 0.0;
+    result.allocationsPerOp = static_cast<double>(allocationsAfter - allocationsBefore) / iterations;
+
+    std::sort(latencies.begin(), latencies.end());
+    result.p50Nanos = static_cast<double>(latencies[(iterations - 1) * 50 / 100]);
+    result.p99Nanos = static_cast<double>(latencies[(iterations - 1) * 99 / 100]);
+
+    results.push_back(result);
+    std::cout << std::left << std::setw(34) << result.name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(0) << result.opsPerSecond
+              << std::setw(12) << result.p50Nanos
+              << std::setw(12) << result.p99Nanos
+              << std::setw(12) << std::setprecision(2) << result.allocationsPerOp << std::endl;
+}
+
+void BenchRunner::printTable() const {
+    std::cout << std::left << std::setw(34) << "benchmark" << std::right
+              << std::setw(14) << "ops/sec"
+              << std::setw(12) << "p50 ns"
+              << std::setw(12) << "p99 ns"
+              << std::setw(12) << "allocs/op" << std::endl;
+}
+
+// Baseline file for comparing releases
+bool BenchRunner::writeJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"operations\": " << r.operations
+            << ", \"seconds\": " << r.seconds
+            << ", \"ops_per_sec\": " << r.opsPerSecond
+            << ", \"p50_ns\": " << r.p50Nanos
+            << ", \"p99_ns\": " << r.p99Nanos
+            << ", \"allocs_per_op\": " << r.allocationsPerOp << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return true;
+}
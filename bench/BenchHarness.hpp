@@ -0,0 +1,50 @@
+#ifndef BENCHHARNESS_HPP
+#define BENCHHARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal microbenchmark harness.
+// Every operation is timed individually so the report can give p50/p99
+// latency next to throughput, and heap allocations are counted through the
+// replaced global operator new (see BenchHarness.cpp).
+
+// Allocations performed by the calling thread since it started
+uint64_t threadAllocationCount();
+
+struct BenchResult {
+    std::string name;
+    uint64_t operations = 0;
+    double seconds = 0.0;
+    double opsPerSecond = 0.0;
+    double p50Nanos = 0.0;
+    double p99Nanos = 0.0;
+    double allocationsPerOp = 0.0;
+};
+
+class BenchRunner {
+public:
+    // Only benchmarks whose name contains filter are run (empty runs all)
+    explicit BenchRunner(const std::string& filter = "");
+
+    // Time op(i) for i in [0, iterations), each index once (no warm-up: op may
+    // not be repeatable, e.g. an insert of key i)
+    void run(const std::string& name, uint64_t iterations, const std::function<void(uint64_t)>& op);
+
+    bool isSelected(const std::string& name) const;
+
+    void printTable() const;
+    bool writeJson(const std::string& path) const;
+
+    const std::vector<BenchResult>& getResults() const { return results; }
+
+private:
+    std::string filter;
+    std::vector<BenchResult> results;
+};
+
+#endif // BENCHHARNESS_HPP
@@ -0,0 +1,172 @@
+// Microbenchmarks for every engine component.
+// Reports ops/sec, p50/p99 latency and heap allocations per operation.
+//
+// Usage: engine_bench [filter] [--iterations N] [--json baseline.json]
+
+#include "BenchHarness.hpp"
+#include "Indexing.hpp"
+#include "StorageEngine.hpp"
+#include "QueryProcessor.hpp"
+#include "Session.hpp"
+#include "CommitLog.hpp"
+#include "Metrics.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> makeKeys(uint64_t count) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        keys.push_back("user" + std::to_string(i * 2654435761u % 1000003));
+    }
+    return keys;
+}
+
+const std::string sampleTable = "CREATE TABLE users (id INT, name TEXT, age INT);";
+const std::string sampleRow = "INSERT INTO users VALUES (1, 'Alice', 30);";
+
+// Insert then look up the same keys in a fresh index
+template <typename IndexType>
+void benchIndex(BenchRunner& runner, const std::string& name, uint64_t iterations) {
+    std::vector<std::string> keys = makeKeys(iterations);
+    IndexType index;
+    runner.run(name + ".insert", iterations, [&](uint64_t i) {
+        index.addIndexEntry(keys[i], static_cast<int>(i));
+    });
+    runner.run(name + ".lookup", iterations, [&](uint64_t i) {
+        volatile bool found = index.hasIndexEntry(keys[i]);
+        (void)found;
+    });
+}
+
+// Store rows, then retrieve a table of retrieveRows rows
+void benchBackend(BenchRunner& runner, const std::string& name, StorageBackend& backend,
+                  uint64_t storeIterations, uint64_t retrieveIterations) {
+    runner.run(name + ".store", storeIterations, [&](uint64_t) {
+        backend.storeData(sampleRow);
+    });
+    runner.run(name + ".retrieve", retrieveIterations, [&](uint64_t) {
+        volatile size_t rows = backend.retrieveData().size();
+        (void)rows;
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string jsonPath;
+    uint64_t iterations = 100000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else {
+            filter = arg;
+        }
+    }
+
+    BenchRunner runner(filter);
+    runner.printTable();
+
+    // Indexes
+    benchIndex<HashIndex>(runner, "HashIndex", iterations);
+    benchIndex<ShardedHashIndex>(runner, "ShardedHashIndex", iterations);
+    benchIndex<BTreeIndex>(runner, "BTreeIndex", iterations);
+
+    // Metrics recording (the cost every instrumented hot path pays)
+    {
+        MetricsRegistry& metrics = MetricsRegistry::getInstance();
+        runner.run("Metrics.counterAdd", iterations * 10, [&](uint64_t) {
+            metrics.add(Counter::RowsScanned);
+        });
+        runner.run("Metrics.histogramRecord", iterations * 10, [&](uint64_t i) {
+            metrics.record(Histogram::QueryLatency, 1000 + (i & 0xffff));
+        });
+    }
+
+    // Storage backends (retrieve copies the whole table, so it runs fewer times)
+    {
+        MemoryStorage memory;
+        benchBackend(runner, "MemoryStorage", memory, 1000, iterations / 100);
+    }
+    {
+        const std::string path = "engine_bench_storage.txt";
+        std::remove(path.c_str());
+        FileStorage file(path);
+        benchBackend(runner, "FileStorage", file, 1000, iterations / 1000);
+        std::remove(path.c_str());
+    }
+
+    // Query processing: parsing, planning and execution against memory storage
+    {
+        StorageEngine storage("memory");
+        QueryProcessor processor(&storage);
+        processor.executeQuery("CREATE TABLE accounts (id INT, name TEXT, age INT, PRIMARY KEY (id));");
+        runner.run("QueryProcessor.insert", iterations, [&](uint64_t i) {
+            processor.executeQuery("INSERT INTO accounts VALUES (" + std::to_string(i) + ", 'Alice', 30);");
+        });
+        runner.run("QueryProcessor.pointSelect", iterations, [&](uint64_t i) {
+            processor.executeQuery("SELECT * FROM accounts WHERE id = " + std::to_string(i) + ";");
+        });
+        runner.run("QueryProcessor.update", iterations, [&](uint64_t i) {
+            processor.executeQuery("UPDATE accounts SET age = 31 WHERE id = " + std::to_string(i) + ";");
+        });
+        runner.run("QueryProcessor.seqScan", iterations / 1000, [&](uint64_t) {
+            processor.executeQuery("SELECT id FROM accounts WHERE age = 99;");
+        });
+    }
+
+    // Transactions: begin + one buffered change + commit
+    {
+        StorageEngine storage("memory");
+        Session session(1, &storage);
+        session.executeQuery(sampleTable);
+        runner.run("Transaction.beginCommit", iterations, [&](uint64_t) {
+            session.startTransaction();
+            session.insertData(sampleRow);
+            session.commitTransaction();
+        });
+        runner.run("Transaction.beginRollback", iterations, [&](uint64_t) {
+            session.startTransaction();
+            session.insertData(sampleRow);
+            session.rollbackTransaction();
+        });
+    }
+    {
+        const std::string path = "engine_bench_commit.wal";
+        std::remove(path.c_str());
+        {
+            StorageEngine storage("memory");
+            CommitLog log(path);
+            Session session(1, &storage, &log);
+            session.executeQuery(sampleTable);
+            runner.run("Transaction.commitDurable", iterations / 1000, [&](uint64_t) {
+                session.startTransaction();
+                session.insertData(sampleRow);
+                session.commitTransaction();  // Waits for fsync
+            });
+            log.setSynchronousCommit(false);
+            runner.run("Transaction.commitAsync", iterations, [&](uint64_t) {
+                session.startTransaction();
+                session.insertData(sampleRow);
+                session.commitTransaction();  // Acknowledged before fsync
+            });
+        }
+        std::remove(path.c_str());
+    }
+
+    if (!jsonPath.empty() && !runner.writeJson(jsonPath)) {
+        std::cerr << "Unable to write " << jsonPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
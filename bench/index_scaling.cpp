@@ -0,0 +1,113 @@
+// Multi-threaded insert/lookup scaling benchmark for the concurrent indexes.
+// Runs the same workload with 1, 2, 4, ... N threads against BTreeIndex,
+// ShardedHashIndex and a single mutex around an ordered map (the baseline a
+// coarse-locked index would give), and prints throughput per thread count.
+//
+// Usage: index_scaling [maxThreads] [keysPerThread]
+
+#include "Indexing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Baseline: one mutex serializing every reader and writer
+class LockedMapIndex {
+public:
+    void addIndexEntry(const std::string& key, int rowId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        data[key].push_back(rowId);
+    }
+
+    bool hasIndexEntry(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return data.find(key) != data.end();
+    }
+
+private:
+    std::mutex mutex;
+    std::map<std::string, std::vector<int>> data;
+};
+
+// Keys are generated up front so the timed region measures only the index
+std::vector<std::vector<std::string>> makeKeys(int threads, int keysPerThread) {
+    std::vector<std::vector<std::string>> keys(threads);
+    for (int t = 0; t < threads; ++t) {
+        keys[t].reserve(keysPerThread);
+        for (int i = 0; i < keysPerThread; ++i) {
+            keys[t].push_back("user" + std::to_string(i * threads + t));
+        }
+        std::shuffle(keys[t].begin(), keys[t].end(), std::mt19937(t + 1));
+    }
+    return keys;
+}
+
+// Run op(threadIndex) on every thread and return elapsed seconds
+template <typename Op>
+double runThreads(int threads, Op op) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back(op, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename IndexType>
+void runWorkload(const char* name, int threads, int keysPerThread) {
+    auto keys = makeKeys(threads, keysPerThread);
+    IndexType index;
+
+    double insertSeconds = runThreads(threads, [&](int t) {
+        for (int i = 0; i < keysPerThread; ++i) {
+            index.addIndexEntry(keys[t][i], i);
+        }
+    });
+
+    double lookupSeconds = runThreads(threads, [&](int t) {
+        int hits = 0;
+        for (int i = 0; i < keysPerThread; ++i) {
+            hits += index.hasIndexEntry(keys[t][i]) ? 1 : 0;
+        }
+        if (hits != keysPerThread) {
+            std::cerr << name << ": lookup missed " << (keysPerThread - hits) << " keys" << std::endl;
+        }
+    });
+
+    double totalOps = static_cast<double>(threads) * keysPerThread;
+    std::cout << std::left << std::setw(14) << name << std::right
+              << std::setw(8) << threads
+              << std::setw(16) << std::fixed << std::setprecision(2) << totalOps / insertSeconds / 1e6
+              << std::setw(16) << totalOps / lookupSeconds / 1e6 << "\n";
+}
+
+int main(int argc, char** argv) {
+    int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : hardwareThreads;
+    int keysPerThread = argc > 2 ? std::atoi(argv[2]) : 200000;
+
+    std::cout << std::left << std::setw(14) << "index" << std::right
+              << std::setw(8) << "threads"
+              << std::setw(16) << "insert Mops/s"
+              << std::setw(16) << "lookup Mops/s" << "\n";
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        runWorkload<BTreeIndex>("BTreeIndex", threads, keysPerThread);
+        runWorkload<ShardedHashIndex>("ShardedHash", threads, keysPerThread);
+        runWorkload<LockedMapIndex>("mutex+map", threads, keysPerThread);
+        if (threads < maxThreads && threads * 2 > maxThreads) {
+            threads = maxThreads / 2;  // Always finish with exactly maxThreads
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,451 @@
+// Side-by-side comparison of DatabaseEngine against embedded SQLite.
+// Both engines run the same SQL text: the classicmodels script from
+// database/mysqlsampledatabase.sql, a synthetic bulk load of extra orders,
+// then point lookups, secondary-index lookups, range scans, joins, sorts and
+// aggregations.
+// SQLite runs on a file in WAL mode with synchronous=NORMAL; neither engine
+// fsyncs per statement. Every statement is parsed and planned on each call
+// (no prepared statements) and every result value is read, on both sides.
+// Result row counts are compared query by query so a faster answer is never
+// a wrong one. Workloads the engine cannot run yet are reported as unsupported.
+//
+// Usage: sqlite_compare [--orders N] [--queries N] [--storage memory|file]
+//                       [--sqlite-path FILE] [--schema FILE] [--json results.json]
+
+#include "DatabaseEngine.hpp"
+#include "LatencyHistogram.hpp"
+#include "Logger.hpp"
+#include "SqlParser.hpp"
+#include <sqlite3.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef COMPARE_SCHEMA_PATH
+#define COMPARE_SCHEMA_PATH "database/mysqlsampledatabase.sql"
+#endif
+
+namespace {
+
+struct Config {
+    int orders = 20000;   // Synthetic orders added by the bulk load
+    int queries = 2000;   // Statements per query workload
+    std::string storage = "file";
+    std::string sqlitePath = "sqlite_compare.db";
+    std::string schemaPath = COMPARE_SCHEMA_PATH;
+    std::string jsonPath;
+};
+
+// Outcome of one statement on one engine
+struct StatementResult {
+    bool success;
+    size_t rows;
+};
+
+// The engine under test, driven through one session
+class EngineTarget {
+public:
+    explicit EngineTarget(const std::string& storage) {
+        engine.initializeDatabase(":memory:");
+        engine.setStorageEngine(storage);
+        session = engine.openSession();
+    }
+
+    StatementResult execute(const std::string& sql) {
+        QueryResult result = session->executeQuery(sql);
+        return {result.success, result.rows.size()};
+    }
+
+private:
+    DatabaseEngine engine;
+    std::unique_ptr<Session> session;
+};
+
+// SQLite on a WAL-mode file
+class SqliteTarget {
+public:
+    explicit SqliteTarget(const std::string& path) : db(nullptr) {
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::remove((path + suffix).c_str());
+        }
+        if (sqlite3_open(path.c_str(), &db) != SQLITE_OK) {
+            std::cerr << "Can't open SQLite database: " << sqlite3_errmsg(db) << std::endl;
+            sqlite3_close(db);
+            db = nullptr;
+            return;
+        }
+        sqlite3_exec(db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+    }
+
+    ~SqliteTarget() {
+        if (db) {
+            sqlite3_close(db);
+        }
+    }
+
+    bool isOpen() const { return db != nullptr; }
+
+    StatementResult execute(const std::string& sql) {
+        sqlite3_stmt* statement = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &statement, nullptr) != SQLITE_OK) {
+            return {false, 0};
+        }
+        size_t rows = 0;
+        int rc;
+        while ((rc = sqlite3_step(statement)) == SQLITE_ROW) {
+            // Materialize every value as text, as the engine's result rows do
+            int columns = sqlite3_column_count(statement);
+            for (int i = 0; i < columns; ++i) {
+                sqlite3_column_text(statement, i);
+            }
+            ++rows;
+        }
+        sqlite3_finalize(statement);
+        return {rc == SQLITE_DONE, rows};
+    }
+
+    // Values of the first result column
+    std::vector<std::string> firstColumn(const std::string& sql) {
+        std::vector<std::string> values;
+        sqlite3_exec(db, sql.c_str(), [](void* target, int, char** row, char**) {
+            static_cast<std::vector<std::string>*>(target)->push_back(row[0] ? row[0] : "");
+            return 0;
+        }, &values, nullptr);
+        return values;
+    }
+
+private:
+    sqlite3* db;
+};
+
+// Measurements of one workload
+struct Comparison {
+    std::string name;
+    std::string unit;  // What one operation is ("rows" or "queries")
+    uint64_t operations = 0;
+    double engineSeconds = 0;
+    double sqliteSeconds = 0;
+    LatencyHistogram engineLatency;
+    LatencyHistogram sqliteLatency;
+    uint64_t mismatches = 0;       // Statements whose row counts differ
+    bool engineSupported = true;   // False once the engine rejects a statement SQLite accepts
+    bool sqliteFailed = false;
+};
+
+// Runs the statements on both engines, alternating per statement so that
+// both see the same cache and machine conditions
+void runWorkload(Comparison& comparison, const std::vector<std::string>& statements, uint64_t operationsPerStatement,
+                 EngineTarget& engine, SqliteTarget& sqlite) {
+    for (const std::string& sql : statements) {
+        auto start = std::chrono::steady_clock::now();
+        StatementResult sqliteResult = sqlite.execute(sql);
+        auto middle = std::chrono::steady_clock::now();
+        StatementResult engineResult = comparison.engineSupported ? engine.execute(sql) : StatementResult{false, 0};
+        auto end = std::chrono::steady_clock::now();
+
+        if (!sqliteResult.success) {
+            comparison.sqliteFailed = true;
+            std::cerr << comparison.name << ": SQLite rejected " << sql.substr(0, 80) << std::endl;
+            return;
+        }
+        if (!engineResult.success) {
+            comparison.engineSupported = false;
+            continue;
+        }
+        std::chrono::duration<double> sqliteTime = middle - start;
+        std::chrono::duration<double> engineTime = end - middle;
+        comparison.sqliteSeconds += sqliteTime.count();
+        comparison.engineSeconds += engineTime.count();
+        comparison.sqliteLatency.record(static_cast<uint64_t>(sqliteTime.count() * 1e9));
+        comparison.engineLatency.record(static_cast<uint64_t>(engineTime.count() * 1e9));
+        comparison.operations += operationsPerStatement;
+        if (engineResult.rows != sqliteResult.rows) {
+            ++comparison.mismatches;
+        }
+    }
+}
+
+std::string money(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f", value);
+    return buffer;
+}
+
+bool parseArguments(int argc, char** argv, Config& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--orders") {
+            config.orders = std::atoi(value.c_str());
+        } else if (arg == "--queries") {
+            config.queries = std::atoi(value.c_str());
+        } else if (arg == "--storage") {
+            config.storage = value;
+        } else if (arg == "--sqlite-path") {
+            config.sqlitePath = value;
+        } else if (arg == "--schema") {
+            config.schemaPath = value;
+        } else if (arg == "--json") {
+            config.jsonPath = value;
+        } else {
+            std::cerr << "Unknown option " << arg << " " << value << std::endl;
+            return false;
+        }
+    }
+    if (config.orders < 0 || config.queries < 1) {
+        std::cerr << "--orders must not be negative and --queries must be positive" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+    Logger::getInstance().setLevel(LogLevel::Warn);
+
+    std::ifstream in(config.schemaPath);
+    if (!in.is_open()) {
+        std::cerr << "Unable to read schema " << config.schemaPath << std::endl;
+        return 1;
+    }
+    std::stringstream script;
+    script << in.rdbuf();
+
+    EngineTarget engine(config.storage);
+    SqliteTarget sqlite(config.sqlitePath);
+    if (!sqlite.isOpen()) {
+        return 1;
+    }
+    std::vector<std::unique_ptr<Comparison>> comparisons;
+    auto addComparison = [&comparisons](const std::string& name, const std::string& unit) -> Comparison& {
+        comparisons.push_back(std::make_unique<Comparison>());
+        comparisons.back()->name = name;
+        comparisons.back()->unit = unit;
+        return *comparisons.back();
+    };
+
+    // classicmodels as shipped (the script's DROP statements only matter for MySQL reruns)
+    std::vector<std::string> statements;
+    for (const std::string& statement : SqlParser::splitStatements(script.str())) {
+        size_t start = statement.find_first_not_of(" \t\r\n");
+        if (start != std::string::npos && !equalsIgnoreCase(statement.substr(start, 4), "DROP")) {
+            statements.push_back(statement);
+        }
+    }
+    runWorkload(addComparison("load classicmodels", "statements"), statements, 1, engine, sqlite);
+
+    // Bulk load: synthetic orders for the sample customers and products, 100 rows per INSERT
+    std::mt19937_64 random(0xc0de);
+    std::vector<std::string> customers = sqlite.firstColumn("SELECT customerNumber FROM customers");
+    std::vector<std::string> products = sqlite.firstColumn("SELECT productCode FROM products");
+    if (customers.empty() || products.empty()) {
+        std::cerr << "classicmodels did not load" << std::endl;
+        return 1;
+    }
+
+    const int firstOrder = 200000;
+    std::vector<std::string> orderBatches;
+    std::vector<std::string> lineBatches;
+    uint64_t lineCount = 0;
+    std::string orderBatch;
+    std::string lineBatch;
+    int batchRows = 0;
+    for (int i = 0; i < config.orders; ++i) {
+        std::string order = std::to_string(firstOrder + i);
+        std::string customer = customers[random() % customers.size()];
+        orderBatch += (orderBatch.empty() ? "INSERT INTO orders VALUES (" : ", (") + order +
+                      ", '2026-01-05', '2026-01-12', NULL, 'In Process', NULL, " + customer + ")";
+        int lines = 1 + static_cast<int>(random() % 10);
+        size_t firstProduct = random() % products.size();
+        for (int line = 0; line < lines; ++line) {
+            lineBatch += (lineBatch.empty() ? "INSERT INTO orderdetails VALUES (" : ", (") + order + ", '" +
+                         products[(firstProduct + line) % products.size()] + "', " +
+                         std::to_string(1 + random() % 50) + ", " + money((100 + random() % 20000) / 100.0) + ", " +
+                         std::to_string(line + 1) + ")";
+            ++lineCount;
+        }
+        if (++batchRows == 100 || i + 1 == config.orders) {
+            orderBatches.push_back(orderBatch);
+            lineBatches.push_back(lineBatch);
+            orderBatch.clear();
+            lineBatch.clear();
+            batchRows = 0;
+        }
+    }
+    Comparison& bulkOrders = addComparison("bulk load orders", "rows");
+    runWorkload(bulkOrders, orderBatches, 0, engine, sqlite);
+    bulkOrders.operations = bulkOrders.engineSupported ? config.orders : 0;
+    Comparison& bulkLines = addComparison("bulk load orderdetails", "rows");
+    runWorkload(bulkLines, lineBatches, 0, engine, sqlite);
+    bulkLines.operations = bulkLines.engineSupported ? lineCount : 0;
+
+    std::vector<std::string> indexes = {"CREATE INDEX orders_customer ON orders (customerNumber)",
+                                        "CREATE INDEX customers_country ON customers (country)"};
+    runWorkload(addComparison("create indexes", "statements"), indexes, 1, engine, sqlite);
+
+    // Optimizer statistics for the cost-based plans
+    runWorkload(addComparison("analyze", "statements"), {"ANALYZE"}, 1, engine, sqlite);
+
+    // Query workloads over sample and synthetic orders alike
+    int totalOrders = config.orders;
+    auto randomOrder = [&]() {
+        // Sample order numbers are 10100-10425, synthetic ones start at firstOrder
+        uint64_t pick = random() % (totalOrders + 326);
+        return std::to_string(pick < 326 ? 10100 + pick : firstOrder + (pick - 326));
+    };
+    auto randomCustomer = [&]() { return customers[random() % customers.size()]; };
+
+    std::vector<std::string> queries;
+    for (int i = 0; i < config.queries; ++i) {
+        queries.push_back("SELECT * FROM orders WHERE orderNumber = " + randomOrder());
+    }
+    runWorkload(addComparison("point lookup", "queries"), queries, 1, engine, sqlite);
+
+    queries.clear();
+    for (int i = 0; i < config.queries; ++i) {
+        queries.push_back("SELECT orderNumber, status FROM orders WHERE customerNumber = " + randomCustomer());
+    }
+    runWorkload(addComparison("secondary index lookup", "queries"), queries, 1, engine, sqlite);
+
+    queries.clear();
+    for (int i = 0; i < config.queries; ++i) {
+        queries.push_back("SELECT orderNumber, orderDate FROM orders WHERE orderNumber >= " + randomOrder() +
+                          " LIMIT 50");
+    }
+    runWorkload(addComparison("range scan", "queries"), queries, 1, engine, sqlite);
+
+    // Time range over the unindexed order date: the synthetic orders' blocks are skipped by their zone maps
+    queries.clear();
+    for (int i = 0; i < config.queries / 10 + 1; ++i) {
+        int month = static_cast<int>(random() % 29);
+        char from[32];
+        char to[32];
+        std::snprintf(from, sizeof(from), "%04d-%02d-01", 2003 + month / 12, month % 12 + 1);
+        std::snprintf(to, sizeof(to), "%04d-%02d-01", 2003 + (month + 1) / 12, (month + 1) % 12 + 1);
+        queries.push_back(std::string("SELECT orderNumber, status FROM orders WHERE orderDate >= '") + from +
+                          "' AND orderDate < '" + to + "'");
+    }
+    runWorkload(addComparison("date range orders", "queries"), queries, 1, engine, sqlite);
+
+    queries.clear();
+    for (int i = 0; i < config.queries / 10 + 1; ++i) {
+        queries.push_back("SELECT * FROM orderdetails WHERE quantityOrdered > " + std::to_string(45 + random() % 5));
+    }
+    runWorkload(addComparison("full scan", "queries"), queries, 1, engine, sqlite);
+
+    queries.clear();
+    for (int i = 0; i < config.queries; ++i) {
+        queries.push_back("SELECT orders.orderNumber, orderdetails.productCode, orderdetails.quantityOrdered "
+                          "FROM orders JOIN orderdetails ON orders.orderNumber = orderdetails.orderNumber "
+                          "WHERE orders.customerNumber = " + randomCustomer());
+    }
+    runWorkload(addComparison("join orders-orderdetails", "queries"), queries, 1, engine, sqlite);
+
+    queries.clear();
+    for (int i = 0; i < config.queries / 10 + 1; ++i) {
+        queries.push_back("SELECT customers.customerName, payments.checkNumber, payments.amount "
+                          "FROM customers JOIN payments ON customers.customerNumber = payments.customerNumber "
+                          "WHERE payments.amount > " + std::to_string(1000 * (random() % 50)));
+    }
+    runWorkload(addComparison("join customers-payments", "queries"), queries, 1, engine, sqlite);
+
+    queries.clear();
+    for (int i = 0; i < config.queries / 10 + 1; ++i) {
+        queries.push_back("SELECT customerNumber, checkNumber, amount FROM payments WHERE amount > " +
+                          std::to_string(1000 * (random() % 50)) + " ORDER BY amount DESC, checkNumber");
+    }
+    runWorkload(addComparison("order by payments", "queries"), queries, 1, engine, sqlite);
+
+    queries.clear();
+    for (int i = 0; i < config.queries; ++i) {
+        queries.push_back("SELECT checkNumber, amount FROM payments WHERE customerNumber > " + randomCustomer() +
+                          " ORDER BY amount DESC LIMIT 10");
+    }
+    runWorkload(addComparison("top-n payments", "queries"), queries, 1, engine, sqlite);
+
+    queries.clear();
+    for (int i = 0; i < config.queries / 10 + 1; ++i) {
+        queries.push_back("SELECT products.productLine, COUNT(*), SUM(orderdetails.quantityOrdered) "
+                          "FROM orderdetails JOIN products ON orderdetails.productCode = products.productCode "
+                          "WHERE orderdetails.quantityOrdered > " + std::to_string(20 + random() % 30) +
+                          " GROUP BY products.productLine");
+    }
+    runWorkload(addComparison("revenue by product line", "queries"), queries, 1, engine, sqlite);
+
+    queries.clear();
+    for (int i = 0; i < config.queries / 10 + 1; ++i) {
+        queries.push_back("SELECT customerNumber, SUM(amount) AS total FROM payments WHERE amount > " +
+                          std::to_string(1000 * (random() % 50)) + " GROUP BY customerNumber ORDER BY total DESC");
+    }
+    runWorkload(addComparison("group by customer", "queries"), queries, 1, engine, sqlite);
+
+    // Report
+    bool failed = false;
+    std::printf("%-26s %10s %14s %14s %8s %22s %22s %10s\n", "workload", "ops", "engine ops/s", "sqlite ops/s",
+                "ratio", "engine p50/p99 us", "sqlite p50/p99 us", "mismatches");
+    for (const auto& comparison : comparisons) {
+        failed = failed || comparison->sqliteFailed || comparison->mismatches > 0;
+        if (!comparison->engineSupported || comparison->sqliteFailed) {
+            std::printf("%-26s %10s\n", comparison->name.c_str(),
+                        comparison->sqliteFailed ? "sqlite failed" : "unsupported by engine");
+            continue;
+        }
+        double engineRate = comparison->engineSeconds > 0 ? comparison->operations / comparison->engineSeconds : 0;
+        double sqliteRate = comparison->sqliteSeconds > 0 ? comparison->operations / comparison->sqliteSeconds : 0;
+        char engineLatency[64];
+        char sqliteLatency[64];
+        std::snprintf(engineLatency, sizeof(engineLatency), "%.1f/%.1f",
+                      comparison->engineLatency.getValueAtPercentile(50) / 1e3,
+                      comparison->engineLatency.getValueAtPercentile(99) / 1e3);
+        std::snprintf(sqliteLatency, sizeof(sqliteLatency), "%.1f/%.1f",
+                      comparison->sqliteLatency.getValueAtPercentile(50) / 1e3,
+                      comparison->sqliteLatency.getValueAtPercentile(99) / 1e3);
+        std::printf("%-26s %10llu %14.0f %14.0f %7.2fx %22s %22s %10llu\n", comparison->name.c_str(),
+                    static_cast<unsigned long long>(comparison->operations), engineRate, sqliteRate,
+                    sqliteRate > 0 ? engineRate / sqliteRate : 0.0, engineLatency, sqliteLatency,
+                    static_cast<unsigned long long>(comparison->mismatches));
+    }
+    std::printf("ratio = engine ops/s / sqlite ops/s (above 1 means the engine is faster)\n");
+
+    if (!config.jsonPath.empty()) {
+        std::ofstream out(config.jsonPath);
+        if (!out.is_open()) {
+            std::cerr << "Unable to write " << config.jsonPath << std::endl;
+            return 1;
+        }
+        out << "{\n  \"storage\": \"" << config.storage << "\",\n"
+            << "  \"sqlite\": {\"version\": \"" << sqlite3_libversion()
+            << "\", \"journal_mode\": \"wal\", \"synchronous\": \"normal\"},\n"
+            << "  \"synthetic_orders\": " << config.orders << ",\n"
+            << "  \"workloads\": [";
+        for (size_t i = 0; i < comparisons.size(); ++i) {
+            const Comparison& comparison = *comparisons[i];
+            out << (i ? ",\n" : "\n") << "    {\"name\": \"" << comparison.name << "\", \"unit\": \""
+                << comparison.unit << "\", \"engine_supported\": " << (comparison.engineSupported ? "true" : "false")
+                << ", \"operations\": " << comparison.operations
+                << ", \"engine_seconds\": " << comparison.engineSeconds
+                << ", \"sqlite_seconds\": " << comparison.sqliteSeconds
+                << ", \"row_count_mismatches\": " << comparison.mismatches
+                << ",\n     \"engine_latency_ns\": " << comparison.engineLatency.toJson()
+                << ",\n     \"sqlite_latency_ns\": " << comparison.sqliteLatency.toJson() << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+    return failed ? 2 : 0;
+}
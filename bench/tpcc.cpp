@@ -0,0 +1,730 @@
+// TPC-C-like OLTP benchmark for DatabaseEngine over the classicmodels schema.
+// Creates the tables of database/mysqlsampledatabase.sql, generates data scaled
+// by warehouse and customer count, then runs New-Order, Payment, Order-Status
+// and Stock-Level transactions from several terminals (one session each).
+// Reports tpmC (committed New-Orders per minute), abort rates and latencies.
+//
+// TPC-C concepts map onto classicmodels as follows:
+//   warehouse -> offices row          district -> employees row (sales rep)
+//   customer  -> customers row        stock    -> products row per warehouse and item
+//   order     -> orders row           order line -> orderdetails row
+//   history   -> payments row         balance  -> customers.creditLimit
+// Delivery is not run (classicmodels has no new-order queue); its share of
+// the mix goes to Order-Status and Stock-Level. Terminals have no keying or
+// think time, so each terminal submits transactions back to back.
+//
+// Usage: tpcc [--warehouses N] [--districts N] [--customers N] [--items N]
+//             [--terminals N] [--warmup SECONDS] [--duration SECONDS]
+//             [--secondary-indexes on|off] [--storage memory|file]
+//             [--schema path/to/mysqlsampledatabase.sql] [--json results.json]
+//             [--trace trace.json] [--trace-seconds SECONDS]
+//
+// --trace records engine spans during the first --trace-seconds of the
+// measured phase and writes them as Chrome trace-event JSON (open in
+// chrome://tracing or ui.perfetto.dev to see commit-path convoys).
+
+#include "DatabaseEngine.hpp"
+#include "LatencyHistogram.hpp"
+#include "Logger.hpp"
+#include "SqlParser.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef TPCC_SCHEMA_PATH
+#define TPCC_SCHEMA_PATH "database/mysqlsampledatabase.sql"
+#endif
+
+namespace {
+
+enum TransactionType { NewOrder, Payment, OrderStatus, StockLevel, TransactionTypeCount };
+const char* transactionNames[TransactionTypeCount] = {"NEW-ORDER", "PAYMENT", "ORDER-STATUS", "STOCK-LEVEL"};
+// TPC-C minimum mix with Delivery's 4% split between the two read-only transactions
+const double transactionMix[TransactionTypeCount] = {0.45, 0.43, 0.06, 0.06};
+
+const uint64_t ordersPerWarehouse = 100000000;  // Order numbers of warehouse w start at w * ordersPerWarehouse
+const int productLineCount = 7;
+
+struct Config {
+    int warehouses = 1;
+    int districts = 10;
+    int customers = 300;    // Per district
+    int items = 10000;      // Stock rows per warehouse
+    int terminals = 4;
+    double warmupSeconds = 5;
+    double durationSeconds = 30;
+    bool secondaryIndexes = true;
+    std::string storage = "memory";
+    std::string schemaPath = TPCC_SCHEMA_PATH;
+    std::string jsonPath;
+    std::string tracePath;
+    double traceSeconds = 0.25;  // Per-thread trace buffers fill within about a second
+};
+
+// Shared run state
+struct Benchmark {
+    Config config;
+    std::unique_ptr<std::atomic<uint64_t>[]> nextOrder;  // Next order sequence number per warehouse
+    std::atomic<int> phase{0};                            // 0 warm-up, 1 measure, 2 stop
+    uint64_t nurandCustomer = 0;                          // NURand run-time constants
+    uint64_t nurandItem = 0;
+    uint64_t nurandLastName = 0;
+};
+
+std::string districtNumber(int warehouse, int district) {
+    return std::to_string(warehouse * 100 + district);
+}
+
+std::string customerNumber(int warehouse, int district, int customer) {
+    return std::to_string((static_cast<uint64_t>(warehouse) * 100 + district) * 10000 + customer);
+}
+
+std::string stockCode(int warehouse, int item) {
+    return "S" + std::to_string(warehouse) + "-" + std::to_string(item);
+}
+
+// TPC-C last names: three syllables chosen by the digits of a number in [0, 999]
+std::string lastName(int number) {
+    static const char* syllables[] = {"BAR", "OUGHT", "ABLE", "PRI", "PRES", "ESE", "ANTI", "CALLY", "ATION", "EING"};
+    return std::string(syllables[number / 100]) + syllables[(number / 10) % 10] + syllables[number % 10];
+}
+
+std::string money(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f", value);
+    return buffer;
+}
+
+std::string currentDate() {
+    std::time_t now = std::time(nullptr);
+    char buffer[16];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", std::localtime(&now));
+    return buffer;
+}
+
+std::string randomText(std::mt19937_64& random, int minLength, int maxLength) {
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    std::string text(minLength + random() % (maxLength - minLength + 1), ' ');
+    for (char& c : text) {
+        c = alphabet[random() % (sizeof(alphabet) - 1)];
+    }
+    return text;
+}
+
+uint64_t uniform(std::mt19937_64& random, uint64_t low, uint64_t high) {
+    return low + random() % (high - low + 1);
+}
+
+// TPC-C non-uniform random number in [low, high]
+uint64_t nurand(std::mt19937_64& random, uint64_t a, uint64_t c, uint64_t low, uint64_t high) {
+    return (((uniform(random, 0, a) | uniform(random, low, high)) + c) % (high - low + 1)) + low;
+}
+
+// Collects rows into multi-row INSERT statements
+class BatchInserter {
+public:
+    BatchInserter(Session& target, const std::string& tableName) : session(target), table(tableName), rows(0) {}
+    ~BatchInserter() { flush(); }
+
+    bool add(const std::string& values) {
+        statement += (rows++ ? ", (" : "INSERT INTO " + table + " VALUES (") + values + ")";
+        return rows < 200 || flush();
+    }
+
+    bool flush() {
+        if (rows == 0) {
+            return true;
+        }
+        QueryResult result = session.executeQuery(statement);
+        statement.clear();
+        rows = 0;
+        if (!result.success) {
+            std::cerr << "Load of " << table << " failed: " << result.message << std::endl;
+        }
+        return result.success;
+    }
+
+private:
+    Session& session;
+    std::string table;
+    std::string statement;
+    int rows;
+};
+
+// Creates the classicmodels tables. DROP statements and the sample rows are
+// skipped: the generator below provides scaled data instead.
+bool createSchema(Session& session, const Config& config) {
+    std::ifstream in(config.schemaPath);
+    if (!in.is_open()) {
+        std::cerr << "Unable to read schema " << config.schemaPath << std::endl;
+        return false;
+    }
+    std::stringstream script;
+    script << in.rdbuf();
+    int created = 0;
+    for (const std::string& statement : SqlParser::splitStatements(script.str())) {
+        size_t start = statement.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos || !equalsIgnoreCase(statement.substr(start, 12), "CREATE TABLE")) {
+            continue;
+        }
+        QueryResult result = session.executeQuery(statement);
+        if (!result.success) {
+            std::cerr << "Schema statement failed: " << result.message << std::endl;
+            return false;
+        }
+        ++created;
+    }
+    if (config.secondaryIndexes) {
+        session.executeQuery("CREATE INDEX customers_last_name ON customers (contactLastName)");
+        session.executeQuery("CREATE INDEX orders_customer ON orders (customerNumber)");
+    }
+    return created > 0;
+}
+
+// Generates the initial population: every customer has placed one order
+bool loadData(Session& session, Benchmark& benchmark, std::mt19937_64& random) {
+    const Config& config = benchmark.config;
+    std::string today = currentDate();
+    {
+        BatchInserter lines(session, "productlines");
+        for (int line = 0; line < productLineCount; ++line) {
+            lines.add("'Line " + std::to_string(line) + "', '" + randomText(random, 20, 60) + "', NULL, NULL");
+        }
+    }
+    for (int w = 1; w <= config.warehouses; ++w) {
+        BatchInserter offices(session, "offices");
+        offices.add("'" + std::to_string(w) + "', 'City " + std::to_string(w) + "', '" + randomText(random, 10, 10) +
+                    "', '" + randomText(random, 10, 20) + "', NULL, NULL, 'Country', '" + randomText(random, 5, 9) +
+                    "', 'NA'");
+        if (!offices.flush()) {
+            return false;
+        }
+
+        BatchInserter employees(session, "employees");
+        for (int d = 1; d <= config.districts; ++d) {
+            employees.add(districtNumber(w, d) + ", '" + randomText(random, 6, 12) + "', '" + randomText(random, 6, 12) +
+                          "', 'x" + std::to_string(d) + "', 'rep" + districtNumber(w, d) + "@example.com', '" +
+                          std::to_string(w) + "', NULL, 'Sales Rep'");
+        }
+        if (!employees.flush()) {
+            return false;
+        }
+
+        BatchInserter products(session, "products");
+        for (int item = 1; item <= config.items; ++item) {
+            products.add("'" + stockCode(w, item) + "', '" + randomText(random, 14, 24) + "', 'Line " +
+                         std::to_string(item % productLineCount) + "', '1:10', '" + randomText(random, 8, 16) + "', '" +
+                         randomText(random, 26, 50) + "', " + std::to_string(uniform(random, 10, 100)) + ", " +
+                         money(uniform(random, 100, 10000) / 100.0) + ", " +
+                         money(uniform(random, 100, 10000) / 100.0 * 1.5));
+        }
+        if (!products.flush()) {
+            return false;
+        }
+
+        BatchInserter customers(session, "customers");
+        BatchInserter orders(session, "orders");
+        BatchInserter details(session, "orderdetails");
+        uint64_t sequence = 0;
+        for (int d = 1; d <= config.districts; ++d) {
+            for (int c = 1; c <= config.customers; ++c) {
+                // The first 1000 customers of a district carry every last name once
+                int nameNumber = c <= 1000 ? c - 1
+                                           : static_cast<int>(nurand(random, 255, benchmark.nurandLastName, 0, 999));
+                std::string number = customerNumber(w, d, c);
+                customers.add(number + ", '" + randomText(random, 8, 16) + "', '" + lastName(nameNumber) + "', '" +
+                              randomText(random, 8, 16) + "', '" + randomText(random, 16, 16) + "', '" +
+                              randomText(random, 10, 20) + "', NULL, '" + randomText(random, 10, 20) + "', NULL, '" +
+                              randomText(random, 5, 9) + "', 'Country', " + districtNumber(w, d) + ", " +
+                              money(50000));
+
+                uint64_t order = w * ordersPerWarehouse + ++sequence;
+                orders.add(std::to_string(order) + ", '" + today + "', '" + today + "', '" + today +
+                           "', 'Shipped', NULL, " + number);
+                int lineCount = static_cast<int>(uniform(random, 5, 15));
+                std::vector<int> chosen;
+                while (static_cast<int>(chosen.size()) < std::min(lineCount, config.items)) {
+                    int item = static_cast<int>(uniform(random, 1, config.items));
+                    if (std::find(chosen.begin(), chosen.end(), item) == chosen.end()) {
+                        chosen.push_back(item);
+                        details.add(std::to_string(order) + ", '" + stockCode(w, item) + "', " +
+                                    std::to_string(uniform(random, 1, 10)) + ", " +
+                                    money(uniform(random, 100, 10000) / 100.0) + ", " +
+                                    std::to_string(chosen.size()));
+                    }
+                }
+            }
+        }
+        if (!customers.flush() || !orders.flush() || !details.flush()) {
+            return false;
+        }
+        benchmark.nextOrder[w - 1] = sequence + 1;
+    }
+    return true;
+}
+
+// Per-terminal driver state
+struct Terminal {
+    Terminal(Benchmark& shared, std::unique_ptr<Session> clientSession, int homeWarehouse, uint64_t seed)
+        : benchmark(shared), config(shared.config), session(std::move(clientSession)), warehouse(homeWarehouse),
+          random(seed), today(currentDate()) {}
+
+    Benchmark& benchmark;
+    const Config& config;
+    std::unique_ptr<Session> session;
+    int warehouse;
+    std::mt19937_64 random;
+    std::string today;
+    uint64_t payments = 0;
+
+    LatencyHistogram latency[TransactionTypeCount];
+    uint64_t committed[TransactionTypeCount] = {0, 0, 0, 0};
+    uint64_t rolledBack[TransactionTypeCount] = {0, 0, 0, 0};  // Business-rule rollbacks
+    uint64_t failed[TransactionTypeCount] = {0, 0, 0, 0};      // Aborted by an error
+    uint64_t ordersPlaced = 0;                                 // Across all phases, for the consistency check
+    uint64_t linesPlaced = 0;
+    uint64_t paymentsMade = 0;
+    uint64_t lowStockItems = 0;                                // Stock-Level results
+
+    enum Outcome { Committed, RolledBack, Failed };
+
+    // Runs a read; any error aborts the transaction
+    bool query(const std::string& sql, QueryResult& result) {
+        result = session->executeQuery(sql);
+        return result.success;
+    }
+
+    Outcome abort(Outcome outcome) {
+        session->rollbackTransaction();
+        return outcome;
+    }
+
+    int randomDistrict() {
+        return static_cast<int>(uniform(random, 1, config.districts));
+    }
+
+    int randomCustomer() {
+        return static_cast<int>(nurand(random, 1023, benchmark.nurandCustomer, 1, config.customers));
+    }
+
+    // 60% of Payment and Order-Status transactions select the customer by last name
+    bool selectCustomer(int w, int d, std::string& customer, std::string& balance) {
+        QueryResult result;
+        if (uniform(random, 1, 100) <= 60) {
+            int names = std::min(config.customers, 1000);
+            std::string name = lastName(static_cast<int>(nurand(random, 255, benchmark.nurandLastName, 0, names - 1)));
+            if (!query("SELECT customerNumber, creditLimit, contactFirstName FROM customers WHERE contactLastName = '" +
+                       name + "' AND salesRepEmployeeNumber = " + districtNumber(w, d), result) ||
+                result.rows.empty()) {
+                return false;
+            }
+            std::sort(result.rows.begin(), result.rows.end(),
+                      [](const Row& a, const Row& b) { return a[2] < b[2]; });
+            const Row& middle = result.rows[(result.rows.size() - 1) / 2];
+            customer = middle[0];
+            balance = middle[1];
+            return true;
+        }
+        customer = customerNumber(w, d, randomCustomer());
+        if (!query("SELECT customerNumber, creditLimit FROM customers WHERE customerNumber = " + customer, result) ||
+            result.rows.empty()) {
+            return false;
+        }
+        balance = result.rows[0][1];
+        return true;
+    }
+
+    Outcome newOrder() {
+        int d = randomDistrict();
+        std::string customer = customerNumber(warehouse, d, randomCustomer());
+        int lineCount = static_cast<int>(uniform(random, 5, 15));
+        bool invalidItem = uniform(random, 1, 100) == 1;  // 1% roll back on an unused item number
+
+        session->startTransaction();
+        QueryResult result;
+        if (!query("SELECT city FROM offices WHERE officeCode = '" + std::to_string(warehouse) + "'", result) ||
+            !query("SELECT lastName FROM employees WHERE employeeNumber = " + districtNumber(warehouse, d), result) ||
+            !query("SELECT customerName, creditLimit FROM customers WHERE customerNumber = " + customer, result) ||
+            result.rows.empty()) {
+            return abort(Failed);
+        }
+
+        uint64_t sequence = benchmark.nextOrder[warehouse - 1].fetch_add(1);
+        std::string order = std::to_string(warehouse * ordersPerWarehouse + sequence);
+        session->insertData("INSERT INTO orders VALUES (" + order + ", '" + today + "', '" + today +
+                            "', NULL, 'In Process', NULL, " + customer + ")");
+        std::vector<std::string> chosen;
+        for (int line = 1; line <= lineCount; ++line) {
+            int item = static_cast<int>(nurand(random, 8191, benchmark.nurandItem, 1, config.items));
+            if (invalidItem && line == lineCount) {
+                item = config.items + 1;
+            }
+            // 1% of order lines are supplied by a remote warehouse
+            int supplier = warehouse;
+            if (config.warehouses > 1 && uniform(random, 1, 100) == 1) {
+                supplier = static_cast<int>(uniform(random, 1, config.warehouses - 1));
+                supplier += supplier >= warehouse ? 1 : 0;
+            }
+            std::string code = stockCode(supplier, item);
+            if (std::find(chosen.begin(), chosen.end(), code) != chosen.end()) {
+                continue;  // One order line per product (orderdetails key)
+            }
+            chosen.push_back(code);
+
+            if (!query("SELECT quantityInStock, buyPrice FROM products WHERE productCode = '" + code + "'", result)) {
+                return abort(Failed);
+            }
+            if (result.rows.empty()) {
+                return abort(RolledBack);
+            }
+            long stock = std::atol(result.rows[0][0].c_str());
+            long quantity = static_cast<long>(uniform(random, 1, 10));
+            stock = stock - quantity >= 10 ? stock - quantity : stock - quantity + 91;
+            session->insertData("UPDATE products SET quantityInStock = " + std::to_string(stock) +
+                                " WHERE productCode = '" + code + "'");
+            session->insertData("INSERT INTO orderdetails VALUES (" + order + ", '" + code + "', " +
+                                std::to_string(quantity) + ", " + result.rows[0][1] + ", " +
+                                std::to_string(chosen.size()) + ")");
+        }
+        session->commitTransaction();
+        ++ordersPlaced;
+        linesPlaced += chosen.size();
+        return Committed;
+    }
+
+    Outcome payment() {
+        int d = randomDistrict();
+        // 15% of payments are made by a customer of a remote warehouse
+        int w = warehouse;
+        if (config.warehouses > 1 && uniform(random, 1, 100) <= 15) {
+            w = static_cast<int>(uniform(random, 1, config.warehouses - 1));
+            w += w >= warehouse ? 1 : 0;
+            d = randomDistrict();
+        }
+        double amount = uniform(random, 100, 500000) / 100.0;
+
+        session->startTransaction();
+        std::string customer;
+        std::string balance;
+        if (!selectCustomer(w, d, customer, balance)) {
+            return abort(Failed);
+        }
+        std::string check = "T" + std::to_string(session->getId()) + "-" + std::to_string(++payments);
+        session->insertData("UPDATE customers SET creditLimit = " + money(std::atof(balance.c_str()) - amount) +
+                            " WHERE customerNumber = " + customer);
+        session->insertData("INSERT INTO payments VALUES (" + customer + ", '" + check + "', '" + today + "', " +
+                            money(amount) + ")");
+        session->commitTransaction();
+        ++paymentsMade;
+        return Committed;
+    }
+
+    Outcome orderStatus() {
+        session->startTransaction();
+        std::string customer;
+        std::string balance;
+        QueryResult result;
+        if (!selectCustomer(warehouse, randomDistrict(), customer, balance) ||
+            !query("SELECT orderNumber, orderDate, status FROM orders WHERE customerNumber = " + customer, result)) {
+            return abort(Failed);
+        }
+        // The customer's most recent order and its lines
+        std::string latest;
+        uint64_t latestNumber = 0;
+        for (const Row& row : result.rows) {
+            uint64_t number = std::strtoull(row[0].c_str(), nullptr, 10);
+            if (number >= latestNumber) {
+                latestNumber = number;
+                latest = row[0];
+            }
+        }
+        if (!latest.empty() &&
+            !query("SELECT productCode, quantityOrdered, priceEach FROM orderdetails WHERE orderNumber = " + latest,
+                   result)) {
+            return abort(Failed);
+        }
+        session->commitTransaction();
+        return Committed;
+    }
+
+    Outcome stockLevel() {
+        long threshold = static_cast<long>(uniform(random, 10, 20));
+        uint64_t next = benchmark.nextOrder[warehouse - 1].load();
+        uint64_t base = warehouse * ordersPerWarehouse;
+        uint64_t first = base + (next > 20 ? next - 20 : 1);
+
+        session->startTransaction();
+        QueryResult orders;
+        if (!query("SELECT orderNumber FROM orders WHERE orderNumber >= " + std::to_string(first) +
+                   " AND orderNumber < " + std::to_string(base + next) + " LIMIT 20", orders)) {
+            return abort(Failed);
+        }
+        // Distinct products of the last 20 orders whose stock is below the threshold
+        std::vector<std::string> products;
+        QueryResult result;
+        for (const Row& order : orders.rows) {
+            if (!query("SELECT productCode FROM orderdetails WHERE orderNumber = " + order[0], result)) {
+                return abort(Failed);
+            }
+            for (const Row& line : result.rows) {
+                products.push_back(line[0]);
+            }
+        }
+        std::sort(products.begin(), products.end());
+        products.erase(std::unique(products.begin(), products.end()), products.end());
+        for (const std::string& code : products) {
+            if (!query("SELECT quantityInStock FROM products WHERE productCode = '" + code + "'", result)) {
+                return abort(Failed);
+            }
+            if (!result.rows.empty() && std::atol(result.rows[0][0].c_str()) < threshold) {
+                ++lowStockItems;
+            }
+        }
+        session->commitTransaction();
+        return Committed;
+    }
+
+    TransactionType chooseTransaction() {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+        for (int type = 0; type < TransactionTypeCount; ++type) {
+            u -= transactionMix[type];
+            if (u < 0) return static_cast<TransactionType>(type);
+        }
+        return NewOrder;
+    }
+
+    void run() {
+        int phase;
+        while ((phase = benchmark.phase.load(std::memory_order_relaxed)) != 2) {
+            TransactionType type = chooseTransaction();
+            auto start = std::chrono::steady_clock::now();
+            Outcome outcome = Committed;
+            switch (type) {
+                case NewOrder: outcome = newOrder(); break;
+                case Payment: outcome = payment(); break;
+                case OrderStatus: outcome = orderStatus(); break;
+                case StockLevel: outcome = stockLevel(); break;
+                default: break;
+            }
+            auto end = std::chrono::steady_clock::now();
+            if (phase == 1) {
+                latency[type].record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+                (outcome == Committed ? committed : outcome == RolledBack ? rolledBack : failed)[type]++;
+            }
+        }
+    }
+};
+
+bool parseArguments(int argc, char** argv, Config& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--warehouses") {
+            config.warehouses = std::atoi(value.c_str());
+        } else if (arg == "--districts") {
+            config.districts = std::atoi(value.c_str());
+        } else if (arg == "--customers") {
+            config.customers = std::atoi(value.c_str());
+        } else if (arg == "--items") {
+            config.items = std::atoi(value.c_str());
+        } else if (arg == "--terminals") {
+            config.terminals = std::atoi(value.c_str());
+        } else if (arg == "--warmup") {
+            config.warmupSeconds = std::atof(value.c_str());
+        } else if (arg == "--duration") {
+            config.durationSeconds = std::atof(value.c_str());
+        } else if (arg == "--secondary-indexes" && (value == "on" || value == "off")) {
+            config.secondaryIndexes = value == "on";
+        } else if (arg == "--storage") {
+            config.storage = value;
+        } else if (arg == "--schema") {
+            config.schemaPath = value;
+        } else if (arg == "--json") {
+            config.jsonPath = value;
+        } else if (arg == "--trace") {
+            config.tracePath = value;
+        } else if (arg == "--trace-seconds") {
+            config.traceSeconds = std::atof(value.c_str());
+        } else {
+            std::cerr << "Unknown option " << arg << " " << value << std::endl;
+            return false;
+        }
+    }
+    if (config.warehouses < 1 || config.terminals < 1 || config.items < 1) {
+        std::cerr << "Counts must be positive" << std::endl;
+        return false;
+    }
+    // Keys encode the district in two digits and the customer in four
+    if (config.districts < 1 || config.districts > 99 || config.customers < 1 || config.customers > 9999) {
+        std::cerr << "--districts must be in [1, 99] and --customers in [1, 9999]" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Benchmark benchmark;
+    Config& config = benchmark.config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+    Logger::getInstance().setLevel(LogLevel::Warn);
+
+    std::mt19937_64 random(0x7bcc);
+    benchmark.nurandCustomer = uniform(random, 0, 1023);
+    benchmark.nurandItem = uniform(random, 0, 8191);
+    benchmark.nurandLastName = uniform(random, 0, 255);
+    benchmark.nextOrder.reset(new std::atomic<uint64_t>[config.warehouses]);
+
+    DatabaseEngine engine;
+    engine.initializeDatabase(":memory:");
+    engine.setStorageEngine(config.storage);
+
+    auto loadStart = std::chrono::steady_clock::now();
+    {
+        std::unique_ptr<Session> loader = engine.openSession();
+        if (!createSchema(*loader, config) || !loadData(*loader, benchmark, random)) {
+            return 1;
+        }
+    }
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+    StorageEngine* storage = engine.getStorageEngine();
+    uint64_t initialOrders = storage->getRowCount("orders");
+    uint64_t initialLines = storage->getRowCount("orderdetails");
+    uint64_t initialPayments = storage->getRowCount("payments");
+    std::cout << "Loaded " << config.warehouses << " warehouses (" << storage->getRowCount("customers")
+              << " customers, " << storage->getRowCount("products") << " stock rows, " << initialLines
+              << " order lines) in " << loadSeconds << " s" << std::endl;
+
+    std::vector<std::unique_ptr<Terminal>> terminals;
+    for (int t = 0; t < config.terminals; ++t) {
+        terminals.push_back(std::make_unique<Terminal>(benchmark, engine.openSession(), t % config.warehouses + 1,
+                                                       0x5eed + t));
+    }
+
+    // Warm-up, then the measured phase
+    std::vector<std::thread> threads;
+    for (auto& terminal : terminals) {
+        threads.emplace_back([&terminal]() { terminal->run(); });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(config.warmupSeconds));
+    auto measureStart = std::chrono::steady_clock::now();
+    benchmark.phase = 1;
+    double traceSeconds = config.tracePath.empty() ? 0 : std::min(config.traceSeconds, config.durationSeconds);
+    if (traceSeconds > 0) {
+        Tracer::getInstance().start();
+        std::this_thread::sleep_for(std::chrono::duration<double>(traceSeconds));
+        Tracer::getInstance().stop();
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(config.durationSeconds - traceSeconds));
+    benchmark.phase = 2;
+    auto measureEnd = std::chrono::steady_clock::now();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(measureEnd - measureStart).count();
+    double minutes = seconds / 60;
+
+    LatencyHistogram totals[TransactionTypeCount];
+    uint64_t committed[TransactionTypeCount] = {0, 0, 0, 0};
+    uint64_t rolledBack[TransactionTypeCount] = {0, 0, 0, 0};
+    uint64_t failed[TransactionTypeCount] = {0, 0, 0, 0};
+    uint64_t ordersPlaced = 0;
+    uint64_t linesPlaced = 0;
+    uint64_t paymentsMade = 0;
+    for (auto& terminal : terminals) {
+        for (int type = 0; type < TransactionTypeCount; ++type) {
+            totals[type].merge(terminal->latency[type]);
+            committed[type] += terminal->committed[type];
+            rolledBack[type] += terminal->rolledBack[type];
+            failed[type] += terminal->failed[type];
+        }
+        ordersPlaced += terminal->ordersPlaced;
+        linesPlaced += terminal->linesPlaced;
+        paymentsMade += terminal->paymentsMade;
+    }
+    uint64_t allCommitted = 0;
+    uint64_t allFailed = 0;
+    for (int type = 0; type < TransactionTypeCount; ++type) {
+        allCommitted += committed[type];
+        allFailed += failed[type];
+    }
+    double tpmC = minutes > 0 ? committed[NewOrder] / minutes : 0.0;
+    double tpmTotal = minutes > 0 ? allCommitted / minutes : 0.0;
+
+    // Every committed transaction must have applied all of its rows
+    bool consistent = storage->getRowCount("orders") == initialOrders + ordersPlaced &&
+                      storage->getRowCount("orderdetails") == initialLines + linesPlaced &&
+                      storage->getRowCount("payments") == initialPayments + paymentsMade;
+
+    std::cout << config.warehouses << " warehouses, " << config.terminals << " terminals: " << tpmC << " tpmC, "
+              << tpmTotal << " tpmTotal, consistency " << (consistent ? "ok" : "FAILED") << std::endl;
+    for (int type = 0; type < TransactionTypeCount; ++type) {
+        uint64_t attempts = committed[type] + rolledBack[type] + failed[type];
+        double abortRate = attempts ? 100.0 * (rolledBack[type] + failed[type]) / attempts : 0.0;
+        std::cout << "  " << transactionNames[type] << ": committed=" << committed[type]
+                  << " rolled_back=" << rolledBack[type] << " failed=" << failed[type]
+                  << " abort_rate=" << abortRate << "%"
+                  << " p50=" << totals[type].getValueAtPercentile(50) / 1e6 << "ms"
+                  << " p90=" << totals[type].getValueAtPercentile(90) / 1e6 << "ms"
+                  << " p99=" << totals[type].getValueAtPercentile(99) / 1e6 << "ms" << std::endl;
+    }
+
+    if (traceSeconds > 0) {
+        Tracer& tracer = Tracer::getInstance();
+        if (!tracer.writeChromeTrace(config.tracePath)) {
+            std::cerr << "Unable to write " << config.tracePath << std::endl;
+            return 1;
+        }
+        std::cout << "trace: " << tracer.getEventCount() << " spans (" << tracer.getDroppedCount()
+                  << " dropped) written to " << config.tracePath << std::endl;
+    }
+
+    if (!config.jsonPath.empty()) {
+        std::ofstream out(config.jsonPath);
+        if (!out.is_open()) {
+            std::cerr << "Unable to write " << config.jsonPath << std::endl;
+            return 1;
+        }
+        out << "{\n  \"warehouses\": " << config.warehouses << ",\n"
+            << "  \"districts\": " << config.districts << ",\n"
+            << "  \"customers_per_district\": " << config.customers << ",\n"
+            << "  \"items\": " << config.items << ",\n"
+            << "  \"terminals\": " << config.terminals << ",\n"
+            << "  \"secondary_indexes\": " << (config.secondaryIndexes ? "true" : "false") << ",\n"
+            << "  \"storage\": \"" << config.storage << "\",\n"
+            << "  \"load_seconds\": " << loadSeconds << ",\n"
+            << "  \"warmup_seconds\": " << config.warmupSeconds << ",\n"
+            << "  \"measured_seconds\": " << seconds << ",\n"
+            << "  \"tpmC\": " << tpmC << ",\n"
+            << "  \"tpmTotal\": " << tpmTotal << ",\n"
+            << "  \"consistent\": " << (consistent ? "true" : "false") << ",\n"
+            << "  \"transactions\": {";
+        for (int type = 0; type < TransactionTypeCount; ++type) {
+            out << (type ? ",\n" : "\n") << "    \"" << transactionNames[type] << "\": {\"committed\": "
+                << committed[type] << ", \"rolled_back\": " << rolledBack[type] << ", \"failed\": " << failed[type]
+                << ", \"latency_ns\": " << totals[type].toJson() << "}";
+        }
+        out << "\n  }\n}\n";
+    }
+    return allFailed == 0 && consistent ? 0 : 2;
+}
@@ -0,0 +1,421 @@
+// YCSB-style workload driver for DatabaseEngine.
+// Loads a usertable, then runs one of the YCSB core workloads (A-F) from
+// several sessions in parallel: an untimed warm-up followed by a measured
+// phase. Reports throughput and per-operation HDR latency histograms.
+//
+// Usage: ycsb [--workload a-f] [--records N] [--threads N] [--fields N]
+//             [--field-length N] [--distribution uniform|zipfian|latest]
+//             [--warmup SECONDS] [--duration SECONDS] [--max-scan N]
+//             [--read P] [--update P] [--insert P] [--scan P] [--rmw P]
+//             [--storage memory|file] [--json results.json]
+
+#include "DatabaseEngine.hpp"
+#include "LatencyHistogram.hpp"
+#include "Logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum Operation { Read, Update, Insert, Scan, ReadModifyWrite, OperationCount };
+const char* operationNames[OperationCount] = {"READ", "UPDATE", "INSERT", "SCAN", "READ-MODIFY-WRITE"};
+
+struct Config {
+    char workload = 'a';
+    uint64_t records = 100000;
+    int threads = 4;
+    int fields = 10;
+    int fieldLength = 100;
+    std::string distribution;  // Empty: the workload's default
+    double warmupSeconds = 5;
+    double durationSeconds = 30;
+    int maxScanLength = 100;
+    double proportions[OperationCount] = {0, 0, 0, 0, 0};
+    bool customMix = false;
+    std::string storage = "memory";
+    std::string jsonPath;
+};
+
+// The YCSB core workload definitions
+void applyWorkload(Config& config) {
+    double mixes[6][OperationCount] = {
+        {0.50, 0.50, 0.00, 0.00, 0.00},  // A: update heavy
+        {0.95, 0.05, 0.00, 0.00, 0.00},  // B: read mostly
+        {1.00, 0.00, 0.00, 0.00, 0.00},  // C: read only
+        {0.95, 0.00, 0.05, 0.00, 0.00},  // D: read latest
+        {0.00, 0.00, 0.05, 0.95, 0.00},  // E: short ranges
+        {0.50, 0.00, 0.00, 0.00, 0.50},  // F: read-modify-write
+    };
+    if (!config.customMix) {
+        for (int op = 0; op < OperationCount; ++op) {
+            config.proportions[op] = mixes[config.workload - 'a'][op];
+        }
+    }
+    if (config.distribution.empty()) {
+        config.distribution = config.workload == 'd' ? "latest" : "zipfian";
+    }
+}
+
+// FNV-1a over the key number: spreads sequential inserts across the key space
+uint64_t fnvHash(uint64_t value) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < 8; ++i) {
+        hash ^= value & 0xff;
+        hash *= 0x100000001b3ULL;
+        value >>= 8;
+    }
+    return hash;
+}
+
+std::string keyName(uint64_t keyNumber) {
+    return "user" + std::to_string(fnvHash(keyNumber));
+}
+
+// Zipfian generator (Gray et al., "Quickly Generating Billion-Record Synthetic
+// Databases"), as used by YCSB. The item count may grow between calls; zeta is
+// extended incrementally.
+class ZipfianGenerator {
+public:
+    explicit ZipfianGenerator(double zipfianConstant = 0.99)
+        : theta(zipfianConstant), alpha(1.0 / (1.0 - zipfianConstant)), zeta2(zeta(0, 2, 0)),
+          zetaN(0), items(0), eta(0) {}
+
+    // Value in [0, itemCount), small values most popular
+    uint64_t next(uint64_t itemCount, std::mt19937_64& random) {
+        if (itemCount != items) {
+            zetaN = itemCount > items ? zeta(items, itemCount, zetaN) : zeta(0, itemCount, 0);
+            items = itemCount;
+            eta = (1 - std::pow(2.0 / items, 1 - theta)) / (1 - zeta2 / zetaN);
+        }
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+        double uz = u * zetaN;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + std::pow(0.5, theta)) return 1;
+        uint64_t value = static_cast<uint64_t>(items * std::pow(eta * u - eta + 1, alpha));
+        return value < items ? value : items - 1;
+    }
+
+private:
+    double zeta(uint64_t from, uint64_t to, double initial) const {
+        double sum = initial;
+        for (uint64_t i = from; i < to; ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+        }
+        return sum;
+    }
+
+    double theta;
+    double alpha;
+    double zeta2;
+    double zetaN;
+    uint64_t items;
+    double eta;
+};
+
+// Shared run state
+struct Workload {
+    Config config;
+    std::atomic<uint64_t> insertedKeys{0};   // Keys [0, insertedKeys) exist
+    std::atomic<uint64_t> nextInsertKey{0};  // Next key number handed to an inserter
+    std::atomic<int> phase{0};               // 0 warm-up, 1 measure, 2 stop
+};
+
+// Per-thread driver state
+struct Worker {
+    Worker(Workload& shared, std::unique_ptr<Session> clientSession, uint64_t seed)
+        : workload(shared), session(std::move(clientSession)), random(seed) {}
+
+    Workload& workload;
+    std::unique_ptr<Session> session;
+    std::mt19937_64 random;
+    ZipfianGenerator zipfian;
+    LatencyHistogram latency[OperationCount];
+    uint64_t errors = 0;
+
+    std::string randomValue() {
+        static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+        std::string value(workload.config.fieldLength, ' ');
+        for (char& c : value) {
+            c = alphabet[random() % (sizeof(alphabet) - 1)];
+        }
+        return value;
+    }
+
+    uint64_t chooseKey() {
+        uint64_t count = workload.insertedKeys.load(std::memory_order_acquire);
+        const std::string& distribution = workload.config.distribution;
+        if (distribution == "uniform") {
+            return random() % count;
+        }
+        if (distribution == "latest") {
+            return count - 1 - zipfian.next(count, random);
+        }
+        return fnvHash(zipfian.next(count, random)) % count;  // Scrambled zipfian
+    }
+
+    bool check(const QueryResult& result) {
+        if (!result.success) {
+            ++errors;
+        }
+        return result.success;
+    }
+
+    void insert(uint64_t keyNumber) {
+        std::string statement = "INSERT INTO usertable VALUES ('" + keyName(keyNumber) + "'";
+        for (int i = 0; i < workload.config.fields; ++i) {
+            statement += ", '" + randomValue() + "'";
+        }
+        check(session->executeQuery(statement + ")"));
+    }
+
+    void read(uint64_t keyNumber) {
+        check(session->executeQuery("SELECT * FROM usertable WHERE ycsb_key = '" + keyName(keyNumber) + "'"));
+    }
+
+    void update(uint64_t keyNumber) {
+        std::string field = "field" + std::to_string(random() % workload.config.fields);
+        check(session->executeQuery("UPDATE usertable SET " + field + " = '" + randomValue() +
+                                    "' WHERE ycsb_key = '" + keyName(keyNumber) + "'"));
+    }
+
+    void scan(uint64_t keyNumber) {
+        uint64_t length = 1 + random() % workload.config.maxScanLength;
+        check(session->executeQuery("SELECT * FROM usertable WHERE ycsb_key >= '" + keyName(keyNumber) +
+                                    "' LIMIT " + std::to_string(length)));
+    }
+
+    Operation chooseOperation() {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+        for (int op = 0; op < OperationCount; ++op) {
+            u -= workload.config.proportions[op];
+            if (u < 0) return static_cast<Operation>(op);
+        }
+        return Read;
+    }
+
+    void run() {
+        int phase;
+        while ((phase = workload.phase.load(std::memory_order_relaxed)) != 2) {
+            Operation op = chooseOperation();
+            auto start = std::chrono::steady_clock::now();
+            switch (op) {
+                case Read: read(chooseKey()); break;
+                case Update: update(chooseKey()); break;
+                case Scan: scan(chooseKey()); break;
+                case ReadModifyWrite: {
+                    uint64_t key = chooseKey();
+                    read(key);
+                    update(key);
+                    break;
+                }
+                case Insert: {
+                    uint64_t key = workload.nextInsertKey.fetch_add(1);
+                    insert(key);
+                    // Publish in order so readers never pick a key that is still being inserted
+                    uint64_t expected = key;
+                    while (!workload.insertedKeys.compare_exchange_weak(expected, key + 1)) {
+                        expected = key;
+                        std::this_thread::yield();
+                    }
+                    break;
+                }
+                default: break;
+            }
+            auto end = std::chrono::steady_clock::now();
+            if (phase == 1) {
+                latency[op].record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+            }
+        }
+    }
+};
+
+bool parseArguments(int argc, char** argv, Config& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--workload" && value.size() == 1 && std::tolower(value[0]) >= 'a' && std::tolower(value[0]) <= 'f') {
+            config.workload = static_cast<char>(std::tolower(value[0]));
+        } else if (arg == "--records") {
+            config.records = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--threads") {
+            config.threads = std::atoi(value.c_str());
+        } else if (arg == "--fields") {
+            config.fields = std::atoi(value.c_str());
+        } else if (arg == "--field-length") {
+            config.fieldLength = std::atoi(value.c_str());
+        } else if (arg == "--distribution" && (value == "uniform" || value == "zipfian" || value == "latest")) {
+            config.distribution = value;
+        } else if (arg == "--warmup") {
+            config.warmupSeconds = std::atof(value.c_str());
+        } else if (arg == "--duration") {
+            config.durationSeconds = std::atof(value.c_str());
+        } else if (arg == "--max-scan") {
+            config.maxScanLength = std::atoi(value.c_str());
+        } else if (arg == "--storage") {
+            config.storage = value;
+        } else if (arg == "--json") {
+            config.jsonPath = value;
+        } else {
+            const char* mixOptions[OperationCount] = {"--read", "--update", "--insert", "--scan", "--rmw"};
+            bool matched = false;
+            for (int op = 0; op < OperationCount; ++op) {
+                if (arg == mixOptions[op]) {
+                    config.proportions[op] = std::atof(value.c_str());
+                    config.customMix = matched = true;
+                }
+            }
+            if (!matched) {
+                std::cerr << "Unknown option " << arg << " " << value << std::endl;
+                return false;
+            }
+        }
+    }
+    if (config.records == 0 || config.threads < 1 || config.fields < 1 || config.fieldLength < 1 ||
+        config.maxScanLength < 1) {
+        std::cerr << "Counts and sizes must be positive" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Workload workload;
+    Config& config = workload.config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+    applyWorkload(config);
+    Logger::getInstance().setLevel(LogLevel::Warn);
+
+    DatabaseEngine engine;
+    engine.initializeDatabase(":memory:");
+    engine.setStorageEngine(config.storage);
+    std::string definition = "CREATE TABLE usertable (ycsb_key VARCHAR(64)";
+    for (int i = 0; i < config.fields; ++i) {
+        definition += ", field" + std::to_string(i) + " TEXT";
+    }
+    engine.createTable(definition + ", PRIMARY KEY (ycsb_key))");
+    if (!engine.hasTable("usertable")) {
+        std::cerr << "Unable to create usertable" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int t = 0; t < config.threads; ++t) {
+        workers.push_back(std::make_unique<Worker>(workload, engine.openSession(), 0x5eed + t));
+    }
+
+    // Load phase: every thread inserts a contiguous slice of the key numbers
+    auto loadStart = std::chrono::steady_clock::now();
+    {
+        std::vector<std::thread> loaders;
+        for (int t = 0; t < config.threads; ++t) {
+            loaders.emplace_back([&, t]() {
+                for (uint64_t key = t; key < config.records; key += config.threads) {
+                    workers[t]->insert(key);
+                }
+            });
+        }
+        for (auto& loader : loaders) {
+            loader.join();
+        }
+    }
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+    workload.insertedKeys = config.records;
+    workload.nextInsertKey = config.records;
+    std::cout << "Loaded " << config.records << " records in " << loadSeconds << " s ("
+              << config.records / loadSeconds << " inserts/sec)" << std::endl;
+
+    // Warm-up, then the measured phase
+    std::vector<std::thread> threads;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker]() { worker->run(); });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(config.warmupSeconds));
+    auto measureStart = std::chrono::steady_clock::now();
+    workload.phase = 1;
+    std::this_thread::sleep_for(std::chrono::duration<double>(config.durationSeconds));
+    workload.phase = 2;
+    auto measureEnd = std::chrono::steady_clock::now();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(measureEnd - measureStart).count();
+
+    LatencyHistogram totals[OperationCount];
+    uint64_t operations = 0;
+    uint64_t errors = 0;
+    for (auto& worker : workers) {
+        for (int op = 0; op < OperationCount; ++op) {
+            totals[op].merge(worker->latency[op]);
+        }
+        errors += worker->errors;
+    }
+    for (int op = 0; op < OperationCount; ++op) {
+        operations += totals[op].getCount();
+    }
+    double throughput = seconds > 0 ? operations / seconds : 0.0;
+
+    std::cout << "Workload " << static_cast<char>(std::toupper(config.workload)) << " (" << config.distribution
+              << "), " << config.threads << " threads: " << throughput << " ops/sec, " << errors << " errors"
+              << std::endl;
+    for (int op = 0; op < OperationCount; ++op) {
+        if (totals[op].getCount()) {
+            std::cout << "  " << operationNames[op] << ": count=" << totals[op].getCount()
+                      << " mean=" << totals[op].getMean() / 1000 << "us"
+                      << " p50=" << totals[op].getValueAtPercentile(50) / 1000.0 << "us"
+                      << " p99=" << totals[op].getValueAtPercentile(99) / 1000.0 << "us"
+                      << " max=" << totals[op].getMax() / 1000.0 << "us" << std::endl;
+        }
+    }
+
+    if (!config.jsonPath.empty()) {
+        std::ofstream out(config.jsonPath);
+        if (!out.is_open()) {
+            std::cerr << "Unable to write " << config.jsonPath << std::endl;
+            return 1;
+        }
+        out << "{\n  \"workload\": \"" << config.workload << "\",\n"
+            << "  \"distribution\": \"" << config.distribution << "\",\n"
+            << "  \"storage\": \"" << config.storage << "\",\n"
+            << "  \"records\": " << config.records << ",\n"
+            << "  \"threads\": " << config.threads << ",\n"
+            << "  \"field_count\": " << config.fields << ",\n"
+            << "  \"field_length\": " << config.fieldLength << ",\n"
+            << "  \"load\": {\"seconds\": " << loadSeconds << ", \"ops_per_sec\": " << config.records / loadSeconds
+            << "},\n"
+            << "  \"warmup_seconds\": " << config.warmupSeconds << ",\n"
+            << "  \"measured_seconds\": " << seconds << ",\n"
+            << "  \"operations\": " << operations << ",\n"
+            << "  \"errors\": " << errors << ",\n"
+            << "  \"throughput_ops_per_sec\": " << throughput << ",\n"
+            << "  \"latency_ns\": {";
+        bool first = true;
+        for (int op = 0; op < OperationCount; ++op) {
+            if (totals[op].getCount()) {
+                out << (first ? "\n" : ",\n") << "    \"" << operationNames[op] << "\": " << totals[op].toJson();
+                first = false;
+            }
+        }
+        out << "\n  }\n}\n";
+    }
+    return errors == 0 ? 0 : 2;
+}
@@ -0,0 +1,262 @@
+#include "ArrowInterface.hpp"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+// Stand-in for empty buffers (the specification asks for non-null data buffers)
+alignas(64) const int64_t emptyBuffer[8] = {};
+
+// Keeps the exported result alive; shared by the struct array and its children
+struct ExportedArray {
+    std::shared_ptr<const ColumnarResult> result;
+    std::vector<const void*> buffers;
+    std::vector<ArrowArray*> children;
+    std::vector<std::unique_ptr<ArrowArray>> ownedChildren;
+};
+
+struct ExportedSchema {
+    std::string format;
+    std::string name;
+    std::vector<ArrowSchema*> children;
+    std::vector<std::unique_ptr<ArrowSchema>> ownedChildren;
+};
+
+// Children moved out by the consumer have release == nullptr and are skipped
+void releaseArray(ArrowArray* array) {
+    auto* exported = static_cast<ExportedArray*>(array->private_data);
+    for (ArrowArray* child : exported->children) {
+        if (child->release) {
+            child->release(child);
+        }
+    }
+    delete exported;
+    array->release = nullptr;
+}
+
+void releaseSchema(ArrowSchema* schema) {
+    auto* exported = static_cast<ExportedSchema*>(schema->private_data);
+    for (ArrowSchema* child : exported->children) {
+        if (child->release) {
+            child->release(child);
+        }
+    }
+    delete exported;
+    schema->release = nullptr;
+}
+
+const void* bufferOrEmpty(const void* data, size_t size) {
+    return size ? data : emptyBuffer;
+}
+
+void fillSchema(ArrowSchema* schema, ExportedSchema* exported, int64_t flags) {
+    schema->format = exported->format.c_str();
+    schema->name = exported->name.c_str();
+    schema->metadata = nullptr;
+    schema->flags = flags;
+    schema->n_children = static_cast<int64_t>(exported->children.size());
+    schema->children = exported->children.empty() ? nullptr : exported->children.data();
+    schema->dictionary = nullptr;
+    schema->release = releaseSchema;
+    schema->private_data = exported;
+}
+
+void fillArray(ArrowArray* array, ExportedArray* exported, int64_t length, int64_t nullCount) {
+    array->length = length;
+    array->null_count = nullCount;
+    array->offset = 0;
+    array->n_buffers = static_cast<int64_t>(exported->buffers.size());
+    array->n_children = static_cast<int64_t>(exported->children.size());
+    array->buffers = exported->buffers.data();
+    array->children = exported->children.empty() ? nullptr : exported->children.data();
+    array->dictionary = nullptr;
+    array->release = releaseArray;
+    array->private_data = exported;
+}
+
+bool bitSet(const void* bitmap, int64_t index) {
+    return (static_cast<const uint8_t*>(bitmap)[index / 8] >> (index % 8)) & 1;
+}
+
+// A null_count of -1 means the producer did not count: the validity bitmap decides
+bool hasNulls(const ArrowArray* array) {
+    if (array->null_count >= 0 || array->n_buffers < 1 || !array->buffers[0]) {
+        return array->null_count > 0;
+    }
+    for (int64_t i = 0; i < array->length; ++i) {
+        if (!bitSet(array->buffers[0], array->offset + i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Days since 1970-01-01 as YYYY-MM-DD (proleptic Gregorian calendar)
+std::string formatDate32(int32_t days) {
+    int64_t z = static_cast<int64_t>(days) + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t dayOfEra = z - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+    int64_t day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    int64_t month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    int64_t year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+    char text[48];
+    std::snprintf(text, sizeof(text), "%04lld-%02lld-%02lld", static_cast<long long>(year),
+                  static_cast<long long>(month), static_cast<long long>(day));
+    return text;
+}
+
+// Child formats the importer understands
+enum class ArrowKind { Int8, Int16, Int32, Int64, UInt8, UInt16, UInt32, UInt64, Float32, Float64, Bool, Date32,
+                       Utf8, LargeUtf8, Unsupported };
+
+ArrowKind parseFormat(const char* format) {
+    static const struct { const char* format; ArrowKind kind; } formats[] = {
+        {"c", ArrowKind::Int8}, {"s", ArrowKind::Int16}, {"i", ArrowKind::Int32}, {"l", ArrowKind::Int64},
+        {"C", ArrowKind::UInt8}, {"S", ArrowKind::UInt16}, {"I", ArrowKind::UInt32}, {"L", ArrowKind::UInt64},
+        {"f", ArrowKind::Float32}, {"g", ArrowKind::Float64}, {"b", ArrowKind::Bool}, {"tdD", ArrowKind::Date32},
+        {"u", ArrowKind::Utf8}, {"U", ArrowKind::LargeUtf8},
+    };
+    for (const auto& entry : formats) {
+        if (std::strcmp(format, entry.format) == 0) {
+            return entry.kind;
+        }
+    }
+    return ArrowKind::Unsupported;
+}
+
+template <typename T>
+T valueAt(const void* data, int64_t index) {
+    return static_cast<const T*>(data)[index];
+}
+
+// Value at a physical index of a child array
+std::string childValue(ArrowKind kind, const ArrowArray* array, int64_t index) {
+    const void* data = array->buffers[1];
+    switch (kind) {
+        case ArrowKind::Int8: return std::to_string(valueAt<int8_t>(data, index));
+        case ArrowKind::Int16: return std::to_string(valueAt<int16_t>(data, index));
+        case ArrowKind::Int32: return std::to_string(valueAt<int32_t>(data, index));
+        case ArrowKind::Int64: return std::to_string(valueAt<int64_t>(data, index));
+        case ArrowKind::UInt8: return std::to_string(valueAt<uint8_t>(data, index));
+        case ArrowKind::UInt16: return std::to_string(valueAt<uint16_t>(data, index));
+        case ArrowKind::UInt32: return std::to_string(valueAt<uint32_t>(data, index));
+        case ArrowKind::UInt64: return std::to_string(valueAt<uint64_t>(data, index));
+        case ArrowKind::Float32: return formatDecimal(valueAt<float>(data, index));
+        case ArrowKind::Float64: return formatDecimal(valueAt<double>(data, index));
+        case ArrowKind::Bool: return bitSet(data, index) ? "1" : "0";
+        case ArrowKind::Date32: return formatDate32(valueAt<int32_t>(data, index));
+        case ArrowKind::Utf8: {
+            int32_t begin = valueAt<int32_t>(data, index);
+            return std::string(static_cast<const char*>(array->buffers[2]) + begin,
+                               static_cast<size_t>(valueAt<int32_t>(data, index + 1) - begin));
+        }
+        case ArrowKind::LargeUtf8: {
+            int64_t begin = valueAt<int64_t>(data, index);
+            return std::string(static_cast<const char*>(array->buffers[2]) + begin,
+                               static_cast<size_t>(valueAt<int64_t>(data, index + 1) - begin));
+        }
+        case ArrowKind::Unsupported:
+            break;
+    }
+    return NULL_VALUE;
+}
+
+} // namespace
+
+void exportToArrow(ColumnarResult result, ArrowSchema* schema, ArrowArray* array) {
+    exportToArrow(std::make_shared<const ColumnarResult>(std::move(result)), schema, array);
+}
+
+void exportToArrow(std::shared_ptr<const ColumnarResult> shared, ArrowSchema* schema, ArrowArray* array) {
+    int64_t length = static_cast<int64_t>(shared->rowCount);
+
+    auto* structSchema = new ExportedSchema();
+    structSchema->format = "+s";
+    auto* structArray = new ExportedArray();
+    structArray->result = shared;
+    structArray->buffers.push_back(nullptr);  // No struct-level NULLs
+
+    for (const ResultColumn& column : shared->columns) {
+        auto* childSchema = new ExportedSchema();
+        childSchema->name = column.name;
+        auto* childArray = new ExportedArray();
+        childArray->result = shared;
+        childArray->buffers.push_back(column.nullCount ? column.validity.data() : nullptr);
+        switch (column.type) {
+            case ColumnType::Integer:
+                childSchema->format = "l";
+                childArray->buffers.push_back(bufferOrEmpty(column.integers.data(), column.integers.size()));
+                break;
+            case ColumnType::Decimal:
+                childSchema->format = "g";
+                childArray->buffers.push_back(bufferOrEmpty(column.decimals.data(), column.decimals.size()));
+                break;
+            case ColumnType::Text:
+            case ColumnType::Date:
+                childSchema->format = "U";
+                childArray->buffers.push_back(column.offsets.data());
+                childArray->buffers.push_back(bufferOrEmpty(column.data.data(), column.data.size()));
+                break;
+        }
+
+        structSchema->ownedChildren.emplace_back(new ArrowSchema());
+        fillSchema(structSchema->ownedChildren.back().get(), childSchema, ARROW_FLAG_NULLABLE);
+        structSchema->children.push_back(structSchema->ownedChildren.back().get());
+
+        structArray->ownedChildren.emplace_back(new ArrowArray());
+        fillArray(structArray->ownedChildren.back().get(), childArray, length,
+                  static_cast<int64_t>(column.nullCount));
+        structArray->children.push_back(structArray->ownedChildren.back().get());
+    }
+
+    fillSchema(schema, structSchema, 0);
+    fillArray(array, structArray, length, 0);
+}
+
+bool arrowToRows(const ArrowSchema* schema, const ArrowArray* array, std::vector<std::string>& columnNames,
+                 std::vector<Row>& rows, std::string& error) {
+    if (!schema || !array || !schema->release || !array->release) {
+        error = "Arrow schema or array is missing or released";
+        return false;
+    }
+    if (std::strcmp(schema->format, "+s") != 0 || schema->n_children != array->n_children) {
+        error = "Arrow data must be a struct array (a record batch) of columns";
+        return false;
+    }
+    if (hasNulls(array)) {
+        error = "Arrow record batch has NULL rows";
+        return false;
+    }
+
+    columnNames.clear();
+    for (int64_t c = 0; c < schema->n_children; ++c) {
+        columnNames.push_back(schema->children[c]->name ? schema->children[c]->name : "");
+    }
+
+    std::vector<ArrowKind> kinds;
+    for (int64_t c = 0; c < schema->n_children; ++c) {
+        kinds.push_back(parseFormat(schema->children[c]->format));
+        if (kinds.back() == ArrowKind::Unsupported) {
+            error = "Unsupported Arrow format '" + std::string(schema->children[c]->format) + "' for column " +
+                    columnNames[c];
+            return false;
+        }
+    }
+
+    // Column by column: one format dispatch per value, rows filled in place
+    size_t first = rows.size();
+    rows.resize(first + static_cast<size_t>(array->length), Row(columnNames.size()));
+    for (int64_t c = 0; c < schema->n_children; ++c) {
+        const ArrowArray* child = array->children[c];
+        const void* validity = child->null_count != 0 ? child->buffers[0] : nullptr;  // Also for -1 (not counted)
+        for (int64_t r = 0; r < array->length; ++r) {
+            int64_t index = child->offset + array->offset + r;
+            rows[first + r][c] = validity && !bitSet(validity, index) ? NULL_VALUE : childValue(kinds[c], child, index);
+        }
+    }
+    return true;
+}
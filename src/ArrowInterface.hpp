@@ -0,0 +1,76 @@
+#ifndef ARROWINTERFACE_HPP
+#define ARROWINTERFACE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ColumnarResult.hpp"
+
+// Apache Arrow C Data Interface structures, as defined by the specification
+// (https://arrow.apache.org/docs/format/CDataInterface.html)
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+    int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+    int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+    const char* (*get_last_error)(struct ArrowArrayStream*);
+    void (*release)(struct ArrowArrayStream*);
+    void* private_data;
+};
+
+#endif // ARROW_C_STREAM_INTERFACE
+
+// Export a result as a struct array (format "+s") with one child per column.
+// Integer -> int64 ("l"), Decimal -> float64 ("g"), Text and Date -> large
+// UTF-8 ("U"). The result is moved into the exported structures and its
+// buffers are handed out without copying; they are freed once the consumer
+// has released the schema, the array and any child it moved out.
+void exportToArrow(ColumnarResult result, ArrowSchema* schema, ArrowArray* array);
+
+// Same, sharing a result that stays alive until everything is released
+void exportToArrow(std::shared_ptr<const ColumnarResult> result, ArrowSchema* schema, ArrowArray* array);
+
+// Convert a struct array into rows of engine values (NULL as NULL_VALUE).
+// Accepts integer, floating point, boolean, (large) UTF-8 and date32
+// children. Returns false with a message for anything else. The caller
+// keeps ownership of schema and array.
+bool arrowToRows(const ArrowSchema* schema, const ArrowArray* array, std::vector<std::string>& columnNames,
+                 std::vector<Row>& rows, std::string& error);
+
+#endif // ARROWINTERFACE_HPP
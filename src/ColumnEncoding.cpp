@@ -0,0 +1,351 @@
+#include "ColumnEncoding.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+// Bits needed for unsigned values up to value
+int bitsFor(uint64_t value) {
+    return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+size_t packedBytes(size_t count, int bits) {
+    return ((count * bits + 63) / 64 + 1) * sizeof(uint64_t);
+}
+
+// Heap footprint of a string held in a vector
+size_t stringBytes(const std::string& value) {
+    return sizeof(std::string) + (value.size() > 15 ? value.size() + 1 : 0);
+}
+
+// Integer whose text is exactly what std::to_string prints for it
+bool parseCanonicalInteger(const std::string& text, int64_t& value) {
+    if (text.empty() || text.size() > 20 || (text[0] != '-' && (text[0] < '0' || text[0] > '9'))) {
+        return false;
+    }
+    errno = 0;
+    char* end = nullptr;
+    long long parsed = std::strtoll(text.c_str(), &end, 10);
+    if (errno != 0 || end != text.c_str() + text.size()) {
+        return false;
+    }
+    value = parsed;
+    return std::to_string(parsed) == text;
+}
+
+bool compareNumbers(double actual, CompareOp op, double value) {
+    switch (op) {
+        case CompareOp::Equal: return actual == value;
+        case CompareOp::NotEqual: return actual != value;
+        case CompareOp::Less: return actual < value;
+        case CompareOp::LessEqual: return actual <= value;
+        case CompareOp::Greater: return actual > value;
+        case CompareOp::GreaterEqual: return actual >= value;
+        default: return false;
+    }
+}
+
+// Keeps the positions of the selection for which matches(position) holds
+template <typename Matches>
+void keepMatching(std::vector<uint32_t>& selection, Matches matches) {
+    size_t kept = 0;
+    for (uint32_t position : selection) {
+        if (matches(position)) {
+            selection[kept++] = position;
+        }
+    }
+    selection.resize(kept);
+}
+
+} // namespace
+
+const char* encodingName(Encoding encoding) {
+    switch (encoding) {
+        case Encoding::Plain: return "plain";
+        case Encoding::Dictionary: return "dictionary";
+        case Encoding::RunLength: return "run-length";
+        case Encoding::FrameOfReference: return "frame-of-reference";
+    }
+    return "?";
+}
+
+// BitPackedArray Implementation
+BitPackedArray::BitPackedArray(const std::vector<uint64_t>& values, int valueBits)
+    : bits(valueBits), words(packedBytes(values.size(), valueBits) / sizeof(uint64_t), 0) {
+    if (bits == 0) {
+        words.clear();
+        return;
+    }
+    for (size_t position = 0; position < values.size(); ++position) {
+        size_t bit = position * bits;
+        size_t word = bit >> 6;
+        size_t shift = bit & 63;
+        words[word] |= values[position] << shift;
+        if (shift + bits > 64) {
+            words[word + 1] |= values[position] >> (64 - shift);
+        }
+    }
+}
+
+// EncodedColumn Implementation
+EncodedColumn::EncodedColumn(const std::vector<Row>& rows, int column, ColumnType columnType)
+    : type(columnType), count(rows.size()) {
+    // One pass collects what the size of each encoding depends on. A
+    // dictionary of more than half the rows is given up early.
+    const size_t dictionaryLimit = count / 2 + 1;
+    std::unordered_map<std::string, uint32_t> codes;
+    std::vector<std::string> dictionary;
+    std::vector<uint64_t> rowCodes;
+    bool dictionaryFits = count > 0;
+    size_t textBytes = 0;
+    size_t dictionaryBytes = 0;
+    size_t runBytes = 0;
+    for (size_t position = 0; position < count; ++position) {
+        const std::string& value = rows[position][column];
+        textBytes += value.size();
+        if (position == 0 || value != rows[position - 1][column]) {
+            runBytes += stringBytes(value) + sizeof(uint32_t);
+        }
+        if (!dictionaryFits) {
+            continue;
+        }
+        auto found = codes.find(value);
+        if (found == codes.end()) {
+            if (dictionary.size() == dictionaryLimit) {
+                dictionaryFits = false;
+                continue;
+            }
+            found = codes.emplace(value, static_cast<uint32_t>(dictionary.size())).first;
+            dictionary.push_back(value);
+            dictionaryBytes += stringBytes(value);
+        }
+        rowCodes.push_back(found->second);
+    }
+
+    const size_t never = std::numeric_limits<size_t>::max();
+    size_t plainSize = textBytes + (count + 1) * sizeof(uint32_t);
+    size_t dictionarySize = never;
+    if (dictionaryFits) {
+        dictionarySize = dictionaryBytes + packedBytes(count, bitsFor(dictionary.size() - 1));
+    }
+    size_t frameSize = isNumericType(type) && encodeFrameOfReference(rows, column) ? packed.getBytes() : never;
+    if (frameSize <= runBytes && frameSize <= dictionarySize && frameSize <= plainSize) {
+        encoding = Encoding::FrameOfReference;
+        return;
+    }
+    packed = BitPackedArray();
+    if (runBytes <= dictionarySize && runBytes <= plainSize) {
+        encoding = Encoding::RunLength;
+        for (size_t position = 0; position < count; ++position) {
+            const std::string& value = rows[position][column];
+            if (position == 0 || value != values.back()) {
+                values.push_back(value);
+                runEnds.push_back(static_cast<uint32_t>(position));
+            }
+            runEnds.back() = static_cast<uint32_t>(position + 1);
+        }
+    } else if (dictionarySize <= plainSize) {
+        encoding = Encoding::Dictionary;
+        values = std::move(dictionary);
+        packed = BitPackedArray(rowCodes, bitsFor(values.size() - 1));
+    } else {
+        encoding = Encoding::Plain;
+        text.reserve(textBytes);
+        offsets.reserve(count + 1);
+        for (const Row& row : rows) {
+            offsets.push_back(static_cast<uint32_t>(text.size()));
+            text += row[column];
+        }
+        offsets.push_back(static_cast<uint32_t>(text.size()));
+    }
+}
+
+// Every value a canonical integer, no NULLs: offsets from the smallest value
+bool EncodedColumn::encodeFrameOfReference(const std::vector<Row>& rows, int column) {
+    std::vector<int64_t> numbers(count);
+    for (size_t position = 0; position < count; ++position) {
+        if (!parseCanonicalInteger(rows[position][column], numbers[position])) {
+            return false;
+        }
+    }
+    if (numbers.empty()) {
+        return false;
+    }
+    auto [low, high] = std::minmax_element(numbers.begin(), numbers.end());
+    reference = *low;
+    std::vector<uint64_t> deltas(count);
+    for (size_t position = 0; position < count; ++position) {
+        deltas[position] = static_cast<uint64_t>(numbers[position]) - static_cast<uint64_t>(reference);
+    }
+    packed = BitPackedArray(deltas, bitsFor(static_cast<uint64_t>(*high) - static_cast<uint64_t>(reference)));
+    return true;
+}
+
+size_t EncodedColumn::getBytes() const {
+    size_t bytes = sizeof(*this) + text.capacity() + offsets.capacity() * sizeof(uint32_t) +
+                   runEnds.capacity() * sizeof(uint32_t) + packed.getBytes();
+    for (const std::string& value : values) {
+        bytes += stringBytes(value);
+    }
+    return bytes;
+}
+
+size_t EncodedColumn::runOf(size_t position) const {
+    return std::upper_bound(runEnds.begin(), runEnds.end(), position) - runEnds.begin();
+}
+
+std::string EncodedColumn::integerAt(size_t position) const {
+    return std::to_string(static_cast<int64_t>(static_cast<uint64_t>(reference) + packed.get(position)));
+}
+
+std::string EncodedColumn::get(size_t position) const {
+    switch (encoding) {
+        case Encoding::Plain: return text.substr(offsets[position], offsets[position + 1] - offsets[position]);
+        case Encoding::Dictionary: return values[packed.get(position)];
+        case Encoding::RunLength: return values[runOf(position)];
+        case Encoding::FrameOfReference: return integerAt(position);
+    }
+    return std::string();
+}
+
+bool EncodedColumn::patch(size_t position, const std::string& value) {
+    switch (encoding) {
+        case Encoding::Plain: {
+            size_t length = offsets[position + 1] - offsets[position];
+            if (value.size() != length) {
+                return false;
+            }
+            text.replace(offsets[position], length, value);
+            return true;
+        }
+        case Encoding::Dictionary: {
+            size_t code = std::find(values.begin(), values.end(), value) - values.begin();
+            if (code == values.size()) {
+                if (packed.getBits() < 64 && values.size() >= (1ULL << packed.getBits())) {
+                    return false;
+                }
+                values.push_back(value);
+            }
+            packed.set(position, code);
+            return true;
+        }
+        case Encoding::RunLength: {
+            size_t run = runOf(position);
+            if (values[run] == value) {
+                return true;
+            }
+            if (runEnds[run] - (run ? runEnds[run - 1] : 0) != 1) {
+                return false;
+            }
+            values[run] = value;
+            return true;
+        }
+        case Encoding::FrameOfReference: {
+            int64_t number = 0;
+            if (!parseCanonicalInteger(value, number) || number < reference) {
+                return false;
+            }
+            uint64_t delta = static_cast<uint64_t>(number) - static_cast<uint64_t>(reference);
+            if (packed.getBits() < 64 && delta >> packed.getBits() != 0) {
+                return false;
+            }
+            packed.set(position, delta);
+            return true;
+        }
+    }
+    return false;
+}
+
+void EncodedColumn::filter(const BoundCondition& condition, std::vector<uint32_t>& selection) const {
+    if (selection.empty()) {
+        return;
+    }
+    if (encoding == Encoding::Dictionary) {
+        // The condition is evaluated once per distinct value
+        std::vector<char> matching(values.size());
+        for (size_t code = 0; code < values.size(); ++code) {
+            matching[code] = condition.matchesValue(values[code]);
+        }
+        keepMatching(selection, [&](uint32_t position) { return matching[packed.get(position)]; });
+        return;
+    }
+    if (encoding == Encoding::RunLength) {
+        // Once per run
+        size_t run = runOf(selection[0]);
+        size_t evaluated = values.size();
+        bool runMatches = false;
+        keepMatching(selection, [&](uint32_t position) {
+            while (runEnds[run] <= position) {
+                ++run;
+            }
+            if (run != evaluated) {
+                evaluated = run;
+                runMatches = condition.matchesValue(values[run]);
+            }
+            return runMatches;
+        });
+        return;
+    }
+    if (encoding == Encoding::FrameOfReference && condition.op != CompareOp::In) {
+        // On the integers, with the value compared as a number like compareValues does
+        double value = 0;
+        CompareOp op = condition.op;
+        if (op == CompareOp::IsNotNull) {
+            return;
+        }
+        if (op == CompareOp::IsNull || isNull(condition.value)) {
+            selection.clear();  // No NULLs here, and comparisons with NULL are never true
+            return;
+        }
+        if (parseNumber(condition.value, value)) {
+            keepMatching(selection, [&](uint32_t position) {
+                double actual = static_cast<double>(static_cast<int64_t>(static_cast<uint64_t>(reference) +
+                                                                         packed.get(position)));
+                return compareNumbers(actual, op, value);
+            });
+            return;
+        }
+    }
+    // Decoded value by value
+    std::string value;
+    keepMatching(selection, [&](uint32_t position) {
+        if (encoding == Encoding::Plain) {
+            value.assign(text, offsets[position], offsets[position + 1] - offsets[position]);
+        } else {
+            value = get(position);
+        }
+        return condition.matchesValue(value);
+    });
+}
+
+void EncodedColumn::gather(const std::vector<uint32_t>& selection, std::vector<Row>& rows, size_t first,
+                           int column) const {
+    if (selection.empty()) {
+        return;
+    }
+    size_t run = encoding == Encoding::RunLength ? runOf(selection[0]) : 0;
+    for (size_t i = 0; i < selection.size(); ++i) {
+        uint32_t position = selection[i];
+        std::string& value = rows[first + i][column];
+        switch (encoding) {
+            case Encoding::Plain:
+                value.assign(text, offsets[position], offsets[position + 1] - offsets[position]);
+                break;
+            case Encoding::Dictionary:
+                value = values[packed.get(position)];
+                break;
+            case Encoding::RunLength:
+                while (runEnds[run] <= position) {
+                    ++run;
+                }
+                value = values[run];
+                break;
+            case Encoding::FrameOfReference:
+                value = integerAt(position);
+                break;
+        }
+    }
+}
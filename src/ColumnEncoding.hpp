@@ -0,0 +1,101 @@
+#ifndef COLUMNENCODING_HPP
+#define COLUMNENCODING_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ScanSpec.hpp"
+#include "TableSchema.hpp"
+
+// Lightweight encodings of a column of a block of rows
+enum class Encoding {
+    Plain,             // The values back to back with their offsets
+    Dictionary,        // Distinct values once, a bit-packed code per row
+    RunLength,         // One value per run of equal values
+    FrameOfReference,  // Integers as bit-packed offsets from the smallest one
+};
+
+const char* encodingName(Encoding encoding);  // e.g. "dictionary"
+
+// Unsigned integers of a fixed number of bits packed back to back into 64-bit words
+class BitPackedArray {
+public:
+    BitPackedArray() = default;
+    BitPackedArray(const std::vector<uint64_t>& values, int bits);
+
+    uint64_t get(size_t position) const {
+        if (bits == 0) {
+            return 0;
+        }
+        size_t bit = position * bits;
+        size_t word = bit >> 6;
+        size_t shift = bit & 63;
+        // The padding word keeps words[word + 1] in range
+        uint64_t value = words[word] >> shift | (shift ? words[word + 1] << (64 - shift) : 0);
+        return bits == 64 ? value : value & ((1ULL << bits) - 1);
+    }
+    // The value must fit in bits
+    void set(size_t position, uint64_t value) {
+        if (bits == 0) {
+            return;
+        }
+        size_t bit = position * bits;
+        size_t word = bit >> 6;
+        size_t shift = bit & 63;
+        uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+        words[word] = (words[word] & ~(mask << shift)) | value << shift;
+        if (shift + bits > 64) {
+            words[word + 1] = (words[word + 1] & ~(mask >> (64 - shift))) | value >> (64 - shift);
+        }
+    }
+    int getBits() const { return bits; }
+    size_t getBytes() const { return words.size() * sizeof(uint64_t); }
+
+private:
+    int bits = 0;
+    std::vector<uint64_t> words;
+};
+
+// One column of a block of rows, encoded in whichever of the encodings that
+// fit its values takes the fewest bytes. Values decode to exactly the text
+// they were stored as. Filters run on the encoded data: once per dictionary
+// entry or run, or on the integers themselves.
+class EncodedColumn {
+public:
+    EncodedColumn(const std::vector<Row>& rows, int column, ColumnType type);
+
+    Encoding getEncoding() const { return encoding; }
+    size_t size() const { return count; }
+    size_t getBytes() const;  // Approximate heap footprint
+
+    std::string get(size_t position) const;
+
+    // Replaces the value at position if the encoding can hold the new one in
+    // place: a dictionary entry (added while the codes have room), an integer
+    // within the frame, a run of one row, or plain text of the same length.
+    // False, with the column unchanged, otherwise.
+    bool patch(size_t position, const std::string& value);
+
+    // Keeps only the positions (ascending) whose value satisfies the condition
+    void filter(const BoundCondition& condition, std::vector<uint32_t>& selection) const;
+
+    // Stores the values at the selected positions (ascending) into the column of rows[first], rows[first + 1], ...
+    void gather(const std::vector<uint32_t>& selection, std::vector<Row>& rows, size_t first, int column) const;
+
+private:
+    bool encodeFrameOfReference(const std::vector<Row>& rows, int column);
+    size_t runOf(size_t position) const;
+    std::string integerAt(size_t position) const;
+
+    Encoding encoding = Encoding::Plain;
+    ColumnType type = ColumnType::Text;
+    size_t count = 0;
+    std::string text;                  // Plain: the values back to back
+    std::vector<uint32_t> offsets;     // Plain: where each value starts, plus the end
+    std::vector<std::string> values;   // Dictionary entries, or the value of each run
+    std::vector<uint32_t> runEnds;     // RunLength: position after each run
+    BitPackedArray packed;             // Dictionary codes, or frame-of-reference offsets
+    int64_t reference = 0;             // FrameOfReference: the smallest value
+};
+
+#endif // COLUMNENCODING_HPP
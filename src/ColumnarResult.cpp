@@ -0,0 +1,74 @@
+#include "ColumnarResult.hpp"
+#include <cstdlib>
+
+std::string ResultColumn::getText(size_t row) const {
+    return std::string(data.data() + offsets[row], data.data() + offsets[row + 1]);
+}
+
+int ColumnarResult::getColumnIndex(const std::string& name) const {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (equalsIgnoreCase(columns[i].name, name)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+ColumnarBuilder::ColumnarBuilder(ColumnarResult& target, const std::vector<std::string>& names,
+                                 const std::vector<ColumnType>& types)
+    : result(target) {
+    result.rowCount = 0;
+    result.columns.clear();
+    for (size_t i = 0; i < names.size(); ++i) {
+        ResultColumn column;
+        column.name = names[i];
+        column.type = i < types.size() ? types[i] : ColumnType::Text;
+        if (column.type == ColumnType::Text || column.type == ColumnType::Date) {
+            column.offsets.push_back(0);
+        }
+        result.columns.push_back(std::move(column));
+    }
+}
+
+// Values that do not parse as numbers (the engine stores what was inserted) become NULL
+void ColumnarBuilder::append(const Row& row) {
+    size_t index = result.rowCount++;
+    if (index % 8 == 0) {
+        for (ResultColumn& column : result.columns) {
+            column.validity.push_back(0);
+        }
+    }
+    for (size_t i = 0; i < result.columns.size(); ++i) {
+        ResultColumn& column = result.columns[i];
+        const std::string& value = row[i];
+        bool valid = !isNull(value);
+        switch (column.type) {
+            case ColumnType::Integer: {
+                char* end = nullptr;
+                long long parsed = valid ? std::strtoll(value.c_str(), &end, 10) : 0;
+                valid = valid && end != value.c_str() && *end == '\0';
+                column.integers.push_back(valid ? parsed : 0);
+                break;
+            }
+            case ColumnType::Decimal: {
+                char* end = nullptr;
+                double parsed = valid ? std::strtod(value.c_str(), &end) : 0.0;
+                valid = valid && end != value.c_str() && *end == '\0';
+                column.decimals.push_back(valid ? parsed : 0.0);
+                break;
+            }
+            case ColumnType::Text:
+            case ColumnType::Date:
+                if (valid) {
+                    column.data.insert(column.data.end(), value.begin(), value.end());
+                }
+                column.offsets.push_back(static_cast<int64_t>(column.data.size()));
+                break;
+        }
+        if (valid) {
+            column.validity.back() |= static_cast<uint8_t>(1u << (index % 8));
+        } else {
+            ++column.nullCount;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef COLUMNARRESULT_HPP
+#define COLUMNARRESULT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TableSchema.hpp"
+
+// One result column in contiguous buffers laid out as in Apache Arrow:
+// Integer -> int64 values, Decimal -> float64 values, Text and Date -> UTF-8
+// bytes with int64 offsets (value i is data[offsets[i], offsets[i + 1])).
+// NULL values have a cleared validity bit and a zero / empty value.
+struct ResultColumn {
+    std::string name;
+    ColumnType type = ColumnType::Text;
+    size_t nullCount = 0;
+    std::vector<uint8_t> validity;   // Bit i (LSB first) set: row i is not NULL
+    std::vector<int64_t> integers;   // Integer columns
+    std::vector<double> decimals;    // Decimal columns
+    std::vector<int64_t> offsets;    // Text and Date columns: row count + 1 entries
+    std::vector<char> data;          // Text and Date columns: concatenated values
+
+    bool isValid(size_t row) const { return (validity[row / 8] >> (row % 8)) & 1; }
+    std::string getText(size_t row) const;
+};
+
+// ColumnarResult: a query result stored column by column, so callers (the
+// Python bindings, Arrow export) can hand the buffers out without touching
+// individual values
+struct ColumnarResult {
+    bool success = true;
+    std::string message;      // Error description when !success
+    size_t rowCount = 0;
+    size_t affectedRows = 0;  // Rows inserted or updated
+    std::vector<ResultColumn> columns;
+
+    // Column position by name (case-insensitive), -1 if missing
+    int getColumnIndex(const std::string& name) const;
+};
+
+// Appends rows to the columns of a ColumnarResult
+class ColumnarBuilder {
+public:
+    ColumnarBuilder(ColumnarResult& target, const std::vector<std::string>& names,
+                    const std::vector<ColumnType>& types);
+
+    void append(const Row& row);
+
+private:
+    ColumnarResult& result;
+};
+
+#endif // COLUMNARRESULT_HPP
@@ -0,0 +1,236 @@
+#include "CommitLog.hpp"
+#include "Logger.hpp"
+#include "Metrics.hpp"
+#include "Trace.hpp"
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Force written data to stable storage
+static void syncFile(std::FILE* file) {
+    std::fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+// Backslash, newline and carriage return escaped, so a record is exactly one line
+static void appendEscaped(std::string& line, const std::string& change) {
+    for (char c : change) {
+        switch (c) {
+            case '\\': line += "\\\\"; break;
+            case '\n': line += "\\n"; break;
+            case '\r': line += "\\r"; break;
+            default: line += c; break;
+        }
+    }
+}
+
+// LSN of the last complete record of an existing log, 0 if there is none. The
+// file is read backwards from its end, so reopening a long log does not scan it.
+// torn: the log ends in a partly written line.
+static uint64_t lastLsn(const std::string& path, bool& torn) {
+    torn = false;
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) {
+        return 0;
+    }
+    const long chunk = 4096;
+    long end = std::fseek(in, 0, SEEK_END) == 0 ? std::ftell(in) : 0;
+    std::string tail;
+    uint64_t lsn = 0;
+    while (end > 0) {
+        long start = end > chunk ? end - chunk : 0;
+        std::string block(static_cast<size_t>(end - start), '\0');
+        std::fseek(in, start, SEEK_SET);
+        block.resize(std::fread(&block[0], 1, block.size(), in));
+        tail.insert(0, block);
+        torn = torn || (tail.size() == block.size() && tail.back() != '\n');
+        end = start;
+
+        // The last line ending in a newline; a torn one after it is skipped
+        size_t lineEnd = tail.rfind('\n');
+        if (lineEnd == std::string::npos) {
+            continue;
+        }
+        size_t lineStart = lineEnd == 0 ? std::string::npos : tail.rfind('\n', lineEnd - 1);
+        if (lineStart != std::string::npos || end == 0) {
+            lsn = std::strtoull(tail.c_str() + (lineStart == std::string::npos ? 0 : lineStart + 1), nullptr, 10);
+            break;
+        }
+    }
+    std::fclose(in);
+    return lsn;
+}
+
+// Constructor: opens (or creates) the log for appending and starts the writer
+CommitLog::CommitLog(const std::string& path)
+    : logPath(path), file(std::fopen(path.c_str(), "ab")), nextLsn(1), durableLsn(0), syncWaiters(0),
+      synchronousCommit(true), flushInterval(10), stopping(false), commitCount(0), syncCount(0) {
+    if (!file) {
+        LOG_ERROR("Unable to open commit log: " << logPath);
+    }
+    bool torn = false;
+    durableLsn = lastLsn(logPath, torn);
+    nextLsn = durableLsn + 1;
+    if (file && torn) {
+        std::fputc('\n', file);  // The next record starts on a line of its own
+    }
+    writer = std::thread(&CommitLog::writerLoop, this);
+}
+
+// Destructor: the writer drains the queue before it exits
+CommitLog::~CommitLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    writer.join();
+
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+std::future<void> CommitLog::append(const std::vector<std::string>& changes) {
+    TRACE_SPAN("wal", "append");
+    Request request;
+    request.changes = changes;
+    request.enqueued = std::chrono::steady_clock::now();
+    std::future<void> acknowledged = request.durable.get_future();
+
+    {
+        std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+        lockCounted(lock);
+        request.lsn = nextLsn++;
+        request.waitForSync = synchronousCommit;
+        if (request.waitForSync) {
+            ++syncWaiters;
+        } else {
+            request.durable.set_value();  // Acknowledge before fsync
+        }
+        pending.push_back(std::move(request));
+    }
+    ++commitCount;
+    workAvailable.notify_one();
+    return acknowledged;
+}
+
+void CommitLog::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    uint64_t target = nextLsn - 1;
+    if (durableLsn >= target) {
+        return;
+    }
+
+    // Cut the writer's linger short. Only while commits are queued: the writer
+    // resets the count when it takes them, and an in-flight batch needs no hurry.
+    if (!pending.empty()) {
+        ++syncWaiters;
+        workAvailable.notify_one();
+    }
+    durableAdvanced.wait(lock, [&]() { return durableLsn >= target; });
+}
+
+void CommitLog::setSynchronousCommit(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex);
+    synchronousCommit = enabled;
+}
+
+bool CommitLog::isSynchronousCommit() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return synchronousCommit;
+}
+
+void CommitLog::setFlushInterval(std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        flushInterval = interval;
+    }
+    workAvailable.notify_one();
+}
+
+bool CommitLog::isOpen() const {
+    return file != nullptr;
+}
+
+uint64_t CommitLog::getCommitCount() const {
+    return commitCount.load();
+}
+
+uint64_t CommitLog::getSyncCount() const {
+    return syncCount.load();
+}
+
+// Background writer: one write + fsync per group of queued commits
+void CommitLog::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        workAvailable.wait(lock, [&]() { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            break;  // Stopping and fully drained
+        }
+
+        // Only asynchronous commits queued: linger so more of them share the fsync,
+        // but never past the flush interval of the oldest one
+        if (syncWaiters == 0 && !stopping) {
+            auto deadline = pending.front().enqueued + flushInterval;
+            workAvailable.wait_until(lock, deadline, [&]() { return stopping || syncWaiters > 0; });
+        }
+
+        std::deque<Request> batch;
+        batch.swap(pending);
+        syncWaiters = 0;
+
+        lock.unlock();
+        writeBatch(batch);
+        lock.lock();
+
+        durableLsn = batch.back().lsn;
+        for (auto& request : batch) {
+            if (request.waitForSync) {
+                request.durable.set_value();
+            }
+        }
+        durableAdvanced.notify_all();
+    }
+}
+
+// Record format: one "<lsn>\t<change>" line per change (backslash, newline and
+// carriage return escaped as \\, \n and \r), then "<lsn>\tCOMMIT"
+void CommitLog::writeBatch(std::deque<Request>& batch) {
+    if (!file) {
+        return;
+    }
+    TRACE_SPAN("wal", "write batch");
+
+    std::string records;
+    for (const auto& request : batch) {
+        std::string lsn = std::to_string(request.lsn) + "\t";
+        for (const auto& change : request.changes) {
+            records += lsn;
+            appendEscaped(records, change);
+            records += '\n';
+        }
+        records += lsn + "COMMIT\n";
+    }
+    uint64_t bytes = std::fwrite(records.data(), 1, records.size(), file);
+    {
+        ScopedLatency fsyncLatency(Histogram::FsyncLatency);
+        TRACE_SPAN("wal", "fsync");
+        syncFile(file);
+    }
+    ++syncCount;
+
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    metrics.add(Counter::WalRecords, batch.size());
+    metrics.add(Counter::WalBytes, bytes);
+    metrics.add(Counter::WalFsyncs);
+}
@@ -0,0 +1,86 @@
+#ifndef COMMITLOG_HPP
+#define COMMITLOG_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+
+// CommitLog: record of committed transactions, with group commit.
+// A transaction is appended after its changes were applied to storage, with
+// only the changes that took effect; nothing reads the log back yet. LSNs
+// continue from the last record when an existing log is reopened.
+//
+// Committing sessions hand their changes to append(); a background writer
+// thread writes everything queued so far and makes it durable with a single
+// fsync, so concurrent commits share the cost of one flush.
+//
+// With synchronous commit on (the default) the returned future becomes ready
+// once the commit is durable. With synchronous commit off it is ready
+// immediately and the writer flushes at least every flush interval, which
+// bounds how much acknowledged work a crash can lose.
+class CommitLog {
+public:
+    explicit CommitLog(const std::string& path);
+    ~CommitLog();  // Flushes everything still queued
+
+    CommitLog(const CommitLog&) = delete;
+    CommitLog& operator=(const CommitLog&) = delete;
+
+    // Queue one transaction's changes; returns a future for its acknowledgement
+    std::future<void> append(const std::vector<std::string>& changes);
+
+    // Block until everything appended so far is durable
+    void flush();
+
+    // synchronous_commit=on/off
+    void setSynchronousCommit(bool enabled);
+    bool isSynchronousCommit() const;
+
+    // Upper bound on how long an asynchronous commit stays unflushed
+    void setFlushInterval(std::chrono::milliseconds interval);
+
+    bool isOpen() const;
+    uint64_t getCommitCount() const;  // Transactions appended
+    uint64_t getSyncCount() const;    // fsync calls issued
+
+private:
+    struct Request {
+        uint64_t lsn;
+        std::vector<std::string> changes;
+        std::promise<void> durable;
+        bool waitForSync;
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    void writerLoop();
+    void writeBatch(std::deque<Request>& batch);
+
+    std::string logPath;
+    std::FILE* file;
+
+    mutable std::mutex mutex;                   // Guards everything below
+    std::condition_variable workAvailable;
+    std::condition_variable durableAdvanced;
+    std::deque<Request> pending;
+    uint64_t nextLsn;
+    uint64_t durableLsn;
+    int syncWaiters;                            // Queued commits/flushes blocked on fsync
+    bool synchronousCommit;
+    std::chrono::milliseconds flushInterval;
+    bool stopping;
+
+    std::atomic<uint64_t> commitCount;
+    std::atomic<uint64_t> syncCount;
+
+    std::thread writer;  // Started last, after every member above is ready
+};
+
+#endif // COMMITLOG_HPP
@@ -0,0 +1,26 @@
+#include "CycleClock.hpp"
+#include <thread>
+
+// Count ticks over a short steady_clock interval
+static double calibrate() {
+#ifdef DB_HAVE_RDTSC
+    auto start = std::chrono::steady_clock::now();
+    uint64_t startTicks = CycleClock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    auto end = std::chrono::steady_clock::now();
+    uint64_t endTicks = CycleClock::now();
+    double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    return nanoseconds > 0 && endTicks > startTicks ? (endTicks - startTicks) / nanoseconds : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+double CycleClock::ticksPerNanosecond() {
+    static const double rate = calibrate();
+    return rate;
+}
+
+double CycleClock::toNanoseconds(uint64_t ticks) {
+    return ticks / ticksPerNanosecond();
+}
@@ -0,0 +1,34 @@
+#ifndef CYCLECLOCK_HPP
+#define CYCLECLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define DB_HAVE_RDTSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define DB_HAVE_RDTSC 1
+#endif
+
+// CycleClock: cheap timestamps for timing individual operator calls.
+// Reads the CPU time-stamp counter where available (a few nanoseconds per
+// read, invariant on current x86 CPUs); elsewhere falls back to
+// steady_clock. Ticks are converted with a rate calibrated once per process.
+class CycleClock {
+public:
+    static uint64_t now() {
+#ifdef DB_HAVE_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    static double ticksPerNanosecond();  // Calibrated on first use (about 1 ms)
+    static double toNanoseconds(uint64_t ticks);
+};
+
+#endif // CYCLECLOCK_HPP
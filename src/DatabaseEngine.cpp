@@ -1,108 +1,302 @@
 #include "DatabaseEngine.hpp"
-#include <iostream>
+#include "Logger.hpp"
 #include <sqlite3.h>
 
 // Constructor
 DatabaseEngine::DatabaseEngine() 
-    : storageEngine(nullptr), queryProcessor(new QueryProcessor()), transactionManager(new TransactionManager()), initialized(false) {
+    : storageEngine(nullptr), nextSessionId(1), workMemory(0), initialized(false) {
 }
 
-// Destructor
+// Destructor (the default session must go before the storage it points to)
 DatabaseEngine::~DatabaseEngine() {
+    defaultSession.reset();
+    commitLog.reset();  // Flushes outstanding commits
     delete storageEngine;
-    delete queryProcessor;
-    delete transactionManager;
 }
 
 // Initialize Database Engine (opens SQLite DB if path is provided)
 void DatabaseEngine::initializeDatabase(const std::string& dbPath) {
+    std::lock_guard<std::mutex> lock(setupMutex);
+
     // Only initialize once
     if (initialized) {
-        std::cerr << "Database is already initialized!" << std::endl;
+        LOG_WARN("Database is already initialized!");
         return;
     }
 
     sqlite3* db;
     int rc = sqlite3_open(dbPath.c_str(), &db); // Creates the DB if it doesn't exist
     if (rc) {
-        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        LOG_ERROR("Can't open database: " << sqlite3_errmsg(db));
         return;
     } else {
-        std::cout << "Opened database successfully!" << std::endl;
+        LOG_INFO("Opened database successfully!");
     }
     sqlite3_close(db);
+
+    // Commits are logged next to the database file (nothing to make durable for in-memory databases).
+    // A default session set up before the log exists is pointed at it.
+    if (!dbPath.empty() && dbPath != ":memory:") {
+        commitLog = std::make_unique<CommitLog>(dbPath + "-wal");
+        std::lock_guard<std::mutex> sessionLock(defaultSessionMutex);
+        if (defaultSession) {
+            defaultSession->setCommitLog(commitLog.get());
+        }
+    }
     initialized = true;
 }
 
-// Create a table in the database (simulated for now)
+// Create a table in the database (the definition is parsed into a schema)
 void DatabaseEngine::createTable(const std::string& tableDefinition) {
     if (!initialized) {
-        std::cerr << "Database not initialized!" << std::endl;
+        LOG_ERROR("Database not initialized!");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (!defaultSession) {
+        LOG_ERROR("Storage engine not set!");
         return;
     }
 
-    std::cout << "Creating table with definition: " << tableDefinition << std::endl;
-    tables["table_name"] = tableDefinition;  // Simulate table creation
+    LOG_INFO("Creating table with definition: " << tableDefinition);
+    defaultSession->executeQuery(tableDefinition);
+}
+
+bool DatabaseEngine::hasTable(const std::string& tableName) const {
+    return storageEngine && storageEngine->hasTable(tableName);
+}
+
+std::string DatabaseEngine::getTableDefinition(const std::string& tableName) const {
+    std::shared_ptr<const TableSchema> schema = storageEngine ? storageEngine->getSchema(tableName) : nullptr;
+    return schema ? schema->definition : std::string();
 }
 
 // Insert data into the database (simulated storage)
 void DatabaseEngine::insertData(const std::string& insertStatement) {
     if (!initialized) {
-        std::cerr << "Database not initialized!" << std::endl;
+        LOG_ERROR("Database not initialized!");
         return;
     }
 
-    std::cout << "Inserting data: " << insertStatement << std::endl;
-    storageEngine->storeData(insertStatement);
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (!defaultSession) {
+        LOG_ERROR("Storage engine not set!");
+        return;
+    }
+
+    defaultSession->insertData(insertStatement);
 }
 
-// Execute a query (delegates to QueryProcessor)
+// Execute a query (delegates to the default session)
 void DatabaseEngine::executeQuery(const std::string& query) {
     if (!initialized) {
-        std::cerr << "Database not initialized!" << std::endl;
+        LOG_ERROR("Database not initialized!");
         return;
     }
 
-    std::cout << "Executing query: " << query << std::endl;
-    queryProcessor->executeQuery(query);
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (!defaultSession) {
+        LOG_ERROR("Storage engine not set!");
+        return;
+    }
+
+    LOG_DEBUG("Executing query: " << query);
+    QueryResult result = defaultSession->executeQuery(query);
+    for (const Row& row : result.rows) {
+        std::string line;
+        for (size_t i = 0; i < row.size(); ++i) {
+            line += (i ? ", " : "") + (isNull(row[i]) ? std::string("NULL") : row[i]);
+        }
+        LOG_INFO("Result: " << line);
+    }
 }
 
-// Start a transaction (delegates to TransactionManager)
+// Start a transaction (delegates to the default session)
 void DatabaseEngine::startTransaction() {
     if (!initialized) {
-        std::cerr << "Database not initialized!" << std::endl;
+        LOG_ERROR("Database not initialized!");
         return;
     }
 
-    std::cout << "Starting transaction." << std::endl;
-    transactionManager->setState(new ActiveState());
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (!defaultSession) {
+        LOG_ERROR("Storage engine not set!");
+        return;
+    }
+
+    defaultSession->startTransaction();
 }
 
-// Commit the transaction (delegates to TransactionManager)
+// Commit the transaction (delegates to the default session)
 void DatabaseEngine::commitTransaction() {
     if (!initialized) {
-        std::cerr << "Database not initialized!" << std::endl;
+        LOG_ERROR("Database not initialized!");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (!defaultSession) {
+        LOG_ERROR("Storage engine not set!");
+        return;
+    }
+
+    defaultSession->commitTransaction();
+}
+
+// Commit without waiting for durability (delegates to the default session)
+std::future<void> DatabaseEngine::commitAsync() {
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (!initialized || !defaultSession) {
+        const char* message = !initialized ? "Database not initialized!" : "Storage engine not set!";
+        LOG_ERROR(message);
+        std::promise<void> done;
+        done.set_value();
+        return done.get_future();
+    }
+
+    return defaultSession->commitAsync();
+}
+
+void DatabaseEngine::setSynchronousCommit(bool enabled, int flushIntervalMs) {
+    if (!initialized) {
+        LOG_ERROR("Database not initialized!");
         return;
     }
 
-    std::cout << "Committing transaction." << std::endl;
-    transactionManager->setState(new CommittedState());
-    transactionManager->handleTransaction();
+    if (!commitLog) {
+        return;  // In-memory database: commits are never fsynced anyway
+    }
+    commitLog->setSynchronousCommit(enabled);
+    commitLog->setFlushInterval(std::chrono::milliseconds(flushIntervalMs));
 }
 
-// Rollback the transaction (delegates to TransactionManager)
+// Rollback the transaction (delegates to the default session)
 void DatabaseEngine::rollbackTransaction() {
     if (!initialized) {
-        std::cerr << "Database not initialized!" << std::endl;
+        LOG_ERROR("Database not initialized!");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (!defaultSession) {
+        LOG_ERROR("Storage engine not set!");
         return;
     }
 
-    std::cout << "Rolling back transaction." << std::endl;
-    transactionManager->setState(new AbortedState());
-    transactionManager->handleTransaction();
+    defaultSession->rollbackTransaction();
+}
+
+// Open a new session; sessions share storage but not transaction state.
+// Only after initialization, so that the session gets the commit log.
+std::unique_ptr<Session> DatabaseEngine::openSession() {
+    std::lock_guard<std::mutex> lock(setupMutex);
+    if (!initialized) {
+        LOG_ERROR("Database not initialized!");
+        return nullptr;
+    }
+    if (!storageEngine) {
+        LOG_ERROR("Storage engine not set!");
+        return nullptr;
+    }
+
+    auto session = std::make_unique<Session>(nextSessionId++, storageEngine, commitLog.get(), &queryStats);
+    if (workMemory) {
+        session->setWorkMemory(workMemory);
+    }
+    return session;
+}
+
+void DatabaseEngine::setWorkMemory(size_t bytes) {
+    workMemory = bytes;
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (defaultSession) {
+        defaultSession->setWorkMemory(bytes);
+    }
 }
 
 // Set the storage engine type (memory, file, etc.)
+// Sessions keep a pointer to the storage engine, so it can only be set once.
 void DatabaseEngine::setStorageEngine(const std::string& storageType) {
+    std::lock_guard<std::mutex> lock(setupMutex);
+    if (storageEngine) {
+        LOG_WARN("Storage engine is already set!");
+        return;
+    }
+
     storageEngine = new StorageEngine(storageType);
+    auto session = std::make_unique<Session>(0, storageEngine, commitLog.get(), &queryStats);
+    if (workMemory) {
+        session->setWorkMemory(workMemory);
+    }
+    std::lock_guard<std::mutex> sessionLock(defaultSessionMutex);
+    defaultSession = std::move(session);
+}
+
+StorageEngine* DatabaseEngine::getStorageEngine() const {
+    return storageEngine;
+}
+
+// Execute a query and return its result by column (delegates to the default session)
+ColumnarResult DatabaseEngine::executeColumnar(const std::string& query) {
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (!initialized || !defaultSession) {
+        ColumnarResult result;
+        result.success = false;
+        result.message = !initialized ? "Database not initialized!" : "Storage engine not set!";
+        LOG_ERROR(result.message);
+        return result;
+    }
+
+    return defaultSession->executeColumnar(query);
+}
+
+// Bulk insert of an Arrow record batch (delegates to the default session)
+QueryResult DatabaseEngine::insertArrow(const std::string& table, ArrowSchema* schema, ArrowArray* array) {
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (!initialized || !defaultSession) {
+        if (array && array->release) {
+            array->release(array);
+        }
+        if (schema && schema->release) {
+            schema->release(schema);
+        }
+        QueryResult result;
+        result.success = false;
+        result.message = !initialized ? "Database not initialized!" : "Storage engine not set!";
+        LOG_ERROR(result.message);
+        return result;
+    }
+
+    return defaultSession->insertArrow(table, schema, array);
+}
+
+QueryResult DatabaseEngine::insertRows(const std::string& table, const std::vector<std::string>& columns,
+                                       std::vector<Row> rows) {
+    std::lock_guard<std::mutex> lock(defaultSessionMutex);
+    if (!initialized || !defaultSession) {
+        QueryResult result;
+        result.success = false;
+        result.message = !initialized ? "Database not initialized!" : "Storage engine not set!";
+        LOG_ERROR(result.message);
+        return result;
+    }
+
+    return defaultSession->insertRows(table, columns, std::move(rows));
+}
+
+MetricsSnapshot DatabaseEngine::metrics() const {
+    return MetricsRegistry::getInstance().snapshot();
+}
+
+std::vector<QueryStatsEntry> DatabaseEngine::queryStatistics() const {
+    return queryStats.snapshot();
+}
+
+void DatabaseEngine::resetQueryStatistics() {
+    queryStats.reset();
+}
+
+void DatabaseEngine::setSlowQueryLog(const std::string& path, double thresholdMs) {
+    queryStats.setSlowQueryLog(path, thresholdMs);
 }
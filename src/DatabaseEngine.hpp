@@ -2,45 +2,87 @@
 #define DATABASEENGINE_HPP
 
 #include <string>
-#include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <atomic>
 #include "StorageEngine.hpp"
-#include "QueryProcessor.hpp"
-#include "TransactionManager.hpp"
+#include "Session.hpp"
+#include "CommitLog.hpp"
+#include "Metrics.hpp"
+#include "QueryStats.hpp"
 
 class DatabaseEngine {
 public:
     // Constructor
     DatabaseEngine();
 
-    // Methods for initializing, table creation, inserting data, and querying
+    DatabaseEngine(const DatabaseEngine&) = delete;
+    DatabaseEngine& operator=(const DatabaseEngine&) = delete;
+
+    // Methods for initializing, table creation, inserting data, and querying.
+    // They share one default session; calls from several threads are serialized.
     void initializeDatabase(const std::string& dbPath = "");
     void createTable(const std::string& tableDefinition);
     void insertData(const std::string& insertStatement);
     void executeQuery(const std::string& query);
+    ColumnarResult executeColumnar(const std::string& query);  // Result rows stored by column
+    QueryResult insertArrow(const std::string& table, ArrowSchema* schema, ArrowArray* array);  // Takes ownership
+    QueryResult insertRows(const std::string& table, const std::vector<std::string>& columns, std::vector<Row> rows);
 
-    // Transaction management
+    // Transaction management (on the engine's default session)
     void startTransaction();
     void commitTransaction();
+    std::future<void> commitAsync();  // Ready once the commit is durable
     void rollbackTransaction();
 
+    // synchronous_commit=off acknowledges commits before fsync; at most
+    // flushIntervalMs of acknowledged commits can be lost on a crash
+    void setSynchronousCommit(bool enabled, int flushIntervalMs = 10);
+
+    // Open a new session with its own transaction context (one per thread);
+    // null until the database is initialized and the storage engine set
+    std::unique_ptr<Session> openSession();
+
+    // Memory one query operator may use before spilling to temporary files
+    // (default session and sessions opened afterwards)
+    void setWorkMemory(size_t bytes);
+
+    // Catalog lookup (tables live in the storage engine's catalog)
+    bool hasTable(const std::string& tableName) const;
+    std::string getTableDefinition(const std::string& tableName) const;
+
     // Storage Engine Setup
     void setStorageEngine(const std::string& storageType);
+    StorageEngine* getStorageEngine() const;  // Shared storage (null until set up)
+
+    // Engine counters and latency histograms, summed over all threads
+    MetricsSnapshot metrics() const;
+
+    // Per-fingerprint statement statistics of all sessions, most total time first
+    std::vector<QueryStatsEntry> queryStatistics() const;
+    void resetQueryStatistics();
+
+    // Append statements taking at least thresholdMs to a slow-query log (empty path turns it off)
+    void setSlowQueryLog(const std::string& path, double thresholdMs);
 
     // Destructor
     ~DatabaseEngine();
 
 private:
     // Components of the database engine
-    StorageEngine* storageEngine;
-    QueryProcessor* queryProcessor;
-    TransactionManager* transactionManager;
+    StorageEngine* storageEngine;           // Shared by all sessions
+    std::unique_ptr<CommitLog> commitLog;   // Group-commit log, shared by all sessions
+    QueryStats queryStats;                  // Statement statistics, fed by all sessions
+    std::unique_ptr<Session> defaultSession;  // Backs the API above (one shared transaction context)
+
+    std::mutex setupMutex;  // Serializes initialization and storage setup
+    std::mutex defaultSessionMutex;  // Guards defaultSession and serializes calls on it (e.g. from Python threads)
 
-    // Table storage (for simulation purposes)
-    std::unordered_map<std::string, std::string> tables;
+    std::atomic<int> nextSessionId;
+    std::atomic<size_t> workMemory;  // 0: the QueryProcessor default
 
     // Flag to ensure database is initialized
-    bool initialized;
+    std::atomic<bool> initialized;
 };
 
-#endif // DATABASEENGINE_HPP
\ No newline at end of file
+#endif // DATABASEENGINE_HPP
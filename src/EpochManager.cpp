@@ -0,0 +1,149 @@
+#include "EpochManager.hpp"
+
+namespace {
+
+// Retired objects a thread collects before it tries to reclaim
+const size_t reclaimThreshold = 64;
+
+} // namespace
+
+// Constructor
+EpochManager::EpochManager() : globalEpoch(1), records(&EpochManager::releaseThread), pendingCount(0) {}
+
+// Destructor: runs after all thread-local records are released. The records
+// themselves stay allocated like every ThreadBlockList's blocks.
+EpochManager::~EpochManager() {
+    for (const auto& retired : orphans) {
+        retired.deleter(retired.object);
+    }
+}
+
+EpochManager& EpochManager::getInstance() {
+    static EpochManager instance;
+    return instance;
+}
+
+// Runs as a thread exits, before its record is released: the thread's
+// unreclaimed objects become orphans
+void EpochManager::releaseThread(ThreadRecord& record) {
+    record.localEpoch.store(0, std::memory_order_release);
+    record.depth = 0;
+
+    EpochManager& manager = getInstance();
+    std::lock_guard<std::mutex> lock(manager.orphanMutex);
+    manager.orphans.insert(manager.orphans.end(), record.retired.begin(), record.retired.end());
+    record.retired.clear();
+}
+
+void EpochManager::enter() {
+    ThreadRecord& record = records.local();
+    if (record.depth++ > 0) {
+        return;  // Already pinned by an outer critical section
+    }
+
+    uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+    record.localEpoch.store((epoch << 1) | 1, std::memory_order_relaxed);
+    // Publish the pin before any shared pointer is read
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void EpochManager::exit() {
+    ThreadRecord& record = records.local();
+    if (--record.depth > 0) {
+        return;
+    }
+
+    record.localEpoch.store(0, std::memory_order_release);
+    if (record.retired.size() >= reclaimThreshold) {
+        tryReclaim();
+    }
+}
+
+// A record of its own, published as active in the current epoch
+EpochManager::ThreadRecord* EpochManager::pin() {
+    ThreadRecord* record = records.acquire();
+    uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+    record->localEpoch.store((epoch << 1) | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return record;
+}
+
+void EpochManager::unpin(ThreadRecord* pin) {
+    pin->localEpoch.store(0, std::memory_order_release);
+    records.release(pin);
+}
+
+bool EpochManager::inCriticalSection() const {
+    const ThreadRecord* record = records.current();
+    return record && record->depth > 0;
+}
+
+void EpochManager::retire(void* object, void (*deleter)(void*)) {
+    std::vector<RetiredObject>& retired = records.local().retired;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    retired.push_back({object, deleter, globalEpoch.load(std::memory_order_acquire)});
+    pendingCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (retired.size() >= reclaimThreshold) {
+        tryReclaim();
+    }
+}
+
+// The epoch may only move forward once every pinned thread has observed it
+bool EpochManager::tryAdvance() {
+    uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    for (ThreadRecord* record = records.head(); record; record = record->next) {
+        if (!record->inUse.load(std::memory_order_acquire)) {
+            continue;
+        }
+        uint64_t local = record->localEpoch.load(std::memory_order_acquire);
+        if ((local & 1) && (local >> 1) != epoch) {
+            return false;  // A reader is still in an older epoch
+        }
+    }
+
+    return globalEpoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+}
+
+// Free objects retired at least two epochs ago
+size_t EpochManager::reclaimList(std::vector<RetiredObject>& retired, uint64_t safeEpoch) {
+    std::vector<RetiredObject> ready;
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); ++i) {
+        if (retired[i].epoch + 2 <= safeEpoch) {
+            ready.push_back(retired[i]);
+        } else {
+            retired[kept++] = retired[i];
+        }
+    }
+    retired.resize(kept);
+
+    // Deleters run last: they may retire further objects themselves
+    for (const auto& object : ready) {
+        object.deleter(object.object);
+    }
+    pendingCount.fetch_sub(ready.size(), std::memory_order_relaxed);
+    return ready.size();
+}
+
+void EpochManager::tryReclaim() {
+    tryAdvance();
+    uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+
+    reclaimList(records.local().retired, epoch);
+
+    std::unique_lock<std::mutex> lock(orphanMutex, std::try_to_lock);
+    if (lock.owns_lock() && !orphans.empty()) {
+        reclaimList(orphans, epoch);
+    }
+}
+
+uint64_t EpochManager::getGlobalEpoch() const {
+    return globalEpoch.load(std::memory_order_acquire);
+}
+
+size_t EpochManager::getPendingCount() const {
+    return pendingCount.load(std::memory_order_relaxed);
+}
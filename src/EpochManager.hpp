@@ -0,0 +1,92 @@
+#ifndef EPOCHMANAGER_HPP
+#define EPOCHMANAGER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "ThreadBlocks.hpp"
+
+// EpochManager: epoch-based memory reclamation (EBR).
+//
+// Readers of shared structures (index nodes, catalog snapshots, transaction
+// states) wrap their accesses in an EpochGuard instead of taking a lock.
+// Writers unlink an object and hand it to retire(); it is freed only once the
+// global epoch has advanced twice, i.e. once every thread that could still
+// hold a reference has left its critical section.
+class EpochManager {
+public:
+    // Process-wide instance shared by every lock-free structure
+    static EpochManager& getInstance();
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    // Enter/exit a read-side critical section for the calling thread (nestable)
+    void enter();
+    void exit();
+    bool inCriticalSection() const;
+
+    // Defer freeing of an unlinked object until no reader can reach it
+    void retire(void* object, void (*deleter)(void*));
+
+    template <typename T>
+    void retire(T* object) {
+        retire(static_cast<void*>(object), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    // Try to advance the global epoch and free everything that became safe
+    void tryReclaim();
+
+    uint64_t getGlobalEpoch() const;
+    size_t getPendingCount() const;  // Retired objects not yet freed (approximate)
+
+    struct RetiredObject {
+        void* object;
+        void (*deleter)(void*);
+        uint64_t epoch;  // Global epoch at retire time
+    };
+
+    // Per-thread (or per-pin) bookkeeping. Only the owner touches depth and
+    // retired; a pin leaves them unused.
+    struct ThreadRecord {
+        alignas(64) std::atomic<uint64_t> localEpoch{0};  // (epoch << 1) | active bit
+        std::atomic<bool> inUse{false};
+        ThreadRecord* next = nullptr;
+        int depth = 0;                       // Critical section nesting
+        std::vector<RetiredObject> retired;  // Retired by the owning thread, not yet freed
+    };
+
+    // A pin owned by something other than a thread (a transaction): it holds
+    // back reclamation like a critical section, and any thread may release it
+    ThreadRecord* pin();
+    void unpin(ThreadRecord* pin);
+
+private:
+    EpochManager();
+    ~EpochManager();
+
+    static void releaseThread(ThreadRecord& record);
+    bool tryAdvance();
+    size_t reclaimList(std::vector<RetiredObject>& retired, uint64_t safeEpoch);
+
+    alignas(64) std::atomic<uint64_t> globalEpoch;
+    ThreadBlockList<ThreadRecord> records;   // Threads' records and pins
+    std::atomic<size_t> pendingCount;
+
+    std::mutex orphanMutex;                  // Guards orphans
+    std::vector<RetiredObject> orphans;      // Left behind by threads that exited
+};
+
+// EpochGuard: RAII read-side critical section
+class EpochGuard {
+public:
+    EpochGuard() { EpochManager::getInstance().enter(); }
+    ~EpochGuard() { EpochManager::getInstance().exit(); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+#endif // EPOCHMANAGER_HPP
@@ -0,0 +1,348 @@
+#include "ExternalSort.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace {
+
+// Runs smaller than this are sorted by comparison only
+const size_t radixSortRows = 4096;
+
+// Type tags of a non-NULL value; NULL is a lone 0x00
+const char numberTag = 0x01;
+const char textTag = 0x02;
+
+uint64_t keyPrefix(const std::string& key) {
+    uint64_t prefix = 0;
+    size_t length = std::min<size_t>(key.size(), 8);
+    for (size_t i = 0; i < length; ++i) {
+        prefix |= static_cast<uint64_t>(static_cast<unsigned char>(key[i])) << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+} // namespace
+
+void appendSortKey(const std::string& value, ColumnType type, bool descending, std::string& key) {
+    size_t start = key.size();
+    double number = 0;
+    if (isNull(value)) {
+        key += '\0';
+    } else if (isNumericType(type) && parseNumber(value, number)) {
+        // IEEE-754 bits with the sign handled so unsigned order equals numeric order
+        number = number == 0 ? 0 : number;  // -0 sorts with +0
+        uint64_t bits = 0;
+        std::memcpy(&bits, &number, sizeof(bits));
+        bits = (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+        key += numberTag;
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            key += static_cast<char>(bits >> shift);
+        }
+    } else {
+        // 0x00 bytes are escaped so the 0x00 0x00 terminator sorts a prefix first
+        key += textTag;
+        for (char c : value) {
+            key += c;
+            if (c == '\0') {
+                key += '\xff';
+            }
+        }
+        key.append(2, '\0');
+    }
+    if (descending) {
+        for (size_t i = start; i < key.size(); ++i) {
+            key[i] = static_cast<char>(~key[i]);
+        }
+    }
+}
+
+// RunMerge: k-way merge of sorted runs with a loser tree. Each inner node of
+// the tree holds the loser of the match played there and tree[0] the overall
+// winner, so replacing the winner replays only its leaf-to-root path: about
+// log2(k) key comparisons per row. Equal keys come from the earlier run first.
+class RunMerge {
+public:
+    // Produces a run's next (key, row); false after its last row
+    using Source = std::function<bool(std::string&, Row&)>;
+
+    explicit RunMerge(std::vector<Source> sources) : inputs(sources.size()), tree(sources.size(), -1) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            inputs[i].source = std::move(sources[i]);
+            inputs[i].done = !inputs[i].source(inputs[i].key, inputs[i].row);
+        }
+        // Empty nodes (-1) win every match until all leaves have played
+        for (size_t i = inputs.size(); i-- > 0;) {
+            replay(static_cast<int>(i));
+        }
+    }
+
+    bool next(std::string& key, Row& row) {
+        if (inputs.empty() || inputs[tree[0]].done) {
+            return false;
+        }
+        Input& winner = inputs[tree[0]];
+        key.swap(winner.key);
+        row.swap(winner.row);
+        winner.done = !winner.source(winner.key, winner.row);
+        replay(tree[0]);
+        return true;
+    }
+
+private:
+    struct Input {
+        Source source;
+        std::string key;
+        Row row;
+        bool done = false;
+    };
+
+    bool beats(int a, int b) const {
+        if (inputs[a].done || inputs[b].done) {
+            return !inputs[a].done;
+        }
+        int order = inputs[a].key.compare(inputs[b].key);
+        return order != 0 ? order < 0 : a < b;
+    }
+
+    void replay(int winner) {
+        for (size_t node = (winner + inputs.size()) / 2; node > 0; node /= 2) {
+            if (tree[node] == -1 || (winner != -1 && beats(tree[node], winner))) {
+                std::swap(tree[node], winner);
+            }
+        }
+        tree[0] = winner;
+    }
+
+    std::vector<Input> inputs;
+    std::vector<int> tree;
+};
+
+namespace {
+
+RunMerge::Source fileSource(SpillFile& file) {
+    file.rewind();
+    return [&file](std::string& key, Row& row) {
+        if (!file.read(row)) {
+            return false;
+        }
+        key.swap(row.back());
+        row.pop_back();
+        return true;
+    };
+}
+
+} // namespace
+
+SortNode::SortNode(std::unique_ptr<PlanNode> child, std::vector<SortKey> sortKeys, size_t budget, long long rowLimit,
+                   std::string text)
+    : keys(std::move(sortKeys)), memoryBudget(budget), limit(rowLimit), description(std::move(text)) {
+    children.push_back(std::move(child));
+}
+
+SortNode::~SortNode() = default;
+
+void SortNode::openNode() {
+    clearRun();
+    runs.clear();
+    merge.reset();
+    spilledRuns = 0;
+
+    PlanNode& input = *children[0];
+    input.open();
+    Row row;
+    while (input.next(row)) {
+        addRow(std::move(row));
+    }
+    input.close();
+
+    sortRun();
+    if (limit >= 0) {
+        truncateRun(static_cast<size_t>(limit));
+    }
+    if (runs.empty()) {
+        return;
+    }
+
+    // Spilled runs come first in input order, the run still in memory last
+    mergeSpilledRuns();
+    std::vector<RunMerge::Source> sources;
+    for (auto& run : runs) {
+        sources.push_back(fileSource(*run));
+    }
+    sources.push_back([this](std::string& key, Row& row) {
+        if (position == entries.size()) {
+            return false;
+        }
+        uint32_t index = entries[position++].row;
+        key.swap(rowKeys[index]);
+        row.swap(rows[index]);
+        return true;
+    });
+    merge = std::make_unique<RunMerge>(std::move(sources));
+}
+
+void SortNode::addRow(Row row) {
+    std::string key;
+    for (const SortKey& sortKey : keys) {
+        appendSortKey(row[sortKey.column], sortKey.type, sortKey.descending, key);
+    }
+    runBytes += rowMemoryBytes(row) + sizeof(std::string) + key.capacity() + sizeof(Entry);
+    rows.push_back(std::move(row));
+    rowKeys.push_back(std::move(key));
+
+    // Top-N: once the run holds twice the limit, only its first rows can still be returned
+    if (limit >= 0 && rows.size() >= 2 * static_cast<size_t>(limit) + 1024) {
+        sortRun();
+        truncateRun(static_cast<size_t>(limit));
+    }
+    if (runBytes > memoryBudget) {
+        spillRun();
+    }
+}
+
+// Sorts entries (not the rows) by key, then input position
+void SortNode::sortRun() {
+    entries.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        entries[i] = Entry{keyPrefix(rowKeys[i]), static_cast<uint32_t>(i)};
+    }
+    auto less = [this](const Entry& a, const Entry& b) {
+        if (a.prefix != b.prefix) {
+            return a.prefix < b.prefix;
+        }
+        int order = rowKeys[a.row].compare(rowKeys[b.row]);
+        return order != 0 ? order < 0 : a.row < b.row;
+    };
+    if (entries.size() < radixSortRows) {
+        std::sort(entries.begin(), entries.end(), less);
+        position = 0;
+        return;
+    }
+
+    // LSD radix sort on the prefix, one byte per pass; bytes every entry shares are skipped
+    std::vector<Entry> buffer(entries.size());
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t counts[256] = {};
+        for (const Entry& entry : entries) {
+            ++counts[(entry.prefix >> shift) & 0xFF];
+        }
+        if (counts[(entries[0].prefix >> shift) & 0xFF] == entries.size()) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            size_t next = offset + count;
+            count = offset;
+            offset = next;
+        }
+        for (const Entry& entry : entries) {
+            buffer[counts[(entry.prefix >> shift) & 0xFF]++] = entry;
+        }
+        entries.swap(buffer);
+    }
+
+    // Entries with equal prefixes are ordered by the rest of their keys
+    for (size_t begin = 0; begin < entries.size();) {
+        size_t end = begin + 1;
+        while (end < entries.size() && entries[end].prefix == entries[begin].prefix) {
+            ++end;
+        }
+        if (end - begin > 1) {
+            std::sort(entries.begin() + begin, entries.begin() + end, less);
+        }
+        begin = end;
+    }
+    position = 0;
+}
+
+// Rebuilds the run from its first sorted entries, in sorted order
+void SortNode::truncateRun(size_t keep) {
+    keep = std::min(keep, entries.size());
+    std::vector<Row> keptRows;
+    std::vector<std::string> keptKeys;
+    keptRows.reserve(keep);
+    keptKeys.reserve(keep);
+    runBytes = 0;
+    for (size_t i = 0; i < keep; ++i) {
+        uint32_t index = entries[i].row;
+        runBytes += rowMemoryBytes(rows[index]) + sizeof(std::string) + rowKeys[index].capacity() + sizeof(Entry);
+        keptRows.push_back(std::move(rows[index]));
+        keptKeys.push_back(std::move(rowKeys[index]));
+        entries[i] = Entry{entries[i].prefix, static_cast<uint32_t>(i)};
+    }
+    rows.swap(keptRows);
+    rowKeys.swap(keptKeys);
+    entries.resize(keep);
+}
+
+void SortNode::spillRun() {
+    sortRun();
+    size_t count = limit >= 0 ? std::min(entries.size(), static_cast<size_t>(limit)) : entries.size();
+    auto file = std::make_unique<SpillFile>();
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t index = entries[i].row;
+        rows[index].push_back(std::move(rowKeys[index]));
+        file->write(rows[index]);
+    }
+    runs.push_back(std::move(file));
+    ++spilledRuns;
+    clearRun();
+}
+
+// Merges the earliest runs into one until a single merge can take the rest
+void SortNode::mergeSpilledRuns() {
+    while (runs.size() + 1 > mergeFanout) {
+        std::vector<RunMerge::Source> sources;
+        for (size_t i = 0; i < mergeFanout; ++i) {
+            sources.push_back(fileSource(*runs[i]));
+        }
+        RunMerge pass(std::move(sources));
+        auto merged = std::make_unique<SpillFile>();
+        std::string key;
+        Row row;
+        long long written = 0;
+        while ((limit < 0 || written < limit) && pass.next(key, row)) {
+            row.push_back(std::move(key));
+            merged->write(row);
+            ++written;
+        }
+        runs.erase(runs.begin(), runs.begin() + mergeFanout);
+        runs.insert(runs.begin(), std::move(merged));
+    }
+}
+
+bool SortNode::nextRow(Row& row) {
+    if (merge) {
+        return merge->next(mergeKey, row);
+    }
+    if (position == entries.size()) {
+        return false;
+    }
+    row = std::move(rows[entries[position++].row]);
+    return true;
+}
+
+void SortNode::closeNode() {
+    clearRun();
+    merge.reset();
+    runs.clear();
+}
+
+void SortNode::clearRun() {
+    rows.clear();
+    rowKeys.clear();
+    entries.clear();
+    runBytes = 0;
+    position = 0;
+}
+
+std::string SortNode::describe() const {
+    std::string text = "Sort by " + description;
+    if (limit >= 0) {
+        text += " (top " + std::to_string(limit) + ")";
+    }
+    if (spilledRuns) {
+        text += " (spilled runs=" + std::to_string(spilledRuns) + ")";
+    }
+    return text;
+}
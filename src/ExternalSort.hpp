@@ -0,0 +1,83 @@
+#ifndef EXTERNALSORT_HPP
+#define EXTERNALSORT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "QueryPlan.hpp"
+#include "SpillFile.hpp"
+
+// One ORDER BY term bound to a column position of the input rows
+struct SortKey {
+    int column = -1;
+    ColumnType type = ColumnType::Text;
+    bool descending = false;
+};
+
+// Appends the normalized encoding of a value to key. Encodings compare with
+// memcmp in ORDER BY order, so a multi-column key is the concatenation of its
+// columns: NULL sorts first (last when descending), numbers by value, text
+// by bytes.
+void appendSortKey(const std::string& value, ColumnType type, bool descending, std::string& key);
+
+class RunMerge;
+
+// SortNode: ORDER BY. Reads its whole input on open(), then returns it in
+// key order.
+//
+// Rows are collected into a run until the run exceeds the memory budget; the
+// run is then sorted and written to a spill file. Runs are sorted on an
+// 8-byte big-endian prefix of the normalized key (radix sort for large runs,
+// ties resolved on the full key) and merged with a loser tree. With a LIMIT
+// only the first rows of each run are kept (top-N). Equal keys keep their
+// input order.
+class SortNode : public PlanNode {
+public:
+    SortNode(std::unique_ptr<PlanNode> child, std::vector<SortKey> keys, size_t memoryBudget, long long limit,
+             std::string description);
+    ~SortNode() override;
+    std::string describe() const override;
+
+    // After execution: sorted runs written to spill files
+    size_t getSpilledRunCount() const { return spilledRuns; }
+
+protected:
+    void openNode() override;
+    bool nextRow(Row& row) override;
+    void closeNode() override;
+
+private:
+    struct Entry {
+        uint64_t prefix;  // First 8 key bytes, big-endian
+        uint32_t row;     // Position in the run
+    };
+
+    static const size_t mergeFanout = 64;  // Runs merged at once
+
+    void addRow(Row row);
+    void sortRun();
+    void truncateRun(size_t keep);  // Keep the first rows in sorted order
+    void spillRun();
+    void mergeSpilledRuns();
+    void clearRun();
+
+    std::vector<SortKey> keys;
+    size_t memoryBudget;
+    long long limit;          // -1: none
+    std::string description;  // For describe()
+
+    // Run being collected, sorted in place by sortRun()
+    std::vector<Row> rows;
+    std::vector<std::string> rowKeys;
+    std::vector<Entry> entries;
+    size_t runBytes = 0;
+    size_t position = 0;      // Next entry to return when nothing spilled
+
+    std::vector<std::unique_ptr<SpillFile>> runs;  // Rows with their key as the last value
+    size_t spilledRuns = 0;
+    std::unique_ptr<RunMerge> merge;
+    std::string mergeKey;
+};
+
+#endif // EXTERNALSORT_HPP
@@ -0,0 +1,22 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// std::hash followed by the Murmur3 64-bit finalizer. std::hash may be weak
+// (or the identity) in its low or high bits; after the finalizer every bit
+// range is usable, for partition numbers, bloom filter positions and
+// HyperLogLog registers alike.
+inline uint64_t mixedHash(const std::string& value) {
+    uint64_t hash = std::hash<std::string>()(value);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+#endif // HASH_HPP
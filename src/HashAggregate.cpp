@@ -0,0 +1,512 @@
+#include "HashAggregate.hpp"
+#include "ExternalSort.hpp"
+#include "Hash.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+namespace {
+
+// Inputs smaller than this are aggregated on the calling thread alone
+const size_t parallelRows = 1 << 16;
+
+// Rows handed to a pre-aggregation lane at a time
+const size_t batchRows = 1024;
+
+// Merging fewer groups than this is not worth dispatching to workers
+const size_t parallelMergeGroups = 1 << 14;
+
+// The top bits of the mixed hash pick the partition
+size_t partitionOf(const std::string& key, size_t partitions) {
+    return (mixedHash(key) >> 32) % partitions;
+}
+
+// Sums of DECIMAL values with up to this many fraction digits are kept exact
+const int maxExactScale = 18;
+const int64_t powersOfTen[maxExactScale + 1] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL,
+    10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL, 100000000000000LL, 1000000000000000LL,
+    10000000000000000LL, 100000000000000000LL, 1000000000000000000LL};
+
+// A whole INT value; false if it is not one or does not fit an int64
+bool parseInteger(const std::string& text, int64_t& value) {
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoll(text.c_str(), &end, 10);
+    return errno == 0 && end != text.c_str() && end == text.c_str() + text.size();
+}
+
+// A [-]digits[.digits] DECIMAL value as an integer scaled by 10^scale; false
+// for anything else (exponents, too many digits)
+bool parseScaled(const std::string& text, int64_t& value, int& scale) {
+    bool negative = !text.empty() && text[0] == '-';
+    bool digits = false;
+    value = 0;
+    scale = -1;
+    for (size_t i = negative; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '.' && scale < 0) {
+            scale = 0;
+            continue;
+        }
+        int digit = c - '0';
+        if (digit < 0 || digit > 9 || __builtin_mul_overflow(value, 10, &value) ||
+            __builtin_add_overflow(value, negative ? -digit : digit, &value)) {
+            return false;
+        }
+        digits = true;
+        scale += scale >= 0;
+    }
+    scale = std::max(scale, 0);
+    return digits && scale <= maxExactScale;
+}
+
+// Adds value (scaled by 10^valueScale) to sum at the larger of the two scales;
+// on overflow the exact sum is given up (scale -1)
+void addExact(int64_t& sum, int& scale, int64_t value, int valueScale) {
+    if (scale < 0) {
+        return;
+    }
+    int target = std::max(scale, valueScale);
+    if (valueScale < 0 || __builtin_mul_overflow(sum, powersOfTen[target - scale], &sum) ||
+        __builtin_mul_overflow(value, powersOfTen[target - valueScale], &value) ||
+        __builtin_add_overflow(sum, value, &sum)) {
+        scale = -1;
+        return;
+    }
+    scale = target;
+}
+
+// DECIMAL text of an integer scaled by 10^scale: (123, 2) -> "1.23"
+std::string formatScaled(int64_t value, int scale) {
+    if (scale == 0) {
+        return std::to_string(value);
+    }
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    std::string text = std::to_string(magnitude);
+    if (text.size() <= static_cast<size_t>(scale)) {
+        text.insert(0, scale + 1 - text.size(), '0');
+    }
+    text.insert(text.size() - scale, ".");
+    return value < 0 ? "-" + text : text;
+}
+
+// Up to batchRows rows of input; false once the input is exhausted
+bool readBatch(PlanNode& input, std::vector<Row>& batch) {
+    batch.clear();
+    Row row;
+    while (batch.size() < batchRows && input.next(row)) {
+        batch.push_back(std::move(row));
+    }
+    return batch.size() == batchRows;
+}
+
+} // namespace
+
+ColumnType aggregateType(const AggregateSpec& aggregate) {
+    switch (aggregate.function) {
+        case AggregateFunction::Count: return ColumnType::Integer;
+        case AggregateFunction::Sum:
+            return aggregate.type == ColumnType::Integer ? ColumnType::Integer : ColumnType::Decimal;
+        case AggregateFunction::Avg: return ColumnType::Decimal;
+        default: return aggregate.type;
+    }
+}
+
+HashAggregateNode::HashAggregateNode(std::unique_ptr<PlanNode> child, std::vector<int> columns,
+                                     std::vector<ColumnType> types, std::vector<AggregateSpec> specs, size_t budget,
+                                     size_t lanes, std::string text)
+    : groupColumns(std::move(columns)), groupTypes(std::move(types)), aggregates(std::move(specs)),
+      memoryBudget(budget), parallelism(std::max<size_t>(lanes, 1)), description(std::move(text)) {
+    children.push_back(std::move(child));
+}
+
+void HashAggregateNode::openNode() {
+    tables.clear();
+    output.clear();
+    outputPartition = 0;
+    outputPosition = 0;
+    spill.clear();
+    spilled = false;
+    spillPartition = 0;
+    workerCount = 1;
+
+    tables.push_back(std::make_unique<Table>());
+    tables[0]->partitions.resize(partitionCount);
+    PlanNode& input = *children[0];
+    input.open();
+    auto* scan = dynamic_cast<SeqScanNode*>(&input);
+    size_t rowCount = scan ? scan->getTableRowCount() : 0;
+    if (scan && parallelism > 1 && rowCount > morselRows) {
+        aggregateMorsels(*scan, rowCount);
+    } else {
+        // Small inputs stay on this thread; the rest of a large one is spread over the lanes
+        std::vector<Row> batch;
+        std::string key;
+        size_t rowsRead = 0;
+        bool more = true;
+        while (more && (parallelism == 1 || rowsRead < parallelRows)) {
+            more = readBatch(input, batch);
+            for (const Row& row : batch) {
+                accumulate(*tables[0], row, key);
+            }
+            rowsRead += batch.size();
+            if (tables[0]->bytes > memoryBudget) {
+                spillTable(*tables[0]);
+            }
+        }
+        if (more) {
+            aggregateBatches(input);
+        }
+    }
+    input.close();
+
+    if (spilled) {
+        for (auto& table : tables) {
+            spillTable(*table);
+        }
+        tables.clear();
+        loadSpillPartition();
+        return;
+    }
+
+    // Merge: each partition combines its groups from every table, independently of the others
+    output.assign(partitionCount, std::vector<Row>());
+    size_t groups = 0;
+    for (auto& table : tables) {
+        for (const Partition& partition : table->partitions) {
+            groups += partition.groups.size();
+        }
+    }
+    if (tables.size() > 1 && groups >= parallelMergeGroups) {
+        TaskScheduler::getInstance().run(partitionCount, parallelism,
+                                         [&](size_t, size_t p) { mergePartition(p, output[p]); });
+    } else {
+        for (size_t p = 0; p < partitionCount; ++p) {
+            mergePartition(p, output[p]);
+        }
+    }
+    tables.clear();
+
+    // Aggregates without GROUP BY still produce a row for empty input
+    if (groupColumns.empty() && groups == 0) {
+        emit(Group{Row(), std::vector<Accumulator>(aggregates.size())}, output[0]);
+    }
+}
+
+void HashAggregateNode::addLaneTables() {
+    while (tables.size() < parallelism) {
+        tables.push_back(std::make_unique<Table>());
+        tables.back()->partitions.resize(partitionCount);
+    }
+    workerCount = parallelism;
+}
+
+// Pre-aggregation fused with a table scan: each morsel of rows is read,
+// filtered and aggregated into its lane's table by a scheduler worker
+void HashAggregateNode::aggregateMorsels(SeqScanNode& scan, size_t rowCount) {
+    addLaneTables();
+    size_t tableBudget = memoryBudget / tables.size();
+    std::vector<uint64_t> rowsRead(parallelism);
+    std::vector<size_t> rowsSkipped(parallelism);
+    std::vector<uint64_t> rowsProduced(parallelism);
+    TaskScheduler::getInstance().run((rowCount + morselRows - 1) / morselRows, parallelism,
+                                     [&](size_t lane, size_t morsel) {
+        Table& table = *tables[lane];
+        std::vector<Row> rows;
+        std::string key;
+        size_t end = std::min((morsel + 1) * morselRows, rowCount);
+        for (size_t start = morsel * morselRows; start < end; start += batchRows) {
+            rows.clear();
+            rowsRead[lane] += scan.scanMorsel(start, std::min(start + batchRows, end), rows, nullptr,
+                                              rowsSkipped[lane]);
+            rowsProduced[lane] += rows.size();
+            for (const Row& row : rows) {
+                accumulate(table, row, key);
+            }
+            if (table.bytes > tableBudget) {
+                spillTable(table);
+            }
+        }
+    });
+    uint64_t read = 0;
+    uint64_t skipped = 0;
+    uint64_t produced = 0;
+    for (size_t lane = 0; lane < parallelism; ++lane) {
+        read += rowsRead[lane];
+        skipped += rowsSkipped[lane];
+        produced += rowsProduced[lane];
+    }
+    scan.recordMorsels(read, skipped, produced);
+}
+
+// Pre-aggregation of any other input: this thread reads a window of batches,
+// the scheduler's workers aggregate them into the lane tables
+void HashAggregateNode::aggregateBatches(PlanNode& input) {
+    addLaneTables();
+    size_t tableBudget = memoryBudget / tables.size();
+    std::vector<std::vector<Row>> window(2 * parallelism);
+    bool more = true;
+    while (more) {
+        size_t count = 0;
+        while (more && count < window.size()) {
+            more = readBatch(input, window[count]);
+            count += !window[count].empty();
+        }
+        TaskScheduler::getInstance().run(count, parallelism, [&](size_t lane, size_t batch) {
+            Table& table = *tables[lane];
+            std::string key;
+            for (const Row& row : window[batch]) {
+                accumulate(table, row, key);
+            }
+            if (table.bytes > tableBudget) {
+                spillTable(table);
+            }
+        });
+    }
+}
+
+void HashAggregateNode::accumulate(Table& table, const Row& row, std::string& key) {
+    key.clear();
+    for (size_t i = 0; i < groupColumns.size(); ++i) {
+        appendSortKey(row[groupColumns[i]], groupTypes[i], false, key);  // NULL is a group of its own
+    }
+    Partition& partition = table.partitions[partitionOf(key, partitionCount)];
+    auto entry = partition.index.try_emplace(key, static_cast<uint32_t>(partition.groups.size()));
+    if (entry.second) {
+        Group group;
+        group.values.reserve(groupColumns.size());
+        for (int column : groupColumns) {
+            group.values.push_back(row[column]);
+        }
+        group.accumulators.resize(aggregates.size());
+        table.bytes += groupBytes(group, key);
+        partition.groups.push_back(std::move(group));
+    }
+    Group& group = partition.groups[entry.first->second];
+    for (size_t a = 0; a < aggregates.size(); ++a) {
+        update(group.accumulators[a], aggregates[a], row);
+    }
+}
+
+void HashAggregateNode::update(Accumulator& accumulator, const AggregateSpec& aggregate, const Row& row) const {
+    if (aggregate.column < 0) {
+        ++accumulator.count;  // COUNT(*)
+        return;
+    }
+    const std::string& value = row[aggregate.column];
+    if (isNull(value)) {
+        return;
+    }
+    double number = 0;
+    int64_t exact = 0;
+    int scale = 0;
+    switch (aggregate.function) {
+        case AggregateFunction::Count:
+            ++accumulator.count;
+            break;
+        case AggregateFunction::Sum:
+        case AggregateFunction::Avg:
+            if (parseNumber(value, number)) {
+                ++accumulator.count;
+                accumulator.sum += number;
+                bool parsed = aggregate.type == ColumnType::Integer ? parseInteger(value, exact)
+                                                                    : parseScaled(value, exact, scale);
+                addExact(accumulator.exactSum, accumulator.scale, exact, parsed ? scale : -1);
+            }
+            break;
+        case AggregateFunction::Min:
+        case AggregateFunction::Max: {
+            int order = accumulator.count ? compareValues(value, accumulator.extreme, aggregate.type) : 0;
+            if (accumulator.count++ == 0 || (aggregate.function == AggregateFunction::Min ? order < 0 : order > 0)) {
+                accumulator.extreme = value;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void HashAggregateNode::combine(Accumulator& into, const Accumulator& from, const AggregateSpec& aggregate) const {
+    if (from.count == 0) {
+        return;
+    }
+    if (aggregate.function == AggregateFunction::Min || aggregate.function == AggregateFunction::Max) {
+        int order = into.count ? compareValues(from.extreme, into.extreme, aggregate.type) : 0;
+        if (into.count == 0 || (aggregate.function == AggregateFunction::Min ? order < 0 : order > 0)) {
+            into.extreme = from.extreme;
+        }
+    }
+    into.count += from.count;
+    into.sum += from.sum;
+    addExact(into.exactSum, into.scale, from.exactSum, from.scale);
+}
+
+// Approximate heap footprint of a group and its hash table entry
+size_t HashAggregateNode::groupBytes(const Group& group, const std::string& key) const {
+    return rowMemoryBytes(group.values) + sizeof(Group) + group.accumulators.size() * sizeof(Accumulator) +
+           sizeof(std::string) + key.capacity() + 4 * sizeof(void*);
+}
+
+// Writes a table's groups as partial aggregates to the spill file of their
+// partition: group values, then count, sum, exact sum, scale and extreme per aggregate
+void HashAggregateNode::spillTable(Table& table) {
+    std::lock_guard<std::mutex> lock(spillMutex);
+    if (!spilled) {
+        for (size_t p = 0; p < partitionCount; ++p) {
+            spill.push_back(std::make_unique<SpillFile>());
+        }
+        spilled = true;
+    }
+    Row state;
+    for (size_t p = 0; p < partitionCount; ++p) {
+        for (const Group& group : table.partitions[p].groups) {
+            state = group.values;
+            for (const Accumulator& accumulator : group.accumulators) {
+                state.push_back(std::to_string(accumulator.count));
+                state.push_back(formatDecimal(accumulator.sum));
+                state.push_back(std::to_string(accumulator.exactSum));
+                state.push_back(std::to_string(accumulator.scale));
+                state.push_back(accumulator.extreme);
+            }
+            spill[p]->write(state);
+        }
+    }
+    table.partitions.assign(partitionCount, Partition());
+    table.bytes = 0;
+}
+
+// Combines one partition of every table into the first table's, then emits it
+void HashAggregateNode::mergePartition(size_t p, std::vector<Row>& rows) {
+    Partition& merged = tables[0]->partitions[p];
+    for (size_t t = 1; t < tables.size(); ++t) {
+        Partition& other = tables[t]->partitions[p];
+        for (const auto& entry : other.index) {
+            Group& group = other.groups[entry.second];
+            auto found = merged.index.try_emplace(entry.first, static_cast<uint32_t>(merged.groups.size()));
+            if (found.second) {
+                merged.groups.push_back(std::move(group));
+                continue;
+            }
+            Group& into = merged.groups[found.first->second];
+            for (size_t a = 0; a < aggregates.size(); ++a) {
+                combine(into.accumulators[a], group.accumulators[a], aggregates[a]);
+            }
+        }
+        other = Partition();
+    }
+    rows.reserve(merged.groups.size());
+    for (const Group& group : merged.groups) {
+        emit(group, rows);
+    }
+    merged = Partition();
+}
+
+// Merges the partial aggregates of the next non-empty spilled partition into
+// the output. A partition is merged whole, even if it alone is over the budget.
+bool HashAggregateNode::loadSpillPartition() {
+    output.assign(1, std::vector<Row>());
+    outputPartition = 0;
+    outputPosition = 0;
+    for (; spillPartition < partitionCount; ++spillPartition) {
+        SpillFile& file = *spill[spillPartition];
+        if (file.getRowCount() == 0) {
+            continue;
+        }
+        file.rewind();
+        Partition partition;
+        Row state;
+        std::string key;
+        while (file.read(state)) {
+            key.clear();
+            for (size_t i = 0; i < groupColumns.size(); ++i) {
+                appendSortKey(state[i], groupTypes[i], false, key);
+            }
+            auto entry = partition.index.try_emplace(key, static_cast<uint32_t>(partition.groups.size()));
+            if (entry.second) {
+                Group group;
+                group.values.assign(state.begin(), state.begin() + groupColumns.size());
+                group.accumulators.resize(aggregates.size());
+                partition.groups.push_back(std::move(group));
+            }
+            Group& group = partition.groups[entry.first->second];
+            size_t field = groupColumns.size();
+            for (size_t a = 0; a < aggregates.size(); ++a, field += 5) {
+                Accumulator from;
+                from.count = std::stoll(state[field]);
+                from.sum = std::stod(state[field + 1]);
+                from.exactSum = std::stoll(state[field + 2]);
+                from.scale = std::stoi(state[field + 3]);
+                from.extreme = std::move(state[field + 4]);
+                combine(group.accumulators[a], from, aggregates[a]);
+            }
+        }
+        spill[spillPartition++].reset();
+        for (const Group& group : partition.groups) {
+            emit(group, output[0]);
+        }
+        return true;
+    }
+    return false;
+}
+
+void HashAggregateNode::emit(const Group& group, std::vector<Row>& rows) const {
+    Row row = group.values;
+    row.reserve(group.values.size() + aggregates.size());
+    for (size_t a = 0; a < aggregates.size(); ++a) {
+        const AggregateSpec& aggregate = aggregates[a];
+        const Accumulator& accumulator = group.accumulators[a];
+        if (aggregate.function == AggregateFunction::Count) {
+            row.push_back(std::to_string(accumulator.count));
+        } else if (accumulator.count == 0) {
+            row.push_back(NULL_VALUE);  // SUM, AVG, MIN and MAX of no values
+        } else if (aggregate.function == AggregateFunction::Sum) {
+            row.push_back(accumulator.scale >= 0 ? formatScaled(accumulator.exactSum, accumulator.scale)
+                                                 : formatDecimal(accumulator.sum));
+        } else if (aggregate.function == AggregateFunction::Avg && accumulator.scale >= 0) {
+            // One division of the exact sum, so AVG(0.1, 0.2, 0.3) is 0.2
+            row.push_back(formatDecimal(static_cast<double>(accumulator.exactSum) /
+                                        (static_cast<double>(powersOfTen[accumulator.scale]) *
+                                         static_cast<double>(accumulator.count))));
+        } else if (aggregate.function == AggregateFunction::Avg) {
+            row.push_back(formatDecimal(accumulator.sum / static_cast<double>(accumulator.count)));
+        } else {
+            row.push_back(accumulator.extreme);
+        }
+    }
+    rows.push_back(std::move(row));
+}
+
+bool HashAggregateNode::nextRow(Row& row) {
+    while (true) {
+        while (outputPartition < output.size()) {
+            std::vector<Row>& rows = output[outputPartition];
+            if (outputPosition < rows.size()) {
+                row = std::move(rows[outputPosition++]);
+                return true;
+            }
+            rows = std::vector<Row>();
+            ++outputPartition;
+            outputPosition = 0;
+        }
+        if (!spilled || !loadSpillPartition()) {
+            return false;
+        }
+    }
+}
+
+void HashAggregateNode::closeNode() {
+    tables.clear();
+    output.clear();
+    spill.clear();
+}
+
+std::string HashAggregateNode::describe() const {
+    if (workerCount == 0) {
+        return description;
+    }
+    return description + " (workers=" + std::to_string(workerCount) +
+           (spilled ? " spilled partitions=" + std::to_string(partitionCount) : "") + ")";
+}
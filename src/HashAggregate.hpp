@@ -0,0 +1,107 @@
+#ifndef HASHAGGREGATE_HPP
+#define HASHAGGREGATE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "QueryPlan.hpp"
+#include "SpillFile.hpp"
+
+// One aggregate computed by a HashAggregateNode
+struct AggregateSpec {
+    AggregateFunction function = AggregateFunction::Count;
+    int column = -1;                        // Input column, -1 for COUNT(*)
+    ColumnType type = ColumnType::Integer;  // Type of the input column
+};
+
+// Result type of an aggregate: COUNT is an integer, SUM keeps integers, AVG is a decimal
+ColumnType aggregateType(const AggregateSpec& aggregate);
+
+// HashAggregateNode: GROUP BY with COUNT/SUM/AVG/MIN/MAX. Output rows are the
+// group columns followed by one value per aggregate; without group columns
+// there is exactly one output row.
+//
+// Two phases. Pre-aggregation: input is aggregated into one table per
+// TaskScheduler lane, each table split into partitions by the high bits of
+// the group hash. Over a table scan the scan runs inside the pipeline, morsel
+// by morsel; other inputs are read here and handed out in batches. Merge: the
+// lane tables' partitions are combined partition by partition, in parallel.
+// A lane table that outgrows its share of the memory budget is written to
+// partitioned spill files as partial aggregates; the spilled partitions are
+// then merged one at a time.
+class HashAggregateNode : public PlanNode {
+public:
+    HashAggregateNode(std::unique_ptr<PlanNode> child, std::vector<int> groupColumns,
+                      std::vector<ColumnType> groupTypes, std::vector<AggregateSpec> aggregates, size_t memoryBudget,
+                      size_t parallelism, std::string description);
+    std::string describe() const override;
+
+    // After execution: pre-aggregation lanes, spill partitions used
+    size_t getWorkerCount() const { return workerCount; }
+    size_t getSpillPartitionCount() const { return spilled ? partitionCount : 0; }
+
+protected:
+    void openNode() override;
+    bool nextRow(Row& row) override;
+    void closeNode() override;
+
+private:
+    struct Accumulator {
+        int64_t count = 0;     // Values seen (rows for COUNT(*))
+        double sum = 0;        // Used once the exact sum is given up
+        int64_t exactSum = 0;  // SUM scaled by 10^scale
+        int scale = 0;         // Fraction digits of exactSum, -1 once a value or the total did not fit
+        std::string extreme;   // MIN or MAX so far
+    };
+    struct Group {
+        Row values;
+        std::vector<Accumulator> accumulators;
+    };
+    struct Partition {
+        std::unordered_map<std::string, uint32_t> index;  // Group key -> groups position
+        std::vector<Group> groups;
+    };
+    struct Table {
+        std::vector<Partition> partitions;
+        size_t bytes = 0;
+    };
+
+    static const size_t partitionCount = 64;
+
+    void aggregateMorsels(SeqScanNode& scan, size_t rowCount);
+    void aggregateBatches(PlanNode& input);
+    void addLaneTables();
+    void accumulate(Table& table, const Row& row, std::string& key);
+    void update(Accumulator& accumulator, const AggregateSpec& aggregate, const Row& row) const;
+    void combine(Accumulator& into, const Accumulator& from, const AggregateSpec& aggregate) const;
+    void spillTable(Table& table);
+    void mergePartition(size_t partition, std::vector<Row>& rows);
+    bool loadSpillPartition();
+    void emit(const Group& group, std::vector<Row>& rows) const;
+    size_t groupBytes(const Group& group, const std::string& key) const;
+
+    std::vector<int> groupColumns;
+    std::vector<ColumnType> groupTypes;
+    std::vector<AggregateSpec> aggregates;
+    size_t memoryBudget;
+    size_t parallelism;       // Lanes of the parallel phases
+    std::string description;  // For describe()
+
+    std::vector<std::unique_ptr<Table>> tables;  // One per pre-aggregation lane
+    size_t workerCount = 0;
+
+    // Output, partition by partition
+    std::vector<std::vector<Row>> output;
+    size_t outputPartition = 0;
+    size_t outputPosition = 0;
+
+    bool spilled = false;
+    std::mutex spillMutex;                          // Lanes spill into the same files
+    std::vector<std::unique_ptr<SpillFile>> spill;  // Partial aggregates by partition
+    size_t spillPartition = 0;                      // Next spilled partition to merge
+};
+
+#endif // HASHAGGREGATE_HPP
@@ -0,0 +1,307 @@
+#include "HashJoin.hpp"
+#include "Hash.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+
+namespace {
+
+// Partitions are sized so their slot array fits in a typical L2 cache
+const size_t partitionBytes = 256 * 1024;
+const size_t maxPartitions = 1024;
+
+// Builds smaller than this are filled on the calling thread alone
+const size_t parallelBuildRows = 1 << 16;
+
+size_t nextPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+// Join key of a row: numbers as 8 raw bytes, text length-prefixed.
+// False if a key column is NULL (NULL never joins).
+bool makeKey(const Row& row, const JoinKeys& keys, std::string& key) {
+    key.clear();
+    for (size_t i = 0; i < keys.columns.size(); ++i) {
+        const std::string& value = row[keys.columns[i]];
+        if (isNull(value)) {
+            return false;
+        }
+        double number = 0;
+        if (isNumericType(keys.types[i]) && parseNumber(value, number)) {  // 10 joins 10.0
+            number = number == 0 ? 0 : number;  // -0 joins +0
+            key += 'n';
+            key.append(reinterpret_cast<const char*>(&number), sizeof(number));
+            continue;
+        }
+        uint32_t length = static_cast<uint32_t>(value.size());
+        key += 't';
+        key.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        key += value;
+    }
+    return true;
+}
+
+// Approximate heap footprint of a build row and its key
+size_t rowBytes(const Row& row, const std::string& key) {
+    return rowMemoryBytes(row) + sizeof(std::string) + sizeof(uint64_t) + key.capacity();
+}
+
+// Spill partition from bits the in-memory partitioning and slot index do not use
+size_t spillIndex(uint64_t hash, size_t fanout) {
+    return (hash >> 26) & (fanout - 1);
+}
+
+// Bloom filter block and bit mask: three bits in one 64-bit word
+uint64_t bloomMask(uint64_t hash) {
+    uint64_t mixed = hash * 0x9E3779B97F4A7C15ULL;
+    return (1ULL << (mixed & 63)) | (1ULL << ((mixed >> 6) & 63)) | (1ULL << ((mixed >> 12) & 63));
+}
+
+size_t bloomWord(uint64_t hash, size_t words) {
+    return ((hash * 0x9E3779B97F4A7C15ULL) >> 32) & (words - 1);
+}
+
+} // namespace
+
+HashJoinNode::HashJoinNode(std::unique_ptr<PlanNode> probe, std::unique_ptr<PlanNode> build, JoinKeys probeColumns,
+                           JoinKeys buildColumns, bool buildLeft, size_t budget, size_t lanes,
+                           std::string joinCondition)
+    : probeKeys(std::move(probeColumns)), buildKeys(std::move(buildColumns)), buildIsLeft(buildLeft),
+      memoryBudget(budget), parallelism(std::max<size_t>(lanes, 1)), condition(std::move(joinCondition)) {
+    children.push_back(std::move(probe));
+    children.push_back(std::move(build));
+}
+
+void HashJoinNode::openNode() {
+    clearTable();
+    buildSpill.clear();
+    probeSpill.clear();
+    spilled = false;
+    probing = false;
+    bloomFiltered = 0;
+    partitionCount = 0;
+    spillPartition = 0;
+
+    // Build: read the whole build input, spilling once it outgrows the budget
+    PlanNode& build = *children[1];
+    build.open();
+    Row row;
+    std::string key;
+    while (build.next(row)) {
+        if (!makeKey(row, buildKeys, key)) {
+            continue;
+        }
+        uint64_t hash = mixedHash(key);
+        if (spilled) {
+            buildSpill[spillIndex(hash, spillFanout)]->write(row);
+            continue;
+        }
+        addBuildRow(std::move(row), key, hash);
+        if (buildBytes > memoryBudget) {
+            spillBuild();
+        }
+    }
+    build.close();
+
+    children[0]->open();
+    if (!spilled) {
+        buildTable();
+        return;
+    }
+
+    // Grace hash join: partition the probe input the same way, then join partition by partition
+    while (children[0]->next(row)) {
+        if (makeKey(row, probeKeys, key)) {
+            probeSpill[spillIndex(mixedHash(key), spillFanout)]->write(row);
+        }
+    }
+    loadSpillPartition();
+}
+
+void HashJoinNode::addBuildRow(Row row, std::string key, uint64_t hash) {
+    buildBytes += rowBytes(row, key);
+    buildRows.push_back(std::move(row));
+    buildKeyValues.push_back(std::move(key));
+    buildHashes.push_back(hash);
+}
+
+void HashJoinNode::buildTable() {
+    size_t count = buildRows.size();
+    size_t totalSlots = nextPowerOfTwo(std::max<size_t>(2 * count, 2));
+    size_t partitionTotal =
+        std::min(maxPartitions, nextPowerOfTwo((totalSlots * sizeof(Slot) + partitionBytes - 1) / partitionBytes));
+    int bits = 0;
+    while ((size_t(1) << bits) < partitionTotal) {
+        ++bits;
+    }
+    partitionShift = 64 - bits;
+    partitionCount = std::max(partitionCount, partitionTotal);
+    auto partitionOf = [this](uint64_t hash) { return partitionShift >= 64 ? 0 : hash >> partitionShift; };
+
+    // Radix scatter: row numbers grouped by partition
+    std::vector<size_t> offsets(partitionTotal + 1, 0);
+    for (uint64_t hash : buildHashes) {
+        ++offsets[partitionOf(hash) + 1];
+    }
+    for (size_t p = 0; p < partitionTotal; ++p) {
+        offsets[p + 1] += offsets[p];
+    }
+    std::vector<uint32_t> order(count);
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        order[cursor[partitionOf(buildHashes[i])]++] = static_cast<uint32_t>(i);
+    }
+
+    // Each partition is filled on its own, in row order so duplicate keys come back in input order
+    partitions.assign(partitionTotal, Partition());
+    auto fill = [&](size_t p) {
+        Partition& partition = partitions[p];
+        size_t capacity = nextPowerOfTwo(std::max<size_t>(2 * (offsets[p + 1] - offsets[p]), 2));
+        partition.slots.assign(capacity, Slot{0, 0});
+        partition.mask = capacity - 1;
+        for (size_t i = offsets[p]; i < offsets[p + 1]; ++i) {
+            uint32_t row = order[i];
+            uint64_t hash = buildHashes[row];
+            size_t slot = hash & partition.mask;
+            while (partition.slots[slot].row != 0) {
+                slot = (slot + 1) & partition.mask;
+            }
+            partition.slots[slot] = Slot{static_cast<uint32_t>(hash >> 32), row + 1};
+        }
+    };
+    if (count >= parallelBuildRows && parallelism > 1 && partitionTotal > 1) {
+        TaskScheduler::getInstance().run(partitionTotal, std::min(parallelism, partitionTotal),
+                                         [&](size_t, size_t p) { fill(p); });
+    } else {
+        for (size_t p = 0; p < partitionTotal; ++p) {
+            fill(p);
+        }
+    }
+
+    // About 16 bits per key
+    bloom.assign(count ? nextPowerOfTwo(count / 4 + 1) : 0, 0);
+    for (uint64_t hash : buildHashes) {
+        bloom[bloomWord(hash, bloom.size())] |= bloomMask(hash);
+    }
+}
+
+void HashJoinNode::spillBuild() {
+    spilled = true;
+    for (size_t i = 0; i < spillFanout; ++i) {
+        buildSpill.push_back(std::make_unique<SpillFile>());
+        probeSpill.push_back(std::make_unique<SpillFile>());
+    }
+    for (size_t i = 0; i < buildRows.size(); ++i) {
+        buildSpill[spillIndex(buildHashes[i], spillFanout)]->write(buildRows[i]);
+    }
+    clearTable();
+}
+
+// Loads the next spill partition with rows on both sides into the hash table.
+// A partition is loaded whole, even if it alone is over the budget.
+bool HashJoinNode::loadSpillPartition() {
+    for (; spillPartition < spillFanout; ++spillPartition) {
+        if (buildSpill[spillPartition]->getRowCount() == 0 || probeSpill[spillPartition]->getRowCount() == 0) {
+            continue;
+        }
+        clearTable();
+        SpillFile& file = *buildSpill[spillPartition];
+        file.rewind();
+        Row row;
+        std::string key;
+        while (file.read(row)) {
+            makeKey(row, buildKeys, key);
+            uint64_t hash = mixedHash(key);
+            addBuildRow(std::move(row), key, hash);
+        }
+        buildTable();
+        probeSpill[spillPartition]->rewind();
+        return true;
+    }
+    return false;
+}
+
+bool HashJoinNode::nextProbeRow() {
+    if (!spilled) {
+        return !buildRows.empty() && children[0]->next(probeRow);
+    }
+    while (spillPartition < spillFanout) {
+        if (probeSpill[spillPartition]->read(probeRow)) {
+            return true;
+        }
+        ++spillPartition;
+        loadSpillPartition();
+    }
+    return false;
+}
+
+bool HashJoinNode::nextRow(Row& row) {
+    while (true) {
+        if (probing) {
+            const std::vector<Slot>& slots = probePartition->slots;
+            while (slots[probeSlot].row != 0) {
+                Slot slot = slots[probeSlot];
+                probeSlot = (probeSlot + 1) & probePartition->mask;
+                if (slot.tag == probeTag && buildKeyValues[slot.row - 1] == probeKey) {
+                    const Row& left = buildIsLeft ? buildRows[slot.row - 1] : probeRow;
+                    const Row& right = buildIsLeft ? probeRow : buildRows[slot.row - 1];
+                    row.clear();
+                    row.reserve(left.size() + right.size());
+                    row.insert(row.end(), left.begin(), left.end());
+                    row.insert(row.end(), right.begin(), right.end());
+                    return true;
+                }
+            }
+            probing = false;
+        }
+
+        if (!nextProbeRow()) {
+            return false;
+        }
+        if (!makeKey(probeRow, probeKeys, probeKey)) {
+            continue;
+        }
+        uint64_t hash = mixedHash(probeKey);
+        uint64_t mask = bloomMask(hash);
+        if ((bloom[bloomWord(hash, bloom.size())] & mask) != mask) {
+            ++bloomFiltered;
+            continue;
+        }
+        probePartition = &partitions[partitionShift >= 64 ? 0 : hash >> partitionShift];
+        probeSlot = hash & probePartition->mask;
+        probeTag = static_cast<uint32_t>(hash >> 32);
+        probing = true;
+    }
+}
+
+void HashJoinNode::closeNode() {
+    children[0]->close();
+    clearTable();
+    buildSpill.clear();
+    probeSpill.clear();
+}
+
+void HashJoinNode::clearTable() {
+    buildRows.clear();
+    buildKeyValues.clear();
+    buildHashes.clear();
+    buildBytes = 0;
+    partitions.clear();
+    bloom.clear();
+    probing = false;
+}
+
+std::string HashJoinNode::describe() const {
+    std::string text = "HashJoin on " + condition;
+    if (partitionCount) {
+        text += " (partitions=" + std::to_string(partitionCount) + " bloom filtered=" + std::to_string(bloomFiltered);
+        if (spilled) {
+            text += " spilled partitions=" + std::to_string(spillFanout);
+        }
+        text += ")";
+    }
+    return text;
+}
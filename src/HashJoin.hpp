@@ -0,0 +1,99 @@
+#ifndef HASHJOIN_HPP
+#define HASHJOIN_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "QueryPlan.hpp"
+#include "SpillFile.hpp"
+
+// Equi-join keys of one input: key column positions in that input's rows
+struct JoinKeys {
+    std::vector<int> columns;
+    std::vector<ColumnType> types;  // Comparison type of each key (numeric keys match 10 and 10.0)
+};
+
+// HashJoinNode: inner equi-join. The build input is read completely into a
+// hash table, then every probe row is looked up in it.
+//
+// The table is radix-partitioned on the high bits of the key hash so each
+// partition fits in L2 cache while it is built; large builds fill the
+// partitions in parallel on the TaskScheduler's lanes. A blocked bloom filter
+// in front of the table drops probe rows without a match before they touch
+// it. When the build input exceeds the memory budget, both inputs are written
+// to partitioned spill files and joined one partition at a time (Grace hash
+// join).
+//
+// Output rows are the left input's columns followed by the right input's,
+// whichever side is built.
+class HashJoinNode : public PlanNode {
+public:
+    HashJoinNode(std::unique_ptr<PlanNode> probe, std::unique_ptr<PlanNode> build, JoinKeys probeKeys,
+                 JoinKeys buildKeys, bool buildIsLeft, size_t memoryBudget, size_t parallelism,
+                 std::string condition);
+    std::string describe() const override;
+
+    // After execution: hash table partitions, probe rows dropped by the bloom filter, spill partitions used
+    size_t getPartitionCount() const { return partitionCount; }
+    uint64_t getBloomFiltered() const { return bloomFiltered; }
+    size_t getSpillPartitionCount() const { return spilled ? spillFanout : 0; }
+
+protected:
+    void openNode() override;
+    bool nextRow(Row& row) override;
+    void closeNode() override;
+
+private:
+    struct Slot {
+        uint32_t tag;  // High hash bits, checked before the key
+        uint32_t row;  // Build row + 1, 0 for an empty slot
+    };
+    struct Partition {
+        std::vector<Slot> slots;
+        size_t mask = 0;
+    };
+
+    static const size_t spillFanout = 64;
+
+    void addBuildRow(Row row, std::string key, uint64_t hash);
+    void buildTable();
+    void spillBuild();
+    bool nextProbeRow();
+    bool loadSpillPartition();
+    void clearTable();
+
+    JoinKeys probeKeys;
+    JoinKeys buildKeys;
+    bool buildIsLeft;
+    size_t memoryBudget;
+    size_t parallelism;     // Lanes the partitions are filled on
+    std::string condition;  // For describe()
+
+    // Build side
+    std::vector<Row> buildRows;
+    std::vector<std::string> buildKeyValues;
+    std::vector<uint64_t> buildHashes;
+    size_t buildBytes = 0;
+    std::vector<Partition> partitions;
+    int partitionShift = 64;       // Partition = hash >> partitionShift (64: one partition)
+    std::vector<uint64_t> bloom;   // One 64-bit block per key, three bits set
+    size_t partitionCount = 0;
+
+    // Probe state
+    Row probeRow;
+    std::string probeKey;
+    const Partition* probePartition = nullptr;
+    size_t probeSlot = 0;
+    uint32_t probeTag = 0;
+    bool probing = false;
+    uint64_t bloomFiltered = 0;
+
+    // Grace hash join
+    bool spilled = false;
+    std::vector<std::unique_ptr<SpillFile>> buildSpill;
+    std::vector<std::unique_ptr<SpillFile>> probeSpill;
+    size_t spillPartition = 0;     // Partition being joined, spillFanout when done
+};
+
+#endif // HASHJOIN_HPP
@@ -1,11 +1,16 @@
 #include "Indexing.hpp"
-#include <iostream>
+#include "EpochManager.hpp"
+#include "Metrics.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
 #include <unordered_map>
+#include <functional>
+#include <thread>
 
 // HashIndex Implementation
 void HashIndex::addIndexEntry(const std::string& key, int rowId) {
     indexData[key].push_back(rowId);
-    std::cout << "Hash Index: Added entry [" << key << "] -> Row ID: " << rowId << std::endl;
+    LOG_DEBUG("Hash Index: Added entry [" << key << "] -> Row ID: " << rowId);
 }
 
 std::vector<int> HashIndex::getIndexEntries(const std::string& key) const {
@@ -20,22 +25,673 @@ bool HashIndex::hasIndexEntry(const std::string& key) const {
     return indexData.find(key) != indexData.end();
 }
 
-// BTreeIndex Implementation (simplified version)
+// ShardedHashIndex Implementation
+
+struct ShardedHashIndex::Entry {
+    std::string key;
+    size_t hash;
+    std::vector<int> rowIds;
+};
+
+// Open-addressing table with linear probing; slots point at immutable entries
+struct ShardedHashIndex::Table {
+    size_t capacity;  // Power of two
+    std::unique_ptr<std::atomic<const Entry*>[]> slots;
+
+    explicit Table(size_t slotCount) : capacity(slotCount), slots(new std::atomic<const Entry*>[slotCount]) {
+        for (size_t i = 0; i < capacity; ++i) {
+            slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    // Place an entry whose key is known to be absent (writer only)
+    void place(const Entry* entry) {
+        size_t mask = capacity - 1;
+        for (size_t i = entry->hash & mask;; i = (i + 1) & mask) {
+            if (!slots[i].load(std::memory_order_relaxed)) {
+                slots[i].store(entry, std::memory_order_release);
+                return;
+            }
+        }
+    }
+};
+
+struct alignas(64) ShardedHashIndex::Shard {
+    static const size_t initialCapacity = 16;
+
+    std::atomic<Table*> table{new Table(initialCapacity)};
+    std::atomic<bool> locked{false};  // Writer spin lock
+    size_t size = 0;                  // Entries in the table, guarded by the lock
+
+    void lock() {
+        if (!locked.exchange(true, std::memory_order_acquire)) {
+            return;
+        }
+        MetricsRegistry::getInstance().add(Counter::LockWaits);
+        ScopedLatency wait(Histogram::LockWaitTime);
+        for (;;) {
+            while (locked.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+            if (!locked.exchange(true, std::memory_order_acquire)) {
+                return;
+            }
+        }
+    }
+
+    void unlock() {
+        locked.store(false, std::memory_order_release);
+    }
+};
+
+ShardedHashIndex::ShardedHashIndex(size_t requestedShards) : shardCount(1), shardBits(0) {
+    while (shardCount < requestedShards) {
+        shardCount <<= 1;
+        ++shardBits;
+    }
+    shards.reset(new Shard[shardCount]);
+}
+
+// No reader may be active when the index itself is destroyed
+ShardedHashIndex::~ShardedHashIndex() {
+    for (size_t s = 0; s < shardCount; ++s) {
+        Table* table = shards[s].table.load();
+        for (size_t i = 0; i < table->capacity; ++i) {
+            delete table->slots[i].load();
+        }
+        delete table;
+    }
+}
+
+// High hash bits pick the shard, low bits the slot inside it
+size_t ShardedHashIndex::shardFor(size_t hash) const {
+    if (shardBits == 0) {
+        return 0;
+    }
+    return hash >> (sizeof(size_t) * 8 - shardBits);
+}
+
+void ShardedHashIndex::addIndexEntry(const std::string& key, int rowId) {
+    EpochGuard guard;
+    size_t hash = std::hash<std::string>()(key);
+    Shard& shard = shards[shardFor(hash)];
+
+    shard.lock();
+    Table* table = shard.table.load(std::memory_order_relaxed);
+    size_t mask = table->capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Entry* existing = table->slots[i].load(std::memory_order_relaxed);
+        if (!existing) {
+            break;
+        }
+        if (existing->hash == hash && existing->key == key) {
+            // Copy-on-write so lock-free readers never see a vector being modified
+            Entry* updated = new Entry(*existing);
+            updated->rowIds.push_back(rowId);
+            table->slots[i].store(updated, std::memory_order_release);
+            shard.unlock();
+            EpochManager::getInstance().retire(const_cast<Entry*>(existing));
+            return;
+        }
+    }
+
+    // Grow this shard alone at 3/4 load; readers keep probing the old table until they leave
+    Table* retiredTable = nullptr;
+    if ((shard.size + 1) * 4 > table->capacity * 3) {
+        Table* grown = new Table(table->capacity * 2);
+        for (size_t i = 0; i < table->capacity; ++i) {
+            const Entry* entry = table->slots[i].load(std::memory_order_relaxed);
+            if (entry) {
+                grown->place(entry);
+            }
+        }
+        shard.table.store(grown, std::memory_order_release);
+        retiredTable = table;
+        table = grown;
+    }
+
+    table->place(new Entry{key, hash, {rowId}});
+    ++shard.size;
+    shard.unlock();
+
+    if (retiredTable) {
+        EpochManager::getInstance().retire(retiredTable);
+    }
+    LOG_DEBUG("Sharded Hash Index: Added entry [" << key << "] -> Row ID: " << rowId);
+}
+
+// Lock-free probe; the caller holds an EpochGuard
+const ShardedHashIndex::Entry* ShardedHashIndex::findEntry(const std::string& key, size_t hash) const {
+    const Table* table = shards[shardFor(hash)].table.load(std::memory_order_acquire);
+    size_t mask = table->capacity - 1;
+    size_t i = hash & mask;
+    for (size_t probes = 0; probes < table->capacity; ++probes, i = (i + 1) & mask) {
+        const Entry* entry = table->slots[i].load(std::memory_order_acquire);
+        if (!entry) {
+            return nullptr;
+        }
+        if (entry->hash == hash && entry->key == key) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<int> ShardedHashIndex::getIndexEntries(const std::string& key) const {
+    EpochGuard guard;
+    const Entry* entry = findEntry(key, std::hash<std::string>()(key));
+    if (entry) {
+        return entry->rowIds;
+    }
+    return {};  // Return empty vector if key not found
+}
+
+bool ShardedHashIndex::hasIndexEntry(const std::string& key) const {
+    EpochGuard guard;
+    return findEntry(key, std::hash<std::string>()(key)) != nullptr;
+}
+
+size_t ShardedHashIndex::getShardCount() const {
+    return shardCount;
+}
+
+size_t ShardedHashIndex::getShardCapacity(size_t shard) const {
+    EpochGuard guard;
+    return shards[shard].table.load(std::memory_order_acquire)->capacity;
+}
+
+// BTreeIndex Implementation (optimistic lock coupling)
+
+// Node header: version word layout is [version:62 | locked:1 | unused:1].
+// Writers set the lock bit with a CAS; unlocking adds 2, which clears the
+// bit and bumps the version so every optimistic reader of the node restarts.
+struct BTreeIndex::Node {
+    std::atomic<uint64_t> version{4};
+    std::atomic<int> count{0};
+    const bool isLeaf;
+
+    explicit Node(bool leaf) : isLeaf(leaf) {}
+
+    uint64_t readLockOrRestart(bool& restart) const {
+        uint64_t current = version.load(std::memory_order_acquire);
+        if (current & 2) {
+            std::this_thread::yield();
+            restart = true;
+        }
+        return current;
+    }
+
+    // Validate that nothing changed since readLockOrRestart()
+    void readUnlockOrRestart(uint64_t start, bool& restart) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (start != version.load(std::memory_order_relaxed)) {
+            restart = true;
+        }
+    }
+
+    void upgradeToWriteLockOrRestart(uint64_t& current, bool& restart) {
+        if (version.compare_exchange_strong(current, current + 2, std::memory_order_acquire)) {
+            current += 2;
+        } else {
+            restart = true;
+        }
+    }
+
+    void writeUnlock() {
+        version.fetch_add(2, std::memory_order_release);
+    }
+
+    // Node size clamped to capacity: optimistic readers may see a torn count
+    int safeCount(int capacity) const {
+        int n = count.load(std::memory_order_relaxed);
+        return n < 0 ? 0 : (n > capacity ? capacity : n);
+    }
+};
+
+struct BTreeIndex::Entry {
+    std::string key;
+    std::vector<int> rowIds;
+};
+
+struct BTreeIndex::LeafNode : Node {
+    static const int capacity = 64;
+    std::atomic<const Entry*> entries[capacity];
+    std::atomic<LeafNode*> next{nullptr};  // B-link right sibling
+
+    LeafNode() : Node(true) {
+        for (auto& entry : entries) {
+            entry.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    // First position whose key is >= key
+    int lowerBound(const std::string& key, bool& restart) const {
+        int low = 0;
+        int high = safeCount(capacity);
+        while (low < high) {
+            int mid = (low + high) / 2;
+            const Entry* entry = entries[mid].load(std::memory_order_acquire);
+            if (!entry) {
+                restart = true;
+                return 0;
+            }
+            if (entry->key < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    // Insert under the write lock; an existing key gets a fresh copy-on-write entry
+    void insert(const std::string& key, int rowId) {
+        bool unused = false;
+        int n = count.load(std::memory_order_relaxed);
+        int pos = lowerBound(key, unused);
+        const Entry* existing = pos < n ? entries[pos].load(std::memory_order_relaxed) : nullptr;
+        if (existing && existing->key == key) {
+            Entry* updated = new Entry(*existing);
+            updated->rowIds.push_back(rowId);
+            entries[pos].store(updated, std::memory_order_release);
+            EpochManager::getInstance().retire(const_cast<Entry*>(existing));
+            return;
+        }
+
+        for (int i = n; i > pos; --i) {
+            entries[i].store(entries[i - 1].load(std::memory_order_relaxed), std::memory_order_release);
+        }
+        entries[pos].store(new Entry{key, {rowId}}, std::memory_order_release);
+        count.store(n + 1, std::memory_order_relaxed);
+    }
+
+    // Move the upper half into a new right sibling; returns it and the separator
+    LeafNode* split(const std::string*& separator) {
+        LeafNode* right = new LeafNode();
+        int n = count.load(std::memory_order_relaxed);
+        int half = n / 2;
+        for (int i = half; i < n; ++i) {
+            right->entries[i - half].store(entries[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        right->count.store(n - half, std::memory_order_relaxed);
+        right->next.store(next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        count.store(half, std::memory_order_relaxed);
+        next.store(right, std::memory_order_release);
+        separator = new std::string(entries[half - 1].load(std::memory_order_relaxed)->key);
+        return right;
+    }
+};
+
+// Inner node: children[i] holds keys <= keys[i], children[count] the rest
+struct BTreeIndex::InnerNode : Node {
+    static const int capacity = 64;
+    std::atomic<const std::string*> keys[capacity];
+    std::atomic<Node*> children[capacity + 1];
+
+    InnerNode() : Node(false) {
+        for (auto& key : keys) {
+            key.store(nullptr, std::memory_order_relaxed);
+        }
+        for (auto& child : children) {
+            child.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    int lowerBound(const std::string& key, bool& restart) const {
+        int low = 0;
+        int high = safeCount(capacity);
+        while (low < high) {
+            int mid = (low + high) / 2;
+            const std::string* separator = keys[mid].load(std::memory_order_acquire);
+            if (!separator) {
+                restart = true;
+                return 0;
+            }
+            if (*separator < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    // Insert a separator and the right half of a split child (node has room)
+    void insert(const std::string* separator, Node* right) {
+        bool unused = false;
+        int n = count.load(std::memory_order_relaxed);
+        int pos = lowerBound(*separator, unused);
+        for (int i = n; i > pos; --i) {
+            keys[i].store(keys[i - 1].load(std::memory_order_relaxed), std::memory_order_release);
+            children[i + 1].store(children[i].load(std::memory_order_relaxed), std::memory_order_release);
+        }
+        keys[pos].store(separator, std::memory_order_release);
+        children[pos + 1].store(right, std::memory_order_release);
+        count.store(n + 1, std::memory_order_relaxed);
+    }
+
+    // The middle key moves up to the parent and is no longer owned here
+    InnerNode* split(const std::string*& separator) {
+        InnerNode* right = new InnerNode();
+        int n = count.load(std::memory_order_relaxed);
+        int half = n / 2;
+        for (int i = half + 1; i < n; ++i) {
+            right->keys[i - half - 1].store(keys[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        for (int i = half + 1; i <= n; ++i) {
+            right->children[i - half - 1].store(children[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        right->count.store(n - half - 1, std::memory_order_relaxed);
+
+        separator = keys[half].load(std::memory_order_relaxed);
+        count.store(half, std::memory_order_relaxed);
+        return right;
+    }
+};
+
+BTreeIndex::BTreeIndex() : root(new LeafNode()) {}
+
+// No reader may be active when the index itself is destroyed
+BTreeIndex::~BTreeIndex() {
+    freeNode(root.load());
+}
+
+void BTreeIndex::freeNode(Node* node) {
+    if (node->isLeaf) {
+        LeafNode* leaf = static_cast<LeafNode*>(node);
+        int n = leaf->count.load();
+        for (int i = 0; i < n; ++i) {
+            delete leaf->entries[i].load();
+        }
+        delete leaf;
+        return;
+    }
+
+    InnerNode* inner = static_cast<InnerNode*>(node);
+    int n = inner->count.load();
+    for (int i = 0; i < n; ++i) {
+        delete inner->keys[i].load();
+    }
+    for (int i = 0; i <= n; ++i) {
+        freeNode(inner->children[i].load());
+    }
+    delete inner;
+}
+
+// Called with the old root write-locked
+void BTreeIndex::makeRoot(const std::string* separator, Node* left, Node* right) {
+    InnerNode* newRoot = new InnerNode();
+    newRoot->keys[0].store(separator, std::memory_order_relaxed);
+    newRoot->children[0].store(left, std::memory_order_relaxed);
+    newRoot->children[1].store(right, std::memory_order_relaxed);
+    newRoot->count.store(1, std::memory_order_relaxed);
+    root.store(newRoot, std::memory_order_release);
+}
+
 void BTreeIndex::addIndexEntry(const std::string& key, int rowId) {
-    indexData[key].push_back(rowId);
-    std::cout << "B-Tree Index: Added entry [" << key << "] -> Row ID: " << rowId << std::endl;
+    EpochGuard guard;
+    while (!tryInsert(key, rowId)) {
+        // Restart from the root after a conflicting write
+        MetricsRegistry::getInstance().add(Counter::IndexRestarts);
+    }
+    LOG_DEBUG("B-Tree Index: Added entry [" << key << "] -> Row ID: " << rowId);
+}
+
+// One optimistic descent; returns false when the caller must restart
+bool BTreeIndex::tryInsert(const std::string& key, int rowId) {
+    bool restart = false;
+    Node* node = root.load(std::memory_order_acquire);
+    uint64_t version = node->readLockOrRestart(restart);
+    if (restart || node != root.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    InnerNode* parent = nullptr;
+    uint64_t parentVersion = 0;
+
+    while (!node->isLeaf) {
+        InnerNode* inner = static_cast<InnerNode*>(node);
+
+        // Split full inner nodes eagerly so a split never has to propagate upwards
+        if (inner->count.load(std::memory_order_relaxed) == InnerNode::capacity) {
+            if (parent) {
+                parent->upgradeToWriteLockOrRestart(parentVersion, restart);
+                if (restart) return false;
+            }
+            inner->upgradeToWriteLockOrRestart(version, restart);
+            if (restart) {
+                if (parent) parent->writeUnlock();
+                return false;
+            }
+            if (!parent && inner != root.load(std::memory_order_acquire)) {
+                inner->writeUnlock();
+                return false;
+            }
+
+            const std::string* separator = nullptr;
+            InnerNode* right = inner->split(separator);
+            if (parent) {
+                parent->insert(separator, right);
+            } else {
+                makeRoot(separator, inner, right);
+            }
+            inner->writeUnlock();
+            if (parent) parent->writeUnlock();
+            return false;
+        }
+
+        if (parent) {
+            parent->readUnlockOrRestart(parentVersion, restart);
+            if (restart) return false;
+        }
+
+        parent = inner;
+        parentVersion = version;
+
+        int pos = inner->lowerBound(key, restart);
+        node = inner->children[pos].load(std::memory_order_acquire);
+        inner->readUnlockOrRestart(version, restart);
+        if (restart || !node) return false;
+        version = node->readLockOrRestart(restart);
+        if (restart) return false;
+    }
+
+    LeafNode* leaf = static_cast<LeafNode*>(node);
+    int n = leaf->count.load(std::memory_order_relaxed);
+    int pos = leaf->lowerBound(key, restart);
+    const Entry* existing = pos < n ? leaf->entries[pos].load(std::memory_order_acquire) : nullptr;
+    bool exists = existing && existing->key == key;
+    leaf->readUnlockOrRestart(version, restart);
+    if (restart) return false;
+
+    if (!exists && n == LeafNode::capacity) {
+        if (parent) {
+            parent->upgradeToWriteLockOrRestart(parentVersion, restart);
+            if (restart) return false;
+        }
+        leaf->upgradeToWriteLockOrRestart(version, restart);
+        if (restart) {
+            if (parent) parent->writeUnlock();
+            return false;
+        }
+        if (!parent && leaf != root.load(std::memory_order_acquire)) {
+            leaf->writeUnlock();
+            return false;
+        }
+
+        const std::string* separator = nullptr;
+        LeafNode* right = leaf->split(separator);
+        if (parent) {
+            parent->insert(separator, right);
+        } else {
+            makeRoot(separator, leaf, right);
+        }
+        leaf->writeUnlock();
+        if (parent) parent->writeUnlock();
+        return false;  // Restart; the key now fits
+    }
+
+    leaf->upgradeToWriteLockOrRestart(version, restart);
+    if (restart) return false;
+    if (parent) {
+        // The leaf must still be the right one: its parent did not split meanwhile
+        parent->readUnlockOrRestart(parentVersion, restart);
+        if (restart) {
+            leaf->writeUnlock();
+            return false;
+        }
+    }
+
+    leaf->insert(key, rowId);
+    leaf->writeUnlock();
+    return true;
 }
 
 std::vector<int> BTreeIndex::getIndexEntries(const std::string& key) const {
-    auto it = indexData.find(key);
-    if (it != indexData.end()) {
-        return it->second;
+    EpochGuard guard;
+    std::vector<int> rowIds;
+    bool found = false;
+    while (!tryLookup(key, rowIds, found)) {
+        rowIds.clear();
+        MetricsRegistry::getInstance().add(Counter::IndexRestarts);
     }
-    return {};  // Return empty vector if key not found
+    return rowIds;
 }
 
 bool BTreeIndex::hasIndexEntry(const std::string& key) const {
-    return indexData.find(key) != indexData.end();
+    EpochGuard guard;
+    std::vector<int> rowIds;
+    bool found = false;
+    while (!tryLookup(key, rowIds, found)) {
+        rowIds.clear();
+        MetricsRegistry::getInstance().add(Counter::IndexRestarts);
+    }
+    return found;
+}
+
+// Optimistic descent to the leaf that holds key. Returns the leaf with the
+// version to validate against, or nullptr when the caller must restart.
+const BTreeIndex::LeafNode* BTreeIndex::findLeaf(const std::string& key, uint64_t& version) const {
+    bool restart = false;
+    Node* node = root.load(std::memory_order_acquire);
+    version = node->readLockOrRestart(restart);
+    if (restart || node != root.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    InnerNode* parent = nullptr;
+    uint64_t parentVersion = 0;
+
+    while (!node->isLeaf) {
+        InnerNode* inner = static_cast<InnerNode*>(node);
+        if (parent) {
+            parent->readUnlockOrRestart(parentVersion, restart);
+            if (restart) return nullptr;
+        }
+
+        parent = inner;
+        parentVersion = version;
+
+        int pos = inner->lowerBound(key, restart);
+        node = inner->children[pos].load(std::memory_order_acquire);
+        inner->readUnlockOrRestart(version, restart);
+        if (restart || !node) return nullptr;
+        version = node->readLockOrRestart(restart);
+        if (restart) return nullptr;
+    }
+
+    if (parent) {
+        parent->readUnlockOrRestart(parentVersion, restart);
+        if (restart) return nullptr;
+    }
+    return static_cast<const LeafNode*>(node);
+}
+
+// Lock-free lookup: validate every node version, restart on any conflict
+bool BTreeIndex::tryLookup(const std::string& key, std::vector<int>& rowIds, bool& found) const {
+    uint64_t version = 0;
+    const LeafNode* leaf = findLeaf(key, version);
+    if (!leaf) {
+        return false;
+    }
+
+    bool restart = false;
+    int n = leaf->safeCount(LeafNode::capacity);
+    int pos = leaf->lowerBound(key, restart);
+    const Entry* entry = pos < n ? leaf->entries[pos].load(std::memory_order_acquire) : nullptr;
+    found = entry && entry->key == key;
+    if (found) {
+        rowIds = entry->rowIds;  // Entries are immutable and protected by the epoch guard
+    }
+
+    leaf->readUnlockOrRestart(version, restart);
+    return !restart;
+}
+
+std::vector<int> BTreeIndex::rangeScan(const std::string& startKey, bool inclusive, size_t maxRows,
+                                       std::vector<std::string>* keys) const {
+    EpochGuard guard;
+    std::vector<int> rowIds;
+    std::string resumeKey = startKey;
+    while (!tryRangeScan(resumeKey, inclusive, maxRows, rowIds, keys)) {
+        // Restart from the last key already returned
+        MetricsRegistry::getInstance().add(Counter::IndexRestarts);
+    }
+    return rowIds;
+}
+
+// B-link scan: each leaf is read optimistically and only its validated
+// entries are emitted; resumeKey/inclusive track the progress so a restart
+// continues after the last emitted key.
+bool BTreeIndex::tryRangeScan(std::string& resumeKey, bool& inclusive, size_t maxRows,
+                              std::vector<int>& rowIds, std::vector<std::string>* keys) const {
+    if (rowIds.size() >= maxRows) {
+        return true;
+    }
+    uint64_t version = 0;
+    const LeafNode* leaf = findLeaf(resumeKey, version);
+    if (!leaf) {
+        return false;
+    }
+
+    std::vector<const Entry*> visible;
+    while (true) {
+        bool restart = false;
+        int n = leaf->safeCount(LeafNode::capacity);
+        int pos = leaf->lowerBound(resumeKey, restart);
+        visible.clear();
+        for (int i = pos; i < n && !restart; ++i) {
+            const Entry* entry = leaf->entries[i].load(std::memory_order_acquire);
+            if (!entry) {
+                restart = true;
+            } else if (inclusive || entry->key != resumeKey) {
+                visible.push_back(entry);
+            }
+        }
+        const LeafNode* next = leaf->next.load(std::memory_order_acquire);
+        leaf->readUnlockOrRestart(version, restart);
+        if (restart) return false;
+
+        for (const Entry* entry : visible) {
+            rowIds.insert(rowIds.end(), entry->rowIds.begin(), entry->rowIds.end());
+            if (keys) {
+                keys->resize(rowIds.size(), entry->key);
+            }
+            resumeKey = entry->key;
+            inclusive = false;
+            if (rowIds.size() >= maxRows) {
+                return true;
+            }
+        }
+        if (!next) {
+            return true;
+        }
+
+        leaf = next;
+        version = leaf->readLockOrRestart(restart);
+        if (restart) return false;
+    }
 }
 
 // Index Class Implementation
@@ -43,17 +699,34 @@ Index::Index(const std::string& columnName, std::unique_ptr<IndexStrategy> strat
     : columnName(columnName), indexStrategy(std::move(strategy)) {}
 
 void Index::addIndexEntry(const std::string& key, int rowId) {
+    TRACE_SPAN("index", "insert");
+    MetricsRegistry::getInstance().add(Counter::IndexInserts);
     indexStrategy->addIndexEntry(key, rowId);
 }
 
 std::vector<int> Index::getIndexEntries(const std::string& key) const {
+    TRACE_SPAN("index", "probe");
+    MetricsRegistry::getInstance().add(Counter::IndexProbes);
     return indexStrategy->getIndexEntries(key);
 }
 
 bool Index::hasIndexEntry(const std::string& key) const {
+    TRACE_SPAN("index", "probe");
+    MetricsRegistry::getInstance().add(Counter::IndexProbes);
     return indexStrategy->hasIndexEntry(key);
 }
 
+bool Index::supportsRangeScan() const {
+    return indexStrategy->supportsRangeScan();
+}
+
+std::vector<int> Index::rangeScan(const std::string& startKey, bool inclusive, size_t maxRows,
+                                  std::vector<std::string>* keys) const {
+    TRACE_SPAN("index", "range scan");
+    MetricsRegistry::getInstance().add(Counter::IndexProbes);
+    return indexStrategy->rangeScan(startKey, inclusive, maxRows, keys);
+}
+
 std::string Index::getColumnName() const {
     return columnName;
 }
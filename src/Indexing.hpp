@@ -5,6 +5,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <atomic>
 
 // Base class for indexing strategies
 class IndexStrategy {
@@ -19,6 +20,15 @@ public:
 
     // Check if an index entry exists
     virtual bool hasIndexEntry(const std::string& key) const = 0;
+
+    // Ordered strategies: row IDs of the keys after startKey (or equal to it
+    // when inclusive) in key order, stopping once maxRows IDs are collected.
+    // With keys, the key of every returned row ID is appended to it.
+    virtual bool supportsRangeScan() const { return false; }
+    virtual std::vector<int> rangeScan(const std::string& /*startKey*/, bool /*inclusive*/, size_t /*maxRows*/,
+                                       std::vector<std::string>* /*keys*/ = nullptr) const {
+        return {};
+    }
 };
 
 // Hash Index Strategy
@@ -32,16 +42,80 @@ private:
     std::unordered_map<std::string, std::vector<int>> indexData;
 };
 
-// B-Tree Index Strategy (simplified version)
+// Sharded Hash Index Strategy: thread-safe variant of HashIndex.
+// Keys are partitioned across a fixed number of shards, each with its own
+// open-addressing table and a small spin lock taken by writers only.
+// Readers are lock-free: they probe the shard's current table under an
+// EpochGuard. A shard that fills up is resized on its own by publishing a
+// larger table; the old table is retired, so readers and the other shards
+// are never stopped for a global rehash.
+class ShardedHashIndex : public IndexStrategy {
+public:
+    explicit ShardedHashIndex(size_t shardCount = 64);
+    ~ShardedHashIndex() override;
+
+    ShardedHashIndex(const ShardedHashIndex&) = delete;
+    ShardedHashIndex& operator=(const ShardedHashIndex&) = delete;
+
+    void addIndexEntry(const std::string& key, int rowId) override;
+    std::vector<int> getIndexEntries(const std::string& key) const override;
+    bool hasIndexEntry(const std::string& key) const override;
+
+    size_t getShardCount() const;
+    size_t getShardCapacity(size_t shard) const;  // Slots in the shard's current table
+
+private:
+    struct Entry;
+    struct Table;
+    struct Shard;
+
+    const Entry* findEntry(const std::string& key, size_t hash) const;
+    size_t shardFor(size_t hash) const;
+
+    std::unique_ptr<Shard[]> shards;
+    size_t shardCount;  // Power of two
+    int shardBits;
+};
+
+// B-Tree Index Strategy: concurrent B+tree with optimistic lock coupling.
+// Every node carries a version counter with a lock bit. Readers never lock:
+// they read a node optimistically and restart if its version changed.
+// Writers lock only the nodes they modify (plus the parent on a split), and
+// leaves are chained through right pointers (B-link) for ordered scans.
+// Entries are immutable; appending a row ID publishes a new entry and
+// retires the old one through the EpochManager.
 class BTreeIndex : public IndexStrategy {
 public:
+    BTreeIndex();
+    ~BTreeIndex() override;
+
+    BTreeIndex(const BTreeIndex&) = delete;
+    BTreeIndex& operator=(const BTreeIndex&) = delete;
+
     void addIndexEntry(const std::string& key, int rowId) override;
     std::vector<int> getIndexEntries(const std::string& key) const override;
     bool hasIndexEntry(const std::string& key) const override;
 
+    // Walks the leaf chain; concurrent inserts may or may not be seen
+    bool supportsRangeScan() const override { return true; }
+    std::vector<int> rangeScan(const std::string& startKey, bool inclusive, size_t maxRows,
+                               std::vector<std::string>* keys = nullptr) const override;
+
 private:
-    // Placeholder for B-tree node structure (simplified)
-    std::unordered_map<std::string, std::vector<int>> indexData;
+    struct Node;
+    struct InnerNode;
+    struct LeafNode;
+    struct Entry;
+
+    bool tryInsert(const std::string& key, int rowId);
+    bool tryLookup(const std::string& key, std::vector<int>& rowIds, bool& found) const;
+    const LeafNode* findLeaf(const std::string& key, uint64_t& version) const;  // Nullptr: restart
+    bool tryRangeScan(std::string& resumeKey, bool& inclusive, size_t maxRows, std::vector<int>& rowIds,
+                      std::vector<std::string>* keys) const;
+    void makeRoot(const std::string* separator, Node* left, Node* right);
+    static void freeNode(Node* node);
+
+    std::atomic<Node*> root;
 };
 
 // Index class that uses different strategies
@@ -59,6 +133,11 @@ public:
     // Check if an index entry exists for the key
     bool hasIndexEntry(const std::string& key) const;
 
+    // Ordered scan from startKey (only if supportsRangeScan())
+    bool supportsRangeScan() const;
+    std::vector<int> rangeScan(const std::string& startKey, bool inclusive, size_t maxRows,
+                               std::vector<std::string>* keys = nullptr) const;
+
     // Get the column name this index is based on
     std::string getColumnName() const;
 
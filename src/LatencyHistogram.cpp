@@ -0,0 +1,144 @@
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace {
+constexpr uint64_t halfBucketCount(int subBucketBits) {
+    return uint64_t(1) << (subBucketBits - 1);
+}
+
+// Position of the highest set bit (value > 0)
+int highestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+    : counts(getBucketCount(), 0), totalCount(0),
+      minValue(std::numeric_limits<uint64_t>::max()), maxValue(0), sum(0) {}
+
+size_t LatencyHistogram::getBucketCount() {
+    return bucketIndex((uint64_t(1) << maxValueBits) - 1) + 1;
+}
+
+uint64_t LatencyHistogram::clampValue(uint64_t value) {
+    return std::min(value, (uint64_t(1) << maxValueBits) - 1);
+}
+
+// Exact below 2^subBucketBits; above, the top subBucketBits bits select the bucket
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < (uint64_t(1) << subBucketBits)) {
+        return static_cast<size_t>(value);
+    }
+    int shift = highestBit(value) - (subBucketBits - 1);
+    return static_cast<size_t>(shift * halfBucketCount(subBucketBits) + (value >> shift));
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < (size_t(1) << subBucketBits)) {
+        return index;
+    }
+    uint64_t shift = index / halfBucketCount(subBucketBits) - 1;
+    uint64_t subBucket = index - shift * halfBucketCount(subBucketBits);
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    record(value, 1);
+}
+
+void LatencyHistogram::record(uint64_t value, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    value = clampValue(value);
+    counts[bucketIndex(value)] += count;
+    totalCount += count;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    sum += static_cast<double>(value) * count;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    totalCount += other.totalCount;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    sum += other.sum;
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    totalCount = 0;
+    minValue = std::numeric_limits<uint64_t>::max();
+    maxValue = 0;
+    sum = 0;
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return totalCount;
+}
+
+uint64_t LatencyHistogram::getMin() const {
+    return totalCount ? minValue : 0;
+}
+
+uint64_t LatencyHistogram::getMax() const {
+    return maxValue;
+}
+
+double LatencyHistogram::getMean() const {
+    return totalCount ? sum / totalCount : 0.0;
+}
+
+uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const {
+    if (totalCount == 0) {
+        return 0;
+    }
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * totalCount + 0.5);
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= target) {
+            return std::min(bucketUpperBound(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+std::string LatencyHistogram::toJson() const {
+    std::ostringstream out;
+    out << "{\"count\": " << totalCount
+        << ", \"min\": " << getMin()
+        << ", \"mean\": " << static_cast<uint64_t>(getMean())
+        << ", \"p50\": " << getValueAtPercentile(50)
+        << ", \"p90\": " << getValueAtPercentile(90)
+        << ", \"p95\": " << getValueAtPercentile(95)
+        << ", \"p99\": " << getValueAtPercentile(99)
+        << ", \"p999\": " << getValueAtPercentile(99.9)
+        << ", \"max\": " << maxValue
+        << ", \"buckets\": [";
+    bool first = true;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i]) {
+            out << (first ? "" : ", ") << "[" << bucketUpperBound(i) << ", " << counts[i] << "]";
+            first = false;
+        }
+    }
+    out << "]}";
+    return out.str();
+}
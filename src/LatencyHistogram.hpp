@@ -0,0 +1,52 @@
+#ifndef LATENCYHISTOGRAM_HPP
+#define LATENCYHISTOGRAM_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// LatencyHistogram: HDR-style log-linear histogram of non-negative values
+// (typically nanoseconds). Values below 256 are counted exactly; above that
+// every power-of-two range is split into 128 linear buckets, so a recorded
+// value is reported within 1% of its true value. Values beyond 2^40 are
+// clamped. Recording is O(1) and allocation-free.
+// Not thread-safe: record into one histogram per thread and merge() them.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(uint64_t value);
+    void record(uint64_t value, uint64_t count);  // count occurrences of value
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t getCount() const;
+    uint64_t getMin() const;
+    uint64_t getMax() const;
+    double getMean() const;
+
+    // Smallest recorded value v such that percentile% of the values are <= v (0-100)
+    uint64_t getValueAtPercentile(double percentile) const;
+
+    // {"count", "min", "mean", "p50", "p90", "p95", "p99", "p999", "max",
+    //  "buckets": [[upper bound, count], ...]} with only non-empty buckets
+    std::string toJson() const;
+
+    // Bucket layout, for recorders that keep their own counts (see Metrics)
+    static size_t getBucketCount();
+    static size_t bucketIndex(uint64_t value);        // value must be below 2^40
+    static uint64_t bucketUpperBound(size_t index);   // Largest value counted in a bucket
+    static uint64_t clampValue(uint64_t value);
+
+private:
+    static constexpr int subBucketBits = 8;
+    static constexpr int maxValueBits = 40;
+
+    std::vector<uint64_t> counts;
+    uint64_t totalCount;
+    uint64_t minValue;
+    uint64_t maxValue;
+    double sum;
+};
+
+#endif // LATENCYHISTOGRAM_HPP
@@ -0,0 +1,225 @@
+#include "Logger.hpp"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+// How often the sink wakes up on its own to drain the rings
+const std::chrono::milliseconds sinkInterval(5);
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info:  return "INFO";
+        case LogLevel::Warn:  return "WARN";
+        case LogLevel::Error: return "ERROR";
+        default:              return "OFF";
+    }
+}
+
+struct Record {
+    static constexpr size_t maxLength = 248;  // Longer messages are truncated
+    LogLevel level;
+    uint32_t length;
+    char text[maxLength];
+};
+
+} // namespace
+
+// Single-producer/single-consumer ring: the owning thread pushes, the sink pops
+class Logger::RingBuffer {
+public:
+    static constexpr size_t capacity = 512;  // Power of two
+
+    bool tryPush(LogLevel level, const std::string& message) {
+        size_t writeIndex = head.load(std::memory_order_relaxed);
+        if (writeIndex - tail.load(std::memory_order_acquire) == capacity) {
+            return false;  // Full
+        }
+
+        Record& record = slots[writeIndex & (capacity - 1)];
+        record.level = level;
+        record.length = static_cast<uint32_t>(std::min(message.size(), Record::maxLength));
+        std::memcpy(record.text, message.data(), record.length);
+        head.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(Record& out) {
+        size_t readIndex = tail.load(std::memory_order_relaxed);
+        if (readIndex == head.load(std::memory_order_acquire)) {
+            return false;  // Empty
+        }
+
+        out = slots[readIndex & (capacity - 1)];
+        tail.store(readIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+    std::atomic<bool> abandoned{false};  // Owning thread has exited
+
+private:
+    Record slots[capacity];
+    alignas(64) std::atomic<size_t> head{0};  // Next slot to write (producer)
+    alignas(64) std::atomic<size_t> tail{0};  // Next slot to read (consumer)
+};
+
+namespace {
+
+// Ties a ring to its thread; the sink frees it once drained after the thread exits
+struct ThreadBufferHolder {
+    std::shared_ptr<Logger::RingBuffer> buffer;
+
+    ~ThreadBufferHolder() {
+        if (buffer) {
+            buffer->abandoned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadBufferHolder threadHolder;
+
+} // namespace
+
+// Constructor: starts the sink thread
+Logger::Logger() : minLevel(static_cast<int>(LogLevel::Info)), dropped(0), stopping(false) {
+    sink = std::thread(&Logger::sinkLoop, this);
+}
+
+// Destructor: stops the sink after a final drain
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    sink.join();
+}
+
+Logger& Logger::getInstance() {
+    static Logger instance;
+    return instance;
+}
+
+Logger::RingBuffer* Logger::threadBuffer() {
+    if (!threadHolder.buffer) {
+        threadHolder.buffer = std::make_shared<RingBuffer>();
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.push_back(threadHolder.buffer);
+    }
+    return threadHolder.buffer.get();
+}
+
+void Logger::log(LogLevel level, const std::string& message) {
+    RingBuffer* buffer = threadBuffer();
+    if (buffer->tryPush(level, message)) {
+        if (level >= LogLevel::Warn) {
+            wake.notify_one();  // Surface problems promptly
+        }
+        return;
+    }
+
+    if (level < LogLevel::Warn) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Warnings and errors are never dropped: wait for the sink to make room
+    do {
+        wake.notify_one();
+        std::this_thread::yield();
+    } while (!buffer->tryPush(level, message));
+}
+
+void Logger::setLevel(LogLevel level) {
+    minLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel Logger::getLevel() const {
+    return static_cast<LogLevel>(minLevel.load(std::memory_order_relaxed));
+}
+
+void Logger::setOutputFile(const std::string& path) {
+    drainAll();  // Earlier messages go to the previous target
+
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    if (outputFile.is_open()) {
+        outputFile.close();
+    }
+    if (!path.empty()) {
+        outputFile.open(path, std::ios::app);
+        if (!outputFile.is_open()) {
+            std::cerr << "Error: Unable to open log file: " << path << std::endl;
+        }
+    }
+}
+
+void Logger::flush() {
+    drainAll();
+}
+
+uint64_t Logger::getDroppedCount() const {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+void Logger::sinkLoop() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (!stopping) {
+        wake.wait_for(lock, sinkInterval);
+        lock.unlock();
+        drainAll();
+        lock.lock();
+    }
+    lock.unlock();
+    drainAll();
+}
+
+// Write out every ring; one flush per pass instead of one per message
+void Logger::drainAll() {
+    std::lock_guard<std::mutex> sinkLock(sinkMutex);
+
+    std::vector<std::shared_ptr<RingBuffer>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        snapshot = buffers;
+    }
+
+    bool wroteOut = false;
+    bool wroteErr = false;
+    Record record;
+    for (const auto& buffer : snapshot) {
+        while (buffer->tryPop(record)) {
+            std::ostream& out = outputFile.is_open() ? static_cast<std::ostream&>(outputFile)
+                              : (record.level >= LogLevel::Warn ? std::cerr : std::cout);
+            out << '[' << levelName(record.level) << "] ";
+            out.write(record.text, record.length);
+            out << '\n';
+            (&out == &std::cerr ? wroteErr : wroteOut) = true;
+        }
+    }
+
+    if (wroteOut) {
+        (outputFile.is_open() ? static_cast<std::ostream&>(outputFile) : std::cout).flush();
+    }
+    if (wroteErr) {
+        std::cerr.flush();
+    }
+
+    // Forget rings whose thread has exited and that are fully drained
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (size_t i = 0; i < buffers.size();) {
+        if (buffers[i]->abandoned.load(std::memory_order_acquire) && buffers[i]->empty()) {
+            buffers[i] = buffers.back();
+            buffers.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
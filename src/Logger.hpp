@@ -0,0 +1,119 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <cstdint>
+
+// Log levels, lowest to highest severity
+enum class LogLevel { Trace = 0, Debug = 1, Info = 2, Warn = 3, Error = 4, Off = 5 };
+
+// Statements below this level are removed at compile time (0 = Trace ... 5 = Off).
+// Hot paths log at Debug/Trace, so the default build carries no cost for them.
+#ifndef DB_LOG_COMPILE_LEVEL
+#define DB_LOG_COMPILE_LEVEL 2
+#endif
+
+// Logger: asynchronous, leveled logging.
+// Each thread formats its message and pushes it into its own lock-free
+// single-producer ring buffer; a background sink thread drains all rings and
+// writes them out in batches. Logging never performs I/O on the caller's
+// thread. If a ring is full, Trace/Debug/Info messages are dropped (and
+// counted) while Warn/Error wait for space.
+class Logger {
+public:
+    static Logger& getInstance();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void log(LogLevel level, const std::string& message);
+
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= minLevel.load(std::memory_order_relaxed);
+    }
+
+    // Runtime level (on top of the compile-time floor)
+    void setLevel(LogLevel level);
+    LogLevel getLevel() const;
+
+    // Write to a file instead of stdout/stderr (empty path restores the console)
+    void setOutputFile(const std::string& path);
+
+    // Block until everything logged so far has been written out
+    void flush();
+
+    uint64_t getDroppedCount() const;
+
+    class RingBuffer;
+
+private:
+    Logger();
+    ~Logger();
+
+    RingBuffer* threadBuffer();
+    void sinkLoop();
+    void drainAll();
+
+    std::atomic<int> minLevel;
+    std::atomic<uint64_t> dropped;
+
+    std::mutex buffersMutex;                           // Guards buffers (registration is rare)
+    std::vector<std::shared_ptr<RingBuffer>> buffers;
+
+    std::mutex sinkMutex;                              // Serializes draining and the output target
+    std::ofstream outputFile;
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping;
+    std::thread sink;
+};
+
+#define DB_LOG(level, expr)                                           \
+    do {                                                              \
+        if (Logger::getInstance().isEnabled(level)) {                 \
+            std::ostringstream dbLogStream;                           \
+            dbLogStream << expr;                                      \
+            Logger::getInstance().log(level, dbLogStream.str());      \
+        }                                                             \
+    } while (0)
+
+#if DB_LOG_COMPILE_LEVEL <= 0
+#define LOG_TRACE(expr) DB_LOG(LogLevel::Trace, expr)
+#else
+#define LOG_TRACE(expr) do {} while (0)
+#endif
+
+#if DB_LOG_COMPILE_LEVEL <= 1
+#define LOG_DEBUG(expr) DB_LOG(LogLevel::Debug, expr)
+#else
+#define LOG_DEBUG(expr) do {} while (0)
+#endif
+
+#if DB_LOG_COMPILE_LEVEL <= 2
+#define LOG_INFO(expr) DB_LOG(LogLevel::Info, expr)
+#else
+#define LOG_INFO(expr) do {} while (0)
+#endif
+
+#if DB_LOG_COMPILE_LEVEL <= 3
+#define LOG_WARN(expr) DB_LOG(LogLevel::Warn, expr)
+#else
+#define LOG_WARN(expr) do {} while (0)
+#endif
+
+#if DB_LOG_COMPILE_LEVEL <= 4
+#define LOG_ERROR(expr) DB_LOG(LogLevel::Error, expr)
+#else
+#define LOG_ERROR(expr) do {} while (0)
+#endif
+
+#endif // LOGGER_HPP
@@ -0,0 +1,88 @@
+#include "MergeJoin.hpp"
+
+MergeJoinNode::MergeJoinNode(std::unique_ptr<PlanNode> left, std::unique_ptr<PlanNode> right, JoinKeys leftColumns,
+                             JoinKeys rightColumns, std::string joinCondition)
+    : leftKeys(std::move(leftColumns)), rightKeys(std::move(rightColumns)), condition(std::move(joinCondition)) {
+    children.push_back(std::move(left));
+    children.push_back(std::move(right));
+}
+
+void MergeJoinNode::openNode() {
+    children[0]->open();
+    children[1]->open();
+    group.clear();
+    groupKey.clear();
+    groupPosition = 0;
+    rightValid = advanceRight();
+}
+
+// Next row of an input whose key has no NULL column (NULL never joins)
+bool MergeJoinNode::advance(size_t input, const JoinKeys& keys, Row& row, std::string& key) {
+    while (children[input]->next(row)) {
+        key.clear();
+        bool hasNull = false;
+        for (size_t i = 0; i < keys.columns.size() && !hasNull; ++i) {
+            const std::string& value = row[keys.columns[i]];
+            hasNull = isNull(value);
+            appendSortKey(value, keys.types[i], false, key);
+        }
+        if (!hasNull) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MergeJoinNode::advanceRight() {
+    return advance(1, rightKeys, rightRow, rightKey);
+}
+
+bool MergeJoinNode::nextRow(Row& row) {
+    while (true) {
+        if (groupPosition < group.size()) {
+            const Row& right = group[groupPosition++];
+            row.clear();
+            row.reserve(leftRow.size() + right.size());
+            row.insert(row.end(), leftRow.begin(), leftRow.end());
+            row.insert(row.end(), right.begin(), right.end());
+            return true;
+        }
+
+        if (!advance(0, leftKeys, leftRow, leftKey)) {
+            return false;
+        }
+        // Left duplicates join the group again
+        if (!group.empty() && leftKey == groupKey) {
+            groupPosition = 0;
+            continue;
+        }
+        group.clear();
+        groupPosition = 0;
+        while (rightValid && rightKey < leftKey) {
+            rightValid = advanceRight();
+        }
+        if (!rightValid) {
+            return false;
+        }
+        if (rightKey != leftKey) {
+            continue;
+        }
+        groupKey = rightKey;
+        while (rightValid && rightKey == groupKey) {
+            group.push_back(std::move(rightRow));
+            rightValid = advanceRight();
+        }
+    }
+}
+
+void MergeJoinNode::closeNode() {
+    children[0]->close();
+    children[1]->close();
+    group.clear();
+    leftRow.clear();
+    rightRow.clear();
+}
+
+std::string MergeJoinNode::describe() const {
+    return "MergeJoin on " + condition;
+}
@@ -0,0 +1,45 @@
+#ifndef MERGEJOIN_HPP
+#define MERGEJOIN_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "HashJoin.hpp"
+#include "ExternalSort.hpp"
+
+// MergeJoinNode: inner equi-join of two inputs that arrive ordered by their
+// join keys (ascending, NULL first, as an ordered B-tree scan or a SortNode
+// delivers them). Both inputs are read once in step; only the right rows
+// sharing the current key are held in memory, so neither side is built into
+// a table. Output rows are the left input's columns followed by the right
+// input's, in join key order.
+class MergeJoinNode : public PlanNode {
+public:
+    MergeJoinNode(std::unique_ptr<PlanNode> left, std::unique_ptr<PlanNode> right, JoinKeys leftKeys,
+                  JoinKeys rightKeys, std::string condition);
+    std::string describe() const override;
+
+protected:
+    void openNode() override;
+    bool nextRow(Row& row) override;
+    void closeNode() override;
+
+private:
+    bool advance(size_t input, const JoinKeys& keys, Row& row, std::string& key);  // Skips NULL keys
+    bool advanceRight();
+
+    JoinKeys leftKeys;
+    JoinKeys rightKeys;
+    std::string condition;  // For describe()
+
+    Row leftRow;
+    std::string leftKey;
+    Row rightRow;                // Right row after the current group
+    std::string rightKey;
+    bool rightValid = false;
+    std::vector<Row> group;      // Right rows whose key is groupKey
+    std::string groupKey;
+    size_t groupPosition = 0;    // Next group row to join with leftRow
+};
+
+#endif // MERGEJOIN_HPP
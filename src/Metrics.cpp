@@ -0,0 +1,104 @@
+#include "Metrics.hpp"
+#include <sstream>
+
+namespace {
+
+// Only the owning thread writes a block, so a plain load/store pair suffices
+void bump(std::atomic<uint64_t>& slot, uint64_t delta) {
+    slot.store(slot.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+const char* counterNames[counterCount] = {
+    "queries_executed", "query_errors", "rows_scanned", "rows_skipped", "rows_returned", "rows_inserted",
+    "rows_updated", "index_probes", "index_inserts", "index_restarts", "transactions_committed",
+    "transactions_rolled_back", "wal_records", "wal_bytes", "wal_fsyncs", "lock_waits", "spill_bytes",
+};
+
+const char* histogramNames[histogramCount] = {"query_latency_ns", "fsync_latency_ns", "lock_wait_ns"};
+
+} // namespace
+
+const char* getCounterName(Counter counter) {
+    return counterNames[static_cast<size_t>(counter)];
+}
+
+const char* getHistogramName(Histogram histogram) {
+    return histogramNames[static_cast<size_t>(histogram)];
+}
+
+uint64_t MetricsSnapshot::getCounter(Counter counter) const {
+    return counters[static_cast<size_t>(counter)];
+}
+
+const LatencyHistogram& MetricsSnapshot::getHistogram(Histogram histogram) const {
+    return histograms[static_cast<size_t>(histogram)];
+}
+
+std::string MetricsSnapshot::toJson() const {
+    std::ostringstream out;
+    out << "{\"counters\": {";
+    for (size_t i = 0; i < counterCount; ++i) {
+        out << (i ? ", " : "") << "\"" << counterNames[i] << "\": " << counters[i];
+    }
+    out << "}, \"histograms\": {";
+    for (size_t i = 0; i < histogramCount; ++i) {
+        out << (i ? ", " : "") << "\"" << histogramNames[i] << "\": " << histograms[i].toJson();
+    }
+    out << "}}";
+    return out.str();
+}
+
+MetricsRegistry::ThreadBlock::ThreadBlock() {
+    for (auto& counter : counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto& histogram : buckets) {
+        histogram.reset(new std::atomic<uint64_t>[LatencyHistogram::getBucketCount()]);
+        for (size_t i = 0; i < LatencyHistogram::getBucketCount(); ++i) {
+            histogram[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+MetricsRegistry::MetricsRegistry() = default;
+
+// Blocks are left allocated: threads that exit after static destruction still release theirs
+MetricsRegistry::~MetricsRegistry() = default;
+
+MetricsRegistry& MetricsRegistry::getInstance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+void MetricsRegistry::add(Counter counter, uint64_t delta) {
+    bump(blocks.local().counters[static_cast<size_t>(counter)], delta);
+}
+
+void MetricsRegistry::record(Histogram histogram, uint64_t nanoseconds) {
+    size_t bucket = LatencyHistogram::bucketIndex(LatencyHistogram::clampValue(nanoseconds));
+    bump(blocks.local().buckets[static_cast<size_t>(histogram)][bucket], 1);
+}
+
+uint64_t MetricsRegistry::threadCounter(Counter counter) {
+    return blocks.local().counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+// Sums every block; bucket counts are reported at the bucket's upper bound
+MetricsSnapshot MetricsRegistry::snapshot() const {
+    MetricsSnapshot result;
+    size_t bucketCount = LatencyHistogram::getBucketCount();
+    for (ThreadBlock* block = blocks.head(); block; block = block->next) {
+        for (size_t i = 0; i < counterCount; ++i) {
+            result.counters[i] += block->counters[i].load(std::memory_order_relaxed);
+        }
+        for (size_t h = 0; h < histogramCount; ++h) {
+            for (size_t i = 0; i < bucketCount; ++i) {
+                uint64_t count = block->buckets[h][i].load(std::memory_order_relaxed);
+                if (count) {
+                    result.histograms[h].record(LatencyHistogram::bucketUpperBound(i), count);
+                }
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,128 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "LatencyHistogram.hpp"
+#include "ThreadBlocks.hpp"
+#include "Trace.hpp"
+
+// Engine counters
+enum class Counter {
+    QueriesExecuted,
+    QueryErrors,
+    RowsScanned,             // Rows read from table storage by scans and index fetches
+    RowsSkipped,             // Rows scans passed over because their block's zone map ruled out the filter
+    RowsReturned,            // Rows in query results
+    RowsInserted,
+    RowsUpdated,
+    IndexProbes,             // Point lookups and range scans on an index
+    IndexInserts,
+    IndexRestarts,           // Optimistic B+tree operations that restarted after a conflict
+    TransactionsCommitted,
+    TransactionsRolledBack,
+    WalRecords,              // Transactions written to the commit log
+    WalBytes,
+    WalFsyncs,
+    LockWaits,               // Lock acquisitions that had to block
+    SpillBytes,              // Bytes written to temporary files by operators over their memory budget
+    Count
+};
+
+// Engine latency histograms (nanoseconds)
+enum class Histogram {
+    QueryLatency,
+    FsyncLatency,
+    LockWaitTime,
+    Count
+};
+
+const size_t counterCount = static_cast<size_t>(Counter::Count);
+const size_t histogramCount = static_cast<size_t>(Histogram::Count);
+
+const char* getCounterName(Counter counter);        // e.g. "rows_scanned"
+const char* getHistogramName(Histogram histogram);  // e.g. "query_latency_ns"
+
+// MetricsSnapshot: the sum over all threads at the time it was taken
+struct MetricsSnapshot {
+    uint64_t counters[counterCount] = {};
+    LatencyHistogram histograms[histogramCount];
+
+    uint64_t getCounter(Counter counter) const;
+    const LatencyHistogram& getHistogram(Histogram histogram) const;
+
+    // {"counters": {name: value, ...}, "histograms": {name: {...}, ...}}
+    std::string toJson() const;
+};
+
+// MetricsRegistry: process-wide counters and latency histograms.
+// Each thread records into its own block with relaxed load/store pairs (no
+// read-modify-write, no lock), so recording costs a few nanoseconds and
+// threads never share a cache line. snapshot() sums the blocks; its values
+// may trail concurrent recording slightly. Blocks of exited threads are
+// reused (see ThreadBlockList), so nothing recorded is lost.
+class MetricsRegistry {
+public:
+    static MetricsRegistry& getInstance();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    void add(Counter counter, uint64_t delta = 1);
+    void record(Histogram histogram, uint64_t nanoseconds);
+
+    MetricsSnapshot snapshot() const;
+
+    // The calling thread's running total (the difference of two reads is the work done in between)
+    uint64_t threadCounter(Counter counter);
+
+private:
+    struct ThreadBlock {
+        ThreadBlock();
+
+        alignas(64) std::atomic<uint64_t> counters[counterCount];
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets[histogramCount];
+        std::atomic<bool> inUse{false};
+        ThreadBlock* next = nullptr;
+    };
+
+    MetricsRegistry();
+    ~MetricsRegistry();
+
+    ThreadBlockList<ThreadBlock> blocks;
+};
+
+// ScopedLatency: records the lifetime of the scope into a histogram
+class ScopedLatency {
+public:
+    explicit ScopedLatency(Histogram target) : histogram(target), start(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        MetricsRegistry::getInstance().record(histogram, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    Histogram histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Acquire a (deferred) lock; a contended acquisition counts as a lock wait and is timed
+template <typename Lock>
+void lockCounted(Lock& lock) {
+    if (lock.try_lock()) {
+        return;
+    }
+    MetricsRegistry::getInstance().add(Counter::LockWaits);
+    ScopedLatency wait(Histogram::LockWaitTime);
+    TRACE_SPAN("lock", "wait");
+    lock.lock();
+}
+
+#endif // METRICS_HPP
@@ -0,0 +1,388 @@
+#include "QueryPlan.hpp"
+#include "Metrics.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+
+static std::string describeFilter(const std::vector<BoundCondition>& filter, const TableSchema& schema) {
+    std::string text;
+    for (const BoundCondition& condition : filter) {
+        text += (text.empty() ? " filter: " : " AND ") + condition.describe(schema);
+    }
+    return text;
+}
+
+// PlanNode Implementation
+void PlanNode::setTimed(bool enabled) {
+    timed = enabled;
+    for (auto& child : children) {
+        child->setTimed(enabled);
+    }
+}
+
+static std::string formatMilliseconds(double nanoseconds) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", nanoseconds / 1e6);
+    return text;
+}
+
+static void explainNode(const PlanNode& node, bool analyze, size_t depth, std::vector<std::string>& lines) {
+    std::string line = depth == 0 ? "" : std::string(depth * 2 - 2, ' ') + "-> ";
+    line += node.describe();
+    if (analyze) {
+        const OperatorStats& stats = node.getStats();
+        line += "  (actual rows=" + std::to_string(stats.rows) + " loops=" + std::to_string(stats.loops) +
+                " time=" + formatMilliseconds(CycleClock::toNanoseconds(stats.ticks)) + " ms";
+        if (stats.rowsRead || stats.indexProbes) {
+            line += " rows read=" + std::to_string(stats.rowsRead);
+        }
+        if (stats.rowsSkipped) {
+            line += " rows skipped=" + std::to_string(stats.rowsSkipped);
+        }
+        if (stats.indexProbes) {
+            line += " index probes=" + std::to_string(stats.indexProbes);
+        }
+        line += ")";
+    }
+    lines.push_back(std::move(line));
+    for (const auto& child : node.getChildren()) {
+        explainNode(*child, analyze, depth + 1, lines);
+    }
+}
+
+std::vector<std::string> explainPlan(const PlanNode& root, bool analyze) {
+    std::vector<std::string> lines;
+    explainNode(root, analyze, 0, lines);
+    return lines;
+}
+
+// ScanNode Implementation
+ScanNode::ScanNode(StorageEngine* storage, std::shared_ptr<const TableSchema> tableSchema,
+                   std::vector<BoundCondition> conditions)
+    : storageEngine(storage), schema(std::move(tableSchema)), currentRowId(-1) {
+    spec.filter = std::move(conditions);
+}
+
+void ScanNode::setProjection(std::vector<int> columns) {
+    spec.allColumns = false;
+    spec.columns = std::move(columns);
+}
+
+// SeqScanNode Implementation
+void SeqScanNode::openNode() {
+    batch.clear();
+    batchRowIds.clear();
+    nextRowId = 0;
+    batchPosition = 0;
+}
+
+bool SeqScanNode::nextRow(Row& row) {
+    while (batchPosition == batch.size()) {
+        batch.clear();
+        batchRowIds.clear();
+        batchPosition = 0;
+        size_t skipped = 0;
+        size_t count = storageEngine->scanRows(schema->name, nextRowId, batchSize, spec, batch, &batchRowIds,
+                                               &skipped);
+        if (count == 0) {
+            return false;
+        }
+        nextRowId += count;
+        recordMorsels(count - skipped, skipped, 0);
+    }
+    currentRowId = batchRowIds[batchPosition];
+    row = std::move(batch[batchPosition++]);
+    return true;
+}
+
+void SeqScanNode::closeNode() {
+    batch.clear();
+    batch.shrink_to_fit();
+    batchRowIds.clear();
+    batchRowIds.shrink_to_fit();
+}
+
+std::string SeqScanNode::describe() const {
+    return "SeqScan on " + schema->name + describeFilter(spec.filter, *schema);
+}
+
+size_t SeqScanNode::scanMorsel(size_t firstRowId, size_t endRowId, std::vector<Row>& rows, std::vector<int>* rowIds,
+                               size_t& rowsSkipped) const {
+    size_t read = 0;
+    size_t start = firstRowId;
+    while (start < endRowId) {
+        size_t count = endRowId - start < batchSize ? endRowId - start : batchSize;
+        size_t skipped = 0;
+        size_t examined = storageEngine->scanRows(schema->name, start, count, spec, rows, rowIds, &skipped);
+        if (examined == 0) {
+            break;
+        }
+        start += examined;
+        read += examined - skipped;
+        rowsSkipped += skipped;
+    }
+    return read;
+}
+
+void SeqScanNode::recordMorsels(uint64_t rowsRead, uint64_t rowsSkipped, uint64_t rowsProduced) {
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    metrics.add(Counter::RowsScanned, rowsRead);
+    metrics.add(Counter::RowsSkipped, rowsSkipped);
+    stats.rowsRead += rowsRead;
+    stats.rowsSkipped += rowsSkipped;
+    stats.rows += rowsProduced;
+}
+
+size_t SeqScanNode::getTableRowCount() const {
+    return storageEngine->getRowCount(schema->name);
+}
+
+// ParallelScanNode Implementation
+ParallelScanNode::ParallelScanNode(StorageEngine* storage, std::shared_ptr<const TableSchema> tableSchema,
+                                   std::vector<BoundCondition> conditions, size_t laneCount)
+    : SeqScanNode(storage, std::move(tableSchema), std::move(conditions)), lanes(laneCount) {}
+
+void ParallelScanNode::openNode() {
+    rowCount = getTableRowCount();
+    nextMorsel = 0;
+    windowRows.clear();
+    windowRowIds.clear();
+    windowIndex = 0;
+    position = 0;
+}
+
+// Scans the next two morsels per lane; false after the last morsel
+bool ParallelScanNode::runWindow() {
+    size_t morselCount = (rowCount + morselRows - 1) / morselRows;
+    if (nextMorsel >= morselCount) {
+        return false;
+    }
+    size_t count = std::min(morselCount - nextMorsel, 2 * lanes);
+    size_t first = nextMorsel;
+    windowRows.assign(count, std::vector<Row>());
+    windowRowIds.assign(count, std::vector<int>());
+    std::vector<size_t> read(count);
+    std::vector<size_t> skipped(count);
+    TaskScheduler::getInstance().run(count, lanes, [&](size_t, size_t morsel) {
+        size_t start = (first + morsel) * morselRows;
+        read[morsel] = scanMorsel(start, std::min(start + morselRows, rowCount), windowRows[morsel],
+                                  &windowRowIds[morsel], skipped[morsel]);
+    });
+    uint64_t rowsRead = 0;
+    uint64_t rowsSkipped = 0;
+    for (size_t morsel = 0; morsel < count; ++morsel) {
+        rowsRead += read[morsel];
+        rowsSkipped += skipped[morsel];
+    }
+    recordMorsels(rowsRead, rowsSkipped, 0);  // Produced rows are counted as next() returns them
+    nextMorsel += count;
+    windowIndex = 0;
+    position = 0;
+    return true;
+}
+
+bool ParallelScanNode::nextRow(Row& row) {
+    while (true) {
+        if (windowIndex < windowRows.size()) {
+            std::vector<Row>& rows = windowRows[windowIndex];
+            if (position < rows.size()) {
+                currentRowId = windowRowIds[windowIndex][position];
+                row = std::move(rows[position++]);
+                return true;
+            }
+            rows = std::vector<Row>();
+            ++windowIndex;
+            position = 0;
+            continue;
+        }
+        if (!runWindow()) {
+            return false;
+        }
+    }
+}
+
+void ParallelScanNode::closeNode() {
+    windowRows.clear();
+    windowRowIds.clear();
+}
+
+std::string ParallelScanNode::describe() const {
+    return "Parallel SeqScan on " + schema->name + " (workers=" + std::to_string(lanes) + ")" +
+           describeFilter(spec.filter, *schema);
+}
+
+// IndexLookupNode Implementation
+IndexLookupNode::IndexLookupNode(StorageEngine* storage, std::shared_ptr<const TableSchema> tableSchema,
+                                 std::vector<BoundCondition> conditions, std::shared_ptr<Index> lookupIndex,
+                                 std::string lookupKey, std::string name)
+    : ScanNode(storage, std::move(tableSchema), std::move(conditions)), index(std::move(lookupIndex)),
+      key(std::move(lookupKey)), indexName(std::move(name)),
+      indexColumn(schema->getColumnIndex(index->getColumnName())) {}
+
+// Row IDs in table order, each once
+void IndexLookupNode::openNode() {
+    rowIds = index->getIndexEntries(key);
+    std::sort(rowIds.begin(), rowIds.end());
+    rowIds.erase(std::unique(rowIds.begin(), rowIds.end()), rowIds.end());
+    ++stats.indexProbes;
+    position = 0;
+}
+
+// Rows are re-checked: an update may have left a stale index entry behind
+bool IndexLookupNode::nextRow(Row& row) {
+    while (position < rowIds.size()) {
+        int rowId = rowIds[position++];
+        MetricsRegistry::getInstance().add(Counter::RowsScanned);
+        ++stats.rowsRead;
+        if (storageEngine->fetchRow(schema->name, rowId, row) &&
+            encodeIndexKey(row[indexColumn], schema->columns[indexColumn].type) == key &&
+            matchesAll(spec.filter, row)) {
+            currentRowId = rowId;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string IndexLookupNode::describe() const {
+    return "IndexLookup on " + schema->name + " using " + indexName + describeFilter(spec.filter, *schema);
+}
+
+// IndexRangeScanNode Implementation
+IndexRangeScanNode::IndexRangeScanNode(StorageEngine* storage, std::shared_ptr<const TableSchema> tableSchema,
+                                       std::vector<BoundCondition> conditions, std::shared_ptr<Index> scanIndex,
+                                       std::string key, bool inclusiveStart, size_t expectedRows, std::string name)
+    : ScanNode(storage, std::move(tableSchema), std::move(conditions)), index(std::move(scanIndex)),
+      startKey(std::move(key)), inclusive(inclusiveStart), requested(expectedRows), indexName(std::move(name)),
+      indexColumn(schema->getColumnIndex(index->getColumnName())) {}
+
+void IndexRangeScanNode::openNode() {
+    rowIds.clear();
+    keys.clear();
+    currentKey.clear();
+    keyRowIds.clear();
+    consumed = 0;
+    position = 0;
+    exhausted = false;
+    rowIds = index->rangeScan(startKey, inclusive, requested, &keys);
+    ++stats.indexProbes;
+    exhausted = rowIds.size() < requested;
+}
+
+// Walk the index again with twice the budget, skipping the IDs already returned
+bool IndexRangeScanNode::fetchMore() {
+    if (exhausted) {
+        return false;
+    }
+    consumed += rowIds.size();
+    requested = requested > std::numeric_limits<size_t>::max() / 2 ? std::numeric_limits<size_t>::max() : requested * 2;
+    std::vector<std::string> moreKeys;
+    std::vector<int> more = index->rangeScan(startKey, inclusive, requested, &moreKeys);
+    ++stats.indexProbes;
+    exhausted = more.size() < requested;
+    if (more.size() <= consumed) {
+        exhausted = true;
+        return false;
+    }
+    rowIds.assign(more.begin() + consumed, more.end());
+    keys.assign(std::make_move_iterator(moreKeys.begin() + consumed), std::make_move_iterator(moreKeys.end()));
+    position = 0;
+    return true;
+}
+
+// A row reached through a stale entry (its indexed value was updated) is
+// skipped; it comes again under its current key, keeping the output ordered.
+// A row listed twice under one key is returned once.
+bool IndexRangeScanNode::nextRow(Row& row) {
+    while (true) {
+        if (position == rowIds.size() && !fetchMore()) {
+            return false;
+        }
+        int rowId = rowIds[position];
+        const std::string& key = keys[position++];
+        if (key != currentKey) {
+            currentKey = key;
+            keyRowIds.clear();
+        }
+        if (!keyRowIds.insert(rowId).second) {
+            continue;
+        }
+        MetricsRegistry::getInstance().add(Counter::RowsScanned);
+        ++stats.rowsRead;
+        if (storageEngine->fetchRow(schema->name, rowId, row) &&
+            encodeIndexKey(row[indexColumn], schema->columns[indexColumn].type) == key &&
+            matchesAll(spec.filter, row)) {
+            currentRowId = rowId;
+            return true;
+        }
+    }
+}
+
+std::string IndexRangeScanNode::describe() const {
+    if (startKey.empty() && inclusive) {
+        return "IndexScan on " + schema->name + " using " + indexName + describeFilter(spec.filter, *schema);
+    }
+    return "IndexRangeScan on " + schema->name + " using " + indexName + describeFilter(spec.filter, *schema);
+}
+
+// LimitNode Implementation
+LimitNode::LimitNode(std::unique_ptr<PlanNode> child, long long rowLimit) : limit(rowLimit) {
+    children.push_back(std::move(child));
+}
+
+void LimitNode::openNode() {
+    produced = 0;
+    children[0]->open();
+}
+
+bool LimitNode::nextRow(Row& row) {
+    if (produced >= limit || !children[0]->next(row)) {
+        return false;
+    }
+    ++produced;
+    return true;
+}
+
+void LimitNode::closeNode() {
+    children[0]->close();
+}
+
+std::string LimitNode::describe() const {
+    return "Limit " + std::to_string(limit);
+}
+
+// ProjectionNode Implementation
+ProjectionNode::ProjectionNode(std::unique_ptr<PlanNode> child, std::vector<int> selected,
+                               std::vector<std::string> columnNames)
+    : columns(std::move(selected)), names(std::move(columnNames)) {
+    children.push_back(std::move(child));
+}
+
+void ProjectionNode::openNode() {
+    children[0]->open();
+}
+
+bool ProjectionNode::nextRow(Row& row) {
+    if (!children[0]->next(input)) {
+        return false;
+    }
+    row.resize(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        row[i] = input[columns[i]];
+    }
+    return true;
+}
+
+void ProjectionNode::closeNode() {
+    children[0]->close();
+}
+
+std::string ProjectionNode::describe() const {
+    std::string text = "Project";
+    for (size_t i = 0; i < names.size(); ++i) {
+        text += (i == 0 ? " " : ", ") + names[i];
+    }
+    return text;
+}
@@ -0,0 +1,240 @@
+#ifndef QUERYPLAN_HPP
+#define QUERYPLAN_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_set>
+#include "TableSchema.hpp"
+#include "SqlParser.hpp"
+#include "StorageEngine.hpp"
+#include "CycleClock.hpp"
+
+// What one operator did during execution (reported by EXPLAIN ANALYZE)
+struct OperatorStats {
+    uint64_t loops = 0;        // Times the operator was opened
+    uint64_t rows = 0;         // Rows produced over all loops
+    uint64_t ticks = 0;        // CycleClock ticks spent in the operator and its children (timed plans only)
+    uint64_t rowsRead = 0;     // Rows read from table storage
+    uint64_t rowsSkipped = 0;  // Rows of blocks a scan skipped by their zone maps
+    uint64_t indexProbes = 0;  // Index lookups and range walks
+};
+
+// PlanNode: pull-based (iterator model) query operator.
+// open() prepares the node, next() produces one row at a time until it
+// returns false, close() releases resources. Subclasses implement
+// openNode/nextRow/closeNode; the public wrappers keep the statistics.
+class PlanNode {
+public:
+    virtual ~PlanNode() = default;
+
+    void open() {
+        ++stats.loops;
+        uint64_t start = timed ? CycleClock::now() : 0;
+        openNode();
+        stats.ticks += timed ? CycleClock::now() - start : 0;
+    }
+
+    bool next(Row& row) {
+        if (!timed) {
+            bool produced = nextRow(row);
+            stats.rows += produced;
+            return produced;
+        }
+        uint64_t start = CycleClock::now();
+        bool produced = nextRow(row);
+        stats.ticks += CycleClock::now() - start;
+        stats.rows += produced;
+        return produced;
+    }
+
+    void close() {
+        uint64_t start = timed ? CycleClock::now() : 0;
+        closeNode();
+        stats.ticks += timed ? CycleClock::now() - start : 0;
+    }
+
+    // One-line description of the operator (used by EXPLAIN)
+    virtual std::string describe() const = 0;
+
+    // Time every call of this node and its children (EXPLAIN ANALYZE)
+    void setTimed(bool enabled);
+    const OperatorStats& getStats() const { return stats; }
+
+    const std::vector<std::unique_ptr<PlanNode>>& getChildren() const { return children; }
+
+protected:
+    virtual void openNode() = 0;
+    virtual bool nextRow(Row& row) = 0;
+    virtual void closeNode() {}
+
+    std::vector<std::unique_ptr<PlanNode>> children;
+    OperatorStats stats;
+    bool timed = false;
+};
+
+// EXPLAIN output: one line per operator, children indented under their parent.
+// With analyze, every line carries the operator's statistics.
+std::vector<std::string> explainPlan(const PlanNode& root, bool analyze);
+
+// ScanNode: leaf operator reading one table; remembers the row ID of the
+// last row it produced so UPDATE can write it back
+class ScanNode : public PlanNode {
+public:
+    ScanNode(StorageEngine* storage, std::shared_ptr<const TableSchema> schema, std::vector<BoundCondition> filter);
+    int getRowId() const { return currentRowId; }
+
+    // Only these columns are used above the scan. Table scans have the storage
+    // layer copy just them; the other columns of the rows produced may be empty.
+    void setProjection(std::vector<int> columns);
+
+protected:
+    StorageEngine* storageEngine;
+    std::shared_ptr<const TableSchema> schema;
+    ScanSpec spec;  // Filter applied to every row read, and the projection
+    int currentRowId;
+};
+
+// Full table scan in batches of rows
+class SeqScanNode : public ScanNode {
+public:
+    using ScanNode::ScanNode;
+    std::string describe() const override;
+
+    // Morsel-driven execution: appends the rows of [firstRowId, endRowId) that
+    // pass the filter, projected (and their row IDs), and returns the rows read.
+    // Rows of blocks skipped by their zone maps are added to rowsSkipped instead.
+    // Safe to call from several threads at once; records no statistics.
+    size_t scanMorsel(size_t firstRowId, size_t endRowId, std::vector<Row>& rows, std::vector<int>* rowIds,
+                      size_t& rowsSkipped) const;
+
+    // Accounts for scanMorsel calls in the statistics, on the calling thread
+    void recordMorsels(uint64_t rowsRead, uint64_t rowsSkipped, uint64_t rowsProduced);
+
+    size_t getTableRowCount() const;
+
+protected:
+    void openNode() override;
+    bool nextRow(Row& row) override;
+    void closeNode() override;
+
+private:
+    static const size_t batchSize = 1024;
+    std::vector<Row> batch;    // Rows of the last storage read that passed the filter
+    std::vector<int> batchRowIds;
+    size_t nextRowId = 0;      // First row ID the next storage read examines
+    size_t batchPosition = 0;
+};
+
+// SeqScan whose morsels are read and filtered on the TaskScheduler's
+// workers, a window of morsels at a time; rows still come out in row ID order
+class ParallelScanNode : public SeqScanNode {
+public:
+    ParallelScanNode(StorageEngine* storage, std::shared_ptr<const TableSchema> schema,
+                     std::vector<BoundCondition> filter, size_t lanes);
+    std::string describe() const override;
+
+protected:
+    void openNode() override;
+    bool nextRow(Row& row) override;
+    void closeNode() override;
+
+private:
+    bool runWindow();
+
+    size_t lanes;              // Morsels scanned at once
+    size_t rowCount = 0;       // Table rows when opened
+    size_t nextMorsel = 0;
+    std::vector<std::vector<Row>> windowRows;  // Filtered rows of each morsel in the window
+    std::vector<std::vector<int>> windowRowIds;
+    size_t windowIndex = 0;
+    size_t position = 0;
+};
+
+// Rows whose indexed column equals a key
+class IndexLookupNode : public ScanNode {
+public:
+    IndexLookupNode(StorageEngine* storage, std::shared_ptr<const TableSchema> schema,
+                    std::vector<BoundCondition> filter, std::shared_ptr<Index> index, std::string key,
+                    std::string indexName);
+    std::string describe() const override;
+
+protected:
+    void openNode() override;
+    bool nextRow(Row& row) override;
+
+private:
+    std::shared_ptr<Index> index;
+    std::string key;         // Encoded index key
+    std::string indexName;
+    int indexColumn;
+    std::vector<int> rowIds;
+    size_t position = 0;
+};
+
+// Rows in index order starting at a key (the whole index from an empty
+// inclusive key); fetches row IDs in growing batches so a LIMIT stops the
+// index walk early. Output is ordered by the indexed column.
+class IndexRangeScanNode : public ScanNode {
+public:
+    IndexRangeScanNode(StorageEngine* storage, std::shared_ptr<const TableSchema> schema,
+                       std::vector<BoundCondition> filter, std::shared_ptr<Index> index, std::string startKey,
+                       bool inclusive, size_t expectedRows, std::string indexName);
+    std::string describe() const override;
+
+protected:
+    void openNode() override;
+    bool nextRow(Row& row) override;
+
+private:
+    bool fetchMore();
+
+    std::shared_ptr<Index> index;
+    std::string startKey;    // Encoded index key
+    bool inclusive;
+    size_t requested;        // Row IDs asked for in the last index walk
+    std::string indexName;
+    int indexColumn;
+    std::vector<int> rowIds;
+    std::vector<std::string> keys;  // Index key each row ID was found under
+    std::string currentKey;         // Key of the last row ID walked
+    std::unordered_set<int> keyRowIds;  // Row IDs walked under currentKey
+    size_t consumed = 0;            // Row IDs of earlier walks, before rowIds[0]
+    size_t position = 0;
+    bool exhausted = false;
+};
+
+// Stops after a number of rows
+class LimitNode : public PlanNode {
+public:
+    LimitNode(std::unique_ptr<PlanNode> child, long long limit);
+    std::string describe() const override;
+
+protected:
+    void openNode() override;
+    bool nextRow(Row& row) override;
+    void closeNode() override;
+
+private:
+    long long limit;
+    long long produced = 0;
+};
+
+// Keeps the selected columns in the requested order
+class ProjectionNode : public PlanNode {
+public:
+    ProjectionNode(std::unique_ptr<PlanNode> child, std::vector<int> columns, std::vector<std::string> names);
+    std::string describe() const override;
+
+protected:
+    void openNode() override;
+    bool nextRow(Row& row) override;
+    void closeNode() override;
+
+private:
+    std::vector<int> columns;
+    std::vector<std::string> names;
+    Row input;
+};
+
+#endif // QUERYPLAN_HPP
@@ -1,32 +1,1058 @@
 #include "QueryProcessor.hpp"
-#include <iostream>
+#include "EpochManager.hpp"
+#include "Metrics.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include "HashJoin.hpp"
+#include "MergeJoin.hpp"
+#include "ExternalSort.hpp"
+#include "HashAggregate.hpp"
+#include "TaskScheduler.hpp"
+#include "TableStatistics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
 
-QueryProcessor::QueryProcessor(StorageEngine* engine) : storageEngine(engine) {}
+QueryProcessor::QueryProcessor(StorageEngine* engine)
+    : storageEngine(engine), parallelism(TaskScheduler::getInstance().getWorkerCount() + 1) {}
 
-void QueryProcessor::executeQuery(const std::string& query) {
-    std::cout << "Executing query: " << query << std::endl;
-    // Basic query routing (for now, assuming SELECT or INSERT)
-    if (query.find("SELECT") != std::string::npos) {
-        executeSelect(query);
-    } else if (query.find("INSERT") != std::string::npos) {
-        executeInsert(query);
+static QueryResult errorResult(const std::string& message) {
+    QueryResult result;
+    result.success = false;
+    result.message = message;
+    LOG_ERROR(message);
+    return result;
+}
+
+// Counts a finished statement (its latency is recorded by the caller's ScopedLatency)
+static QueryResult countResult(QueryResult result) {
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    metrics.add(Counter::QueriesExecuted);
+    metrics.add(result.success ? Counter::RowsReturned : Counter::QueryErrors,
+                result.success ? result.rows.size() : 1);
+    return result;
+}
+
+QueryResult QueryProcessor::executeQuery(const std::string& query) {
+    LOG_DEBUG("Executing query: " << query);
+    ScopedLatency latency(Histogram::QueryLatency);
+    try {
+        std::unique_ptr<Statement> statement = SqlParser::parse(query);
+        return countResult(execute(*statement));
+    } catch (const std::exception& e) {  // Syntax and name errors, failed spill files
+        return countResult(errorResult(e.what()));
+    }
+}
+
+QueryResult QueryProcessor::executeSelect(const std::string& query) {
+    LOG_DEBUG("Executing SELECT query: " << query);
+    ScopedLatency latency(Histogram::QueryLatency);
+    try {
+        std::unique_ptr<Statement> statement = SqlParser::parse(query);
+        if (statement->type != StatementType::Select) {
+            return countResult(errorResult("Not a SELECT statement: " + query));
+        }
+        return countResult(executeSelect(static_cast<const SelectStatement&>(*statement)));
+    } catch (const std::exception& e) {
+        return countResult(errorResult(e.what()));
+    }
+}
+
+QueryResult QueryProcessor::executeInsert(const std::string& query) {
+    LOG_DEBUG("Executing INSERT query: " << query);
+    ScopedLatency latency(Histogram::QueryLatency);
+    try {
+        std::unique_ptr<Statement> statement = SqlParser::parse(query);
+        if (statement->type != StatementType::Insert) {
+            return countResult(errorResult("Not an INSERT statement: " + query));
+        }
+        return countResult(executeInsert(static_cast<const InsertStatement&>(*statement)));
+    } catch (const std::exception& e) {
+        return countResult(errorResult(e.what()));
+    }
+}
+
+ColumnarResult QueryProcessor::executeColumnar(const std::string& query) {
+    LOG_DEBUG("Executing query: " << query);
+    ScopedLatency latency(Histogram::QueryLatency);
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    ColumnarResult columnar;
+    try {
+        std::unique_ptr<Statement> statement = SqlParser::parse(query);
+        if (statement->type == StatementType::Select) {
+            TRACE_SPAN("query", "execute");
+            std::vector<std::string> names;
+            std::vector<ColumnType> types;
+            std::unique_ptr<PlanNode> plan = planSelect(static_cast<const SelectStatement&>(*statement), names, &types);
+            ColumnarBuilder builder(columnar, names, types);
+            plan->open();
+            Row row;
+            while (plan->next(row)) {
+                builder.append(row);
+            }
+            plan->close();
+            metrics.add(Counter::QueriesExecuted);
+            metrics.add(Counter::RowsReturned, columnar.rowCount);
+            return columnar;
+        }
+        QueryResult result = countResult(execute(*statement));
+        columnar.success = result.success;
+        columnar.message = result.message;
+        columnar.affectedRows = result.affectedRows;
+        ColumnarBuilder builder(columnar, result.columns, result.columnTypes);
+        for (const Row& row : result.rows) {
+            builder.append(row);
+        }
+    } catch (const std::exception& e) {
+        QueryResult error = countResult(errorResult(e.what()));
+        columnar.success = false;
+        columnar.message = error.message;
+    }
+    return columnar;
+}
+
+QueryResult QueryProcessor::insertArrow(const std::string& table, ArrowSchema* schema, ArrowArray* array) {
+    LOG_DEBUG("Inserting Arrow batch into " << table);
+    ScopedLatency latency(Histogram::QueryLatency);
+    std::vector<std::string> columns;
+    std::vector<Row> rows;
+    std::string error;
+    bool converted = arrowToRows(schema, array, columns, rows, error);
+    if (array && array->release) {
+        array->release(array);
+    }
+    if (schema && schema->release) {
+        schema->release(schema);
+    }
+    if (!converted) {
+        return countResult(errorResult(error));
+    }
+    return countResult(insertValues(table, columns, std::move(rows)));
+}
+
+QueryResult QueryProcessor::insertRows(const std::string& table, const std::vector<std::string>& columns,
+                                       std::vector<Row> rows) {
+    LOG_DEBUG("Inserting " << rows.size() << " rows into " << table);
+    ScopedLatency latency(Histogram::QueryLatency);
+    return countResult(insertValues(table, columns, std::move(rows)));
+}
+
+QueryResult QueryProcessor::execute(const Statement& statement) {
+    TRACE_SPAN("query", "execute");
+    switch (statement.type) {
+        case StatementType::CreateTable:
+            return executeCreateTable(static_cast<const CreateTableStatement&>(statement));
+        case StatementType::CreateIndex:
+            return executeCreateIndex(static_cast<const CreateIndexStatement&>(statement));
+        case StatementType::Insert:
+            return executeInsert(static_cast<const InsertStatement&>(statement));
+        case StatementType::Select:
+            return executeSelect(static_cast<const SelectStatement&>(statement));
+        case StatementType::Update:
+            return executeUpdate(static_cast<const UpdateStatement&>(statement));
+        case StatementType::Explain:
+            return executeExplain(static_cast<const ExplainStatement&>(statement));
+        case StatementType::Analyze:
+            return executeAnalyze(static_cast<const AnalyzeStatement&>(statement));
+    }
+    return errorResult("Unsupported statement");
+}
+
+QueryResult QueryProcessor::executeCreateTable(const CreateTableStatement& statement) {
+    if (!storageEngine->createTable(statement.schema)) {
+        return errorResult("Table already exists: " + statement.schema.name);
+    }
+    return QueryResult();
+}
+
+// Statistics come from one pass over every row; plans made afterwards use them
+QueryResult QueryProcessor::executeAnalyze(const AnalyzeStatement& statement) {
+    std::vector<std::string> tables = storageEngine->getTableNames();
+    if (!statement.table.empty()) {
+        if (!storageEngine->hasTable(statement.table)) {
+            return errorResult("Unknown table: " + statement.table);
+        }
+        tables = {statement.table};
+    }
+    for (const std::string& table : tables) {
+        std::shared_ptr<const TableSchema> schema = storageEngine->getSchema(table);
+        StatisticsBuilder builder(*schema);
+        std::vector<Row> batch;
+        size_t start = 0;
+        while (storageEngine->readRows(table, start, 4096, batch) > 0) {
+            for (const Row& row : batch) {
+                builder.add(row);
+            }
+            start += batch.size();
+            batch.clear();
+        }
+        storageEngine->setStatistics(table, std::make_shared<const TableStatistics>(builder.finish()));
+    }
+    return QueryResult();
+}
+
+QueryResult QueryProcessor::executeCreateIndex(const CreateIndexStatement& statement) {
+    IndexKind kind = statement.method == "HASH" ? IndexKind::Hash : IndexKind::BTree;
+    if (!storageEngine->createIndex(statement.table, statement.column, kind, statement.indexName)) {
+        return errorResult("Cannot create index " + statement.indexName);
+    }
+    return QueryResult();
+}
+
+// A multi-row INSERT is one batch: a failing row fails the statement and no row is inserted
+QueryResult QueryProcessor::executeInsert(const InsertStatement& statement) {
+    return insertValues(statement.table, statement.columns, statement.rows);
+}
+
+// The whole batch is checked before the first row is stored, so a failing
+// statement inserts nothing
+QueryResult QueryProcessor::insertValues(const std::string& table, const std::vector<std::string>& columns,
+                                         std::vector<Row> values) {
+    std::shared_ptr<const TableSchema> schema = storageEngine->getSchema(table);
+    if (!schema) {
+        return errorResult("Unknown table: " + table);
+    }
+
+    // Position in the table of every value in the statement
+    std::vector<int> targets;
+    if (columns.empty()) {
+        for (size_t i = 0; i < schema->columns.size(); ++i) {
+            targets.push_back(static_cast<int>(i));
+        }
+    } else {
+        for (const std::string& column : columns) {
+            int index = schema->getColumnIndex(column);
+            if (index < 0) {
+                return errorResult("Unknown column " + column + " in table " + table);
+            }
+            targets.push_back(index);
+        }
+    }
+    bool inTableOrder = targets.size() == schema->columns.size();
+    for (size_t i = 0; i < targets.size() && inTableOrder; ++i) {
+        inTableOrder = targets[i] == static_cast<int>(i);
+    }
+
+    // A single-column primary key is unique (checked against the rows holding it now and within the batch).
+    // The key latch is held until the rows are stored, so no other writer takes a key in between.
+    bool uniqueKey = schema->primaryKey.size() == 1;
+    std::unordered_set<std::string> batchKeys;
+    std::shared_ptr<std::mutex> keyLatch = uniqueKey ? storageEngine->getKeyLatch(table) : nullptr;
+    std::unique_lock<std::mutex> keyLock;
+    if (keyLatch) {
+        keyLock = std::unique_lock<std::mutex>(*keyLatch);
+    }
+
+    std::vector<Row> rows;
+    rows.reserve(values.size());
+    for (Row& value : values) {
+        if (value.size() != targets.size()) {
+            return errorResult("Column count doesn't match value count");
+        }
+        if (inTableOrder) {
+            rows.push_back(std::move(value));
+        } else {
+            rows.emplace_back(schema->columns.size(), NULL_VALUE);
+            for (size_t i = 0; i < value.size(); ++i) {
+                rows.back()[targets[i]] = std::move(value[i]);
+            }
+        }
+
+        const Row& row = rows.back();
+        for (size_t i = 0; i < row.size(); ++i) {
+            if (schema->columns[i].notNull && isNull(row[i])) {
+                return errorResult("Column " + schema->columns[i].name + " cannot be null");
+            }
+        }
+        if (uniqueKey) {
+            int key = schema->primaryKey[0];
+            std::string encoded = encodeIndexKey(row[key], schema->columns[key].type);
+            if (!storageEngine->lookupRows(table, key, row[key]).empty() ||
+                (values.size() > 1 && !batchKeys.insert(encoded).second)) {
+                return errorResult("Duplicate entry '" + row[key] + "' for key PRIMARY");
+            }
+        }
+    }
+
+    if (!rows.empty() && storageEngine->insertRows(table, rows) < 0) {
+        return errorResult("Insert failed");
+    }
+    QueryResult result;
+    result.affectedRows = values.size();
+    return result;
+}
+
+namespace {
+
+// Result size of a filtered table: from the ANALYZE statistics if the table has them,
+// otherwise the classic defaults (1/10 for equality and IS NULL, 1/3 for other comparisons)
+double estimateRows(size_t tableRows, const TableSchema& schema, const TableStatistics* statistics,
+                    const std::vector<Condition>& where) {
+    double rows = static_cast<double>(tableRows);
+    for (const Condition& condition : where) {
+        int column = statistics ? schema.getColumnIndex(condition.column.substr(condition.column.find('.') + 1)) : -1;
+        if (column >= 0) {
+            BoundCondition bound;
+            bound.column = column;
+            bound.op = condition.op;
+            bound.value = condition.value;
+            bound.values = condition.values;
+            bound.type = schema.columns[column].type;
+            rows *= statistics->selectivity(bound);
+        } else if (condition.op == CompareOp::Equal || condition.op == CompareOp::IsNull) {
+            rows *= 0.1;
+        } else if (condition.op == CompareOp::In) {
+            rows *= std::min(1.0, 0.1 * static_cast<double>(condition.values.size()));
+        } else if (condition.op == CompareOp::IsNotNull) {
+            rows *= 0.9;
+        } else {
+            rows *= 1.0 / 3;
+        }
+    }
+    return rows;
+}
+
+// Rough memory of that many rows of the table once read (for choosing a join algorithm)
+double estimateBytes(double rows, const TableSchema& schema) {
+    return rows * static_cast<double>(sizeof(Row) + schema.columns.size() * (sizeof(std::string) + 16));
+}
+
+// Access path costs, in rows read by a sequential scan: a row fetched through
+// an index entry is a random access; probing a B-tree walks its height
+const double indexFetchCost = 4;
+
+double indexProbeCost(IndexKind kind, double tableRows) {
+    return kind == IndexKind::Hash ? 1 : std::log2(tableRows + 2);
+}
+
+} // namespace
+
+std::unique_ptr<ScanNode> QueryProcessor::planScan(const std::string& table, const std::vector<Condition>& where,
+                                                   long long limit, int orderColumn, bool* ordered) {
+    EpochGuard guard;
+    const TableInfo* info = storageEngine->getTableInfo(table);
+    if (!info) {
+        throw std::invalid_argument("Unknown table: " + table);
+    }
+    const TableSchema& schema = *info->schema;
+
+    std::vector<BoundCondition> filter;
+    for (const Condition& condition : where) {
+        BoundCondition bound;
+        std::string column = condition.column;
+        if (column.size() > table.size() && column[table.size()] == '.' &&
+            equalsIgnoreCase(column.substr(0, table.size()), table)) {
+            column = column.substr(table.size() + 1);
+        }
+        bound.column = schema.getColumnIndex(column);
+        if (bound.column < 0) {
+            throw std::invalid_argument("Unknown column " + condition.column + " in table " + table);
+        }
+        bound.op = condition.op;
+        bound.value = condition.value;
+        bound.values = condition.values;
+        bound.type = schema.columns[bound.column].type;
+        filter.push_back(bound);
+    }
+
+    // Index keys only order numerically when the literal is a number
+    auto indexKey = [](const BoundCondition& condition, std::string& key) {
+        key = encodeIndexKey(condition.value, condition.type);
+        return !isNull(condition.value) && (!isNumericType(condition.type) || key[0] == '#');
+    };
+
+    // Every condition stays in the filter: index entries can be stale after updates
+    if (ordered) {
+        *ordered = false;
+    }
+    std::string key;
+    auto lookup = [&](const IndexInfo& index) -> std::unique_ptr<ScanNode> {
+        return std::make_unique<IndexLookupNode>(storageEngine, info->schema, filter, index.index, key, index.name);
+    };
+    auto rangeScan = [&](const BoundCondition& condition, const IndexInfo& index) -> std::unique_ptr<ScanNode> {
+        size_t expected = limit >= 0 ? static_cast<size_t>(limit) + 1 : std::numeric_limits<size_t>::max();
+        if (ordered) {
+            *ordered = condition.column == orderColumn;
+        }
+        return std::make_unique<IndexRangeScanNode>(storageEngine, info->schema, filter, index.index, key,
+                                                    condition.op == CompareOp::GreaterEqual, expected, index.name);
+    };
+    auto lowerBound = [](const BoundCondition& condition) {
+        return condition.op == CompareOp::Greater || condition.op == CompareOp::GreaterEqual;
+    };
+    const TableStatistics* statistics = info->statistics.get();
+    const double tableRows = static_cast<double>(storageEngine->getRowCount(table));
+
+    if (statistics) {
+        // Cheapest of the index paths and the full scan. A LIMIT stops a range scan after
+        // that many matches; a full scan is not credited for it, since the matching rows
+        // may all sit at the end of the table.
+        double matching = estimateRows(storageEngine->getRowCount(table), schema, statistics, where);
+        double bestCost = tableRows;
+        const BoundCondition* best = nullptr;
+        const IndexInfo* bestIndex = nullptr;
+        for (const BoundCondition& condition : filter) {
+            const IndexInfo* index = info->findIndex(condition.column);
+            bool usable = index && (condition.op == CompareOp::Equal ||
+                                    (lowerBound(condition) && index->index->supportsRangeScan()));
+            if (!usable || !indexKey(condition, key)) {
+                continue;
+            }
+            double rows = tableRows * statistics->selectivity(condition);
+            if (condition.op != CompareOp::Equal && limit >= 0 && matching > 0) {
+                rows = std::min(rows, static_cast<double>(limit + 1) * rows / matching);
+            }
+            double cost = indexProbeCost(index->kind, tableRows) + rows * indexFetchCost;
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = &condition;
+                bestIndex = index;
+            }
+        }
+        if (best) {
+            indexKey(*best, key);
+            return best->op == CompareOp::Equal ? lookup(*bestIndex) : rangeScan(*best, *bestIndex);
+        }
+    } else {
+        // Without statistics: an equality lookup, else a lower-bound range scan, on the first indexed column
+        for (const BoundCondition& condition : filter) {
+            const IndexInfo* index = info->findIndex(condition.column);
+            if (index && condition.op == CompareOp::Equal && indexKey(condition, key)) {
+                return lookup(*index);
+            }
+        }
+        for (const BoundCondition& condition : filter) {
+            const IndexInfo* index = info->findIndex(condition.column);
+            if (index && lowerBound(condition) && index->index->supportsRangeScan() && indexKey(condition, key)) {
+                return rangeScan(condition, *index);
+            }
+        }
+    }
+
+    // Fetching rows one by one in index order is slower than scanning and sorting
+    // them, unless a LIMIT stops the scan early or the sort would spill
+    const IndexInfo* orderIndex = orderColumn >= 0 ? info->findIndex(orderColumn) : nullptr;
+    bool indexOrder = limit >= 0 || estimateBytes(estimateRows(storageEngine->getRowCount(table), schema, statistics,
+                                                               where),
+                                                  schema) > static_cast<double>(workMemory);
+    if (orderIndex && orderIndex->index->supportsRangeScan() && ordered && indexOrder) {
+        size_t expected = limit >= 0 ? static_cast<size_t>(limit) + 1 : std::numeric_limits<size_t>::max();
+        *ordered = true;
+        return std::make_unique<IndexRangeScanNode>(storageEngine, info->schema, filter, orderIndex->index, "", true,
+                                                    expected, orderIndex->name);
+    }
+
+    // Scans of at least two morsels run on the scheduler's workers; a LIMIT usually stops a scan early
+    if (parallelism > 1 && limit < 0 && tableRows >= 2 * morselRows) {
+        return std::make_unique<ParallelScanNode>(storageEngine, info->schema, filter, parallelism);
+    }
+    return std::make_unique<SeqScanNode>(storageEngine, info->schema, filter);
+}
+
+namespace {
+
+// A table of the FROM clause; its columns start at offset in the joined row
+struct FromTable {
+    std::string name;
+    std::string alias;  // Empty: none
+    std::shared_ptr<const TableSchema> schema;
+    size_t offset = 0;
+    std::shared_ptr<const TableStatistics> statistics;  // Null: not analyzed
+    double estimate = 0;                                // Rows left after its WHERE terms
+
+    const std::string& qualifier() const { return alias.empty() ? name : alias; }
+};
+
+// Columns of two FROM tables an ON clause equates
+struct JoinEdge {
+    size_t leftTable;
+    int leftColumn;
+    size_t rightTable;
+    int rightColumn;
+};
+
+// Joins with more tables keep their FROM order (the search is exponential)
+const size_t maxReorderedTables = 10;
+
+// Result rows of joining leftRows rows with table right over the edges. With statistics
+// on both sides each equated pair keeps 1 / max(distinct values) of the combinations;
+// otherwise assume a foreign-key join, which yields about its larger input.
+double joinRows(const std::vector<FromTable>& tables, double leftRows, size_t right,
+                const std::vector<JoinEdge>& edges) {
+    double rows = leftRows * tables[right].estimate;
+    bool estimated = false;
+    for (const JoinEdge& edge : edges) {
+        const FromTable& left = tables[edge.leftTable];
+        const FromTable& other = tables[edge.rightTable];
+        if (!left.statistics || !other.statistics) {
+            return std::max(leftRows, tables[right].estimate);
+        }
+        rows /= std::max(left.statistics->distinct(edge.leftColumn), other.statistics->distinct(edge.rightColumn));
+        estimated = true;
+    }
+    return estimated ? std::max(1.0, rows) : std::max(leftRows, tables[right].estimate);
+}
+
+// The edges between table and the tables in the subset (a bit mask)
+std::vector<JoinEdge> edgesTo(const std::vector<JoinEdge>& edges, size_t subset, size_t table) {
+    std::vector<JoinEdge> found;
+    for (const JoinEdge& edge : edges) {
+        if ((edge.rightTable == table && (subset >> edge.leftTable & 1)) ||
+            (edge.leftTable == table && (subset >> edge.rightTable & 1))) {
+            found.push_back(edge);
+        }
     }
+    return found;
 }
 
-void QueryProcessor::executeSelect(const std::string& query) {
-    std::cout << "Executing SELECT query: " << query << std::endl;
+// Order of a left-deep join tree. When every table is analyzed, dynamic programming
+// over the subsets of tables finds the order with the least work: each hash join reads
+// both inputs and produces its result, so the cost of an order is the sum of the inputs
+// and results of its joins. Only tables joined to the subset extend it (no cross
+// products). Otherwise, and for two tables, FROM order.
+std::vector<size_t> chooseJoinOrder(const std::vector<FromTable>& tables, const std::vector<JoinEdge>& edges) {
+    std::vector<size_t> order;
+    bool analyzed = tables.size() > 2 && tables.size() <= maxReorderedTables;
+    for (size_t t = 0; t < tables.size(); ++t) {
+        order.push_back(t);
+        analyzed = analyzed && tables[t].statistics;
+    }
+    if (!analyzed) {
+        return order;
+    }
 
-    // Simulate SELECT query (searching an index)
-    std::string column = "name";  // Example column
-    std::string value = "Alice";  // Example value to search
-    auto results = storageEngine->searchIndex(value);
+    struct Plan {
+        double cost = std::numeric_limits<double>::infinity();
+        double rows = 0;
+        std::vector<size_t> order;
+    };
+    std::vector<Plan> best(size_t(1) << tables.size());
+    for (size_t t = 0; t < tables.size(); ++t) {
+        best[size_t(1) << t] = {0, tables[t].estimate, {t}};
+    }
+    for (size_t subset = 1; subset < best.size(); ++subset) {
+        if (std::isinf(best[subset].cost)) {
+            continue;
+        }
+        for (size_t t = 0; t < tables.size(); ++t) {
+            std::vector<JoinEdge> joining = edgesTo(edges, subset, t);
+            if ((subset >> t & 1) || joining.empty()) {
+                continue;
+            }
+            double rows = joinRows(tables, best[subset].rows, t, joining);
+            double cost = best[subset].cost + best[subset].rows + tables[t].estimate + rows;
+            Plan& extended = best[subset | size_t(1) << t];
+            if (cost < extended.cost) {
+                extended = {cost, rows, best[subset].order};
+                extended.order.push_back(t);
+            }
+        }
+    }
+    return best.back().order;
+}
+
+// (table, column) for a possibly qualified column reference; throws for unknown or ambiguous columns
+std::pair<size_t, int> resolveColumn(const std::vector<FromTable>& tables, size_t tableCount,
+                                     const std::string& reference) {
+    size_t dot = reference.find('.');
+    std::string qualifier = dot == std::string::npos ? "" : reference.substr(0, dot);
+    std::string column = dot == std::string::npos ? reference : reference.substr(dot + 1);
+    std::pair<size_t, int> found(0, -1);
+    for (size_t t = 0; t < tableCount; ++t) {
+        int index = tables[t].schema->getColumnIndex(column);
+        if (index < 0 || (!qualifier.empty() && !equalsIgnoreCase(qualifier, tables[t].qualifier()))) {
+            continue;
+        }
+        if (found.second >= 0) {
+            throw std::invalid_argument("Column " + reference + " is ambiguous");
+        }
+        found = {t, index};
+    }
+    if (found.second < 0) {
+        throw std::invalid_argument(tableCount == 1 ? "Unknown column " + reference + " in table " + tables[0].name
+                                                    : "Unknown column " + reference);
+    }
+    return found;
+}
 
-    for (const auto& result : results) {
-        std::cout << "Result: " << result << std::endl;
+// The SELECT item with the given alias, if any (ORDER BY may name one)
+const SelectItem* findAlias(const std::vector<SelectItem>& items, const std::string& name) {
+    for (const SelectItem& item : items) {
+        if (!item.alias.empty() && equalsIgnoreCase(item.alias, name)) {
+            return &item;
+        }
     }
+    return nullptr;
 }
 
-void QueryProcessor::executeInsert(const std::string& query) {
-    std::cout << "Executing INSERT query: " << query << std::endl;
-    storageEngine->storeData(query);  // Simulate insert
+// GROUP BY and aggregates over the joined rows of input: a hash aggregation
+// producing the group columns followed by each distinct aggregate, then
+// ORDER BY, LIMIT and the SELECT list over those rows
+std::unique_ptr<PlanNode> planAggregate(const SelectStatement& select, const std::vector<FromTable>& tables,
+                                        std::unique_ptr<PlanNode> input, size_t workMemory, size_t parallelism,
+                                        std::vector<std::string>& columnNames, std::vector<ColumnType>* columnTypes) {
+    if (select.columns.empty()) {
+        throw std::invalid_argument("SELECT * cannot be used with GROUP BY or aggregates");
+    }
+    auto joinedColumn = [&](const std::string& reference) {
+        auto [table, column] = resolveColumn(tables, tables.size(), reference);
+        return std::make_pair(static_cast<int>(tables[table].offset) + column,
+                              tables[table].schema->columns[column].type);
+    };
+
+    std::vector<int> groupColumns;
+    std::vector<ColumnType> groupTypes;
+    std::string groupText;
+    for (const std::string& reference : select.groupBy) {
+        auto [column, type] = joinedColumn(reference);
+        if (std::find(groupColumns.begin(), groupColumns.end(), column) == groupColumns.end()) {
+            groupColumns.push_back(column);
+            groupTypes.push_back(type);
+            groupText += (groupText.empty() ? " by " : ", ") + reference;
+        }
+    }
+    int groupCount = static_cast<int>(groupColumns.size());
+
+    // Column of the aggregated row for a group column or an aggregate (added on first use)
+    std::vector<AggregateSpec> aggregates;
+    std::string aggregateText;
+    auto outputColumn = [&](const SelectItem& item) {
+        if (item.aggregate == AggregateFunction::None) {
+            auto found = std::find(groupColumns.begin(), groupColumns.end(), joinedColumn(item.column).first);
+            if (found == groupColumns.end()) {
+                throw std::invalid_argument("Column " + item.column + " must appear in GROUP BY or in an aggregate");
+            }
+            return static_cast<int>(found - groupColumns.begin());
+        }
+        AggregateSpec aggregate;
+        aggregate.function = item.aggregate;
+        if (item.column != "*") {
+            std::tie(aggregate.column, aggregate.type) = joinedColumn(item.column);
+            bool arithmetic = item.aggregate == AggregateFunction::Sum || item.aggregate == AggregateFunction::Avg;
+            if (arithmetic && !isNumericType(aggregate.type)) {
+                throw std::invalid_argument(aggregateName(item.aggregate) + " needs a numeric column: " + item.column);
+            }
+        }
+        for (size_t a = 0; a < aggregates.size(); ++a) {
+            if (aggregates[a].function == aggregate.function && aggregates[a].column == aggregate.column) {
+                return groupCount + static_cast<int>(a);
+            }
+        }
+        aggregates.push_back(aggregate);
+        aggregateText += (aggregateText.empty() ? ": " : ", ") + item.text();
+        return groupCount + static_cast<int>(aggregates.size()) - 1;
+    };
+
+    std::vector<int> positions;
+    for (const SelectItem& item : select.columns) {
+        positions.push_back(outputColumn(item));
+    }
+    std::vector<SortKey> sortKeys;
+    std::string sortText;
+    for (const OrderByItem& item : select.orderBy) {
+        SelectItem term{item.column, item.aggregate, ""};
+        const SelectItem* aliased = item.aggregate == AggregateFunction::None ? findAlias(select.columns, item.column)
+                                                                             : nullptr;
+        SortKey key;
+        key.column = aliased ? positions[aliased - select.columns.data()] : outputColumn(term);
+        key.descending = item.descending;
+        sortKeys.push_back(key);
+        sortText += (sortText.empty() ? "" : ", ") + term.text() + (item.descending ? " DESC" : "");
+    }
+    auto typeOf = [&](int column) {
+        return column < groupCount ? groupTypes[column] : aggregateType(aggregates[column - groupCount]);
+    };
+    for (SortKey& key : sortKeys) {
+        key.type = typeOf(key.column);
+    }
+
+    std::unique_ptr<PlanNode> plan =
+        std::make_unique<HashAggregateNode>(std::move(input), groupColumns, groupTypes, aggregates, workMemory,
+                                            parallelism, "HashAggregate" + groupText + aggregateText);
+    if (!sortKeys.empty()) {
+        plan = std::make_unique<SortNode>(std::move(plan), std::move(sortKeys), workMemory, select.limit, sortText);
+    }
+    if (select.limit >= 0) {
+        plan = std::make_unique<LimitNode>(std::move(plan), select.limit);
+    }
+
+    columnNames.clear();
+    if (columnTypes) {
+        columnTypes->clear();
+    }
+    for (size_t i = 0; i < select.columns.size(); ++i) {
+        const SelectItem& item = select.columns[i];
+        std::string name = item.text();
+        if (!item.alias.empty()) {
+            name = item.alias;
+        } else if (item.aggregate == AggregateFunction::None) {
+            auto [table, column] = resolveColumn(tables, tables.size(), item.column);
+            name = tables[table].schema->columns[column].name;
+        }
+        columnNames.push_back(name);
+        if (columnTypes) {
+            columnTypes->push_back(typeOf(positions[i]));
+        }
+    }
+    return std::make_unique<ProjectionNode>(std::move(plan), positions, columnNames);
+}
+
+} // namespace
+
+std::unique_ptr<PlanNode> QueryProcessor::planSelect(const SelectStatement& select,
+                                                     std::vector<std::string>& columnNames,
+                                                     std::vector<ColumnType>* columnTypes) {
+    TRACE_SPAN("query", "plan");
+    std::vector<FromTable> tables;
+    auto addTable = [&](const std::string& name, const std::string& alias) {
+        std::shared_ptr<const TableSchema> schema = storageEngine->getSchema(name);
+        if (!schema) {
+            throw std::invalid_argument("Unknown table: " + name);
+        }
+        FromTable table;
+        table.name = name;
+        table.alias = alias;
+        table.schema = schema;
+        tables.push_back(table);
+    };
+    addTable(select.table, select.alias);
+    for (const JoinClause& join : select.joins) {
+        addTable(join.table, join.alias);
+    }
+
+    // Every WHERE term names one column, so it goes to the scan of that column's table
+    std::vector<std::vector<Condition>> where(tables.size());
+    for (const Condition& condition : select.where) {
+        auto [table, column] = resolveColumn(tables, tables.size(), condition.column);
+        Condition bound = condition;
+        bound.column = tables[table].schema->columns[column].name;
+        where[table].push_back(bound);
+    }
+    for (size_t t = 0; t < tables.size(); ++t) {
+        tables[t].statistics = storageEngine->getStatistics(tables[t].name);
+        tables[t].estimate = estimateRows(storageEngine->getRowCount(tables[t].name), *tables[t].schema,
+                                          tables[t].statistics.get(), where[t]);
+    }
+
+    // Each ON clause compares its table with tables before it in FROM
+    std::vector<JoinEdge> edges;
+    for (size_t i = 1; i < tables.size(); ++i) {
+        const JoinClause& join = select.joins[i - 1];
+        for (const auto& [first, second] : join.on) {
+            std::pair<size_t, int> left = resolveColumn(tables, i + 1, first);
+            std::pair<size_t, int> right = resolveColumn(tables, i + 1, second);
+            if (left.first == i) {
+                std::swap(left, right);
+            }
+            if (left.first == i || right.first != i) {
+                throw std::invalid_argument("JOIN condition " + first + " = " + second + " must compare " +
+                                            join.table + " with an earlier table");
+            }
+            edges.push_back({left.first, left.second, i, right.second});
+        }
+    }
+
+    // The joined row holds the tables' columns in join order
+    std::vector<size_t> order = chooseJoinOrder(tables, edges);
+    size_t offset = 0;
+    for (size_t t : order) {
+        tables[t].offset = offset;
+        offset += tables[t].schema->columns.size();
+    }
+
+    bool aggregating = !select.groupBy.empty();
+    for (const SelectItem& item : select.columns) {
+        aggregating = aggregating || item.aggregate != AggregateFunction::None;
+    }
+    for (const OrderByItem& item : select.orderBy) {
+        aggregating = aggregating || item.aggregate != AggregateFunction::None;
+    }
+
+    // ORDER BY terms over the joined row (aggregate queries sort the aggregated rows instead)
+    std::vector<SortKey> sortKeys;
+    std::string sortText;
+    for (const OrderByItem& item : aggregating ? std::vector<OrderByItem>() : select.orderBy) {
+        const SelectItem* aliased = findAlias(select.columns, item.column);
+        auto [table, column] = resolveColumn(tables, tables.size(), aliased ? aliased->column : item.column);
+        SortKey key;
+        key.column = static_cast<int>(tables[table].offset) + column;
+        key.type = tables[table].schema->columns[column].type;
+        key.descending = item.descending;
+        sortKeys.push_back(key);
+        sortText += (sortText.empty() ? "" : ", ") + item.column + (item.descending ? " DESC" : "");
+    }
+    // Column an ascending single-column ORDER BY wants the output ordered by (-1: none)
+    int orderColumn = sortKeys.size() == 1 && !sortKeys[0].descending ? sortKeys[0].column : -1;
+
+    // Columns read from each table: those selected, grouped, aggregated, sorted or joined on.
+    // WHERE terms are evaluated in storage before the projection, so their columns are not.
+    std::vector<std::vector<bool>> used(tables.size());
+    for (size_t t = 0; t < tables.size(); ++t) {
+        used[t].assign(tables[t].schema->columns.size(), select.columns.empty());
+    }
+    auto use = [&](const std::string& reference) {
+        if (reference != "*") {
+            auto [table, column] = resolveColumn(tables, tables.size(), reference);
+            used[table][column] = true;
+        }
+    };
+    for (const SelectItem& item : select.columns) {
+        use(item.column);
+    }
+    for (const std::string& reference : select.groupBy) {
+        use(reference);
+    }
+    for (const OrderByItem& item : select.orderBy) {
+        const SelectItem* aliased = item.aggregate == AggregateFunction::None ? findAlias(select.columns, item.column)
+                                                                             : nullptr;
+        use(aliased ? aliased->column : item.column);
+    }
+    for (const JoinEdge& edge : edges) {
+        used[edge.leftTable][edge.leftColumn] = true;
+        used[edge.rightTable][edge.rightColumn] = true;
+    }
+    auto scanTable = [&](size_t table, long long limit, int scanOrder, bool* scanOrdered) {
+        std::unique_ptr<ScanNode> scan = planScan(tables[table].name, where[table], limit, scanOrder, scanOrdered);
+        if (!select.columns.empty()) {
+            std::vector<int> columns;
+            for (size_t column = 0; column < used[table].size(); ++column) {
+                if (used[table][column]) {
+                    columns.push_back(static_cast<int>(column));
+                }
+            }
+            scan->setProjection(std::move(columns));
+        }
+        return scan;
+    };
+
+    // Left-deep join tree in join order; each hash join builds on its smaller input.
+    // A single table ordered by an indexed column may be read in index order instead of sorted.
+    bool ordered = false;
+    bool singleTable = tables.size() == 1 && !aggregating;  // LIMIT and ORDER BY apply to the scan itself
+    const FromTable& first = tables[order[0]];
+    std::unique_ptr<PlanNode> plan = scanTable(order[0], singleTable ? select.limit : -1,
+                                               singleTable ? orderColumn : -1, &ordered);
+    double estimate = first.estimate;
+    size_t joined = size_t(1) << order[0];
+    for (size_t step = 1; step < order.size(); ++step) {
+        size_t i = order[step];
+        std::vector<JoinEdge> joining = edgesTo(edges, joined, i);
+        JoinKeys leftKeys;
+        JoinKeys rightKeys;
+        std::string condition;
+        for (const JoinEdge& edge : joining) {
+            bool forward = edge.rightTable == i;
+            size_t leftTable = forward ? edge.leftTable : edge.rightTable;
+            int leftColumn = forward ? edge.leftColumn : edge.rightColumn;
+            int rightColumn = forward ? edge.rightColumn : edge.leftColumn;
+            ColumnType leftType = tables[leftTable].schema->columns[leftColumn].type;
+            ColumnType rightType = tables[i].schema->columns[rightColumn].type;
+            ColumnType type = isNumericType(leftType) && isNumericType(rightType) ? leftType : ColumnType::Text;
+            leftKeys.columns.push_back(static_cast<int>(tables[leftTable].offset) + leftColumn);
+            leftKeys.types.push_back(type);
+            rightKeys.columns.push_back(rightColumn);
+            rightKeys.types.push_back(type);
+            condition += (condition.empty() ? "" : " AND ") + tables[leftTable].qualifier() + "." +
+                         tables[leftTable].schema->columns[leftColumn].name + " = " + tables[i].qualifier() + "." +
+                         tables[i].schema->columns[rightColumn].name;
+        }
+        joined |= size_t(1) << i;
+        double rightEstimate = tables[i].estimate;
+        double resultEstimate = joinRows(tables, estimate, i, joining);
+
+        // Merge join when B-tree indexes deliver both tables in join key order and either
+        // the smaller input would not fit in memory or a LIMIT applies to output ordered by
+        // the key (index order is numeric order only if both key columns are numeric)
+        auto columnType = [&](size_t table, int column) { return tables[table].schema->columns[column].type; };
+        if (step == 1 && joining.size() == 1 &&
+            isNumericType(columnType(order[0], leftKeys.columns[0])) ==
+                isNumericType(columnType(i, rightKeys.columns[0]))) {
+            int rightColumn = static_cast<int>(tables[i].offset) + rightKeys.columns[0];
+            bool orderOnKey = tables.size() == 2 && (orderColumn == leftKeys.columns[0] || orderColumn == rightColumn);
+            long long scanLimit = orderOnKey ? select.limit : -1;
+            bool leftOrdered = false;
+            bool rightOrdered = false;
+            std::unique_ptr<PlanNode> leftScan =
+                scanTable(order[0], scanLimit, leftKeys.columns[0], &leftOrdered);
+            std::unique_ptr<PlanNode> rightScan =
+                scanTable(i, scanLimit, rightKeys.columns[0], &rightOrdered);
+            double smaller = std::min(estimateBytes(estimate, *first.schema),
+                                      estimateBytes(rightEstimate, *tables[i].schema));
+            if (leftOrdered && rightOrdered && (orderOnKey || smaller > static_cast<double>(workMemory))) {
+                plan = std::make_unique<MergeJoinNode>(std::move(leftScan), std::move(rightScan), std::move(leftKeys),
+                                                       std::move(rightKeys), condition);
+                ordered = orderOnKey;
+                estimate = resultEstimate;
+                continue;
+            }
+        }
+
+        ordered = false;
+        std::unique_ptr<PlanNode> right = scanTable(i, -1, -1, nullptr);
+        bool buildLeft = estimate < rightEstimate;
+        if (buildLeft) {
+            plan = std::make_unique<HashJoinNode>(std::move(right), std::move(plan), std::move(rightKeys),
+                                                  std::move(leftKeys), true, workMemory, parallelism, condition);
+        } else {
+            plan = std::make_unique<HashJoinNode>(std::move(plan), std::move(right), std::move(leftKeys),
+                                                  std::move(rightKeys), false, workMemory, parallelism, condition);
+        }
+        estimate = resultEstimate;
+    }
+
+    if (aggregating) {
+        return planAggregate(select, tables, std::move(plan), workMemory, parallelism, columnNames, columnTypes);
+    }
+    if (!sortKeys.empty() && !ordered) {
+        plan = std::make_unique<SortNode>(std::move(plan), std::move(sortKeys), workMemory, select.limit, sortText);
+    }
+    if (select.limit >= 0) {
+        plan = std::make_unique<LimitNode>(std::move(plan), select.limit);
+    }
+
+    columnNames.clear();
+    if (columnTypes) {
+        columnTypes->clear();
+    }
+    if (select.columns.empty()) {
+        std::vector<int> positions;
+        for (const FromTable& table : tables) {
+            for (size_t column = 0; column < table.schema->columns.size(); ++column) {
+                positions.push_back(static_cast<int>(table.offset + column));
+                columnNames.push_back(table.schema->columns[column].name);
+                if (columnTypes) {
+                    columnTypes->push_back(table.schema->columns[column].type);
+                }
+            }
+        }
+        // A reordered join puts the columns back in FROM order
+        if (!std::is_sorted(order.begin(), order.end())) {
+            plan = std::make_unique<ProjectionNode>(std::move(plan), positions, columnNames);
+        }
+        return plan;
+    }
+
+    std::vector<int> positions;
+    for (const SelectItem& item : select.columns) {
+        auto [table, column] = resolveColumn(tables, tables.size(), item.column);
+        const ColumnDef& definition = tables[table].schema->columns[column];
+        positions.push_back(static_cast<int>(tables[table].offset) + column);
+        columnNames.push_back(item.alias.empty() ? definition.name : item.alias);
+        if (columnTypes) {
+            columnTypes->push_back(definition.type);
+        }
+    }
+    return std::make_unique<ProjectionNode>(std::move(plan), positions, columnNames);
+}
+
+QueryResult QueryProcessor::executeSelect(const SelectStatement& statement) {
+    QueryResult result;
+    std::unique_ptr<PlanNode> plan = planSelect(statement, result.columns, &result.columnTypes);
+    plan->open();
+    Row row;
+    while (plan->next(row)) {
+        result.rows.push_back(row);
+    }
+    plan->close();
+    return result;
+}
+
+// EXPLAIN prints the plan; EXPLAIN ANALYZE runs it with every operator timed
+// and discards the rows
+QueryResult QueryProcessor::executeExplain(const ExplainStatement& statement) {
+    const auto& select = static_cast<const SelectStatement&>(*statement.statement);
+    auto planningStart = std::chrono::steady_clock::now();
+    std::vector<std::string> columnNames;
+    std::unique_ptr<PlanNode> plan = planSelect(select, columnNames);
+    auto planningEnd = std::chrono::steady_clock::now();
+
+    size_t produced = 0;
+    if (statement.analyze) {
+        plan->setTimed(true);
+        plan->open();
+        Row row;
+        while (plan->next(row)) {
+            ++produced;
+        }
+        plan->close();
+    }
+    auto executionEnd = std::chrono::steady_clock::now();
+
+    QueryResult result;
+    result.columns = {"QUERY PLAN"};
+    result.columnTypes = {ColumnType::Text};
+    for (std::string& line : explainPlan(*plan, statement.analyze)) {
+        result.rows.push_back({std::move(line)});
+    }
+    if (statement.analyze) {
+        auto milliseconds = [](std::chrono::steady_clock::duration elapsed) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.3f ms", std::chrono::duration<double, std::milli>(elapsed).count());
+            return std::string(text);
+        };
+        result.rows.push_back({"Planning time: " + milliseconds(planningEnd - planningStart)});
+        result.rows.push_back({"Execution time: " + milliseconds(executionEnd - planningEnd)});
+        result.rows.push_back({"Rows: " + std::to_string(produced)});
+    }
+    return result;
+}
+
+// Matching rows are collected first, then updated one by one (each row atomically)
+QueryResult QueryProcessor::executeUpdate(const UpdateStatement& statement) {
+    std::shared_ptr<const TableSchema> schema = storageEngine->getSchema(statement.table);
+    if (!schema) {
+        return errorResult("Unknown table: " + statement.table);
+    }
+
+    ColumnValues values;
+    for (const auto& [column, value] : statement.assignments) {
+        int index = schema->getColumnIndex(column);
+        if (index < 0) {
+            return errorResult("Unknown column " + column + " in table " + statement.table);
+        }
+        if (schema->columns[index].notNull && isNull(value)) {
+            return errorResult("Column " + column + " cannot be null");
+        }
+        values.emplace_back(index, value);
+    }
+
+    std::unique_ptr<ScanNode> scan = planScan(statement.table, statement.where, -1);
+    std::vector<int> rowIds;
+    Row row;
+    scan->open();
+    while (scan->next(row)) {
+        rowIds.push_back(scan->getRowId());
+    }
+    scan->close();
+
+    // A single-column primary key stays unique: one row at most may take the
+    // new key, and only if no other row holds it. The key latch is held until
+    // the rows are written.
+    std::unique_lock<std::mutex> keyLock;
+    for (const auto& [column, value] : values) {
+        if (schema->primaryKey.size() != 1 || column != schema->primaryKey[0] || rowIds.empty()) {
+            continue;
+        }
+        std::shared_ptr<std::mutex> keyLatch = storageEngine->getKeyLatch(statement.table);
+        if (keyLatch && !keyLock.owns_lock()) {
+            keyLock = std::unique_lock<std::mutex>(*keyLatch);
+        }
+        std::vector<int> holders = storageEngine->lookupRows(statement.table, column, value);
+        if (rowIds.size() > 1 || holders.size() > 1 || (holders.size() == 1 && holders[0] != rowIds[0])) {
+            return errorResult("Duplicate entry '" + value + "' for key PRIMARY");
+        }
+    }
+
+    QueryResult result;
+    for (int rowId : rowIds) {
+        if (storageEngine->updateRow(statement.table, rowId, values)) {
+            ++result.affectedRows;
+        }
+    }
+    return result;
 }
@@ -1,17 +1,81 @@
 #ifndef QUERYPROCESSOR_HPP
 #define QUERYPROCESSOR_HPP
 
+#include <string>
+#include <vector>
+#include <memory>
 #include "StorageEngine.hpp"
+#include "SqlParser.hpp"
+#include "QueryPlan.hpp"
+#include "ColumnarResult.hpp"
+#include "ArrowInterface.hpp"
 
+// Outcome of one statement (EXPLAIN returns one "QUERY PLAN" row per line)
+struct QueryResult {
+    bool success = true;
+    std::string message;               // Error description when !success
+    std::vector<std::string> columns;  // SELECT output columns
+    std::vector<ColumnType> columnTypes;
+    std::vector<Row> rows;             // SELECT output rows
+    size_t affectedRows = 0;           // Rows inserted or updated
+};
+
+// QueryProcessor: parses statements, plans them into PlanNode trees and
+// executes them against the storage engine. Errors are reported in the
+// QueryResult, never thrown.
 class QueryProcessor {
 public:
     explicit QueryProcessor(StorageEngine* engine);
-    void executeQuery(const std::string& query);
-    void executeSelect(const std::string& query);
-    void executeInsert(const std::string& query);
+    QueryResult executeQuery(const std::string& query);
+    QueryResult executeSelect(const std::string& query);
+    QueryResult executeInsert(const std::string& query);
+
+    // Like executeQuery, but SELECT rows go straight from the plan into column buffers
+    ColumnarResult executeColumnar(const std::string& query);
+
+    // Bulk insert of an Arrow record batch (a struct array whose children are
+    // named after table columns; missing columns are NULL). Takes ownership of
+    // schema and array and releases them.
+    QueryResult insertArrow(const std::string& table, ArrowSchema* schema, ArrowArray* array);
+
+    // Bulk insert of rows without SQL text. Values are given for the named
+    // columns (all columns in table order if empty). All or nothing, like a
+    // multi-row INSERT.
+    QueryResult insertRows(const std::string& table, const std::vector<std::string>& columns, std::vector<Row> rows);
+
+    // Memory one operator may hold before it spills to temporary files (hash join build side, sort runs)
+    void setWorkMemory(size_t bytes) { workMemory = bytes; }
+    size_t getWorkMemory() const { return workMemory; }
+
+    // Lanes a query may run on at once (scans, aggregation); 1 runs everything on the calling thread
+    void setParallelism(size_t lanes) { parallelism = lanes ? lanes : 1; }
+    size_t getParallelism() const { return parallelism; }
+
+    // Operator tree for a SELECT; throws std::invalid_argument for unknown tables or columns
+    std::unique_ptr<PlanNode> planSelect(const SelectStatement& select, std::vector<std::string>& columnNames,
+                                         std::vector<ColumnType>* columnTypes = nullptr);
 
 private:
+    QueryResult execute(const Statement& statement);
+    QueryResult executeCreateTable(const CreateTableStatement& statement);
+    QueryResult executeCreateIndex(const CreateIndexStatement& statement);
+    QueryResult executeInsert(const InsertStatement& statement);
+    QueryResult insertValues(const std::string& table, const std::vector<std::string>& columns, std::vector<Row> values);
+    QueryResult executeSelect(const SelectStatement& statement);
+    QueryResult executeUpdate(const UpdateStatement& statement);
+    QueryResult executeExplain(const ExplainStatement& statement);
+    QueryResult executeAnalyze(const AnalyzeStatement& statement);
+
+    // Cheapest access path for the WHERE clause: index lookup, index range scan or full scan,
+    // costed from the table's statistics once it is analyzed. Instead of a full scan, an
+    // ordered index scan when output ordered by orderColumn is wanted; ordered tells
+    // whether the rows come out in that order.
+    std::unique_ptr<ScanNode> planScan(const std::string& table, const std::vector<Condition>& where, long long limit,
+                                       int orderColumn = -1, bool* ordered = nullptr);
+
     StorageEngine* storageEngine;
+    size_t workMemory = 64 * 1024 * 1024;
+    size_t parallelism;  // Default: every core (the scheduler's workers and the calling thread)
 };
 
 #endif // QUERYPROCESSOR_HPP
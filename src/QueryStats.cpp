@@ -0,0 +1,303 @@
+#include "QueryStats.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+// ASCII classification (no locale lookups on the statement path)
+static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool isIdentifierChar(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '.' || c == '$' ||
+           static_cast<unsigned char>(c) >= 0x80;
+}
+
+static char toLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Appends tokens with normalized spacing and folds literal-only
+// parenthesized lists as they close
+class FingerprintWriter {
+public:
+    explicit FingerprintWriter(size_t capacity) { text.reserve(capacity); }
+
+    void literal() { append("?", 1); }
+    void token(const char* data, size_t length) {
+        if (length == 1 && data[0] == '(') {
+            groupStart = text.size();
+            append(data, 1);
+            groupLiteralsOnly = true;
+            groupEmpty = true;
+            return;
+        }
+        if (length == 1 && data[0] == ')' && groupStart != std::string::npos && groupLiteralsOnly && !groupEmpty) {
+            // "(?, ?)" becomes "(...)"; a list of them collapses into one
+            text.resize(groupStart);
+            static const char previous[] = "(...),";
+            if (text.size() >= 6 && text.compare(text.size() - 6, 6, previous) == 0) {
+                text.resize(text.size() - 1);
+            } else {
+                append("(...)", 5);
+            }
+            groupStart = std::string::npos;
+            return;
+        }
+        if (!(length == 1 && data[0] == ',')) {
+            groupLiteralsOnly = false;
+        }
+        if (length == 1 && data[0] == ')') {
+            groupStart = std::string::npos;
+        }
+        append(data, length);
+    }
+
+    // Identifier or keyword, lower-cased, without backquotes
+    void word(const char* data, size_t length) {
+        groupLiteralsOnly = false;
+        size_t start = text.size();
+        append(data, length);
+        for (size_t i = start; i < text.size(); ++i) {
+            text[i] = toLower(text[i]);
+        }
+        text.erase(std::remove(text.begin() + start, text.end(), '`'), text.end());
+    }
+
+    char last() const { return text.empty() ? '\0' : text.back(); }
+    std::string take() { return std::move(text); }
+
+private:
+    void append(const char* data, size_t length) {
+        char first = data[0];
+        bool tight = text.empty() || first == ',' || first == ')' || text.back() == '(' ||
+                     (first == '(' && length == 1 && isIdentifierChar(text.back()));
+        if (!tight) {
+            text += ' ';
+        }
+        text.append(data, length);
+        if (!(length == 1 && first == '(')) {
+            groupEmpty = false;
+        }
+    }
+
+    std::string text;
+    size_t groupStart = std::string::npos;  // Text length before the innermost open '(' still eligible for folding
+    bool groupLiteralsOnly = false;
+    bool groupEmpty = true;
+};
+
+std::string fingerprintQuery(const std::string& query) {
+    FingerprintWriter writer(query.size());
+    size_t i = 0;
+    while (i < query.size()) {
+        char c = query[i];
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ';') {
+            ++i;
+        } else if (c == '-' && i + 1 < query.size() && query[i + 1] == '-') {
+            i = query.find('\n', i);
+            i = i == std::string::npos ? query.size() : i;
+        } else if (c == '/' && i + 1 < query.size() && query[i + 1] == '*') {
+            i = query.find("*/", i + 2);
+            i = i == std::string::npos ? query.size() : i + 2;
+        } else if (c == '\'' || c == '"') {
+            // String literal ('' and \' escape a quote)
+            for (++i; i < query.size(); ++i) {
+                if (query[i] == '\\') {
+                    ++i;
+                } else if (query[i] == c) {
+                    if (i + 1 < query.size() && query[i + 1] == c) {
+                        ++i;
+                    } else {
+                        break;
+                    }
+                }
+            }
+            ++i;
+            writer.literal();
+        } else if (isDigit(c) ||
+                   ((c == '-' || c == '.') && i + 1 < query.size() &&
+                    isDigit(query[i + 1]) && !isIdentifierChar(writer.last()))) {
+            // Number (a leading '-' only where no operand precedes it)
+            ++i;
+            while (i < query.size() && (isIdentifierChar(query[i]) ||
+                                        ((query[i] == '+' || query[i] == '-') &&
+                                         (query[i - 1] == 'e' || query[i - 1] == 'E')))) {
+                ++i;
+            }
+            writer.literal();
+        } else if (isIdentifierChar(c) || c == '`') {
+            size_t end = i;
+            while (end < query.size() && (isIdentifierChar(query[end]) || query[end] == '`')) {
+                ++end;
+            }
+            bool null = end - i == 4 && toLower(query[i]) == 'n' && toLower(query[i + 1]) == 'u' &&
+                        toLower(query[i + 2]) == 'l' && toLower(query[i + 3]) == 'l';
+            if (null) {
+                writer.literal();
+            } else {
+                writer.word(query.data() + i, end - i);
+            }
+            i = end;
+        } else if ((c == '<' || c == '>' || c == '!') && i + 1 < query.size() &&
+                   (query[i + 1] == '=' || query[i + 1] == '>')) {
+            writer.token(query.data() + i, 2);
+            i += 2;
+        } else {
+            writer.token(query.data() + i, 1);
+            ++i;
+        }
+    }
+    return writer.take();
+}
+
+// 64-bit FNV-1a
+static uint64_t hashFingerprint(const std::string& fingerprint) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (char c : fingerprint) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return hash ? hash : 1;
+}
+
+static void updateMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+QueryStats::QueryStats(size_t capacity)
+    : dropped(0), slowThresholdNs(std::numeric_limits<uint64_t>::max()) {
+    size_t size = 16;
+    while (size < capacity) {
+        size *= 2;
+    }
+    slots.reset(new Slot[size]);
+    mask = size - 1;
+}
+
+// Linear probing from the hash; the first thread to see a free slot claims it
+QueryStats::Slot* QueryStats::findSlot(uint64_t hash, const std::string& fingerprint) {
+    for (size_t probe = 0; probe < maxProbes; ++probe) {
+        Slot& slot = slots[(hash + probe) & mask];
+        uint64_t current = slot.hash.load(std::memory_order_acquire);
+        if (current == 0) {
+            if (slot.hash.compare_exchange_strong(current, hash, std::memory_order_acq_rel)) {
+                size_t length = std::min(fingerprint.size(), maxFingerprintLength - 1);
+                std::memcpy(slot.fingerprint, fingerprint.data(), length);
+                slot.fingerprint[length] = '\0';
+                slot.ready.store(true, std::memory_order_release);
+                return &slot;
+            }
+        }
+        if (current == hash) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void QueryStats::record(const std::string& query, const QueryExecution& execution) {
+    if (execution.elapsedNs >= slowThresholdNs.load(std::memory_order_relaxed)) {
+        logSlowQuery(query, execution);
+    }
+
+    std::string fingerprint = fingerprintQuery(query);
+    Slot* slot = findSlot(hashFingerprint(fingerprint), fingerprint);
+    if (!slot) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    slot->calls.fetch_add(1, std::memory_order_relaxed);
+    slot->errors.fetch_add(execution.success ? 0 : 1, std::memory_order_relaxed);
+    slot->totalNs.fetch_add(execution.elapsedNs, std::memory_order_relaxed);
+    updateMax(slot->maxNs, execution.elapsedNs);
+    slot->rows.fetch_add(execution.rows, std::memory_order_relaxed);
+    slot->rowsRead.fetch_add(execution.rowsRead, std::memory_order_relaxed);
+    slot->indexProbes.fetch_add(execution.indexProbes, std::memory_order_relaxed);
+}
+
+std::vector<QueryStatsEntry> QueryStats::snapshot() const {
+    std::vector<QueryStatsEntry> entries;
+    for (size_t i = 0; i <= mask; ++i) {
+        const Slot& slot = slots[i];
+        if (!slot.ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+        QueryStatsEntry entry;
+        entry.fingerprint = slot.fingerprint;
+        entry.calls = slot.calls.load(std::memory_order_relaxed);
+        entry.errors = slot.errors.load(std::memory_order_relaxed);
+        entry.totalNs = slot.totalNs.load(std::memory_order_relaxed);
+        entry.maxNs = slot.maxNs.load(std::memory_order_relaxed);
+        entry.rows = slot.rows.load(std::memory_order_relaxed);
+        entry.rowsRead = slot.rowsRead.load(std::memory_order_relaxed);
+        entry.indexProbes = slot.indexProbes.load(std::memory_order_relaxed);
+        if (entry.calls) {
+            entries.push_back(std::move(entry));
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const QueryStatsEntry& a, const QueryStatsEntry& b) {
+        return a.totalNs > b.totalNs;
+    });
+    return entries;
+}
+
+void QueryStats::reset() {
+    for (size_t i = 0; i <= mask; ++i) {
+        Slot& slot = slots[i];
+        for (auto* counter : {&slot.calls, &slot.errors, &slot.totalNs, &slot.maxNs, &slot.rows,
+                              &slot.rowsRead, &slot.indexProbes}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+    dropped.store(0, std::memory_order_relaxed);
+}
+
+uint64_t QueryStats::getDroppedCount() const {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+void QueryStats::setSlowQueryLog(const std::string& path, double thresholdMs) {
+    std::lock_guard<std::mutex> lock(slowLogMutex);
+    slowThresholdNs.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    if (slowLog.is_open()) {
+        slowLog.close();
+    }
+    if (path.empty() || thresholdMs < 0) {
+        return;
+    }
+    slowLog.open(path, std::ios::app);
+    if (!slowLog) {
+        LOG_ERROR("Cannot open slow query log " << path);
+        return;
+    }
+    slowThresholdNs.store(static_cast<uint64_t>(thresholdMs * 1e6), std::memory_order_relaxed);
+}
+
+// One entry per statement, in the style of the MySQL slow query log
+void QueryStats::logSlowQuery(const std::string& query, const QueryExecution& execution) {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+    std::lock_guard<std::mutex> lock(slowLogMutex);
+    if (!slowLog.is_open()) {
+        return;
+    }
+    slowLog << "# Time: " << timestamp << "\n"
+            << "# Query_time: " << execution.elapsedNs / 1e9 << "  Rows: " << execution.rows
+            << "  Rows_read: " << execution.rowsRead << "  Index_probes: " << execution.indexProbes
+            << (execution.success ? "" : "  Error") << "\n"
+            << query << (!query.empty() && query.back() == ';' ? "" : ";") << "\n";
+    slowLog.flush();
+}
@@ -0,0 +1,97 @@
+#ifndef QUERYSTATS_HPP
+#define QUERYSTATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Normalized form of a statement: literals become '?', value lists '(...)',
+// keywords and identifiers are lower-cased and whitespace and comments are
+// collapsed, so "SELECT * FROM t WHERE id = 7" and "select * from t where id=8"
+// share the fingerprint "select * from t where id = ?"
+std::string fingerprintQuery(const std::string& query);
+
+// Aggregated statistics of one fingerprint
+struct QueryStatsEntry {
+    std::string fingerprint;
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+    uint64_t rows = 0;         // Rows returned or affected
+    uint64_t rowsRead = 0;     // Rows read from table storage
+    uint64_t indexProbes = 0;
+
+    double getMeanNs() const { return calls ? static_cast<double>(totalNs) / calls : 0.0; }
+};
+
+// What one execution of a statement cost
+struct QueryExecution {
+    uint64_t elapsedNs = 0;
+    uint64_t rows = 0;
+    uint64_t rowsRead = 0;
+    uint64_t indexProbes = 0;
+    bool success = true;
+};
+
+// QueryStats: per-fingerprint statistics in a fixed-size open-addressing
+// table, plus the slow-query log. Recording is lock-free: a statement claims
+// its slot once with a CAS on the fingerprint hash and then only adds to
+// relaxed atomics. When every slot in a fingerprint's probe window is taken,
+// the execution is counted as dropped instead of evicting an entry.
+// Statements slower than the threshold are appended to the slow-query log.
+class QueryStats {
+public:
+    explicit QueryStats(size_t capacity = 1024);  // Rounded up to a power of two
+
+    QueryStats(const QueryStats&) = delete;
+    QueryStats& operator=(const QueryStats&) = delete;
+
+    void record(const std::string& query, const QueryExecution& execution);
+
+    // All fingerprints, most total time first
+    std::vector<QueryStatsEntry> snapshot() const;
+
+    // Zero the counters (fingerprints keep their slots)
+    void reset();
+
+    uint64_t getDroppedCount() const;
+
+    // Log statements taking at least thresholdMs to path (empty path or a negative threshold turns it off)
+    void setSlowQueryLog(const std::string& path, double thresholdMs);
+
+private:
+    static const size_t maxFingerprintLength = 256;
+    static const size_t maxProbes = 16;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> hash{0};     // 0: free
+        std::atomic<bool> ready{false};    // Fingerprint text is written
+        char fingerprint[maxFingerprintLength];
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint64_t> totalNs{0};
+        std::atomic<uint64_t> maxNs{0};
+        std::atomic<uint64_t> rows{0};
+        std::atomic<uint64_t> rowsRead{0};
+        std::atomic<uint64_t> indexProbes{0};
+    };
+
+    Slot* findSlot(uint64_t hash, const std::string& fingerprint);
+    void logSlowQuery(const std::string& query, const QueryExecution& execution);
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    std::atomic<uint64_t> dropped;
+
+    std::atomic<uint64_t> slowThresholdNs;  // UINT64_MAX: slow-query log off
+    std::mutex slowLogMutex;                // Guards slowLog (slow statements are rare)
+    std::ofstream slowLog;
+};
+
+#endif // QUERYSTATS_HPP
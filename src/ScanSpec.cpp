@@ -0,0 +1,88 @@
+#include "ScanSpec.hpp"
+
+std::string compareOpSymbol(CompareOp op) {
+    switch (op) {
+        case CompareOp::Equal: return "=";
+        case CompareOp::NotEqual: return "!=";
+        case CompareOp::Less: return "<";
+        case CompareOp::LessEqual: return "<=";
+        case CompareOp::Greater: return ">";
+        case CompareOp::GreaterEqual: return ">=";
+        case CompareOp::In: return "IN";
+        case CompareOp::IsNull: return "IS NULL";
+        case CompareOp::IsNotNull: return "IS NOT NULL";
+    }
+    return "?";
+}
+
+// BoundCondition Implementation (comparisons with NULL are never true)
+bool BoundCondition::matchesValue(const std::string& actual) const {
+    if (op == CompareOp::IsNull || op == CompareOp::IsNotNull) {
+        return isNull(actual) == (op == CompareOp::IsNull);
+    }
+    if (op == CompareOp::In) {
+        for (const std::string& candidate : values) {
+            if (!isNull(actual) && !isNull(candidate) && compareValues(actual, candidate, type) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    if (isNull(actual) || isNull(value)) {
+        return false;
+    }
+    int order = compareValues(actual, value, type);
+    switch (op) {
+        case CompareOp::Equal: return order == 0;
+        case CompareOp::NotEqual: return order != 0;
+        case CompareOp::Less: return order < 0;
+        case CompareOp::LessEqual: return order <= 0;
+        case CompareOp::Greater: return order > 0;
+        case CompareOp::GreaterEqual: return order >= 0;
+        default: return false;
+    }
+}
+
+std::string BoundCondition::describe(const TableSchema& schema) const {
+    auto literal = [&](const std::string& text) {
+        return isNull(text) ? "NULL" : (isNumericType(type) ? text : "'" + text + "'");
+    };
+    const std::string& name = schema.columns[column].name;
+    if (op == CompareOp::IsNull || op == CompareOp::IsNotNull) {
+        return name + " " + compareOpSymbol(op);
+    }
+    if (op == CompareOp::In) {
+        std::string list;
+        for (const std::string& candidate : values) {
+            list += (list.empty() ? "" : ", ") + literal(candidate);
+        }
+        return name + " IN (" + list + ")";
+    }
+    return name + " " + compareOpSymbol(op) + " " + literal(value);
+}
+
+bool matchesAll(const std::vector<BoundCondition>& conditions, const Row& row) {
+    for (const BoundCondition& condition : conditions) {
+        if (!condition.matches(row)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ScanSpec Implementation
+bool ScanSpec::project(const Row& row, std::vector<Row>& out) const {
+    if (!matchesAll(filter, row)) {
+        return false;
+    }
+    if (allColumns) {
+        out.push_back(row);
+        return true;
+    }
+    out.emplace_back(row.size());
+    Row& projected = out.back();
+    for (int column : columns) {
+        projected[column] = row[column];
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef SCANSPEC_HPP
+#define SCANSPEC_HPP
+
+#include <string>
+#include <vector>
+#include "TableSchema.hpp"
+
+// Comparison operators usable in WHERE clauses
+enum class CompareOp { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, In, IsNull, IsNotNull };
+
+// Human-readable operator ("=", ">=", "IN", "IS NULL", ...)
+std::string compareOpSymbol(CompareOp op);
+
+// A WHERE term bound to a column position of the input rows
+struct BoundCondition {
+    int column = -1;
+    CompareOp op = CompareOp::Equal;
+    std::string value;
+    std::vector<std::string> values;  // IN list
+    ColumnType type = ColumnType::Text;
+
+    bool matches(const Row& row) const { return matchesValue(row[column]); }
+    bool matchesValue(const std::string& actual) const;
+    std::string describe(const TableSchema& schema) const;
+};
+
+bool matchesAll(const std::vector<BoundCondition>& conditions, const Row& row);
+
+// What a table scan hands back: the rows passing every filter term, with only
+// the listed columns filled in. Both are applied by the storage layer while
+// it reads, so rejected rows and unused columns are never copied. Columns
+// left out stay empty strings; positions within the row do not change.
+struct ScanSpec {
+    std::vector<BoundCondition> filter;
+    bool allColumns = true;
+    std::vector<int> columns;  // Materialized columns unless allColumns
+
+    // Appends row to out if it passes the filter; false if it does not
+    bool project(const Row& row, std::vector<Row>& out) const;
+};
+
+#endif // SCANSPEC_HPP
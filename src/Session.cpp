@@ -0,0 +1,217 @@
+#include "Session.hpp"
+#include "ArrowInterface.hpp"
+#include "Logger.hpp"
+#include "Metrics.hpp"
+#include "Trace.hpp"
+#include <chrono>
+
+// Constructor
+Session::Session(int id, StorageEngine* engine, CommitLog* log, QueryStats* stats)
+    : sessionId(id), storageEngine(engine), commitLog(log), queryStats(stats), queryProcessor(engine), transactionManager(engine, &queryProcessor), transactionActive(false) {
+}
+
+// A future that is already satisfied (nothing to wait for)
+static std::future<void> readyFuture() {
+    std::promise<void> done;
+    done.set_value();
+    return done.get_future();
+}
+
+// Destructor: an open transaction is rolled back when the session goes away
+Session::~Session() {
+    if (transactionActive) {
+        rollbackTransaction();
+    }
+}
+
+// Insert data (buffered until commit while a transaction is active)
+void Session::insertData(const std::string& insertStatement) {
+    if (transactionActive) {
+        LOG_DEBUG("Session " << sessionId << ": buffering change: " << insertStatement);
+        transactionManager.getTransactionData()->addChange(insertStatement);
+        return;
+    }
+
+    LOG_DEBUG("Session " << sessionId << ": inserting data: " << insertStatement);
+    runStatement(insertStatement);
+}
+
+// Execute a query (delegates to this session's QueryProcessor)
+QueryResult Session::executeQuery(const std::string& query) {
+    return runStatement(query);
+}
+
+// Execute a query into column buffers (delegates to this session's QueryProcessor)
+ColumnarResult Session::executeColumnar(const std::string& query) {
+    StatementStart start = queryStats ? beginStatement() : StatementStart();
+    ColumnarResult result = queryProcessor.executeColumnar(query);
+    if (result.success && result.columns.empty()) {
+        logStatement(query);
+    }
+    if (queryStats) {
+        endStatement(query, start, result.rowCount + result.affectedRows, result.success);
+    }
+    return result;
+}
+
+// Arrow batches bypass the transaction buffer. With a commit log the batch is
+// converted here and goes in as a row batch, which logs it.
+QueryResult Session::insertArrow(const std::string& table, ArrowSchema* schema, ArrowArray* array) {
+    LOG_DEBUG("Session " << sessionId << ": inserting Arrow batch into " << table);
+    if (!commitLog) {
+        return queryProcessor.insertArrow(table, schema, array);
+    }
+    std::vector<std::string> columns;
+    std::vector<Row> rows;
+    std::string error;
+    bool converted = arrowToRows(schema, array, columns, rows, error);
+    if (array && array->release) {
+        array->release(array);
+    }
+    if (schema && schema->release) {
+        schema->release(schema);
+    }
+    if (!converted) {
+        LOG_ERROR(error);
+        MetricsRegistry::getInstance().add(Counter::QueriesExecuted);
+        MetricsRegistry::getInstance().add(Counter::QueryErrors);
+        QueryResult result;
+        result.success = false;
+        result.message = error;
+        return result;
+    }
+    return insertRows(table, columns, std::move(rows));
+}
+
+// Row batches bypass the transaction buffer and commit on their own. The log
+// holds SQL text, so a batch is logged as the INSERT that parses back to its rows.
+QueryResult Session::insertRows(const std::string& table, const std::vector<std::string>& columns, std::vector<Row> rows) {
+    LOG_DEBUG("Session " << sessionId << ": inserting " << rows.size() << " rows into " << table);
+    std::string statement = commitLog ? insertText(table, columns, rows) : std::string();
+    QueryResult result = queryProcessor.insertRows(table, columns, std::move(rows));
+    if (result.success) {
+        logStatement(statement);
+    }
+    return result;
+}
+
+QueryResult Session::runStatement(const std::string& query) {
+    StatementStart start = queryStats ? beginStatement() : StatementStart();
+    QueryResult result = queryProcessor.executeQuery(query);
+    if (result.success && result.columns.empty()) {
+        logStatement(query);
+    }
+    if (queryStats) {
+        endStatement(query, start, result.rows.size() + result.affectedRows, result.success);
+    }
+    return result;
+}
+
+// A statement without a result set (INSERT, UPDATE, CREATE, ANALYZE) that
+// succeeded is committed on its own: logged, and durable on return with
+// synchronous commit on
+void Session::logStatement(const std::string& query) {
+    if (commitLog) {
+        commitLog->append({query}).wait();
+    }
+}
+
+// The rows a statement read are this thread's counter growth while it ran
+Session::StatementStart Session::beginStatement() const {
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    return StatementStart{metrics.threadCounter(Counter::RowsScanned), metrics.threadCounter(Counter::IndexProbes),
+                          std::chrono::steady_clock::now()};
+}
+
+void Session::endStatement(const std::string& query, const StatementStart& start, size_t rows, bool success) {
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    QueryExecution execution;
+    execution.elapsedNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start.time).count());
+    execution.rows = rows;
+    execution.rowsRead = metrics.threadCounter(Counter::RowsScanned) - start.rowsRead;
+    execution.indexProbes = metrics.threadCounter(Counter::IndexProbes) - start.indexProbes;
+    execution.success = success;
+    queryStats->record(query, execution);
+}
+
+void Session::setCommitLog(CommitLog* log) {
+    commitLog = log;
+}
+
+void Session::setWorkMemory(size_t bytes) {
+    queryProcessor.setWorkMemory(bytes);
+}
+
+void Session::setParallelism(size_t lanes) {
+    queryProcessor.setParallelism(lanes);
+}
+
+// Start a transaction in this session's transaction context
+void Session::startTransaction() {
+    if (transactionActive) {
+        LOG_WARN("Session " << sessionId << ": transaction already active!");
+        return;
+    }
+
+    LOG_DEBUG("Session " << sessionId << ": starting transaction.");
+    transactionManager.beginTransaction();
+    transactionManager.setState(new ActiveState());
+    transactionManager.setTransactionData(new TransactionData());
+    transactionActive = true;
+}
+
+// Commit the transaction and wait for its acknowledgement
+void Session::commitTransaction() {
+    TRACE_SPAN("txn", "commit");
+    commitAsync().wait();
+}
+
+// Commit the transaction: apply the buffered changes to the shared storage, then
+// append a commit record of the ones that took effect (a failed statement is
+// left out). The caller does not wait for the fsync; the group-commit writer
+// fulfils the future.
+std::future<void> Session::commitAsync() {
+    if (!transactionActive) {
+        LOG_WARN("Session " << sessionId << ": no active transaction to commit!");
+        return readyFuture();
+    }
+
+    LOG_DEBUG("Session " << sessionId << ": committing transaction.");
+    TransactionData* data = transactionManager.getTransactionData();
+    transactionManager.setState(new CommittedState());
+    transactionManager.handleTransaction();
+    std::future<void> durable = (commitLog && data && !data->applied.empty())
+        ? commitLog->append(data->applied)
+        : readyFuture();
+
+    transactionManager.setTransactionData(nullptr);
+    transactionManager.endTransaction();
+    transactionActive = false;
+    MetricsRegistry::getInstance().add(Counter::TransactionsCommitted);
+    return durable;
+}
+
+// Rollback the transaction: buffered changes are discarded
+void Session::rollbackTransaction() {
+    if (!transactionActive) {
+        LOG_WARN("Session " << sessionId << ": no active transaction to roll back!");
+        return;
+    }
+
+    LOG_DEBUG("Session " << sessionId << ": rolling back transaction.");
+    transactionManager.setState(new AbortedState());
+    transactionManager.handleTransaction();
+    transactionManager.setTransactionData(nullptr);
+    transactionManager.endTransaction();
+    transactionActive = false;
+    MetricsRegistry::getInstance().add(Counter::TransactionsRolledBack);
+}
+
+bool Session::inTransaction() const {
+    return transactionActive;
+}
+
+int Session::getId() const {
+    return sessionId;
+}
@@ -0,0 +1,79 @@
+#ifndef SESSION_HPP
+#define SESSION_HPP
+
+#include <string>
+#include <chrono>
+#include <future>
+#include "StorageEngine.hpp"
+#include "CommitLog.hpp"
+#include "QueryProcessor.hpp"
+#include "TransactionManager.hpp"
+#include "QueryStats.hpp"
+
+// Session: a client's connection to the database engine.
+// Every session owns an independent transaction context, while the storage,
+// catalog and indexes are shared between all sessions of the engine.
+// A single session is meant to be driven by one thread at a time; open one
+// session per thread to run work in parallel.
+class Session {
+public:
+    Session(int id, StorageEngine* engine, CommitLog* log = nullptr, QueryStats* stats = nullptr);
+    ~Session();
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    // Data access (buffered in the transaction context while a transaction is active)
+    void insertData(const std::string& insertStatement);
+    // Runs at once, also inside a transaction; a successful statement that changes data is
+    // logged as a transaction of its own
+    QueryResult executeQuery(const std::string& query);
+    ColumnarResult executeColumnar(const std::string& query);  // Same, with the result stored by column
+
+    // Bulk insert of an Arrow record batch, at once (takes ownership of schema and array); logged like insertRows
+    QueryResult insertArrow(const std::string& table, ArrowSchema* schema, ArrowArray* array);
+
+    // Bulk insert of rows for the named columns (all if empty), at once; logged as one INSERT
+    QueryResult insertRows(const std::string& table, const std::vector<std::string>& columns, std::vector<Row> rows);
+
+    // Transaction management for this session only
+    void startTransaction();
+    void commitTransaction();              // Returns once the commit is acknowledged
+    std::future<void> commitAsync();       // Ready when durable (or at once with synchronous commit off)
+    void rollbackTransaction();
+
+    // Commit log for this session's commits (when the log is created after the session)
+    void setCommitLog(CommitLog* log);
+
+    // Memory one query operator may use before spilling to temporary files
+    void setWorkMemory(size_t bytes);
+
+    // Lanes one query may run on at once (1: the session's thread only)
+    void setParallelism(size_t lanes);
+
+    bool inTransaction() const;
+    int getId() const;
+
+private:
+    int sessionId;
+    StorageEngine* storageEngine;             // Shared storage, owned by DatabaseEngine
+    CommitLog* commitLog;                     // Shared commit log (may be null), owned by DatabaseEngine
+    QueryStats* queryStats;                   // Shared statement statistics (may be null), owned by DatabaseEngine
+    QueryProcessor queryProcessor;            // Per-session query processor
+    TransactionManager transactionManager;    // Per-session transaction context
+    bool transactionActive;                   // True between start and commit/rollback
+
+    QueryResult runStatement(const std::string& query);  // Executes and feeds the statement statistics
+    void logStatement(const std::string& query);         // Autocommit of a statement that changed data
+
+    // Work counters at the start of a statement (for the statement statistics)
+    struct StatementStart {
+        uint64_t rowsRead;
+        uint64_t indexProbes;
+        std::chrono::steady_clock::time_point time;
+    };
+    StatementStart beginStatement() const;
+    void endStatement(const std::string& query, const StatementStart& start, size_t rows, bool success);
+};
+
+#endif // SESSION_HPP
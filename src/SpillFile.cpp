@@ -0,0 +1,75 @@
+#include "SpillFile.hpp"
+#include "Metrics.hpp"
+#include <cstdint>
+#include <stdexcept>
+
+// Values are written as a 32-bit length and the bytes; NULL has a length of ~0
+static const uint32_t nullLength = 0xFFFFFFFF;
+
+SpillFile::SpillFile() : file(std::tmpfile()) {
+    if (!file) {
+        throw std::runtime_error("Cannot create a temporary file for spilling");
+    }
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 16);
+}
+
+SpillFile::~SpillFile() {
+    std::fclose(file);
+}
+
+void SpillFile::write(const Row& row) {
+    uint32_t count = static_cast<uint32_t>(row.size());
+    std::fwrite(&count, sizeof(count), 1, file);
+    size_t written = sizeof(count);
+    for (const std::string& value : row) {
+        uint32_t length = isNull(value) ? nullLength : static_cast<uint32_t>(value.size());
+        std::fwrite(&length, sizeof(length), 1, file);
+        written += sizeof(length);
+        if (length != nullLength) {
+            std::fwrite(value.data(), 1, value.size(), file);
+            written += value.size();
+        }
+    }
+    if (std::ferror(file)) {
+        throw std::runtime_error("Cannot write to a spill file");
+    }
+    ++rowCount;
+    bytes += written;
+    MetricsRegistry::getInstance().add(Counter::SpillBytes, written);
+}
+
+void SpillFile::rewind() {
+    std::fflush(file);
+    std::rewind(file);
+}
+
+bool SpillFile::read(Row& row) {
+    uint32_t count = 0;
+    if (std::fread(&count, sizeof(count), 1, file) != 1) {
+        return false;
+    }
+    row.resize(count);
+    for (std::string& value : row) {
+        uint32_t length = 0;
+        if (std::fread(&length, sizeof(length), 1, file) != 1) {
+            throw std::runtime_error("Truncated spill file");
+        }
+        if (length == nullLength) {
+            value = NULL_VALUE;
+            continue;
+        }
+        value.resize(length);
+        if (length && std::fread(&value[0], 1, length, file) != length) {
+            throw std::runtime_error("Truncated spill file");
+        }
+    }
+    return true;
+}
+
+size_t rowMemoryBytes(const Row& row) {
+    size_t bytes = sizeof(Row);
+    for (const std::string& value : row) {
+        bytes += sizeof(std::string) + (value.capacity() > 15 ? value.capacity() + 1 : 0);
+    }
+    return bytes;
+}
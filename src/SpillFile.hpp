@@ -0,0 +1,35 @@
+#ifndef SPILLFILE_HPP
+#define SPILLFILE_HPP
+
+#include <cstdio>
+#include <string>
+#include "TableSchema.hpp"
+
+// SpillFile: rows written to an anonymous temporary file by an operator that
+// went over its memory budget. Rows are appended, then read back in order
+// after rewind(). The file is removed when the object is destroyed.
+class SpillFile {
+public:
+    SpillFile();  // Throws std::runtime_error if no temporary file can be created
+    ~SpillFile();
+
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+
+    void write(const Row& row);
+    void rewind();           // Start reading from the first row
+    bool read(Row& row);     // False after the last row
+
+    size_t getRowCount() const { return rowCount; }
+    size_t getBytes() const { return bytes; }
+
+private:
+    std::FILE* file;
+    size_t rowCount = 0;
+    size_t bytes = 0;
+};
+
+// Approximate heap footprint of a row held in memory (for operator memory budgets)
+size_t rowMemoryBytes(const Row& row);
+
+#endif // SPILLFILE_HPP
@@ -0,0 +1,601 @@
+#include "SqlParser.hpp"
+#include "Trace.hpp"
+#include <cctype>
+
+std::string aggregateName(AggregateFunction function) {
+    switch (function) {
+        case AggregateFunction::None: return "";
+        case AggregateFunction::Count: return "COUNT";
+        case AggregateFunction::Sum: return "SUM";
+        case AggregateFunction::Avg: return "AVG";
+        case AggregateFunction::Min: return "MIN";
+        case AggregateFunction::Max: return "MAX";
+    }
+    return "?";
+}
+
+std::string SelectItem::text() const {
+    return aggregate == AggregateFunction::None ? column : aggregateName(aggregate) + "(" + column + ")";
+}
+
+// Quoted so that readQuoted returns the value unchanged: the quote and (outside
+// backticks) the backslash are doubled
+static void appendQuoted(std::string& out, const std::string& value, char quote) {
+    out += quote;
+    for (char c : value) {
+        if (c == quote || (c == '\\' && quote != '`')) {
+            out += c;
+        }
+        out += c;
+    }
+    out += quote;
+}
+
+std::string insertText(const std::string& table, const std::vector<std::string>& columns,
+                       const std::vector<Row>& rows) {
+    std::string text = "INSERT INTO ";
+    appendQuoted(text, table, '`');
+    if (!columns.empty()) {
+        text += " (";
+        for (size_t i = 0; i < columns.size(); ++i) {
+            text += i ? ", " : "";
+            appendQuoted(text, columns[i], '`');
+        }
+        text += ")";
+    }
+    text += " VALUES ";
+    for (size_t r = 0; r < rows.size(); ++r) {
+        text += r ? ", (" : "(";
+        for (size_t i = 0; i < rows[r].size(); ++i) {
+            text += i ? ", " : "";
+            if (isNull(rows[r][i])) {
+                text += "NULL";
+            } else {
+                appendQuoted(text, rows[r][i], '\'');
+            }
+        }
+        text += ")";
+    }
+    return text + ";";
+}
+
+static bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+// Skip whitespace and comments; returns the next significant position
+static size_t skipSpace(const std::string& sql, size_t i) {
+    while (i < sql.size()) {
+        if (std::isspace(static_cast<unsigned char>(sql[i]))) {
+            ++i;
+        } else if (sql.compare(i, 2, "--") == 0) {
+            while (i < sql.size() && sql[i] != '\n') ++i;
+        } else if (sql.compare(i, 2, "/*") == 0) {
+            size_t end = sql.find("*/", i + 2);
+            i = end == std::string::npos ? sql.size() : end + 2;
+        } else {
+            break;
+        }
+    }
+    return i;
+}
+
+// Read a quoted literal starting at sql[i] (the quote); handles '' and backslash escapes
+static std::string readQuoted(const std::string& sql, size_t& i) {
+    char quote = sql[i++];
+    std::string value;
+    while (i < sql.size()) {
+        char c = sql[i++];
+        if (c == '\\' && i < sql.size() && quote != '`') {
+            char escaped = sql[i++];
+            value += escaped == 'n' ? '\n' : (escaped == 't' ? '\t' : escaped);
+        } else if (c == quote) {
+            if (i < sql.size() && sql[i] == quote) {
+                value += quote;
+                ++i;
+            } else {
+                return value;
+            }
+        } else {
+            value += c;
+        }
+    }
+    throw std::invalid_argument("Unterminated quoted literal");
+}
+
+static std::vector<Token> tokenize(const std::string& sql) {
+    std::vector<Token> tokens;
+    size_t i = skipSpace(sql, 0);
+    while (i < sql.size()) {
+        Token token;
+        char c = sql[i];
+        if (c == '\'' || c == '"') {
+            token.kind = Token::Kind::String;
+            token.text = readQuoted(sql, i);
+        } else if (c == '`') {
+            token.kind = Token::Kind::Identifier;
+            token.text = readQuoted(sql, i);
+        } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                   (c == '.' && i + 1 < sql.size() && std::isdigit(static_cast<unsigned char>(sql[i + 1])))) {
+            token.kind = Token::Kind::Number;
+            size_t start = i;
+            while (i < sql.size() && (std::isdigit(static_cast<unsigned char>(sql[i])) || sql[i] == '.')) ++i;
+            if (i < sql.size() && (sql[i] == 'e' || sql[i] == 'E')) {
+                ++i;
+                if (i < sql.size() && (sql[i] == '+' || sql[i] == '-')) ++i;
+                while (i < sql.size() && std::isdigit(static_cast<unsigned char>(sql[i]))) ++i;
+            }
+            token.text = sql.substr(start, i - start);
+        } else if (isIdentifierChar(c)) {
+            token.kind = Token::Kind::Identifier;
+            size_t start = i;
+            while (i < sql.size() && isIdentifierChar(sql[i])) ++i;
+            token.text = sql.substr(start, i - start);
+        } else {
+            token.kind = Token::Kind::Symbol;
+            std::string two = sql.substr(i, 2);
+            if (two == "<=" || two == ">=" || two == "!=" || two == "<>") {
+                token.text = two == "<>" ? "!=" : two;
+                i += 2;
+            } else {
+                token.text = std::string(1, c);
+                ++i;
+            }
+        }
+        tokens.push_back(token);
+        i = skipSpace(sql, i);
+    }
+    tokens.push_back(Token());  // End marker
+    return tokens;
+}
+
+SqlParser::SqlParser(const std::string& sql) : source(sql), tokens(tokenize(sql)), position(0) {}
+
+std::unique_ptr<Statement> SqlParser::parse(const std::string& sql) {
+    TRACE_SPAN("query", "parse");
+    SqlParser parser(sql);
+    std::unique_ptr<Statement> statement = parser.parseStatement();
+    parser.acceptSymbol(";");
+    if (parser.peek().kind != Token::Kind::End) {
+        parser.fail("unexpected '" + parser.peek().text + "'");
+    }
+    return statement;
+}
+
+std::vector<std::string> SqlParser::splitStatements(const std::string& script) {
+    std::vector<std::string> statements;
+    std::string current;
+    size_t i = 0;
+    while (i < script.size()) {
+        size_t next = skipSpace(script, i);
+        if (next != i) {
+            current += ' ';
+            i = next;
+            continue;
+        }
+        char c = script[i];
+        if (c == '\'' || c == '"' || c == '`') {
+            size_t start = i;
+            readQuoted(script, i);
+            current += script.substr(start, i - start);
+        } else if (c == ';') {
+            if (current.find_first_not_of(' ') != std::string::npos) {
+                statements.push_back(current.substr(current.find_first_not_of(' ')));
+            }
+            current.clear();
+            ++i;
+        } else {
+            current += c;
+            ++i;
+        }
+    }
+    if (current.find_first_not_of(' ') != std::string::npos) {
+        statements.push_back(current.substr(current.find_first_not_of(' ')));
+    }
+    return statements;
+}
+
+std::unique_ptr<Statement> SqlParser::parseStatement() {
+    if (acceptKeyword("CREATE")) {
+        if (acceptKeyword("TABLE")) {
+            return parseCreateTable();
+        }
+        acceptKeyword("UNIQUE");
+        expectKeyword("INDEX");
+        return parseCreateIndex();
+    }
+    if (acceptKeyword("INSERT")) {
+        return parseInsert();
+    }
+    if (acceptKeyword("SELECT")) {
+        return parseSelect();
+    }
+    if (acceptKeyword("UPDATE")) {
+        return parseUpdate();
+    }
+    if (acceptKeyword("EXPLAIN")) {
+        auto explain = std::make_unique<ExplainStatement>();
+        explain->analyze = acceptKeyword("ANALYZE");
+        explain->statement = parseStatement();
+        if (explain->statement->type != StatementType::Select) {
+            fail("EXPLAIN supports SELECT statements only");
+        }
+        return explain;
+    }
+    if (acceptKeyword("ANALYZE")) {
+        auto analyze = std::make_unique<AnalyzeStatement>();
+        acceptKeyword("TABLE");
+        if (peek().kind == Token::Kind::Identifier) {
+            analyze->table = expectIdentifier();
+        }
+        return analyze;
+    }
+    fail("unsupported statement");
+}
+
+// Column definitions, PRIMARY KEY (...) and ignored constraints (FOREIGN KEY, KEY, ...)
+std::unique_ptr<Statement> SqlParser::parseCreateTable() {
+    auto statement = std::make_unique<CreateTableStatement>();
+    TableSchema& schema = statement->schema;
+    schema.definition = source;
+    if (acceptKeyword("IF")) {
+        expectKeyword("NOT");
+        expectKeyword("EXISTS");
+    }
+    schema.name = expectIdentifier();
+    expectSymbol("(");
+
+    do {
+        if (acceptKeyword("PRIMARY")) {
+            expectKeyword("KEY");
+            expectSymbol("(");
+            for (const std::string& column : parseIdentifierList()) {
+                int index = schema.getColumnIndex(column);
+                if (index < 0) {
+                    fail("unknown primary key column " + column);
+                }
+                schema.primaryKey.push_back(index);
+            }
+            expectSymbol(")");
+            continue;
+        }
+
+        bool isConstraint = acceptKeyword("FOREIGN") || acceptKeyword("KEY") || acceptKeyword("INDEX") ||
+                            acceptKeyword("UNIQUE") || acceptKeyword("CONSTRAINT");
+        ColumnDef column;
+        if (!isConstraint) {
+            column.name = expectIdentifier();
+            std::string typeName = expectIdentifier();
+            column.type = parseColumnType(typeName);
+        }
+
+        // Skip type arguments and column options up to the next top-level ',' or ')'
+        int depth = 0;
+        while (peek().kind != Token::Kind::End) {
+            const Token& token = peek();
+            if (token.kind == Token::Kind::Symbol && depth == 0 && (token.text == "," || token.text == ")")) {
+                break;
+            }
+            if (token.kind == Token::Kind::Symbol && token.text == "(") ++depth;
+            if (token.kind == Token::Kind::Symbol && token.text == ")") --depth;
+            if (!isConstraint && depth == 0 && acceptKeyword("NOT")) {
+                expectKeyword("NULL");
+                column.notNull = true;
+                continue;
+            }
+            if (!isConstraint && depth == 0 && acceptKeyword("PRIMARY")) {
+                expectKeyword("KEY");
+                schema.primaryKey.push_back(static_cast<int>(schema.columns.size()));
+                continue;
+            }
+            advance();
+        }
+        if (!isConstraint) {
+            if (schema.getColumnIndex(column.name) >= 0) {
+                fail("duplicate column " + column.name);
+            }
+            schema.columns.push_back(column);
+        }
+    } while (acceptSymbol(","));
+    expectSymbol(")");
+
+    // Table options (ENGINE=..., CHARSET=...) are accepted and ignored
+    while (peek().kind != Token::Kind::End && !(peek().kind == Token::Kind::Symbol && peek().text == ";")) {
+        advance();
+    }
+    if (schema.columns.empty()) {
+        fail("table " + schema.name + " has no columns");
+    }
+    return statement;
+}
+
+std::unique_ptr<Statement> SqlParser::parseCreateIndex() {
+    auto statement = std::make_unique<CreateIndexStatement>();
+    statement->indexName = expectIdentifier();
+    expectKeyword("ON");
+    statement->table = expectIdentifier();
+    expectSymbol("(");
+    statement->column = expectIdentifier();
+    expectSymbol(")");
+    if (acceptKeyword("USING")) {
+        std::string method = expectIdentifier();
+        for (char& c : method) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        if (method != "BTREE" && method != "HASH") {
+            fail("unknown index method " + method);
+        }
+        statement->method = method;
+    }
+    return statement;
+}
+
+std::unique_ptr<Statement> SqlParser::parseInsert() {
+    auto statement = std::make_unique<InsertStatement>();
+    expectKeyword("INTO");
+    statement->table = expectIdentifier();
+    if (acceptSymbol("(")) {
+        statement->columns = parseIdentifierList();
+        expectSymbol(")");
+    }
+    if (!acceptKeyword("VALUES")) {
+        expectKeyword("VALUE");
+    }
+    do {
+        expectSymbol("(");
+        Row row;
+        do {
+            row.push_back(parseLiteral());
+        } while (acceptSymbol(","));
+        expectSymbol(")");
+        statement->rows.push_back(std::move(row));
+    } while (acceptSymbol(","));
+    return statement;
+}
+
+std::unique_ptr<Statement> SqlParser::parseSelect() {
+    auto statement = std::make_unique<SelectStatement>();
+    if (!acceptSymbol("*")) {
+        do {
+            statement->columns.push_back(parseSelectItem());
+            statement->columns.back().alias = parseAlias();
+        } while (acceptSymbol(","));
+    }
+    expectKeyword("FROM");
+    statement->table = expectIdentifier();
+    statement->alias = parseAlias();
+    while (true) {
+        if (acceptKeyword("INNER")) {
+            expectKeyword("JOIN");
+        } else if (!acceptKeyword("JOIN")) {
+            break;
+        }
+        JoinClause join;
+        join.table = expectIdentifier();
+        join.alias = parseAlias();
+        expectKeyword("ON");
+        do {
+            std::string left = parseColumnReference();
+            expectSymbol("=");
+            join.on.emplace_back(left, parseColumnReference());
+        } while (acceptKeyword("AND"));
+        statement->joins.push_back(std::move(join));
+    }
+    if (acceptKeyword("WHERE")) {
+        statement->where = parseWhere();
+    }
+    if (acceptKeyword("GROUP")) {
+        expectKeyword("BY");
+        do {
+            statement->groupBy.push_back(parseColumnReference());
+        } while (acceptSymbol(","));
+    }
+    if (acceptKeyword("ORDER")) {
+        expectKeyword("BY");
+        do {
+            SelectItem term = parseSelectItem();
+            OrderByItem item;
+            item.column = term.column;
+            item.aggregate = term.aggregate;
+            item.descending = acceptKeyword("DESC");
+            if (!item.descending) {
+                acceptKeyword("ASC");
+            }
+            statement->orderBy.push_back(item);
+        } while (acceptSymbol(","));
+    }
+    if (acceptKeyword("LIMIT")) {
+        Token token = advance();
+        if (token.kind != Token::Kind::Number) {
+            fail("LIMIT expects a number");
+        }
+        statement->limit = std::stoll(token.text);
+    }
+    return statement;
+}
+
+std::unique_ptr<Statement> SqlParser::parseUpdate() {
+    auto statement = std::make_unique<UpdateStatement>();
+    statement->table = expectIdentifier();
+    expectKeyword("SET");
+    do {
+        std::string column = expectIdentifier();
+        expectSymbol("=");
+        statement->assignments.emplace_back(column, parseLiteral());
+    } while (acceptSymbol(","));
+    if (acceptKeyword("WHERE")) {
+        statement->where = parseWhere();
+    }
+    return statement;
+}
+
+// term { AND term }, term = column op literal | column IN (literal, ...) | column IS [NOT] NULL
+std::vector<Condition> SqlParser::parseWhere() {
+    std::vector<Condition> conditions;
+    do {
+        Condition condition;
+        condition.column = parseColumnReference();
+        if (acceptKeyword("IS")) {
+            condition.op = acceptKeyword("NOT") ? CompareOp::IsNotNull : CompareOp::IsNull;
+            expectKeyword("NULL");
+            conditions.push_back(condition);
+            continue;
+        }
+        if (acceptKeyword("IN")) {
+            condition.op = CompareOp::In;
+            expectSymbol("(");
+            do {
+                condition.values.push_back(parseLiteral());
+            } while (acceptSymbol(","));
+            expectSymbol(")");
+            conditions.push_back(condition);
+            continue;
+        }
+        Token op = advance();
+        if (op.kind != Token::Kind::Symbol) {
+            fail("expected comparison operator");
+        }
+        if (op.text == "=") condition.op = CompareOp::Equal;
+        else if (op.text == "!=") condition.op = CompareOp::NotEqual;
+        else if (op.text == "<") condition.op = CompareOp::Less;
+        else if (op.text == "<=") condition.op = CompareOp::LessEqual;
+        else if (op.text == ">") condition.op = CompareOp::Greater;
+        else if (op.text == ">=") condition.op = CompareOp::GreaterEqual;
+        else fail("unknown operator " + op.text);
+        condition.value = parseLiteral();
+        conditions.push_back(condition);
+    } while (acceptKeyword("AND"));
+    return conditions;
+}
+
+// Number, string or NULL
+std::string SqlParser::parseLiteral() {
+    bool negative = acceptSymbol("-");
+    Token token = advance();
+    if (token.kind == Token::Kind::Number) {
+        return negative ? "-" + token.text : token.text;
+    }
+    if (!negative && token.kind == Token::Kind::String) {
+        return token.text;
+    }
+    if (!negative && token.kind == Token::Kind::Identifier && equalsIgnoreCase(token.text, "NULL")) {
+        return NULL_VALUE;
+    }
+    fail("expected a literal");
+}
+
+// column or table.column
+std::string SqlParser::parseColumnReference() {
+    std::string reference = expectIdentifier();
+    if (acceptSymbol(".")) {
+        reference += "." + expectIdentifier();
+    }
+    return reference;
+}
+
+// Column reference or COUNT(*), COUNT/SUM/AVG/MIN/MAX(column)
+SelectItem SqlParser::parseSelectItem() {
+    static const struct { const char* name; AggregateFunction function; } functions[] = {
+        {"COUNT", AggregateFunction::Count}, {"SUM", AggregateFunction::Sum}, {"AVG", AggregateFunction::Avg},
+        {"MIN", AggregateFunction::Min}, {"MAX", AggregateFunction::Max},
+    };
+    SelectItem item;
+    const Token& next = position + 1 < tokens.size() ? tokens[position + 1] : tokens.back();
+    if (peek().kind == Token::Kind::Identifier && next.kind == Token::Kind::Symbol && next.text == "(") {
+        for (const auto& entry : functions) {
+            if (equalsIgnoreCase(peek().text, entry.name)) {
+                item.aggregate = entry.function;
+            }
+        }
+        if (item.aggregate == AggregateFunction::None) {
+            fail("unknown function " + peek().text);
+        }
+        advance();
+        expectSymbol("(");
+        if (item.aggregate == AggregateFunction::Count && acceptSymbol("*")) {
+            item.column = "*";
+        } else {
+            item.column = parseColumnReference();
+        }
+        expectSymbol(")");
+        return item;
+    }
+    item.column = parseColumnReference();
+    return item;
+}
+
+// [AS] alias after a table name or SELECT item; clause keywords are not aliases
+std::string SqlParser::parseAlias() {
+    if (acceptKeyword("AS")) {
+        return expectIdentifier();
+    }
+    static const char* const keywords[] = {"FROM", "WHERE", "JOIN", "INNER", "ON", "LIMIT", "ORDER", "GROUP", "LEFT",
+                                           "SET"};
+    if (peek().kind != Token::Kind::Identifier) {
+        return "";
+    }
+    for (const char* keyword : keywords) {
+        if (equalsIgnoreCase(peek().text, keyword)) {
+            return "";
+        }
+    }
+    return advance().text;
+}
+
+std::vector<std::string> SqlParser::parseIdentifierList() {
+    std::vector<std::string> identifiers;
+    do {
+        identifiers.push_back(expectIdentifier());
+    } while (acceptSymbol(","));
+    return identifiers;
+}
+
+const Token& SqlParser::peek() const {
+    return tokens[position];
+}
+
+Token SqlParser::advance() {
+    Token token = tokens[position];
+    if (token.kind != Token::Kind::End) {
+        ++position;
+    }
+    return token;
+}
+
+bool SqlParser::acceptKeyword(const char* keyword) {
+    if (peek().kind == Token::Kind::Identifier && equalsIgnoreCase(peek().text, keyword)) {
+        ++position;
+        return true;
+    }
+    return false;
+}
+
+void SqlParser::expectKeyword(const char* keyword) {
+    if (!acceptKeyword(keyword)) {
+        fail(std::string("expected ") + keyword);
+    }
+}
+
+bool SqlParser::acceptSymbol(const char* symbol) {
+    if (peek().kind == Token::Kind::Symbol && peek().text == symbol) {
+        ++position;
+        return true;
+    }
+    return false;
+}
+
+void SqlParser::expectSymbol(const char* symbol) {
+    if (!acceptSymbol(symbol)) {
+        fail(std::string("expected '") + symbol + "'");
+    }
+}
+
+std::string SqlParser::expectIdentifier() {
+    if (peek().kind != Token::Kind::Identifier) {
+        fail("expected identifier");
+    }
+    return advance().text;
+}
+
+void SqlParser::fail(const std::string& message) const {
+    std::string near = peek().kind == Token::Kind::End ? "end of input" : "'" + peek().text + "'";
+    throw std::invalid_argument("SQL syntax error near " + near + ": " + message);
+}
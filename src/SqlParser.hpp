@@ -0,0 +1,168 @@
+#ifndef SQLPARSER_HPP
+#define SQLPARSER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include "TableSchema.hpp"
+#include "ScanSpec.hpp"
+
+// Token produced by the SQL tokenizer
+struct Token {
+    enum class Kind { Identifier, Number, String, Symbol, End };
+    Kind kind = Kind::End;
+    std::string text;  // Identifier/symbol text, literal value for numbers and strings
+};
+
+// One "column <op> literal", "column IN (literal, ...)" or "column IS [NOT] NULL"
+// term; a WHERE clause is their conjunction. Column references may be qualified
+// ("table.column" or "alias.column").
+struct Condition {
+    std::string column;
+    CompareOp op = CompareOp::Equal;
+    std::string value;                  // Literal value, NULL_VALUE for NULL
+    std::vector<std::string> values{};  // IN list
+};
+
+enum class StatementType { CreateTable, CreateIndex, Insert, Select, Update, Explain, Analyze };
+
+// Base class for parsed statements
+struct Statement {
+    explicit Statement(StatementType statementType) : type(statementType) {}
+    virtual ~Statement() = default;
+    StatementType type;
+};
+
+struct CreateTableStatement : Statement {
+    CreateTableStatement() : Statement(StatementType::CreateTable) {}
+    TableSchema schema;
+};
+
+// CREATE INDEX name ON table (column) [USING BTREE|HASH]
+struct CreateIndexStatement : Statement {
+    CreateIndexStatement() : Statement(StatementType::CreateIndex) {}
+    std::string indexName;
+    std::string table;
+    std::string column;
+    std::string method = "BTREE";
+};
+
+// INSERT INTO table [(columns)] VALUES (...)[, (...)]
+struct InsertStatement : Statement {
+    InsertStatement() : Statement(StatementType::Insert) {}
+    std::string table;
+    std::vector<std::string> columns;  // Empty: values are in table order
+    std::vector<Row> rows;
+};
+
+// The INSERT statement that parses back to exactly these rows (NULL as NULL,
+// everything else quoted), for logging batches that were given without SQL text
+std::string insertText(const std::string& table, const std::vector<std::string>& columns,
+                       const std::vector<Row>& rows);
+
+// [INNER] JOIN table [[AS] alias] ON column = column [AND ...]
+struct JoinClause {
+    std::string table;
+    std::string alias;                                           // Empty: none
+    std::vector<std::pair<std::string, std::string>> on;         // Equated column references
+};
+
+// Aggregate functions of SELECT lists and ORDER BY terms
+enum class AggregateFunction { None, Count, Sum, Avg, Min, Max };
+
+// "COUNT", "SUM", ... (empty for None)
+std::string aggregateName(AggregateFunction function);
+
+// SELECT list item: a column reference or an aggregate over one, [[AS] alias]
+struct SelectItem {
+    std::string column;                                   // "*" for COUNT(*)
+    AggregateFunction aggregate = AggregateFunction::None;
+    std::string alias;                                    // Empty: none
+
+    std::string text() const;  // As written, without the alias: "amount", "SUM(amount)"
+};
+
+// ORDER BY term: column reference, aggregate or SELECT alias [ASC|DESC]
+struct OrderByItem {
+    std::string column;
+    AggregateFunction aggregate = AggregateFunction::None;
+    bool descending = false;
+};
+
+// SELECT items FROM table [[AS] alias] [JOIN ...] [WHERE ...] [GROUP BY ...] [ORDER BY ...] [LIMIT n]
+struct SelectStatement : Statement {
+    SelectStatement() : Statement(StatementType::Select) {}
+    std::vector<SelectItem> columns;   // Empty: SELECT *
+    std::string table;
+    std::string alias;                 // Empty: none
+    std::vector<JoinClause> joins;     // Joined left to right
+    std::vector<Condition> where;
+    std::vector<std::string> groupBy;  // Column references
+    std::vector<OrderByItem> orderBy;  // Empty: input order
+    long long limit = -1;              // -1: no limit
+};
+
+// UPDATE table SET column = value[, ...] [WHERE ...]
+struct UpdateStatement : Statement {
+    UpdateStatement() : Statement(StatementType::Update) {}
+    std::string table;
+    std::vector<std::pair<std::string, std::string>> assignments;
+    std::vector<Condition> where;
+};
+
+// EXPLAIN [ANALYZE] statement
+struct ExplainStatement : Statement {
+    ExplainStatement() : Statement(StatementType::Explain) {}
+    bool analyze = false;                  // Execute the statement and report per-operator statistics
+    std::unique_ptr<Statement> statement;
+};
+
+// ANALYZE [TABLE] [table]: collect optimizer statistics (of every table if none is named)
+struct AnalyzeStatement : Statement {
+    AnalyzeStatement() : Statement(StatementType::Analyze) {}
+    std::string table;  // Empty: all tables
+};
+
+// SqlParser: recursive-descent parser for the SQL subset the engine executes.
+// Keywords are case-insensitive; syntax errors throw std::invalid_argument.
+class SqlParser {
+public:
+    explicit SqlParser(const std::string& sql);
+
+    // Parse a single statement (a trailing ';' is optional)
+    static std::unique_ptr<Statement> parse(const std::string& sql);
+
+    // Split a script into statements on top-level ';' (comments are dropped)
+    static std::vector<std::string> splitStatements(const std::string& script);
+
+private:
+    std::unique_ptr<Statement> parseStatement();
+    std::unique_ptr<Statement> parseCreateTable();
+    std::unique_ptr<Statement> parseCreateIndex();
+    std::unique_ptr<Statement> parseInsert();
+    std::unique_ptr<Statement> parseSelect();
+    std::unique_ptr<Statement> parseUpdate();
+    std::vector<Condition> parseWhere();
+    std::string parseColumnReference();
+    SelectItem parseSelectItem();  // Without the alias
+    std::string parseAlias();
+    std::string parseLiteral();
+    std::vector<std::string> parseIdentifierList();
+
+    // Token helpers
+    const Token& peek() const;
+    Token advance();
+    bool acceptKeyword(const char* keyword);
+    void expectKeyword(const char* keyword);
+    bool acceptSymbol(const char* symbol);
+    void expectSymbol(const char* symbol);
+    std::string expectIdentifier();
+    [[noreturn]] void fail(const std::string& message) const;
+
+    std::string source;  // Statement text as given
+    std::vector<Token> tokens;
+    size_t position;
+};
+
+#endif // SQLPARSER_HPP
@@ -1,18 +1,328 @@
 #include "StorageEngine.hpp"
-#include <iostream>
+#include "EpochManager.hpp"
+#include "Metrics.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include <algorithm>
 #include <fstream>
 
+// TableHeap Implementation
+TableHeap::TableHeap(std::vector<ColumnType> columnTypes) : types(std::move(columnTypes)) {}
+
+// Called with the lock held
+void TableHeap::appendRow(Row row) {
+    if (rowCount % blockRows == 0) {
+        blocks.emplace_back();
+        if (!types.empty()) {
+            zones.emplace_back(types);
+        }
+    }
+    if (!types.empty()) {
+        zones.back().add(row);
+    }
+    Block& block = blocks.back();
+    block.rows.push_back(std::move(row));
+    ++rowCount;
+    ++writes;
+    if (block.rows.size() == blockRows && !types.empty()) {
+        encodeBlock(block);
+    }
+}
+
+void TableHeap::encodeBlock(Block& block) {
+    for (size_t column = 0; column < types.size(); ++column) {
+        block.columns.emplace_back(block.rows, static_cast<int>(column), types[column]);
+    }
+    std::vector<Row>().swap(block.rows);
+}
+
+void TableHeap::decodeBlock(Block& block) {
+    block.rows.assign(block.columns[0].size(), Row(types.size()));
+    std::vector<uint32_t> positions(block.rows.size());
+    for (size_t position = 0; position < positions.size(); ++position) {
+        positions[position] = static_cast<uint32_t>(position);
+    }
+    for (size_t column = 0; column < types.size(); ++column) {
+        block.columns[column].gather(positions, block.rows, 0, static_cast<int>(column));
+    }
+    block.columns.clear();
+}
+
+// The zone map is rebuilt from the rows, dropping the values updates replaced
+void TableHeap::encodeIdleBlocks() {
+    size_t kept = 0;
+    for (size_t index : decodedBlocks) {
+        Block& block = blocks[index];
+        if (writes - block.lastWrite < blockRows) {
+            decodedBlocks[kept++] = index;
+            continue;
+        }
+        zones[index] = ZoneMap(types);
+        for (const Row& row : block.rows) {
+            zones[index].add(row);
+        }
+        encodeBlock(block);
+    }
+    decodedBlocks.resize(kept);
+}
+
+void TableHeap::readRow(size_t rowId, Row& row) const {
+    const Block& block = blocks[rowId / blockRows];
+    if (!block.isEncoded()) {
+        row = block.rows[rowId % blockRows];
+        return;
+    }
+    row.resize(types.size());
+    for (size_t column = 0; column < types.size(); ++column) {
+        row[column] = block.columns[column].get(rowId % blockRows);
+    }
+}
+
+// The filter runs column by column on the encoded values, narrowing a list of
+// positions; only the rows left are decoded, and only their projected columns
+void TableHeap::scanEncoded(const Block& block, size_t firstRowId, size_t from, size_t to, const ScanSpec& spec,
+                            std::vector<Row>& out, std::vector<int>* rowIds) const {
+    std::vector<uint32_t> selection(to - from);
+    for (size_t position = from; position < to; ++position) {
+        selection[position - from] = static_cast<uint32_t>(position);
+    }
+    for (const BoundCondition& condition : spec.filter) {
+        block.columns[condition.column].filter(condition, selection);
+    }
+    size_t first = out.size();
+    out.resize(first + selection.size(), Row(types.size()));
+    if (spec.allColumns) {
+        for (size_t column = 0; column < types.size(); ++column) {
+            block.columns[column].gather(selection, out, first, static_cast<int>(column));
+        }
+    } else {
+        for (int column : spec.columns) {
+            block.columns[column].gather(selection, out, first, column);
+        }
+    }
+    if (rowIds) {
+        for (uint32_t position : selection) {
+            rowIds->push_back(static_cast<int>(firstRowId + position));
+        }
+    }
+}
+
+int TableHeap::insertRow(const Row& row) {
+    std::unique_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCounted(lock);
+    appendRow(row);
+    if (!decodedBlocks.empty()) {
+        encodeIdleBlocks();
+    }
+    return static_cast<int>(rowCount - 1);
+}
+
+int TableHeap::insertRows(std::vector<Row>& newRows) {
+    std::unique_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCounted(lock);
+    size_t first = rowCount;
+    for (Row& row : newRows) {
+        appendRow(std::move(row));
+    }
+    if (!decodedBlocks.empty()) {
+        encodeIdleBlocks();
+    }
+    return static_cast<int>(first);
+}
+
+bool TableHeap::updateRow(int rowId, const ColumnValues& values, Row& previous) {
+    std::unique_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCounted(lock);
+    if (rowId < 0 || static_cast<size_t>(rowId) >= rowCount) {
+        return false;
+    }
+    size_t index = rowId / blockRows;
+    size_t position = rowId % blockRows;
+    Block& block = blocks[index];
+    ++writes;
+    block.lastWrite = writes;
+    if (block.isEncoded()) {
+        readRow(rowId, previous);
+        bool patched = true;
+        for (const auto& [column, value] : values) {
+            patched = patched && block.columns[column].patch(position, value);
+        }
+        if (!patched) {
+            decodeBlock(block);  // Columns patched so far are overwritten below again
+            decodedBlocks.push_back(index);
+        }
+    } else {
+        previous = block.rows[position];
+    }
+    for (const auto& [column, value] : values) {
+        if (!block.isEncoded()) {
+            block.rows[position][column] = value;
+        }
+        if (!types.empty()) {
+            zones[index].add(column, value);  // Widens the zone; the old value stays covered
+        }
+    }
+    if (!decodedBlocks.empty()) {
+        encodeIdleBlocks();
+    }
+    return true;
+}
+
+bool TableHeap::fetchRow(int rowId, Row& row) const {
+    std::shared_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCounted(lock);
+    if (rowId < 0 || static_cast<size_t>(rowId) >= rowCount) {
+        return false;
+    }
+    readRow(rowId, row);
+    return true;
+}
+
+size_t TableHeap::readRows(size_t startRowId, size_t maxRows, std::vector<Row>& out) const {
+    std::shared_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCounted(lock);
+    if (startRowId >= rowCount) {
+        return 0;
+    }
+    size_t count = std::min(maxRows, rowCount - startRowId);
+    ScanSpec everything;
+    size_t rowId = startRowId;
+    while (rowId < startRowId + count) {
+        size_t blockStart = rowId / blockRows * blockRows;
+        size_t blockEnd = std::min(blockStart + blockRows, startRowId + count);
+        const Block& block = blocks[rowId / blockRows];
+        if (block.isEncoded()) {
+            scanEncoded(block, blockStart, rowId - blockStart, blockEnd - blockStart, everything, out, nullptr);
+        } else {
+            out.insert(out.end(), block.rows.begin() + (rowId - blockStart),
+                       block.rows.begin() + (blockEnd - blockStart));
+        }
+        rowId = blockEnd;
+    }
+    return count;
+}
+
+size_t TableHeap::scanRows(size_t startRowId, size_t maxRows, const ScanSpec& spec, std::vector<Row>& out,
+                           std::vector<int>* rowIds, size_t* rowsSkipped) const {
+    std::shared_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCounted(lock);
+    if (startRowId >= rowCount) {
+        return 0;
+    }
+    size_t end = startRowId + std::min(maxRows, rowCount - startRowId);
+    size_t rowId = startRowId;
+    while (rowId < end) {
+        size_t blockIndex = rowId / blockRows;
+        size_t blockStart = blockIndex * blockRows;
+        size_t blockEnd = blockStart + blockRows < end ? blockStart + blockRows : end;
+        const Block& block = blocks[blockIndex];
+        if (!spec.filter.empty() && blockIndex < zones.size() && !zones[blockIndex].mayMatch(spec.filter)) {
+            if (rowsSkipped) {
+                *rowsSkipped += blockEnd - rowId;
+            }
+        } else if (block.isEncoded()) {
+            scanEncoded(block, blockStart, rowId - blockStart, blockEnd - blockStart, spec, out, rowIds);
+        } else {
+            for (size_t id = rowId; id < blockEnd; ++id) {
+                if (spec.project(block.rows[id - blockStart], out) && rowIds) {
+                    rowIds->push_back(static_cast<int>(id));
+                }
+            }
+        }
+        rowId = blockEnd;
+    }
+    return end - startRowId;
+}
+
+size_t TableHeap::getRowCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCounted(lock);
+    return rowCount;
+}
+
+std::vector<Encoding> TableHeap::getBlockEncodings(size_t block) const {
+    std::shared_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCounted(lock);
+    std::vector<Encoding> encodings;
+    if (block < blocks.size()) {
+        for (const EncodedColumn& column : blocks[block].columns) {
+            encodings.push_back(column.getEncoding());
+        }
+    }
+    return encodings;
+}
+
+size_t TableHeap::getEncodedBytes() const {
+    std::shared_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    lockCounted(lock);
+    size_t bytes = 0;
+    for (const Block& block : blocks) {
+        for (const EncodedColumn& column : block.columns) {
+            bytes += column.getBytes();
+        }
+    }
+    return bytes;
+}
+
 // MemoryStorage Implementation
 void MemoryStorage::storeData(const std::string& data) {
     memoryData.push_back(data);
-    std::cout << "Data stored in memory: " << data << std::endl;
+    LOG_DEBUG("Data stored in memory: " << data);
 }
 
 std::vector<std::string> MemoryStorage::retrieveData() {
-    std::cout << "Retrieving data from memory." << std::endl;
+    LOG_DEBUG("Retrieving data from memory.");
     return memoryData;
 }
 
+// Heaps are never dropped, so the pointer stays valid after the lock is released
+TableHeap* MemoryStorage::findTable(const std::string& table) {
+    std::shared_lock<std::shared_mutex> lock(tablesMutex);
+    auto it = tables.find(table);
+    return it != tables.end() ? it->second.get() : nullptr;
+}
+
+bool MemoryStorage::createTable(const std::string& table, const std::vector<ColumnType>& types) {
+    std::unique_lock<std::shared_mutex> lock(tablesMutex);
+    return tables.emplace(table, std::make_unique<TableHeap>(types)).second;
+}
+
+int MemoryStorage::insertRow(const std::string& table, const Row& row) {
+    TableHeap* heap = findTable(table);
+    return heap ? heap->insertRow(row) : -1;
+}
+
+int MemoryStorage::insertRows(const std::string& table, std::vector<Row>& rows) {
+    TableHeap* heap = findTable(table);
+    return heap ? heap->insertRows(rows) : -1;
+}
+
+bool MemoryStorage::updateRow(const std::string& table, int rowId, const ColumnValues& values, Row& previous) {
+    TableHeap* heap = findTable(table);
+    return heap && heap->updateRow(rowId, values, previous);
+}
+
+bool MemoryStorage::fetchRow(const std::string& table, int rowId, Row& row) {
+    TableHeap* heap = findTable(table);
+    return heap && heap->fetchRow(rowId, row);
+}
+
+size_t MemoryStorage::readRows(const std::string& table, size_t startRowId, size_t maxRows, std::vector<Row>& rows) {
+    TableHeap* heap = findTable(table);
+    return heap ? heap->readRows(startRowId, maxRows, rows) : 0;
+}
+
+size_t MemoryStorage::scanRows(const std::string& table, size_t startRowId, size_t maxRows, const ScanSpec& spec,
+                               std::vector<Row>& rows, std::vector<int>* rowIds, size_t* rowsSkipped) {
+    TableHeap* heap = findTable(table);
+    return heap ? heap->scanRows(startRowId, maxRows, spec, rows, rowIds, rowsSkipped) : 0;
+}
+
+size_t MemoryStorage::getRowCount(const std::string& table) {
+    TableHeap* heap = findTable(table);
+    return heap ? heap->getRowCount() : 0;
+}
+
 // FileStorage Implementation
 FileStorage::FileStorage(const std::string& file) : filename(file) {}
 
@@ -20,10 +330,10 @@ void FileStorage::storeData(const std::string& data) {
     std::ofstream outfile(filename, std::ios::app);
     if (outfile.is_open()) {
         outfile << data << std::endl;
-        std::cout << "Data stored in file: " << filename << std::endl;
+        LOG_DEBUG("Data stored in file: " << filename);
         outfile.close();
     } else {
-        std::cerr << "Error: Unable to open file for writing." << std::endl;
+        LOG_ERROR("Unable to open file for writing.");
     }
 }
 
@@ -37,50 +347,421 @@ std::vector<std::string> FileStorage::retrieveData() {
         }
         infile.close();
     } else {
-        std::cerr << "Error: Unable to open file for reading." << std::endl;
+        LOG_ERROR("Unable to open file for reading.");
     }
-    std::cout << "Data retrieved from file: " << filename << std::endl;
+    LOG_DEBUG("Data retrieved from file: " << filename);
     return fileData;
 }
 
+// Tab-separated record field: tabs, newlines and backslashes escaped, NULL as \N
+static void appendField(std::string& record, const std::string& value) {
+    record += '\t';
+    if (isNull(value)) {
+        record += "\\N";
+        return;
+    }
+    for (char c : value) {
+        if (c == '\t') record += "\\t";
+        else if (c == '\n') record += "\\n";
+        else if (c == '\\') record += "\\\\";
+        else record += c;
+    }
+}
+
+void FileStorage::appendRecord(const std::string& record) {
+    TRACE_SPAN("storage", "row log append");
+    std::lock_guard<std::mutex> lock(rowLogMutex);
+    if (!rowLog.is_open()) {
+        rowLog.open(filename + ".rows", std::ios::app);
+        if (!rowLog.is_open()) {
+            LOG_ERROR("Unable to open file for writing: " << filename << ".rows");
+            return;
+        }
+    }
+    rowLog << record << '\n';
+    rowLog.flush();
+}
+
+bool FileStorage::createTable(const std::string& table, const std::vector<ColumnType>& types) {
+    if (!rows.createTable(table, types)) {
+        return false;
+    }
+    appendRecord("CREATE\t" + table);
+    return true;
+}
+
+int FileStorage::insertRow(const std::string& table, const Row& row) {
+    int rowId = rows.insertRow(table, row);
+    if (rowId >= 0) {
+        std::string record = "INSERT\t" + table + "\t" + std::to_string(rowId);
+        for (const std::string& value : row) {
+            appendField(record, value);
+        }
+        appendRecord(record);
+    }
+    return rowId;
+}
+
+// Row IDs are only known once the rows are in memory, so the fields are encoded first
+int FileStorage::insertRows(const std::string& table, std::vector<Row>& batch) {
+    std::vector<std::string> fields(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        for (const std::string& value : batch[i]) {
+            appendField(fields[i], value);
+        }
+    }
+    int firstRowId = rows.insertRows(table, batch);
+    if (firstRowId >= 0 && !fields.empty()) {
+        std::string records;
+        for (size_t i = 0; i < fields.size(); ++i) {
+            if (i > 0) {
+                records += '\n';
+            }
+            records += "INSERT\t" + table + "\t" + std::to_string(firstRowId + static_cast<int>(i)) + fields[i];
+        }
+        appendRecord(records);
+    }
+    return firstRowId;
+}
+
+bool FileStorage::updateRow(const std::string& table, int rowId, const ColumnValues& values, Row& previous) {
+    if (!rows.updateRow(table, rowId, values, previous)) {
+        return false;
+    }
+    std::string record = "UPDATE\t" + table + "\t" + std::to_string(rowId);
+    for (const auto& [column, value] : values) {
+        record += "\t" + std::to_string(column);
+        appendField(record, value);
+    }
+    appendRecord(record);
+    return true;
+}
+
+bool FileStorage::fetchRow(const std::string& table, int rowId, Row& row) {
+    return rows.fetchRow(table, rowId, row);
+}
+
+size_t FileStorage::readRows(const std::string& table, size_t startRowId, size_t maxRows, std::vector<Row>& out) {
+    return rows.readRows(table, startRowId, maxRows, out);
+}
+
+size_t FileStorage::scanRows(const std::string& table, size_t startRowId, size_t maxRows, const ScanSpec& spec,
+                             std::vector<Row>& out, std::vector<int>* rowIds, size_t* rowsSkipped) {
+    return rows.scanRows(table, startRowId, maxRows, spec, out, rowIds, rowsSkipped);
+}
+
+size_t FileStorage::getRowCount(const std::string& table) {
+    return rows.getRowCount(table);
+}
+
+// TableInfo Implementation
+const IndexInfo* TableInfo::findIndex(int column) const {
+    for (const IndexInfo& info : indexes) {
+        if (info.column == column) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
 // StorageEngine Implementation
-StorageEngine::StorageEngine(const std::string& backendType) {
+StorageEngine::StorageEngine(const std::string& backendType) : catalog(new Catalog()) {
     if (backendType == "memory") {
         backend = new MemoryStorage();
     } else if (backendType == "file") {
         backend = new FileStorage("database.txt");
     } else {
+        delete catalog.load();
         throw std::invalid_argument("Unknown backend type: " + backendType);
     }
 }
 
 StorageEngine::~StorageEngine() {
     delete backend;
+    delete catalog.load();
 }
 
 void StorageEngine::storeData(const std::string& data) {
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     backend->storeData(data);
 }
 
 std::vector<std::string> StorageEngine::retrieveData() {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return backend->retrieveData();
 }
 
-void StorageEngine::createIndex(const std::string& column) {
-    std::cout << "Index created for column: " << column << std::endl;
-    // Example indexing logic (in a real-world scenario, you'd index the data)
-    index[column] = {};  // Initialize empty index for the column
+// Copy-on-write: readers keep the old snapshot until they leave their epoch
+void StorageEngine::publishCatalog(Catalog* updated) {
+    const Catalog* current = catalog.load(std::memory_order_acquire);
+    catalog.store(updated, std::memory_order_release);
+    EpochManager::getInstance().retire(const_cast<Catalog*>(current));
+}
+
+static std::shared_ptr<Index> makeIndex(const std::string& column, IndexKind kind) {
+    if (kind == IndexKind::Hash) {
+        return std::make_shared<Index>(column, std::make_unique<ShardedHashIndex>());
+    }
+    return std::make_shared<Index>(column, std::make_unique<BTreeIndex>());
+}
+
+bool StorageEngine::createTable(const TableSchema& schema) {
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    const Catalog* current = catalog.load(std::memory_order_acquire);
+    std::vector<ColumnType> types;
+    for (const ColumnDef& column : schema.columns) {
+        types.push_back(column.type);
+    }
+    if (current->count(schema.name) || !backend->createTable(schema.name, types)) {
+        return false;
+    }
+
+    TableInfo info;
+    info.schema = std::make_shared<const TableSchema>(schema);
+    info.keyLatch = std::make_shared<std::mutex>();
+    if (!schema.primaryKey.empty()) {
+        IndexInfo primary;
+        primary.name = "PRIMARY";
+        primary.column = schema.primaryKey[0];
+        primary.index = makeIndex(schema.columns[primary.column].name, IndexKind::BTree);
+        info.indexes.push_back(primary);
+    }
+
+    Catalog* updated = new Catalog(*current);
+    (*updated)[schema.name] = info;
+    publishCatalog(updated);
+    LOG_INFO("Table created: " << schema.name);
+    return true;
+}
+
+const TableInfo* StorageEngine::getTableInfo(const std::string& table) const {
+    const Catalog* snapshot = catalog.load(std::memory_order_acquire);
+    auto it = snapshot->find(table);
+    return it != snapshot->end() ? &it->second : nullptr;
+}
+
+bool StorageEngine::hasTable(const std::string& table) const {
+    EpochGuard guard;
+    return getTableInfo(table) != nullptr;
 }
 
-std::vector<std::string> StorageEngine::searchIndex(const std::string& value) {
-    std::vector<std::string> results;
-    // Search index for a value (simple example)
-    for (const auto& [key, entries] : index) {
-        for (const auto& entry : entries) {
-            if (entry == value) {
-                results.push_back(entry);
+std::shared_ptr<const TableSchema> StorageEngine::getSchema(const std::string& table) const {
+    EpochGuard guard;
+    const TableInfo* info = getTableInfo(table);
+    return info ? info->schema : nullptr;
+}
+
+std::vector<std::string> StorageEngine::getTableNames() const {
+    EpochGuard guard;
+    std::vector<std::string> names;
+    for (const auto& [name, info] : *catalog.load(std::memory_order_acquire)) {
+        names.push_back(name);
+    }
+    return names;
+}
+
+int StorageEngine::insertRow(const std::string& table, const Row& row) {
+    EpochGuard guard;
+    const TableInfo* info = getTableInfo(table);
+    if (!info || row.size() != info->schema->columns.size()) {
+        return -1;
+    }
+
+    int rowId = backend->insertRow(table, row);
+    if (rowId < 0) {
+        return -1;
+    }
+    for (const IndexInfo& index : info->indexes) {
+        ColumnType type = info->schema->columns[index.column].type;
+        index.index->addIndexEntry(encodeIndexKey(row[index.column], type), rowId);
+    }
+    MetricsRegistry::getInstance().add(Counter::RowsInserted);
+    return rowId;
+}
+
+int StorageEngine::insertRows(const std::string& table, std::vector<Row>& rows) {
+    EpochGuard guard;
+    const TableInfo* info = getTableInfo(table);
+    if (!info) {
+        return -1;
+    }
+    for (const Row& row : rows) {
+        if (row.size() != info->schema->columns.size()) {
+            return -1;
+        }
+    }
+
+    // Keys are encoded before the rows are moved into the heap
+    std::vector<std::vector<std::pair<std::string, int>>> indexKeys(info->indexes.size());
+    for (size_t i = 0; i < info->indexes.size(); ++i) {
+        const IndexInfo& index = info->indexes[i];
+        ColumnType type = info->schema->columns[index.column].type;
+        indexKeys[i].reserve(rows.size());
+        for (size_t row = 0; row < rows.size(); ++row) {
+            indexKeys[i].emplace_back(encodeIndexKey(rows[row][index.column], type), static_cast<int>(row));
+        }
+    }
+
+    size_t count = rows.size();
+    int firstRowId = backend->insertRows(table, rows);
+    if (firstRowId < 0) {
+        return -1;
+    }
+
+    // Sorted keys walk the B-tree leaves in order instead of jumping around the tree
+    for (size_t i = 0; i < info->indexes.size(); ++i) {
+        std::vector<std::pair<std::string, int>>& keys = indexKeys[i];
+        if (info->indexes[i].index->supportsRangeScan()) {
+            std::sort(keys.begin(), keys.end());
+        }
+        for (const auto& [key, row] : keys) {
+            info->indexes[i].index->addIndexEntry(key, firstRowId + row);
+        }
+    }
+    MetricsRegistry::getInstance().add(Counter::RowsInserted, count);
+    return firstRowId;
+}
+
+// Changed indexed values get a new index entry, unless the row already has
+// one under that key (a value changed back). The old entry is left in place,
+// so index readers must re-check the row they fetch.
+bool StorageEngine::updateRow(const std::string& table, int rowId, const ColumnValues& values) {
+    EpochGuard guard;
+    const TableInfo* info = getTableInfo(table);
+    if (!info) {
+        return false;
+    }
+    for (const auto& value : values) {
+        if (value.first < 0 || static_cast<size_t>(value.first) >= info->schema->columns.size()) {
+            return false;
+        }
+    }
+
+    Row previous;
+    if (!backend->updateRow(table, rowId, values, previous)) {
+        return false;
+    }
+    for (const auto& [column, value] : values) {
+        const IndexInfo* index = info->findIndex(column);
+        if (index && previous[column] != value) {
+            std::string key = encodeIndexKey(value, info->schema->columns[column].type);
+            std::vector<int> entries = index->index->getIndexEntries(key);
+            if (std::find(entries.begin(), entries.end(), rowId) == entries.end()) {
+                index->index->addIndexEntry(key, rowId);
             }
         }
     }
-    return results;
+    MetricsRegistry::getInstance().add(Counter::RowsUpdated);
+    return true;
+}
+
+bool StorageEngine::fetchRow(const std::string& table, int rowId, Row& row) {
+    TRACE_SPAN("storage", "fetch row");
+    return backend->fetchRow(table, rowId, row);
+}
+
+std::vector<int> StorageEngine::lookupRows(const std::string& table, int column, const std::string& value) {
+    EpochGuard guard;
+    const TableInfo* info = getTableInfo(table);
+    const IndexInfo* index = info ? info->findIndex(column) : nullptr;
+    if (!index) {
+        return {};
+    }
+    ColumnType type = info->schema->columns[column].type;
+    std::string key = encodeIndexKey(value, type);
+    std::vector<int> rowIds = index->index->getIndexEntries(key);
+    std::sort(rowIds.begin(), rowIds.end());
+    rowIds.erase(std::unique(rowIds.begin(), rowIds.end()), rowIds.end());
+    Row row;
+    size_t kept = 0;
+    for (int rowId : rowIds) {
+        if (backend->fetchRow(table, rowId, row) && encodeIndexKey(row[column], type) == key) {
+            rowIds[kept++] = rowId;
+        }
+    }
+    rowIds.resize(kept);
+    return rowIds;
+}
+
+std::shared_ptr<std::mutex> StorageEngine::getKeyLatch(const std::string& table) const {
+    EpochGuard guard;
+    const TableInfo* info = getTableInfo(table);
+    return info ? info->keyLatch : nullptr;
+}
+
+size_t StorageEngine::readRows(const std::string& table, size_t startRowId, size_t maxRows, std::vector<Row>& rows) {
+    TRACE_SPAN("storage", "read rows");
+    return backend->readRows(table, startRowId, maxRows, rows);
+}
+
+size_t StorageEngine::scanRows(const std::string& table, size_t startRowId, size_t maxRows, const ScanSpec& spec,
+                               std::vector<Row>& rows, std::vector<int>* rowIds, size_t* rowsSkipped) {
+    TRACE_SPAN("storage", "scan rows");
+    return backend->scanRows(table, startRowId, maxRows, spec, rows, rowIds, rowsSkipped);
+}
+
+size_t StorageEngine::getRowCount(const std::string& table) {
+    return backend->getRowCount(table);
+}
+
+bool StorageEngine::createIndex(const std::string& table, const std::string& column, IndexKind kind,
+                                const std::string& indexName) {
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    const Catalog* current = catalog.load(std::memory_order_acquire);
+    auto it = current->find(table);
+    if (it == current->end()) {
+        LOG_ERROR("Cannot index unknown table: " << table);
+        return false;
+    }
+    const TableSchema& schema = *it->second.schema;
+    int columnIndex = schema.getColumnIndex(column);
+    if (columnIndex < 0) {
+        LOG_ERROR("Cannot index unknown column: " << table << "." << column);
+        return false;
+    }
+    if (it->second.findIndex(columnIndex)) {
+        return true;  // Already indexed
+    }
+
+    IndexInfo info;
+    info.name = indexName.empty() ? table + "_" + schema.columns[columnIndex].name : indexName;
+    info.column = columnIndex;
+    info.kind = kind;
+    info.index = makeIndex(schema.columns[columnIndex].name, kind);
+
+    // Backfill from the existing rows
+    std::vector<Row> batch;
+    size_t start = 0;
+    while (backend->readRows(table, start, 4096, batch) > 0) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            info.index->addIndexEntry(encodeIndexKey(batch[i][columnIndex], schema.columns[columnIndex].type),
+                                      static_cast<int>(start + i));
+        }
+        start += batch.size();
+        batch.clear();
+    }
+
+    Catalog* updated = new Catalog(*current);
+    (*updated)[table].indexes.push_back(info);
+    publishCatalog(updated);
+    LOG_INFO("Index created for column: " << table << "." << schema.columns[columnIndex].name);
+    return true;
+}
+
+bool StorageEngine::setStatistics(const std::string& table, std::shared_ptr<const TableStatistics> statistics) {
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    const Catalog* current = catalog.load(std::memory_order_acquire);
+    if (!current->count(table)) {
+        return false;
+    }
+    Catalog* updated = new Catalog(*current);
+    (*updated)[table].statistics = std::move(statistics);
+    publishCatalog(updated);
+    return true;
+}
+
+std::shared_ptr<const TableStatistics> StorageEngine::getStatistics(const std::string& table) const {
+    EpochGuard guard;
+    const TableInfo* info = getTableInfo(table);
+    return info ? info->statistics : nullptr;
 }
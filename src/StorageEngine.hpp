@@ -5,6 +5,78 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <fstream>
+#include "TableSchema.hpp"
+#include "Indexing.hpp"
+#include "ScanSpec.hpp"
+#include "ZoneMap.hpp"
+#include "ColumnEncoding.hpp"
+
+struct TableStatistics;
+
+// New values for some columns of a row (column position, value)
+using ColumnValues = std::vector<std::pair<int, std::string>>;
+
+// TableHeap: the rows of one table. A row ID is the row's position.
+// Writers take the heap's lock exclusively, readers share it; blocking on
+// the lock is counted as a lock wait. Given the column types, the heap keeps
+// a zone map per block of rows, which scans use to skip blocks, and stores
+// every full block as compressed columns that scans filter without decoding.
+class TableHeap {
+public:
+    static const size_t blockRows = 4096;
+
+    explicit TableHeap(std::vector<ColumnType> columnTypes);
+
+    int insertRow(const Row& row);
+    int insertRows(std::vector<Row>& newRows);  // Moves the rows in under one lock, returns the first row ID
+    bool updateRow(int rowId, const ColumnValues& values, Row& previous);  // Atomic per row
+    bool fetchRow(int rowId, Row& row) const;
+    size_t readRows(size_t startRowId, size_t maxRows, std::vector<Row>& rows) const;  // Appends, returns count
+    // Appends the rows of up to maxRows that pass the scan's filter, projected; returns the rows
+    // examined, including those of blocks the zone maps skipped (counted in rowsSkipped)
+    size_t scanRows(size_t startRowId, size_t maxRows, const ScanSpec& spec, std::vector<Row>& rows,
+                    std::vector<int>* rowIds, size_t* rowsSkipped) const;
+    size_t getRowCount() const;
+
+    // Encoding of each column of a block (empty while the block is stored as rows)
+    std::vector<Encoding> getBlockEncodings(size_t block) const;
+    size_t getEncodedBytes() const;  // Footprint of the compressed blocks
+
+private:
+    // A block of rows: full blocks are stored as encoded columns, the last
+    // block as rows while it fills. An update patches the encoded columns in
+    // place when they can hold the new values, and otherwise turns the block
+    // back into rows; it is encoded again once blockRows writes have gone by
+    // without touching it.
+    struct Block {
+        std::vector<Row> rows;
+        std::vector<EncodedColumn> columns;
+        size_t lastWrite = 0;  // Heap write count at the block's last update
+
+        bool isEncoded() const { return !columns.empty(); }
+    };
+
+    // Called with the lock held
+    void appendRow(Row row);
+    void encodeBlock(Block& block);
+    void decodeBlock(Block& block);
+    void encodeIdleBlocks();  // Full blocks decoded by updates and left alone since
+    void readRow(size_t rowId, Row& row) const;
+    void scanEncoded(const Block& block, size_t firstRowId, size_t from, size_t to, const ScanSpec& spec,
+                     std::vector<Row>& rows, std::vector<int>* rowIds) const;
+
+    mutable std::shared_mutex mutex;
+    std::vector<Block> blocks;      // Rows [i * blockRows, (i + 1) * blockRows)
+    size_t rowCount = 0;
+    std::vector<ColumnType> types;  // Empty: no zone maps and no compression
+    std::vector<ZoneMap> zones;     // Zone map of each block
+    std::vector<size_t> decodedBlocks;  // Full blocks stored as rows after an update
+    size_t writes = 0;                  // Rows inserted or updated so far
+};
 
 // Abstract class for data storage (Base class for different backends)
 class StorageBackend {
@@ -12,6 +84,19 @@ public:
     virtual ~StorageBackend() = default;
     virtual void storeData(const std::string& data) = 0;
     virtual std::vector<std::string> retrieveData() = 0;
+
+    // Row storage by table; calls naming a missing table fail (-1/false/0).
+    // The column types let the backend keep zone maps for scans.
+    virtual bool createTable(const std::string& table, const std::vector<ColumnType>& types) = 0;
+    virtual int insertRow(const std::string& table, const Row& row) = 0;
+    virtual int insertRows(const std::string& table, std::vector<Row>& rows) = 0;  // Consecutive IDs, first returned
+    virtual bool updateRow(const std::string& table, int rowId, const ColumnValues& values, Row& previous) = 0;
+    virtual bool fetchRow(const std::string& table, int rowId, Row& row) = 0;
+    virtual size_t readRows(const std::string& table, size_t startRowId, size_t maxRows, std::vector<Row>& rows) = 0;
+    // Filtered, projected read of up to maxRows rows (see ScanSpec); returns the rows examined
+    virtual size_t scanRows(const std::string& table, size_t startRowId, size_t maxRows, const ScanSpec& spec,
+                            std::vector<Row>& rows, std::vector<int>* rowIds, size_t* rowsSkipped) = 0;
+    virtual size_t getRowCount(const std::string& table) = 0;
 };
 
 // MemoryStorage: In-memory storage backend
@@ -20,36 +105,147 @@ public:
     void storeData(const std::string& data) override;
     std::vector<std::string> retrieveData() override;
 
+    bool createTable(const std::string& table, const std::vector<ColumnType>& types) override;
+    int insertRow(const std::string& table, const Row& row) override;
+    int insertRows(const std::string& table, std::vector<Row>& rows) override;
+    bool updateRow(const std::string& table, int rowId, const ColumnValues& values, Row& previous) override;
+    bool fetchRow(const std::string& table, int rowId, Row& row) override;
+    size_t readRows(const std::string& table, size_t startRowId, size_t maxRows, std::vector<Row>& rows) override;
+    size_t scanRows(const std::string& table, size_t startRowId, size_t maxRows, const ScanSpec& spec,
+                    std::vector<Row>& rows, std::vector<int>* rowIds, size_t* rowsSkipped) override;
+    size_t getRowCount(const std::string& table) override;
+
 private:
+    TableHeap* findTable(const std::string& table);
+
     std::vector<std::string> memoryData;  // In-memory data storage
+    std::unordered_map<std::string, std::unique_ptr<TableHeap>> tables;  // Row storage per table
+    std::shared_mutex tablesMutex;        // Guards the tables map (not the heaps)
 };
 
-// FileStorage: File-based storage backend
+// FileStorage: File-based storage backend.
+// Rows are served from memory and every row write is appended to
+// "<file>.rows" as a redo record before it is acknowledged.
 class FileStorage : public StorageBackend {
 public:
     explicit FileStorage(const std::string& file);
     void storeData(const std::string& data) override;
     std::vector<std::string> retrieveData() override;
 
+    bool createTable(const std::string& table, const std::vector<ColumnType>& types) override;
+    int insertRow(const std::string& table, const Row& row) override;
+    int insertRows(const std::string& table, std::vector<Row>& rows) override;  // One row log write for the batch
+    bool updateRow(const std::string& table, int rowId, const ColumnValues& values, Row& previous) override;
+    bool fetchRow(const std::string& table, int rowId, Row& row) override;
+    size_t readRows(const std::string& table, size_t startRowId, size_t maxRows, std::vector<Row>& rows) override;
+    size_t scanRows(const std::string& table, size_t startRowId, size_t maxRows, const ScanSpec& spec,
+                    std::vector<Row>& rows, std::vector<int>* rowIds, size_t* rowsSkipped) override;
+    size_t getRowCount(const std::string& table) override;
+
 private:
+    void appendRecord(const std::string& record);
+
     std::string filename;  // File where data is stored
+    MemoryStorage rows;    // Row cache serving reads
+    std::ofstream rowLog;  // Redo records for row writes
+    std::mutex rowLogMutex;
 };
 
-// StorageEngine: The main class that manages different storage backends
+enum class IndexKind { BTree, Hash };
+
+// An index maintained by the storage engine on one column
+struct IndexInfo {
+    std::string name;
+    int column = -1;
+    IndexKind kind = IndexKind::BTree;
+    std::shared_ptr<Index> index;
+};
+
+// Catalog entry of a table
+struct TableInfo {
+    std::shared_ptr<const TableSchema> schema;
+    std::vector<IndexInfo> indexes;
+    std::shared_ptr<const TableStatistics> statistics;  // Null until the table is analyzed
+    std::shared_ptr<std::mutex> keyLatch;               // Held from a primary key check to the write it allows
+
+    // Index on the column (nullptr if none)
+    const IndexInfo* findIndex(int column) const;
+};
+
+// StorageEngine: The main class that manages different storage backends.
+// Shared by all sessions; every public method is safe to call concurrently.
 class StorageEngine {
 public:
     explicit StorageEngine(const std::string& backendType);
     ~StorageEngine();
 
+    StorageEngine(const StorageEngine&) = delete;
+    StorageEngine& operator=(const StorageEngine&) = delete;
+
     void storeData(const std::string& data);
     std::vector<std::string> retrieveData();
 
-    void createIndex(const std::string& column);
-    std::vector<std::string> searchIndex(const std::string& value);
+    // Tables. A single-column primary key gets a unique B-tree index, a
+    // composite one a B-tree index on its first column.
+    bool createTable(const TableSchema& schema);  // False if the table exists
+    bool hasTable(const std::string& table) const;
+    std::shared_ptr<const TableSchema> getSchema(const std::string& table) const;
+    std::vector<std::string> getTableNames() const;
+
+    // Catalog entry; valid while the caller holds an EpochGuard
+    const TableInfo* getTableInfo(const std::string& table) const;
+
+    // Rows (indexes are maintained on insert and update). Constraints are
+    // checked by the QueryProcessor; a row of the wrong width is rejected.
+    int insertRow(const std::string& table, const Row& row);  // Row ID, -1 on error
+
+    // Batch insert: the rows are moved in with consecutive row IDs and every
+    // index is loaded in key order. Nothing is inserted if a row has the
+    // wrong width. Returns the first row ID, -1 on error.
+    int insertRows(const std::string& table, std::vector<Row>& rows);
+    bool updateRow(const std::string& table, int rowId, const ColumnValues& values);  // Atomic per row
+    bool fetchRow(const std::string& table, int rowId, Row& row);
+
+    // Row IDs (ascending) of the rows whose indexed column currently holds a
+    // value with the same index key as value; entries left behind by updates
+    // are re-checked against the row. Empty if the column has no index.
+    std::vector<int> lookupRows(const std::string& table, int column, const std::string& value);
+
+    // Latch that makes a primary key check and the insert or update it allows
+    // one step; writers that check keys hold it (null for unknown tables)
+    std::shared_ptr<std::mutex> getKeyLatch(const std::string& table) const;
+    size_t readRows(const std::string& table, size_t startRowId, size_t maxRows, std::vector<Row>& rows);
+
+    // Table scan with the filter and projection applied inside the backend: appends the
+    // rows among the next maxRows that pass (and their row IDs if asked), returns the rows
+    // examined (0 at the end of the table). Rows of blocks whose zone map rules out the
+    // filter are passed over unread and counted in rowsSkipped.
+    size_t scanRows(const std::string& table, size_t startRowId, size_t maxRows, const ScanSpec& spec,
+                    std::vector<Row>& rows, std::vector<int>* rowIds = nullptr, size_t* rowsSkipped = nullptr);
+    size_t getRowCount(const std::string& table);
+
+    // Build an index over the existing rows. Not atomic with respect to
+    // concurrent writes to the same table: create indexes before loading.
+    bool createIndex(const std::string& table, const std::string& column, IndexKind kind = IndexKind::BTree,
+                     const std::string& indexName = "");
+
+    // Optimizer statistics from ANALYZE (replaces the previous ones; null if never analyzed)
+    bool setStatistics(const std::string& table, std::shared_ptr<const TableStatistics> statistics);
+    std::shared_ptr<const TableStatistics> getStatistics(const std::string& table) const;
 
 private:
+    using Catalog = std::unordered_map<std::string, TableInfo>;
+
+    void publishCatalog(Catalog* updated);  // Called with catalogMutex held
+
     StorageBackend* backend;
-    std::unordered_map<std::string, std::vector<std::string>> index;  // Simple index structure
+
+    // Readers load the current snapshot without locking; writers publish a
+    // modified copy and retire the old snapshot through the EpochManager.
+    std::atomic<const Catalog*> catalog;
+    std::mutex catalogMutex;  // Serializes catalog writers
+
+    mutable std::shared_mutex dataMutex;   // Guards backend raw data (writers exclusive, readers shared)
 };
 
-#endif // STORAGEENGINE_HPP
\ No newline at end of file
+#endif // STORAGEENGINE_HPP
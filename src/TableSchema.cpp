@@ -0,0 +1,131 @@
+#include "TableSchema.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const std::string NULL_VALUE(1, '\0');
+
+bool isNull(const std::string& value) {
+    return value.size() == 1 && value[0] == '\0';
+}
+
+bool equalsIgnoreCase(const std::string& left, const std::string& right) {
+    if (left.size() != right.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < left.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(left[i])) != std::tolower(static_cast<unsigned char>(right[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Map a SQL type name such as "int", "varchar(50)" or "decimal(10,2)"
+ColumnType parseColumnType(const std::string& sqlType) {
+    std::string base = sqlType.substr(0, sqlType.find('('));
+    std::transform(base.begin(), base.end(), base.begin(), [](unsigned char c) { return std::toupper(c); });
+
+    if (base == "INT" || base == "INTEGER" || base == "SMALLINT" || base == "BIGINT" || base == "TINYINT" ||
+        base == "MEDIUMINT") {
+        return ColumnType::Integer;
+    }
+    if (base == "DECIMAL" || base == "NUMERIC" || base == "DOUBLE" || base == "FLOAT" || base == "REAL") {
+        return ColumnType::Decimal;
+    }
+    if (base == "DATE" || base == "DATETIME" || base == "TIMESTAMP") {
+        return ColumnType::Date;
+    }
+    return ColumnType::Text;
+}
+
+bool isNumericType(ColumnType type) {
+    return type == ColumnType::Integer || type == ColumnType::Decimal;
+}
+
+int TableSchema::getColumnIndex(const std::string& column) const {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (equalsIgnoreCase(columns[i].name, column)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Parse the whole string as a number
+// Short integers skip strtod
+bool parseNumber(const std::string& text, double& value) {
+    size_t i = text.size() > 1 && text[0] == '-' ? 1 : 0;
+    if (text.size() - i > 0 && text.size() - i <= 15) {
+        int64_t integer = 0;
+        size_t digit = i;
+        while (digit < text.size() && text[digit] >= '0' && text[digit] <= '9') {
+            integer = integer * 10 + (text[digit++] - '0');
+        }
+        if (digit == text.size()) {
+            value = static_cast<double>(i ? -integer : integer);
+            return true;
+        }
+    }
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end == text.c_str() + text.size();
+}
+
+int compareValues(const std::string& left, const std::string& right, ColumnType type) {
+    bool leftNull = isNull(left);
+    bool rightNull = isNull(right);
+    if (leftNull || rightNull) {
+        return (leftNull ? 0 : 1) - (rightNull ? 0 : 1);
+    }
+
+    double leftNumber = 0;
+    double rightNumber = 0;
+    if (isNumericType(type) && parseNumber(left, leftNumber) && parseNumber(right, rightNumber)) {
+        return leftNumber < rightNumber ? -1 : (leftNumber > rightNumber ? 1 : 0);
+    }
+    return left.compare(right) < 0 ? -1 : (left == right ? 0 : 1);
+}
+
+std::string formatDecimal(double value) {
+    char text[32];
+    for (int precision = 15; precision <= 17; ++precision) {
+        std::snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (std::strtod(text, nullptr) == value) {
+            break;
+        }
+    }
+    return text;
+}
+
+std::string encodeIndexKey(const std::string& value, ColumnType type) {
+    if (isNull(value)) {
+        return std::string();  // Sorts before every non-NULL key
+    }
+
+    double number = 0;
+    if (!isNumericType(type) || !parseNumber(value, number)) {
+        return value;
+    }
+
+    // IEEE-754 bits with the sign handled so unsigned order equals numeric order
+    if (number == 0) {
+        number = 0;  // Fold -0 into +0
+    }
+    uint64_t bits = 0;
+    std::memcpy(&bits, &number, sizeof(bits));
+    bits = (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+
+    static const char digits[] = "0123456789abcdef";
+    std::string encoded(17, '#');
+    for (int i = 16; i > 0; --i, bits >>= 4) {
+        encoded[i] = digits[bits & 15];
+    }
+    return encoded;
+}
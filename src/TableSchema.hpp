@@ -0,0 +1,51 @@
+#ifndef TABLESCHEMA_HPP
+#define TABLESCHEMA_HPP
+
+#include <string>
+#include <vector>
+
+// A row holds one string per column. SQL NULL is stored as NULL_VALUE,
+// a value no SQL literal can produce.
+using Row = std::vector<std::string>;
+extern const std::string NULL_VALUE;
+bool isNull(const std::string& value);
+
+// Column types (SQL type names are mapped onto these)
+enum class ColumnType { Integer, Decimal, Text, Date };
+ColumnType parseColumnType(const std::string& sqlType);
+bool isNumericType(ColumnType type);
+
+struct ColumnDef {
+    std::string name;
+    ColumnType type = ColumnType::Text;
+    bool notNull = false;
+};
+
+// TableSchema: columns and key of a table, plus its original definition
+class TableSchema {
+public:
+    std::string name;
+    std::vector<ColumnDef> columns;
+    std::vector<int> primaryKey;   // Column positions
+    std::string definition;        // CREATE TABLE text as given
+
+    // Column position by name (case-insensitive), -1 if missing
+    int getColumnIndex(const std::string& column) const;
+};
+
+// Number value of a whole text value (false if it is not a number)
+bool parseNumber(const std::string& text, double& value);
+
+// Three-way comparison of two values of the given type; NULL sorts first
+int compareValues(const std::string& left, const std::string& right, ColumnType type);
+
+// Order-preserving index key: comparing keys as strings gives the value order
+std::string encodeIndexKey(const std::string& value, ColumnType type);
+
+// DECIMAL text for a double: the shortest form that reads back as the same value
+std::string formatDecimal(double value);
+
+// Case-insensitive identifier comparison
+bool equalsIgnoreCase(const std::string& left, const std::string& right);
+
+#endif // TABLESCHEMA_HPP
@@ -0,0 +1,241 @@
+#include "TableStatistics.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// Position of a value on a number line, for interpolating inside a histogram
+// bucket; false for text. Dates count days, with every month 31 days long.
+bool linearPosition(const std::string& value, ColumnType type, double& position) {
+    if (type == ColumnType::Date) {
+        int year = 0;
+        int month = 0;
+        int day = 0;
+        if (std::sscanf(value.c_str(), "%d-%d-%d", &year, &month, &day) != 3) {
+            return false;
+        }
+        position = year * 372.0 + month * 31.0 + day;
+        return true;
+    }
+    return isNumericType(type) && parseNumber(value, position);
+}
+
+// Fraction of the histogrammed values below value (or at most value)
+double histogramFraction(const std::vector<std::string>& bounds, ColumnType type, const std::string& value,
+                         bool inclusive) {
+    if (bounds.empty()) {
+        return 0.5;
+    }
+    auto below = [&](const std::string& bound) {
+        int order = compareValues(bound, value, type);
+        return inclusive ? order <= 0 : order < 0;
+    };
+    // Bounds before the value's bucket
+    size_t passed = std::partition_point(bounds.begin(), bounds.end(), below) - bounds.begin();
+    if (passed == 0) {
+        return 0;
+    }
+    if (passed == bounds.size()) {
+        return 1;
+    }
+    size_t buckets = bounds.size() - 1;
+    double low = 0;
+    double high = 0;
+    double position = 0;
+    double within = 0.5;
+    if (linearPosition(bounds[passed - 1], type, low) && linearPosition(bounds[passed], type, high) &&
+        linearPosition(value, type, position) && high > low) {
+        within = std::min(1.0, std::max(0.0, (position - low) / (high - low)));
+    }
+    return (static_cast<double>(passed - 1) + within) / static_cast<double>(buckets);
+}
+
+} // namespace
+
+// HyperLogLog Implementation
+void HyperLogLog::add(const std::string& value) {
+    uint64_t hash = mixedHash(value);
+    size_t slot = hash >> (64 - precision);
+    uint64_t rest = hash << precision;
+    uint8_t rank = rest == 0 ? 64 - precision + 1 : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    registers[slot] = std::max(registers[slot], rank);
+}
+
+double HyperLogLog::estimate() const {
+    const double slots = static_cast<double>(registers.size());
+    double sum = 0;
+    size_t empty = 0;
+    for (uint8_t rank : registers) {
+        sum += std::ldexp(1.0, -rank);
+        empty += rank == 0;
+    }
+    double estimate = 0.7213 / (1 + 1.079 / slots) * slots * slots / sum;
+    // Small cardinalities: linear counting of the empty registers is more accurate
+    if (estimate <= 2.5 * slots && empty > 0) {
+        estimate = slots * std::log(slots / static_cast<double>(empty));
+    }
+    return estimate;
+}
+
+// TableStatistics Implementation
+double TableStatistics::selectivity(const BoundCondition& condition) const {
+    int column = condition.column;
+    if (column < 0 || static_cast<size_t>(column) >= columns.size()) {
+        return 1;
+    }
+    const ColumnStatistics& statistics = columns[column];
+    ColumnType type = condition.type;
+    CompareOp op = condition.op;
+    const std::string& value = condition.value;
+    if (op == CompareOp::IsNull || op == CompareOp::IsNotNull) {
+        return op == CompareOp::IsNull ? statistics.nullFraction : 1 - statistics.nullFraction;
+    }
+    if (op == CompareOp::In) {
+        double matching = 0;
+        BoundCondition equal = condition;
+        equal.op = CompareOp::Equal;
+        for (const std::string& candidate : condition.values) {
+            equal.value = candidate;
+            matching += selectivity(equal);
+        }
+        return std::min(1.0, matching);
+    }
+    if (isNull(value)) {
+        return 0;
+    }
+    double common = 0;
+    for (const auto& entry : statistics.mostCommon) {
+        common += entry.second;
+    }
+    double rest = std::max(0.0, 1 - statistics.nullFraction - common);  // Rows the histogram describes
+
+    double equal = 0;
+    bool found = false;
+    for (const auto& [mostCommon, fraction] : statistics.mostCommon) {
+        if (compareValues(mostCommon, value, type) == 0) {
+            equal = fraction;
+            found = true;
+        }
+    }
+    if (!found) {
+        double others = statistics.distinct - static_cast<double>(statistics.mostCommon.size());
+        equal = rest / std::max(1.0, others);
+    }
+    if (op == CompareOp::Equal) {
+        return equal;
+    }
+    if (op == CompareOp::NotEqual) {
+        return std::max(0.0, 1 - statistics.nullFraction - equal);
+    }
+
+    // Fraction below the value (or at most the value)
+    bool inclusive = op == CompareOp::LessEqual || op == CompareOp::Greater;
+    double below = rest * histogramFraction(statistics.histogram, type, value, inclusive);
+    for (const auto& [mostCommon, fraction] : statistics.mostCommon) {
+        int order = compareValues(mostCommon, value, type);
+        below += order < 0 || (inclusive && order == 0) ? fraction : 0;
+    }
+    double result = op == CompareOp::Less || op == CompareOp::LessEqual ? below
+                                                                          : 1 - statistics.nullFraction - below;
+    return std::min(1.0, std::max(0.0, result));
+}
+
+double TableStatistics::distinct(int column) const {
+    if (column < 0 || static_cast<size_t>(column) >= columns.size()) {
+        return 1;
+    }
+    return std::max(1.0, columns[column].distinct);
+}
+
+// StatisticsBuilder Implementation
+StatisticsBuilder::StatisticsBuilder(const TableSchema& tableSchema)
+    : schema(tableSchema),
+      nullCounts(tableSchema.columns.size(), 0),
+      sketches(tableSchema.columns.size()),
+      random(0x5eed) {}
+
+void StatisticsBuilder::add(const Row& row) {
+    for (size_t column = 0; column < row.size() && column < sketches.size(); ++column) {
+        if (isNull(row[column])) {
+            ++nullCounts[column];
+        } else {
+            sketches[column].add(row[column]);
+        }
+    }
+    ++rows;
+    // Reservoir sampling: every row ends up in the sample with the same probability
+    if (sample.size() < sampleSize) {
+        sample.push_back(row);
+    } else {
+        size_t slot = random() % rows;
+        if (slot < sampleSize) {
+            sample[slot] = row;
+        }
+    }
+}
+
+TableStatistics StatisticsBuilder::finish() {
+    TableStatistics statistics;
+    statistics.rowCount = rows;
+    statistics.sampledRows = sample.size();
+    const double sampled = static_cast<double>(sample.size());
+    for (size_t column = 0; column < schema.columns.size(); ++column) {
+        ColumnType type = schema.columns[column].type;
+        ColumnStatistics result;
+        result.nullFraction = rows ? static_cast<double>(nullCounts[column]) / static_cast<double>(rows) : 0;
+
+        std::unordered_map<std::string, size_t> counts;
+        for (const Row& row : sample) {
+            if (column < row.size() && !isNull(row[column])) {
+                ++counts[row[column]];
+            }
+        }
+        // A sample of the whole table counts exactly; otherwise trust the sketch
+        result.distinct = sample.size() == rows ? static_cast<double>(counts.size()) : sketches[column].estimate();
+
+        // Most common values: clearly more frequent than the average value
+        std::vector<std::pair<std::string, size_t>> frequent;
+        size_t values = 0;
+        for (const auto& entry : counts) {
+            values += entry.second;
+        }
+        double average = counts.empty() ? 0 : static_cast<double>(values) / std::max(1.0, result.distinct);
+        for (const auto& entry : counts) {
+            if (entry.second > 1 && static_cast<double>(entry.second) > 1.25 * average) {
+                frequent.push_back(entry);
+            }
+        }
+        std::sort(frequent.begin(), frequent.end(), [&](const auto& left, const auto& right) {
+            return left.second != right.second ? left.second > right.second
+                                               : compareValues(left.first, right.first, type) < 0;
+        });
+        if (frequent.size() > mostCommonLimit) {
+            frequent.resize(mostCommonLimit);
+        }
+        for (const auto& [value, count] : frequent) {
+            result.mostCommon.emplace_back(value, static_cast<double>(count) / sampled);
+            counts.erase(value);
+        }
+
+        // Equi-depth histogram over the remaining sampled values
+        std::vector<std::string> rest;
+        for (const Row& row : sample) {
+            if (column < row.size() && counts.count(row[column])) {
+                rest.push_back(row[column]);
+            }
+        }
+        std::sort(rest.begin(), rest.end(), [&](const std::string& left, const std::string& right) {
+            return compareValues(left, right, type) < 0;
+        });
+        if (!rest.empty()) {
+            size_t buckets = rest.size() < histogramBuckets ? rest.size() : histogramBuckets;
+            for (size_t bound = 0; bound <= buckets; ++bound) {
+                result.histogram.push_back(rest[(rest.size() - 1) * bound / buckets]);
+            }
+        }
+        statistics.columns.push_back(std::move(result));
+    }
+    return statistics;
+}
@@ -0,0 +1,70 @@
+#ifndef TABLESTATISTICS_HPP
+#define TABLESTATISTICS_HPP
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ScanSpec.hpp"
+#include "TableSchema.hpp"
+
+// HyperLogLog sketch of the distinct values of a column: 4096 registers
+// (4 KB) estimate any number of values within about 1.6%
+class HyperLogLog {
+public:
+    void add(const std::string& value);
+    double estimate() const;
+
+private:
+    static const int precision = 12;
+    std::array<uint8_t, 1 << precision> registers{};
+};
+
+// Distribution of one column, from ANALYZE
+struct ColumnStatistics {
+    double nullFraction = 0;
+    double distinct = 0;                                     // Non-null distinct values
+    std::vector<std::pair<std::string, double>> mostCommon;  // Values and their fraction of the rows
+    std::vector<std::string> histogram;  // Equi-depth bucket bounds over the other non-null values
+};
+
+// Statistics of a table as of its last ANALYZE. Fractions stay useful as
+// the table grows, so estimates scale them by the current row count.
+struct TableStatistics {
+    size_t rowCount = 0;
+    size_t sampledRows = 0;
+    std::vector<ColumnStatistics> columns;
+
+    // Fraction of rows for which the condition holds
+    double selectivity(const BoundCondition& condition) const;
+
+    // Non-null distinct values of the column (at least 1)
+    double distinct(int column) const;
+};
+
+// Builds the statistics of a table from all of its rows: null fractions and
+// HyperLogLog distinct counts from every row, most common values and an
+// equi-depth histogram from a fixed-size random sample
+class StatisticsBuilder {
+public:
+    static const size_t sampleSize = 30000;
+    static const size_t mostCommonLimit = 16;
+    static const size_t histogramBuckets = 32;
+
+    explicit StatisticsBuilder(const TableSchema& schema);
+    void add(const Row& row);
+    TableStatistics finish();
+
+private:
+    const TableSchema& schema;
+    size_t rows = 0;
+    std::vector<size_t> nullCounts;
+    std::vector<HyperLogLog> sketches;
+    std::vector<Row> sample;  // Reservoir sample of the rows
+    std::mt19937_64 random;   // Fixed seed: the same table gives the same plans
+};
+
+#endif // TABLESTATISTICS_HPP
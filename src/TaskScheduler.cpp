@@ -0,0 +1,215 @@
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+uint64_t packRange(size_t begin, size_t end) {
+    return (static_cast<uint64_t>(begin) << 32) | static_cast<uint32_t>(end);
+}
+
+// Claims the first unclaimed morsel of a lane (its owner's end)
+bool popFront(std::atomic<uint64_t>& range, size_t& morsel) {
+    uint64_t current = range.load(std::memory_order_relaxed);
+    while (true) {
+        size_t begin = current >> 32;
+        size_t end = static_cast<uint32_t>(current);
+        if (begin >= end) {
+            return false;
+        }
+        if (range.compare_exchange_weak(current, packRange(begin + 1, end), std::memory_order_relaxed)) {
+            morsel = begin;
+            return true;
+        }
+    }
+}
+
+// Claims the last unclaimed morsel of a lane (the thieves' end)
+bool popBack(std::atomic<uint64_t>& range, size_t& morsel) {
+    uint64_t current = range.load(std::memory_order_relaxed);
+    while (true) {
+        size_t begin = current >> 32;
+        size_t end = static_cast<uint32_t>(current);
+        if (begin >= end) {
+            return false;
+        }
+        if (range.compare_exchange_weak(current, packRange(begin, end - 1), std::memory_order_relaxed)) {
+            morsel = end - 1;
+            return true;
+        }
+    }
+}
+
+} // namespace
+
+TaskScheduler::TaskScheduler(size_t workerCount, bool pinToCores) {
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&TaskScheduler::workerLoop, this, i, pinToCores);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+TaskScheduler& TaskScheduler::getInstance() {
+    static TaskScheduler instance(std::max(1u, std::thread::hardware_concurrency()) - 1, true);
+    return instance;
+}
+
+void TaskScheduler::run(size_t morselCount, size_t laneCount, const Task& task) {
+    if (morselCount == 0) {
+        return;
+    }
+    laneCount = std::max<size_t>(1, std::min(laneCount, morselCount));
+    if (workers.empty() || laneCount == 1) {
+        for (size_t morsel = 0; morsel < morselCount; ++morsel) {
+            task(morsel % laneCount, morsel);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->task = &task;
+    job->laneCount = laneCount;
+    job->lanes.reset(new Lane[laneCount]);
+    job->remaining = morselCount;
+    for (size_t lane = 0; lane < laneCount; ++lane) {
+        job->lanes[lane].range = packRange(morselCount * lane / laneCount, morselCount * (lane + 1) / laneCount);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    }
+    wake.notify_all();
+
+    while (runLane(*job, true)) {
+    }
+    {
+        std::unique_lock<std::mutex> lock(job->doneMutex);
+        job->done.wait(lock, [&] { return job->remaining.load(std::memory_order_acquire) == 0; });
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.erase(std::find(jobs.begin(), jobs.end(), job));
+    }
+    if (job->failure) {
+        std::rethrow_exception(job->failure);
+    }
+}
+
+void TaskScheduler::workerLoop(size_t worker, bool pinToCores) {
+#ifdef __linux__
+    if (pinToCores) {
+        // Core 0 is left to the threads that submit queries
+        cpu_set_t cores;
+        CPU_ZERO(&cores);
+        CPU_SET((worker + 1) % std::max(1u, std::thread::hardware_concurrency()), &cores);
+        pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores);
+    }
+#else
+    (void)worker;
+    (void)pinToCores;
+#endif
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        // Round-robin over the jobs that have a free lane and morsels left
+        std::shared_ptr<Job> job;
+        for (size_t i = 0; i < jobs.size() && !job; ++i) {
+            size_t index = (nextJob + i) % jobs.size();
+            if (hasFreeWork(*jobs[index])) {
+                job = jobs[index];
+                nextJob = index + 1;
+            }
+        }
+        if (!job) {
+            if (stopping) {
+                return;
+            }
+            wake.wait(lock);
+            continue;
+        }
+        lock.unlock();
+        runLane(*job, false);
+        lock.lock();
+    }
+}
+
+// Claims a free lane and runs morsels on it: one (pool workers then move on
+// to the next job) or until none are left. False if no morsel was left.
+bool TaskScheduler::runLane(Job& job, bool untilEmpty) {
+    for (size_t lane = 0; lane < job.laneCount; ++lane) {
+        Lane& state = job.lanes[lane];
+        if (state.busy.load(std::memory_order_relaxed) || state.busy.exchange(true, std::memory_order_acquire)) {
+            continue;
+        }
+        bool ran = false;
+        size_t morsel = 0;
+        while ((untilEmpty || !ran) && takeMorsel(job, lane, morsel)) {
+            runMorsel(job, lane, morsel);
+            ran = true;
+        }
+        state.busy.store(false, std::memory_order_release);
+        if (ran) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);  // No worker misses the release between check and wait
+            }
+            wake.notify_one();
+        }
+        return ran;
+    }
+    return false;
+}
+
+bool TaskScheduler::takeMorsel(Job& job, size_t lane, size_t& morsel) {
+    if (popFront(job.lanes[lane].range, morsel)) {
+        return true;
+    }
+    for (size_t i = 1; i < job.laneCount; ++i) {
+        if (popBack(job.lanes[(lane + i) % job.laneCount].range, morsel)) {
+            stolenMorsels.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::runMorsel(Job& job, size_t lane, size_t morsel) {
+    if (!job.failed.load(std::memory_order_relaxed)) {
+        try {
+            (*job.task)(lane, morsel);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.doneMutex);
+            if (!job.failure) {
+                job.failure = std::current_exception();
+            }
+            job.failed = true;
+        }
+    }
+    if (job.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(job.doneMutex);
+        job.done.notify_all();
+    }
+}
+
+bool TaskScheduler::hasFreeWork(Job& job) {
+    bool freeLane = false;
+    bool morsels = false;
+    for (size_t lane = 0; lane < job.laneCount; ++lane) {
+        uint64_t range = job.lanes[lane].range.load(std::memory_order_relaxed);
+        freeLane = freeLane || !job.lanes[lane].busy.load(std::memory_order_relaxed);
+        morsels = morsels || (range >> 32) < static_cast<uint32_t>(range);
+    }
+    return freeLane && morsels;
+}
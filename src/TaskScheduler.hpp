@@ -0,0 +1,86 @@
+#ifndef TASKSCHEDULER_HPP
+#define TASKSCHEDULER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Rows of a table scan morsel: big enough to amortize dispatch, small
+// enough that the last morsels of a scan finish close together
+const size_t morselRows = 1 << 16;
+
+// TaskScheduler: fixed pool of worker threads, pinned to cores, that run
+// query pipelines morsel by morsel.
+//
+// A job is a pipeline fragment applied to morsels 0..n-1 (row ranges of a
+// scan, input batches, hash partitions). It runs on lanes: per-lane state
+// such as a pre-aggregation table is only ever touched by one thread at a
+// time, whichever thread holds the lane. Each lane starts with a contiguous
+// block of morsels, so a core works through neighbouring rows; a lane that
+// runs dry steals morsels from the back of the others' blocks.
+//
+// The thread that calls run() works on its own job until it is done. Pool
+// workers serve all running jobs round-robin, one morsel at a time, so a
+// large query gets every idle core while concurrent queries share them.
+class TaskScheduler {
+public:
+    using Task = std::function<void(size_t lane, size_t morsel)>;
+
+    explicit TaskScheduler(size_t workerCount, bool pinToCores = false);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // Shared pool: one worker per core besides the calling thread
+    static TaskScheduler& getInstance();
+
+    size_t getWorkerCount() const { return workers.size(); }
+
+    // Runs task(lane, morsel) for every morsel, with lanes in [0, laneCount).
+    // Returns when all morsels are done; the first exception a task throws is
+    // rethrown here and the morsels not yet started are skipped. Without pool
+    // workers the morsels run on this thread, morsel m on lane m % laneCount.
+    void run(size_t morselCount, size_t laneCount, const Task& task);
+
+    // Morsels run on a lane other than the one they started on (for tests and EXPLAIN)
+    uint64_t getStolenMorsels() const { return stolenMorsels.load(std::memory_order_relaxed); }
+
+private:
+    struct Lane {
+        std::atomic<uint64_t> range{0};  // Unclaimed morsels: begin in the high half, end in the low half
+        std::atomic<bool> busy{false};   // Held by a thread
+    };
+    struct Job {
+        const Task* task = nullptr;
+        size_t laneCount = 0;
+        std::unique_ptr<Lane[]> lanes;
+        std::atomic<size_t> remaining{0};  // Morsels not yet finished
+        std::atomic<bool> failed{false};
+        std::exception_ptr failure;        // Guarded by doneMutex
+        std::mutex doneMutex;
+        std::condition_variable done;
+    };
+
+    void workerLoop(size_t worker, bool pinToCores);
+    bool runLane(Job& job, bool untilEmpty);
+    bool takeMorsel(Job& job, size_t lane, size_t& morsel);
+    void runMorsel(Job& job, size_t lane, size_t morsel);
+    static bool hasFreeWork(Job& job);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;              // A job was added or a lane was released
+    std::vector<std::shared_ptr<Job>> jobs;    // Jobs with unclaimed morsels, served round-robin
+    size_t nextJob = 0;
+    bool stopping = false;
+    std::atomic<uint64_t> stolenMorsels{0};
+};
+
+#endif // TASKSCHEDULER_HPP
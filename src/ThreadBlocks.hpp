@@ -0,0 +1,90 @@
+#ifndef THREADBLOCKS_HPP
+#define THREADBLOCKS_HPP
+
+#include <atomic>
+
+// ThreadBlockList: per-thread blocks of state on a lock-free list. A block
+// belongs to one owner at a time, which writes it without locks, while any
+// thread may walk the list and read every block. Blocks released by exited
+// threads are reused and never freed, so nothing recorded in them is lost
+// and a thread exiting after static destruction still finds its block.
+//
+// Block needs `std::atomic<bool> inUse` and `Block* next`. The calling
+// thread's block sits in one thread-local slot per Block type, so a Block
+// type belongs to a single list.
+template <typename Block>
+class ThreadBlockList {
+public:
+    // exitHook (may be null) runs on a thread's block when the thread exits, before the block is released
+    explicit ThreadBlockList(void (*exitHook)(Block&) = nullptr) : blocks(nullptr), onThreadExit(exitHook) {}
+
+    ThreadBlockList(const ThreadBlockList&) = delete;
+    ThreadBlockList& operator=(const ThreadBlockList&) = delete;
+
+    // The calling thread's block, acquired on first use
+    Block& local() {
+        if (!owner.block) {
+            owner.block = acquire();
+            owner.exitHook = onThreadExit;
+        }
+        return *owner.block;
+    }
+
+    // The calling thread's block if it has one yet, else null
+    Block* current() const {
+        return owner.block;
+    }
+
+    // A block for an owner other than the calling thread: reuses a released one or publishes a new one
+    Block* acquire() {
+        for (Block* block = head(); block; block = block->next) {
+            bool expected = false;
+            if (!block->inUse.load(std::memory_order_relaxed) &&
+                block->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                return block;
+            }
+        }
+        Block* block = new Block();
+        block->inUse.store(true, std::memory_order_relaxed);
+        Block* first = blocks.load(std::memory_order_relaxed);
+        do {
+            block->next = first;
+        } while (!blocks.compare_exchange_weak(first, block, std::memory_order_release, std::memory_order_relaxed));
+        return block;
+    }
+
+    static void release(Block* block) {
+        block->inUse.store(false, std::memory_order_release);
+    }
+
+    // Every block ever published, in use or not (follow next)
+    Block* head() const {
+        return blocks.load(std::memory_order_acquire);
+    }
+
+private:
+    // Hands the thread's block back when the thread exits (without touching the list, which may be gone)
+    struct Owner {
+        Block* block = nullptr;
+        void (*exitHook)(Block&) = nullptr;
+
+        ~Owner() {
+            if (block) {
+                if (exitHook) {
+                    exitHook(*block);
+                }
+                release(block);
+            }
+        }
+    };
+
+    static thread_local Owner owner;
+
+    std::atomic<Block*> blocks;
+    void (*onThreadExit)(Block&);
+};
+
+template <typename Block>
+thread_local typename ThreadBlockList<Block>::Owner ThreadBlockList<Block>::owner;
+
+#endif // THREADBLOCKS_HPP
@@ -0,0 +1,134 @@
+#include "Trace.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// Trace thread numbers, in the order buffers are created
+std::atomic<int> nextThreadId{1};
+
+// Span names are literals from the engine, but escape them anyway
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\' << *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            out << ' ';
+        } else {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+Tracer::ThreadBuffer::ThreadBuffer() : threadId(nextThreadId.fetch_add(1, std::memory_order_relaxed)) {}
+
+Tracer::Tracer() : enabled(false), generation(0), startTicks(0) {}
+
+// Buffers are left allocated: threads that exit after static destruction still release theirs
+Tracer::~Tracer() = default;
+
+Tracer& Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+void Tracer::start() {
+    startTicks.store(CycleClock::now(), std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_release);
+    CycleClock::ticksPerNanosecond();  // Calibrate before the first dump, not during it
+    enabled.store(true, std::memory_order_release);
+}
+
+void Tracer::stop() {
+    enabled.store(false, std::memory_order_release);
+}
+
+// Only the owning thread writes its buffer; it empties it when a new trace has started
+void Tracer::record(const char* category, const char* name, uint64_t start, uint64_t end) {
+    ThreadBuffer& buffer = buffers.local();
+    uint64_t current = generation.load(std::memory_order_acquire);
+    if (buffer.generation.load(std::memory_order_relaxed) != current) {
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.generation.store(current, std::memory_order_release);
+    }
+    size_t count = buffer.count.load(std::memory_order_relaxed);
+    if (count == ThreadBuffer::capacity) {
+        buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[count] = TraceEvent{category, name, start, end - start};
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+std::string Tracer::toChromeJson() const {
+    uint64_t current = generation.load(std::memory_order_acquire);
+    uint64_t origin = startTicks.load(std::memory_order_relaxed);
+    double ticksPerMicrosecond = CycleClock::ticksPerNanosecond() * 1000.0;
+
+    std::ostringstream out;
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    for (ThreadBuffer* buffer = buffers.head(); buffer; buffer = buffer->next) {
+        if (buffer->generation.load(std::memory_order_acquire) != current) {
+            continue;
+        }
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        if (count == 0) {
+            continue;
+        }
+        out << (first ? "" : ",") << "\n{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": "
+            << buffer->threadId << ", \"args\": {\"name\": \"thread " << buffer->threadId << "\"}}";
+        first = false;
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->events[i];
+            char timing[96];
+            double start = event.start >= origin ? (event.start - origin) / ticksPerMicrosecond : 0.0;
+            std::snprintf(timing, sizeof(timing), "\"ts\": %.3f, \"dur\": %.3f", start,
+                          event.duration / ticksPerMicrosecond);
+            out << ",\n{\"ph\": \"X\", \"cat\": ";
+            writeJsonString(out, event.category);
+            out << ", \"name\": ";
+            writeJsonString(out, event.name);
+            out << ", \"pid\": 1, \"tid\": " << buffer->threadId << ", " << timing << "}";
+        }
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+bool Tracer::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << toChromeJson();
+    return static_cast<bool>(out);
+}
+
+size_t Tracer::getEventCount() const {
+    uint64_t current = generation.load(std::memory_order_acquire);
+    size_t total = 0;
+    for (ThreadBuffer* buffer = buffers.head(); buffer; buffer = buffer->next) {
+        if (buffer->generation.load(std::memory_order_acquire) == current) {
+            total += buffer->count.load(std::memory_order_acquire);
+        }
+    }
+    return total;
+}
+
+uint64_t Tracer::getDroppedCount() const {
+    uint64_t current = generation.load(std::memory_order_acquire);
+    uint64_t total = 0;
+    for (ThreadBuffer* buffer = buffers.head(); buffer; buffer = buffer->next) {
+        if (buffer->generation.load(std::memory_order_acquire) == current) {
+            total += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
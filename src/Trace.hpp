@@ -0,0 +1,108 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "CycleClock.hpp"
+#include "ThreadBlocks.hpp"
+
+// Spans are compiled in unless DB_TRACING is 0; compiled-in spans cost one
+// relaxed load while tracing is stopped
+#ifndef DB_TRACING
+#define DB_TRACING 1
+#endif
+
+// One completed span
+struct TraceEvent {
+    const char* category;  // String literal
+    const char* name;      // String literal
+    uint64_t start;        // CycleClock ticks
+    uint64_t duration;     // CycleClock ticks
+};
+
+// Tracer: records timed spans into per-thread buffers while tracing is on
+// and writes them out as Chrome trace-event JSON (chrome://tracing, Perfetto).
+// Each thread appends to its own fixed-size buffer without locks; a full
+// buffer drops further spans (counted) instead of overwriting, so a dump
+// only ever reads finished events. Buffers of exited threads are reused (see
+// ThreadBlockList). start() begins a new trace and discards the previous one.
+class Tracer {
+public:
+    static Tracer& getInstance();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    void start();
+    void stop();
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    void record(const char* category, const char* name, uint64_t start, uint64_t end);
+
+    // {"traceEvents": [...]} with one complete ("X") event per span, in microseconds since start()
+    std::string toChromeJson() const;
+    bool writeChromeTrace(const std::string& path) const;
+
+    size_t getEventCount() const;
+    uint64_t getDroppedCount() const;
+
+    // Per-thread span buffer
+    struct ThreadBuffer {
+        static const size_t capacity = 1 << 16;
+
+        ThreadBuffer();
+
+        std::unique_ptr<TraceEvent[]> events{new TraceEvent[capacity]};
+        std::atomic<size_t> count{0};            // Published events of the current generation
+        std::atomic<uint64_t> generation{0};     // Trace the events belong to
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> inUse{false};
+        int threadId;                            // "tid" of its events, fixed before the buffer is published
+        ThreadBuffer* next = nullptr;
+    };
+
+private:
+    Tracer();
+    ~Tracer();
+
+    std::atomic<bool> enabled;
+    std::atomic<uint64_t> generation;   // Incremented by start()
+    std::atomic<uint64_t> startTicks;
+    ThreadBlockList<ThreadBuffer> buffers;
+};
+
+// TraceSpan: records the lifetime of the scope as one event
+class TraceSpan {
+public:
+    TraceSpan(const char* spanCategory, const char* spanName)
+        : category(spanCategory), name(spanName),
+          start(Tracer::getInstance().isEnabled() ? CycleClock::now() : 0) {}
+    ~TraceSpan() {
+        if (start) {
+            Tracer::getInstance().record(category, name, start, CycleClock::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* category;
+    const char* name;
+    uint64_t start;  // 0: tracing was off when the scope began
+};
+
+#define DB_TRACE_CONCAT_INNER(a, b) a##b
+#define DB_TRACE_CONCAT(a, b) DB_TRACE_CONCAT_INNER(a, b)
+
+// TRACE_SPAN("wal", "fsync"): time the rest of the enclosing scope
+#if DB_TRACING
+#define TRACE_SPAN(category, name) TraceSpan DB_TRACE_CONCAT(traceSpan_, __LINE__)(category, name)
+#else
+#define TRACE_SPAN(category, name) do {} while (0)
+#endif
+
+#endif // TRACE_HPP
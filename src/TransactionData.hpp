@@ -7,6 +7,7 @@
 class TransactionData {
 public:
     std::vector<std::string> changes;  // List of changes (SQL queries)
+    std::vector<std::string> applied;  // Changes that took effect on commit (what the log records)
 
     void addChange(const std::string& change) {
         changes.push_back(change);  // Add a change (e.g., SQL query)
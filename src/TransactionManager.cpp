@@ -1,21 +1,49 @@
 #include "TransactionManager.hpp"
 #include "StorageEngine.hpp"
-#include <iostream>
+#include "QueryProcessor.hpp"
+#include "EpochManager.hpp"
+#include "Logger.hpp"
 
 // TransactionManager Implementation
-TransactionManager::TransactionManager(StorageEngine* engine) 
-    : currentState(nullptr), transactionData(nullptr), storageEngine(engine) {}
+TransactionManager::TransactionManager(StorageEngine* engine, QueryProcessor* processor)
+    : currentState(nullptr), transactionData(nullptr), storageEngine(engine), queryProcessor(processor), epochPin(nullptr) {}
 
 TransactionManager::~TransactionManager() {
+    if (epochPin) {
+        endTransaction();
+    }
     delete currentState;
     if (transactionData) {
         delete transactionData;
     }
 }
 
+// Pin the reclamation epoch: nothing this transaction may read is freed until it ends
+void TransactionManager::beginTransaction() {
+    if (epochPin) {
+        return;
+    }
+    epochPin = EpochManager::getInstance().pin();
+}
+
+// Unpin the epoch and reclaim whatever became unreachable meanwhile
+void TransactionManager::endTransaction() {
+    if (!epochPin) {
+        return;
+    }
+    EpochManager::getInstance().unpin(epochPin);
+    epochPin = nullptr;
+    EpochManager::getInstance().tryReclaim();
+}
+
+bool TransactionManager::isInTransaction() const {
+    return epochPin != nullptr;
+}
+
 void TransactionManager::setState(TransactionState* state) {
     if (currentState) {
-        delete currentState;  // Clean up previous state
+        // Deferred: the old state may still be running (a state can switch to its successor from handle())
+        EpochManager::getInstance().retire(currentState);
     }
     currentState = state;  // Set the new state
 }
@@ -24,13 +52,13 @@ void TransactionManager::handleTransaction() {
     if (currentState) {
         currentState->handle(this);  // Delegate to the current state
     } else {
-        std::cerr << "No transaction state set!" << std::endl;
+        LOG_ERROR("No transaction state set!");
     }
 }
 
 void TransactionManager::setTransactionData(TransactionData* data) {
     if (transactionData) {
-        delete transactionData;
+        EpochManager::getInstance().retire(transactionData);
     }
     transactionData = data;  // Set the transaction data
 }
@@ -43,9 +71,13 @@ StorageEngine* TransactionManager::getStorageEngine() {
     return storageEngine;
 }
 
+QueryProcessor* TransactionManager::getQueryProcessor() {
+    return queryProcessor;
+}
+
 // ActiveState Implementation
 void ActiveState::handle(TransactionManager* manager) {
-    std::cout << "Transaction is active. Locking resources and tracking changes..." << std::endl;
+    LOG_DEBUG("Transaction is active. Locking resources and tracking changes...");
 
     // Lock resources
     lockResources(manager);
@@ -58,11 +90,11 @@ void ActiveState::handle(TransactionManager* manager) {
 }
 
 void ActiveState::lockResources(TransactionManager* manager) {
-    std::cout << "Locking resources for transaction..." << std::endl;
+    LOG_DEBUG("Locking resources for transaction...");
 }
 
 void ActiveState::trackChanges(TransactionManager* manager) {
-    std::cout << "Tracking changes..." << std::endl;
+    LOG_DEBUG("Tracking changes...");
 
     // Create new TransactionData and add changes
     manager->setTransactionData(new TransactionData());
@@ -71,7 +103,7 @@ void ActiveState::trackChanges(TransactionManager* manager) {
 
 // CommittedState Implementation
 void CommittedState::handle(TransactionManager* manager) {
-    std::cout << "Transaction has been committed. Applying changes..." << std::endl;
+    LOG_DEBUG("Transaction has been committed. Applying changes...");
 
     // Apply changes (write to the database)
     applyChanges(manager);
@@ -83,21 +115,29 @@ void CommittedState::handle(TransactionManager* manager) {
 void CommittedState::applyChanges(TransactionManager* manager) {
     TransactionData* data = manager->getTransactionData();
     if (data) {
-        std::cout << "Applying changes to the database..." << std::endl;
+        LOG_DEBUG("Applying changes to the database...");
+        data->applied.clear();
         for (const auto& change : data->changes) {
-            std::cout << "Executing: " << change << std::endl;
-            manager->getStorageEngine()->storeData(change);  // Store the changes
+            LOG_DEBUG("Executing: " << change);
+            if (manager->getQueryProcessor()) {
+                if (!manager->getQueryProcessor()->executeQuery(change).success) {  // Apply the statement
+                    continue;
+                }
+            } else {
+                manager->getStorageEngine()->storeData(change);  // Store the changes
+            }
+            data->applied.push_back(change);
         }
     }
 }
 
 void CommittedState::releaseLocks(TransactionManager* manager) {
-    std::cout << "Releasing locks after commit." << std::endl;
+    LOG_DEBUG("Releasing locks after commit.");
 }
 
 // AbortedState Implementation
 void AbortedState::handle(TransactionManager* manager) {
-    std::cout << "Transaction has been aborted. Rolling back changes..." << std::endl;
+    LOG_DEBUG("Transaction has been aborted. Rolling back changes...");
 
     // Rollback changes
     rollbackChanges(manager);
@@ -107,10 +147,10 @@ void AbortedState::handle(TransactionManager* manager) {
 }
 
 void AbortedState::rollbackChanges(TransactionManager* manager) {
-    std::cout << "Rolling back changes..." << std::endl;
+    LOG_DEBUG("Rolling back changes...");
     // Code to undo any changes made during the transaction
 }
 
 void AbortedState::releaseLocks(TransactionManager* manager) {
-    std::cout << "Releasing locks after abort." << std::endl;
+    LOG_DEBUG("Releasing locks after abort.");
 }
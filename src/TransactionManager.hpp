@@ -6,12 +6,14 @@
 #include <iostream>
 #include "TransactionData.hpp"
 #include "StorageEngine.hpp"
+#include "EpochManager.hpp"
 
 // Forward declarations of state classes
 class TransactionManager;
 class TransactionState;
 class TransactionData;
 class StorageEngine;
+class QueryProcessor;
 
 // Abstract TransactionState class
 class TransactionState {
@@ -26,18 +28,27 @@ private:
     TransactionState* currentState;  // Current state of the transaction
     TransactionData* transactionData;  // Data associated with the transaction
     StorageEngine* storageEngine;  // The storage engine managing the database
+    QueryProcessor* queryProcessor;  // Executes committed statements (null: changes are stored as raw data)
+    EpochManager::ThreadRecord* epochPin;  // Held between beginTransaction() and endTransaction()
 public:
 
-    TransactionManager(StorageEngine* engine);
+    TransactionManager(StorageEngine* engine, QueryProcessor* processor = nullptr);
     ~TransactionManager();
 
-    void setState(TransactionState* state);  // Set the transaction state
+    // Transaction boundaries: pin/unpin the reclamation epoch. The pin belongs
+    // to the transaction, so it may begin and end on different threads.
+    void beginTransaction();
+    void endTransaction();
+    bool isInTransaction() const;
+
+    void setState(TransactionState* state);  // Set the transaction state (old one is retired)
     void handleTransaction();  // Handle the transaction
 
-    void setTransactionData(TransactionData* data);  // Set transaction data
+    void setTransactionData(TransactionData* data);  // Set transaction data (old one is retired)
     TransactionData* getTransactionData();  // Get transaction data
 
     StorageEngine* getStorageEngine();  // Get the storage engine
+    QueryProcessor* getQueryProcessor();  // Get the statement executor (may be null)
 };
 
 // ActiveState class
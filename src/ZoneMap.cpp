@@ -0,0 +1,154 @@
+#include "ZoneMap.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+
+namespace {
+
+// Three bits in one 64-bit word
+uint64_t bloomMask(uint64_t hash) {
+    return (1ULL << (hash & 63)) | (1ULL << ((hash >> 6) & 63)) | (1ULL << ((hash >> 12) & 63));
+}
+
+size_t bloomWord(uint64_t hash) {
+    return (hash >> 32) % ZoneMap::bloomWords;
+}
+
+} // namespace
+
+// ColumnZone Implementation
+void ColumnZone::add(const std::string& value) {
+    if (isNull(value)) {
+        ++nulls;
+        return;
+    }
+    bool first = values++ == 0;
+    if (isNumericType(type)) {
+        double number = 0;
+        if (!parseNumber(value, number)) {
+            ordered = false;
+        } else if (first) {
+            low = high = number;
+        } else {
+            low = std::min(low, number);
+            high = std::max(high, number);
+        }
+        return;
+    }
+    if (first || value < min) {
+        min = value;
+    }
+    if (first || value > max) {
+        max = value;
+    }
+    if (type == ColumnType::Text) {
+        if (bloom.empty()) {
+            bloom.assign(ZoneMap::bloomWords, 0);
+        }
+        uint64_t hash = mixedHash(value);
+        bloom[bloomWord(hash)] |= bloomMask(hash);
+    }
+}
+
+// Some covered value may equal value (value is not NULL)
+bool ColumnZone::mayEqual(const std::string& value) const {
+    if (!ordered) {
+        return true;
+    }
+    if (isNumericType(type)) {
+        double number = 0;
+        return !parseNumber(value, number) || (number >= low && number <= high);
+    }
+    if (value < min || value > max) {
+        return false;
+    }
+    if (bloom.empty()) {
+        return true;
+    }
+    uint64_t hash = mixedHash(value);
+    uint64_t mask = bloomMask(hash);
+    return (bloom[bloomWord(hash)] & mask) == mask;
+}
+
+// Mirrors BoundCondition::matches: comparisons with NULL are never true
+bool ColumnZone::mayMatch(const BoundCondition& condition) const {
+    CompareOp op = condition.op;
+    if (op == CompareOp::IsNull) {
+        return nulls > 0;
+    }
+    if (values == 0) {
+        return false;
+    }
+    if (op == CompareOp::IsNotNull) {
+        return true;
+    }
+    if (op == CompareOp::In) {
+        for (const std::string& candidate : condition.values) {
+            if (!isNull(candidate) && mayEqual(candidate)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    const std::string& value = condition.value;
+    if (isNull(value)) {
+        return false;
+    }
+    if (op == CompareOp::Equal) {
+        return mayEqual(value);
+    }
+    if (!ordered) {
+        return true;
+    }
+
+    // Three-way comparisons of the smallest and largest value with value
+    int lowOrder = 0;
+    int highOrder = 0;
+    if (isNumericType(type)) {
+        double number = 0;
+        if (!parseNumber(value, number)) {
+            return true;  // Compared as text
+        }
+        lowOrder = low < number ? -1 : (low > number ? 1 : 0);
+        highOrder = high < number ? -1 : (high > number ? 1 : 0);
+    } else {
+        lowOrder = min.compare(value) < 0 ? -1 : (min == value ? 0 : 1);
+        highOrder = max.compare(value) < 0 ? -1 : (max == value ? 0 : 1);
+    }
+    switch (op) {
+        case CompareOp::NotEqual: return lowOrder != 0 || highOrder != 0;
+        case CompareOp::Less: return lowOrder < 0;
+        case CompareOp::LessEqual: return lowOrder <= 0;
+        case CompareOp::Greater: return highOrder > 0;
+        case CompareOp::GreaterEqual: return highOrder >= 0;
+        default: return true;
+    }
+}
+
+// ZoneMap Implementation
+ZoneMap::ZoneMap(const std::vector<ColumnType>& types) : columns(types.size()) {
+    for (size_t column = 0; column < types.size(); ++column) {
+        columns[column].type = types[column];
+    }
+}
+
+void ZoneMap::add(const Row& row) {
+    for (size_t column = 0; column < row.size() && column < columns.size(); ++column) {
+        columns[column].add(row[column]);
+    }
+}
+
+void ZoneMap::add(int column, const std::string& value) {
+    if (column >= 0 && static_cast<size_t>(column) < columns.size()) {
+        columns[column].add(value);
+    }
+}
+
+bool ZoneMap::mayMatch(const std::vector<BoundCondition>& filter) const {
+    for (const BoundCondition& condition : filter) {
+        if (condition.column >= 0 && static_cast<size_t>(condition.column) < columns.size() &&
+            !columns[condition.column].mayMatch(condition)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef ZONEMAP_HPP
+#define ZONEMAP_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ScanSpec.hpp"
+#include "TableSchema.hpp"
+
+// Synopsis of one column over a block of rows. Values overwritten by an
+// update stay counted, so the synopsis may cover more than the block holds
+// now; it never covers less.
+struct ColumnZone {
+    ColumnType type = ColumnType::Text;
+    uint32_t nulls = 0;    // NULLs written to the block
+    uint32_t values = 0;   // Non-NULL values written to the block
+    bool ordered = true;   // min/max valid (a non-number in a numeric column clears it)
+    double low = 0;        // Numeric columns: smallest and largest value
+    double high = 0;
+    std::string min;       // Other columns: smallest and largest value
+    std::string max;
+    std::vector<uint64_t> bloom;  // Text columns: blocked bloom filter of the values
+
+    // False only if no value the zone covers can satisfy the condition
+    bool mayMatch(const BoundCondition& condition) const;
+    void add(const std::string& value);
+
+private:
+    bool mayEqual(const std::string& value) const;
+};
+
+// Zone map of a block of rows: per column min/max, NULL count and, for text
+// columns, a bloom filter. Scans skip blocks whose zone map rules out a filter term.
+class ZoneMap {
+public:
+    static const size_t bloomWords = 512;  // 4 KB per text column: eight bits per value of a full block
+
+    explicit ZoneMap(const std::vector<ColumnType>& types);
+    void add(const Row& row);
+    void add(int column, const std::string& value);
+
+    // False if no row of the block can pass every term of the filter
+    bool mayMatch(const std::vector<BoundCondition>& filter) const;
+    const ColumnZone& getColumn(int column) const { return columns[column]; }
+
+private:
+    std::vector<ColumnZone> columns;
+};
+
+#endif // ZONEMAP_HPP
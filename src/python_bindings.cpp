@@ -1,25 +1,512 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include "TransactionManager.hpp"
 #include "StorageEngine.hpp"
 #include "DatabaseEngine.hpp"
+#include "Session.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include "ArrowInterface.hpp"
 
 namespace py = pybind11;
 
+// Engine calls run without the GIL so Python threads can query in parallel
+using ReleaseGil = py::call_guard<py::gil_scoped_release>;
+
+// Column position from a name or an index
+static size_t columnPosition(const ColumnarResult& result, const py::object& key) {
+    if (py::isinstance<py::str>(key)) {
+        int index = result.getColumnIndex(key.cast<std::string>());
+        if (index < 0) {
+            throw py::key_error("unknown column " + key.cast<std::string>());
+        }
+        return static_cast<size_t>(index);
+    }
+    long long index = key.cast<long long>();
+    if (index < 0 || static_cast<size_t>(index) >= result.columns.size()) {
+        throw py::index_error("column index out of range");
+    }
+    return static_cast<size_t>(index);
+}
+
+// Read-only NumPy view of a result buffer; the array keeps the result alive
+template <typename T>
+static py::array viewOf(const T* data, size_t count, const py::object& owner) {
+    py::array_t<T> array({count}, {sizeof(T)}, data, owner);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+// Integer and Decimal columns are views; Text and Date become one fixed-width bytes array
+static py::array columnArray(const py::object& owner, size_t position) {
+    const ResultColumn& column = owner.cast<const ColumnarResult&>().columns[position];
+    size_t rows = owner.cast<const ColumnarResult&>().rowCount;
+    switch (column.type) {
+        case ColumnType::Integer:
+            return viewOf(column.integers.data(), rows, owner);
+        case ColumnType::Decimal:
+            return viewOf(column.decimals.data(), rows, owner);
+        case ColumnType::Text:
+        case ColumnType::Date:
+            break;
+    }
+    size_t width = 1;
+    for (size_t i = 0; i < rows; ++i) {
+        width = std::max(width, static_cast<size_t>(column.offsets[i + 1] - column.offsets[i]));
+    }
+    py::array array(py::dtype("S" + std::to_string(width)), std::vector<py::ssize_t>{static_cast<py::ssize_t>(rows)});
+    char* out = static_cast<char*>(array.mutable_data());
+    {
+        py::gil_scoped_release release;
+        std::memset(out, 0, rows * width);
+        for (size_t i = 0; i < rows; ++i) {
+            std::memcpy(out + i * width, column.data.data() + column.offsets[i], column.offsets[i + 1] - column.offsets[i]);
+        }
+    }
+    return array;
+}
+
+static const char* columnTypeName(ColumnType type) {
+    switch (type) {
+        case ColumnType::Integer: return "integer";
+        case ColumnType::Decimal: return "decimal";
+        case ColumnType::Text: return "text";
+        case ColumnType::Date: return "date";
+    }
+    return "text";
+}
+
+// Arrow PyCapsule interface: capsules own the structures and release them unless a consumer moved them out
+static void releaseSchemaCapsule(PyObject* capsule) {
+    auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(capsule, "arrow_schema"));
+    if (schema && schema->release) {
+        schema->release(schema);
+    }
+    delete schema;
+}
+
+static void releaseArrayCapsule(PyObject* capsule) {
+    auto* array = static_cast<ArrowArray*>(PyCapsule_GetPointer(capsule, "arrow_array"));
+    if (array && array->release) {
+        array->release(array);
+    }
+    delete array;
+}
+
+// Moves the structure out of a capsule made by another library (the capsule keeps a released shell)
+template <typename T>
+static T takeFromCapsule(const py::object& capsule, const char* name) {
+    auto* source = static_cast<T*>(PyCapsule_GetPointer(capsule.ptr(), name));
+    if (!source) {
+        throw py::error_already_set();
+    }
+    if (!source->release) {
+        throw py::value_error(std::string(name) + " capsule was already consumed");
+    }
+    T taken = *source;
+    source->release = nullptr;
+    return taken;
+}
+
+// Bulk insert from any object implementing __arrow_c_stream__ (tables, readers)
+// or __arrow_c_array__ (record batches); the conversion runs without the GIL
+template <typename Target>
+static QueryResult insertArrowObject(Target& target, const std::string& table, const py::object& source) {
+    if (py::hasattr(source, "__arrow_c_stream__")) {
+        ArrowArrayStream stream = takeFromCapsule<ArrowArrayStream>(source.attr("__arrow_c_stream__")(), "arrow_array_stream");
+        py::gil_scoped_release release;
+        QueryResult total;
+        total.success = true;
+        while (true) {
+            ArrowSchema schema;
+            ArrowArray array;
+            if (stream.get_schema(&stream, &schema) != 0) {
+                total.success = false;
+            } else if (stream.get_next(&stream, &array) != 0) {
+                schema.release(&schema);
+                total.success = false;
+            } else if (!array.release) {
+                schema.release(&schema);
+                break;  // End of stream
+            }
+            if (!total.success) {
+                const char* error = stream.get_last_error(&stream);
+                total.message = error ? error : "Arrow stream failed";
+                break;
+            }
+            QueryResult batch = target.insertArrow(table, &schema, &array);
+            if (!batch.success) {
+                total = batch;
+                break;
+            }
+            total.affectedRows += batch.affectedRows;
+        }
+        stream.release(&stream);
+        return total;
+    }
+    if (py::hasattr(source, "__arrow_c_array__")) {
+        py::tuple capsules = source.attr("__arrow_c_array__")();
+        ArrowSchema schema = takeFromCapsule<ArrowSchema>(capsules[0], "arrow_schema");
+        ArrowArray array = takeFromCapsule<ArrowArray>(capsules[1], "arrow_array");
+        py::gil_scoped_release release;
+        return target.insertArrow(table, &schema, &array);
+    }
+    throw py::type_error("insertArrow expects an object with __arrow_c_stream__ or __arrow_c_array__");
+}
+
+// Engine text for a Python value: None is NULL, numbers are formatted without calling str()
+static std::string valueText(py::handle value) {
+    if (value.is_none()) {
+        return NULL_VALUE;
+    }
+    if (PyBool_Check(value.ptr())) {
+        return value.ptr() == Py_True ? "1" : "0";
+    }
+    if (PyLong_Check(value.ptr())) {
+        int overflow = 0;
+        long long number = PyLong_AsLongLongAndOverflow(value.ptr(), &overflow);
+        if (!overflow) {
+            return std::to_string(number);
+        }
+    } else if (PyFloat_Check(value.ptr())) {
+        double number = PyFloat_AS_DOUBLE(value.ptr());
+        return std::isnan(number) ? NULL_VALUE : formatDecimal(number);
+    } else if (PyBytes_Check(value.ptr())) {
+        return value.cast<std::string>();
+    }
+    return py::str(value).cast<std::string>();
+}
+
+// A 1-D NumPy array of a numeric dtype, read without the GIL
+struct NumericColumn {
+    size_t position;       // Column in the batch
+    const char* data;
+    py::ssize_t stride;
+    char kind;             // NumPy kind: 'i', 'u', 'f' or 'b'
+    py::ssize_t itemSize;
+};
+
+static bool isNumericArray(const py::array& array) {
+    std::string kinds = "iufb";
+    return array.ndim() == 1 && kinds.find(array.dtype().kind()) != std::string::npos &&
+           array.dtype().attr("isnative").cast<bool>();
+}
+
+template <typename T>
+static T loadItem(const char* item) {
+    T value;
+    std::memcpy(&value, item, sizeof(T));
+    return value;
+}
+
+// NaN reads as NULL, as in pandas
+static std::string numericText(const NumericColumn& column, size_t index) {
+    const char* item = column.data + static_cast<py::ssize_t>(index) * column.stride;
+    switch (column.kind) {
+        case 'b':
+            return *item ? "1" : "0";
+        case 'f': {
+            double value = column.itemSize == 4 ? loadItem<float>(item) : loadItem<double>(item);
+            return std::isnan(value) ? NULL_VALUE : formatDecimal(value);
+        }
+        case 'u':
+            switch (column.itemSize) {
+                case 1: return std::to_string(loadItem<uint8_t>(item));
+                case 2: return std::to_string(loadItem<uint16_t>(item));
+                case 4: return std::to_string(loadItem<uint32_t>(item));
+                default: return std::to_string(loadItem<uint64_t>(item));
+            }
+        default:
+            switch (column.itemSize) {
+                case 1: return std::to_string(loadItem<int8_t>(item));
+                case 2: return std::to_string(loadItem<int16_t>(item));
+                case 4: return std::to_string(loadItem<int32_t>(item));
+                default: return std::to_string(loadItem<int64_t>(item));
+            }
+    }
+}
+
+// insert_many: a dict of columns (sequences or NumPy arrays), or a sequence of
+// rows (tuples or dicts). Python objects are read with the GIL held; NumPy
+// buffers are formatted and the batch is inserted without it.
+template <typename Target>
+static QueryResult insertManyObject(Target& target, const std::string& table, const py::object& source,
+                                    std::vector<std::string> columns) {
+    std::vector<Row> rows;
+    std::vector<py::array> arrays;         // Keeps the NumPy buffers alive
+    std::vector<NumericColumn> numeric;
+
+    if (py::isinstance<py::dict>(source)) {
+        py::dict data = source.cast<py::dict>();
+        columns.clear();
+        size_t count = 0;
+        for (auto [name, values] : data) {
+            size_t position = columns.size();
+            columns.push_back(py::str(name).cast<std::string>());
+            size_t length = py::len(values);
+            if (position > 0 && length != count) {
+                throw py::value_error("insert_many: columns have different lengths");
+            }
+            count = length;
+            rows.resize(count);
+            if (py::isinstance<py::array>(values) && isNumericArray(values.cast<py::array>())) {
+                arrays.push_back(values.cast<py::array>());
+                const py::array& array = arrays.back();
+                numeric.push_back({position, static_cast<const char*>(array.data()), array.strides(0),
+                                   array.dtype().kind(), array.itemsize()});
+                continue;
+            }
+            size_t i = 0;
+            for (py::handle value : values) {
+                rows[i].resize(position + 1);
+                rows[i++][position] = valueText(value);
+            }
+        }
+        for (Row& row : rows) {
+            row.resize(columns.size());
+        }
+    } else {
+        for (py::handle item : source) {
+            if (py::isinstance<py::dict>(item)) {
+                py::dict values = py::reinterpret_borrow<py::dict>(item);
+                if (columns.empty()) {
+                    for (auto [name, value] : values) {
+                        columns.push_back(py::str(name).cast<std::string>());
+                    }
+                }
+                Row row;
+                for (const std::string& column : columns) {
+                    PyObject* value = PyDict_GetItemString(values.ptr(), column.c_str());  // Borrowed
+                    row.push_back(value ? valueText(value) : NULL_VALUE);
+                }
+                rows.push_back(std::move(row));
+                continue;
+            }
+            Row row;
+            for (py::handle value : item) {
+                row.push_back(valueText(value));
+            }
+            rows.push_back(std::move(row));
+        }
+    }
+
+    py::gil_scoped_release release;
+    for (const NumericColumn& column : numeric) {
+        for (size_t i = 0; i < rows.size(); ++i) {
+            rows[i][column.position] = numericText(column, i);
+        }
+    }
+    return target.insertRows(table, columns, std::move(rows));
+}
+
 PYBIND11_MODULE(database_engine, m) {
     m.doc() = "Python bindings for the C++ Database Engine";
 
+    // Logging controls
+    py::enum_<LogLevel>(m, "LogLevel")
+        .value("Trace", LogLevel::Trace)
+        .value("Debug", LogLevel::Debug)
+        .value("Info", LogLevel::Info)
+        .value("Warn", LogLevel::Warn)
+        .value("Error", LogLevel::Error)
+        .value("Off", LogLevel::Off);
+
+    m.def("setLogLevel", [](LogLevel level) { Logger::getInstance().setLevel(level); });
+    m.def("setLogFile", [](const std::string& path) { Logger::getInstance().setOutputFile(path); });
+    m.def("flushLog", []() { Logger::getInstance().flush(); });
+
+    // Trace spans, written as Chrome trace-event JSON
+    m.def("startTracing", []() { Tracer::getInstance().start(); });
+    m.def("stopTracing", []() { Tracer::getInstance().stop(); });
+    m.def("writeTrace", [](const std::string& path) { return Tracer::getInstance().writeChromeTrace(path); });
+
+    // Bind QueryResult (NULL values become None)
+    py::class_<QueryResult>(m, "QueryResult")
+        .def_readonly("success", &QueryResult::success)
+        .def_readonly("message", &QueryResult::message)
+        .def_readonly("columns", &QueryResult::columns)
+        .def_readonly("affectedRows", &QueryResult::affectedRows)
+        .def_property_readonly("rows", [](const QueryResult& result) {
+            py::list rows;
+            for (const Row& row : result.rows) {
+                py::list values;
+                for (const std::string& value : row) {
+                    values.append(isNull(value) ? py::object(py::none()) : py::object(py::str(value)));
+                }
+                rows.append(py::tuple(values));
+            }
+            return rows;
+        });
+
+    // Bind ColumnarResult: columns come back as NumPy arrays over the result's buffers
+    py::class_<ColumnarResult, std::shared_ptr<ColumnarResult>>(m, "ColumnarResult")
+        .def_readonly("success", &ColumnarResult::success)
+        .def_readonly("message", &ColumnarResult::message)
+        .def_readonly("affectedRows", &ColumnarResult::affectedRows)
+        .def_readonly("num_rows", &ColumnarResult::rowCount)
+        .def_property_readonly("columns", [](const ColumnarResult& result) {
+            std::vector<std::string> names;
+            for (const ResultColumn& column : result.columns) {
+                names.push_back(column.name);
+            }
+            return names;
+        })
+        .def_property_readonly("types", [](const ColumnarResult& result) {
+            std::vector<std::string> types;
+            for (const ResultColumn& column : result.columns) {
+                types.push_back(columnTypeName(column.type));
+            }
+            return types;
+        })
+        // int64 / float64 view, or an S<width> bytes array for text and dates (NULL reads as 0 / b"")
+        .def("column", [](py::object self, py::object key) {
+            return columnArray(self, columnPosition(self.cast<const ColumnarResult&>(), key));
+        })
+        // Boolean array, True where the value is not NULL
+        .def("validity", [](const ColumnarResult& result, py::object key) {
+            const ResultColumn& column = result.columns[columnPosition(result, key)];
+            py::array_t<bool> valid(result.rowCount);
+            bool* out = valid.mutable_data();
+            for (size_t i = 0; i < result.rowCount; ++i) {
+                out[i] = column.isValid(i);
+            }
+            return valid;
+        })
+        .def("null_count", [](const ColumnarResult& result, py::object key) {
+            return result.columns[columnPosition(result, key)].nullCount;
+        })
+        // (int64 offsets, uint8 UTF-8 bytes) views of a text or date column
+        .def("text_buffers", [](py::object self, py::object key) {
+            const ColumnarResult& result = self.cast<const ColumnarResult&>();
+            const ResultColumn& column = result.columns[columnPosition(result, key)];
+            if (column.type != ColumnType::Text && column.type != ColumnType::Date) {
+                throw py::type_error("column " + column.name + " is not a text column");
+            }
+            return py::make_tuple(viewOf(column.offsets.data(), column.offsets.size(), self),
+                                  viewOf(reinterpret_cast<const uint8_t*>(column.data.data()), column.data.size(), self));
+        })
+        // {name: column(name)}, e.g. for pandas.DataFrame(result.to_dict())
+        .def("to_dict", [](py::object self) {
+            const ColumnarResult& result = self.cast<const ColumnarResult&>();
+            py::dict columns;
+            for (size_t i = 0; i < result.columns.size(); ++i) {
+                columns[py::str(result.columns[i].name)] = columnArray(self, i);
+            }
+            return columns;
+        })
+        // Arrow PyCapsule interface without copying, e.g. pyarrow.record_batch(result) or polars.from_arrow(result)
+        .def("__arrow_c_array__", [](std::shared_ptr<ColumnarResult> self, py::object requestedSchema) {
+            if (!requestedSchema.is_none()) {
+                throw py::not_implemented_error("requested_schema is not supported");
+            }
+            auto* schema = new ArrowSchema();
+            auto* array = new ArrowArray();
+            exportToArrow(std::shared_ptr<const ColumnarResult>(self), schema, array);
+            return py::make_tuple(py::capsule(schema, "arrow_schema", releaseSchemaCapsule),
+                                  py::capsule(array, "arrow_array", releaseArrayCapsule));
+        }, py::arg("requested_schema") = py::none());
+
     // Bind DatabaseEngine
     py::class_<DatabaseEngine>(m, "DatabaseEngine")
         .def(py::init<>())  // Expose the default constructor
-        .def("initializeDatabase", &DatabaseEngine::initializeDatabase)
-        .def("createTable", &DatabaseEngine::createTable)
-        .def("insertData", &DatabaseEngine::insertData)
-        .def("executeQuery", &DatabaseEngine::executeQuery)
-        .def("startTransaction", &DatabaseEngine::startTransaction)
-        .def("commitTransaction", &DatabaseEngine::commitTransaction)
-        .def("rollbackTransaction", &DatabaseEngine::rollbackTransaction)
-        .def("setStorageEngine", &DatabaseEngine::setStorageEngine);
+        .def("initializeDatabase", &DatabaseEngine::initializeDatabase, ReleaseGil())
+        .def("createTable", &DatabaseEngine::createTable, ReleaseGil())
+        .def("insertData", &DatabaseEngine::insertData, ReleaseGil())
+        .def("executeQuery", &DatabaseEngine::executeQuery, ReleaseGil())
+        .def("executeColumnar", [](DatabaseEngine& engine, const std::string& query) {
+            py::gil_scoped_release release;
+            return std::make_shared<ColumnarResult>(engine.executeColumnar(query));
+        })
+        .def("insertArrow", [](DatabaseEngine& engine, const std::string& table, py::object source) {
+            return insertArrowObject(engine, table, source);
+        })
+        .def("insert_many", [](DatabaseEngine& engine, const std::string& table, py::object rows,
+                               std::vector<std::string> columns) {
+            return insertManyObject(engine, table, rows, std::move(columns));
+        }, py::arg("table"), py::arg("rows"), py::arg("columns") = std::vector<std::string>())
+        .def("startTransaction", &DatabaseEngine::startTransaction, ReleaseGil())
+        .def("commitTransaction", &DatabaseEngine::commitTransaction, ReleaseGil())
+        .def("rollbackTransaction", &DatabaseEngine::rollbackTransaction, ReleaseGil())
+        .def("setSynchronousCommit", &DatabaseEngine::setSynchronousCommit,
+             py::arg("enabled"), py::arg("flushIntervalMs") = 10, ReleaseGil())
+        .def("openSession", &DatabaseEngine::openSession, ReleaseGil())
+        .def("setWorkMemory", &DatabaseEngine::setWorkMemory, ReleaseGil())
+        .def("hasTable", &DatabaseEngine::hasTable)
+        .def("getTableDefinition", &DatabaseEngine::getTableDefinition)
+        .def("setStorageEngine", &DatabaseEngine::setStorageEngine, ReleaseGil())
+        .def("metrics", [](const DatabaseEngine& engine) {
+            // {"counters": {name: value}, "histograms": {name: {"count", "mean", "p50", ...}}}
+            MetricsSnapshot snapshot = engine.metrics();
+            py::dict counters;
+            for (size_t i = 0; i < counterCount; ++i) {
+                counters[getCounterName(static_cast<Counter>(i))] = snapshot.counters[i];
+            }
+            py::dict histograms;
+            for (size_t i = 0; i < histogramCount; ++i) {
+                const LatencyHistogram& histogram = snapshot.histograms[i];
+                py::dict summary;
+                summary["count"] = histogram.getCount();
+                summary["min"] = histogram.getMin();
+                summary["mean"] = histogram.getMean();
+                summary["p50"] = histogram.getValueAtPercentile(50);
+                summary["p90"] = histogram.getValueAtPercentile(90);
+                summary["p99"] = histogram.getValueAtPercentile(99);
+                summary["p999"] = histogram.getValueAtPercentile(99.9);
+                summary["max"] = histogram.getMax();
+                histograms[getHistogramName(static_cast<Histogram>(i))] = summary;
+            }
+            py::dict result;
+            result["counters"] = counters;
+            result["histograms"] = histograms;
+            return result;
+        })
+        .def("queryStatistics", [](const DatabaseEngine& engine) {
+            // [{"fingerprint", "calls", "errors", "total_ns", "mean_ns", "max_ns", "rows", ...}], most total time first
+            py::list entries;
+            for (const QueryStatsEntry& entry : engine.queryStatistics()) {
+                py::dict item;
+                item["fingerprint"] = entry.fingerprint;
+                item["calls"] = entry.calls;
+                item["errors"] = entry.errors;
+                item["total_ns"] = entry.totalNs;
+                item["mean_ns"] = entry.getMeanNs();
+                item["max_ns"] = entry.maxNs;
+                item["rows"] = entry.rows;
+                item["rows_read"] = entry.rowsRead;
+                item["index_probes"] = entry.indexProbes;
+                entries.append(item);
+            }
+            return entries;
+        })
+        .def("resetQueryStatistics", &DatabaseEngine::resetQueryStatistics)
+        .def("setSlowQueryLog", &DatabaseEngine::setSlowQueryLog, py::arg("path"), py::arg("thresholdMs"));
+
+    // Bind Session (one per Python thread)
+    py::class_<Session>(m, "Session")
+        .def("insertData", &Session::insertData, ReleaseGil())
+        .def("executeQuery", &Session::executeQuery, ReleaseGil())
+        .def("executeColumnar", [](Session& session, const std::string& query) {
+            py::gil_scoped_release release;
+            return std::make_shared<ColumnarResult>(session.executeColumnar(query));
+        })
+        .def("insertArrow", [](Session& session, const std::string& table, py::object source) {
+            return insertArrowObject(session, table, source);
+        })
+        .def("insert_many", [](Session& session, const std::string& table, py::object rows,
+                               std::vector<std::string> columns) {
+            return insertManyObject(session, table, rows, std::move(columns));
+        }, py::arg("table"), py::arg("rows"), py::arg("columns") = std::vector<std::string>())
+        .def("startTransaction", &Session::startTransaction, ReleaseGil())
+        .def("commitTransaction", &Session::commitTransaction, ReleaseGil())
+        .def("rollbackTransaction", &Session::rollbackTransaction, ReleaseGil())
+        .def("setWorkMemory", &Session::setWorkMemory)
+        .def("setParallelism", &Session::setParallelism)
+        .def("inTransaction", &Session::inTransaction)
+        .def("getId", &Session::getId);
 
     // Bind StorageEngine
     py::class_<StorageEngine>(m, "StorageEngine")
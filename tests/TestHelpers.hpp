@@ -0,0 +1,30 @@
+#ifndef TESTHELPERS_HPP
+#define TESTHELPERS_HPP
+
+#include "QueryProcessor.hpp"
+#include "ScanSpec.hpp"
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <vector>
+
+// A filter term on a column position, as the planner would bind it
+inline BoundCondition condition(int column, ColumnType type, CompareOp op, const std::string& value,
+                                std::vector<std::string> values = {}) {
+    BoundCondition bound;
+    bound.column = column;
+    bound.type = type;
+    bound.op = op;
+    bound.value = value;
+    bound.values = std::move(values);
+    return bound;
+}
+
+// The rows of a successful result, sorted, for comparing results regardless of row order
+inline std::vector<Row> sortedRows(QueryResult result) {
+    assert(result.success);
+    std::sort(result.rows.begin(), result.rows.end());
+    return result.rows;
+}
+
+#endif // TESTHELPERS_HPP
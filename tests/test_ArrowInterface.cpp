@@ -0,0 +1,172 @@
+#include "ArrowInterface.hpp"
+#include "QueryProcessor.hpp"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+void testExport() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE products (id INT, name TEXT, price DECIMAL(10,2), PRIMARY KEY (id));");
+    processor.executeQuery("INSERT INTO products VALUES (1, 'bolt', 0.25), (2, NULL, 3.5), (3, 'nut', NULL);");
+
+    ArrowSchema schema;
+    ArrowArray array;
+    exportToArrow(processor.executeColumnar("SELECT * FROM products;"), &schema, &array);
+
+    // A struct array with one child per column
+    assert(std::strcmp(schema.format, "+s") == 0 && schema.n_children == 3);
+    assert(array.length == 3 && array.n_children == 3 && array.null_count == 0);
+    assert(std::strcmp(schema.children[0]->format, "l") == 0 && std::strcmp(schema.children[0]->name, "id") == 0);
+    assert(std::strcmp(schema.children[1]->format, "U") == 0);
+    assert(std::strcmp(schema.children[2]->format, "g") == 0);
+    assert(schema.children[1]->flags & ARROW_FLAG_NULLABLE);
+
+    const ArrowArray* ids = array.children[0];
+    assert(ids->n_buffers == 2 && ids->buffers[0] == nullptr && ids->null_count == 0);
+    assert(static_cast<const int64_t*>(ids->buffers[1])[2] == 3);
+
+    const ArrowArray* names = array.children[1];
+    assert(names->n_buffers == 3 && names->null_count == 1);
+    assert((static_cast<const uint8_t*>(names->buffers[0])[0] & 0x7) == 0x5);
+    const int64_t* offsets = static_cast<const int64_t*>(names->buffers[1]);
+    assert(offsets[0] == 0 && offsets[1] == 4 && offsets[2] == 4 && offsets[3] == 7);
+    assert(std::memcmp(names->buffers[2], "boltnut", 7) == 0);
+    assert(static_cast<const double*>(array.children[2]->buffers[1])[1] == 3.5);
+
+    // A consumer may move a child out and release it after the parent
+    ArrowArray moved = *array.children[0];
+    array.children[0]->release = nullptr;
+    array.release(&array);
+    assert(array.release == nullptr);
+    assert(static_cast<const int64_t*>(moved.buffers[1])[0] == 1 && "Buffers freed while a child was alive");
+    moved.release(&moved);
+    schema.release(&schema);
+    assert(schema.release == nullptr);
+
+    std::cout << "Export test passed!" << std::endl;
+}
+
+void testRoundTrip() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE source (id INT, label TEXT, weight DECIMAL(8,3));");
+    processor.executeQuery("CREATE TABLE target (id INT, label TEXT, weight DECIMAL(8,3), PRIMARY KEY (id));");
+    for (int i = 0; i < 100; ++i) {
+        processor.executeQuery("INSERT INTO source VALUES (" + std::to_string(i) + ", " +
+                               (i % 10 ? "'item" + std::to_string(i) + "'" : std::string("NULL")) + ", " +
+                               std::to_string(i) + ".125);");
+    }
+
+    ArrowSchema schema;
+    ArrowArray array;
+    exportToArrow(processor.executeColumnar("SELECT * FROM source;"), &schema, &array);
+    QueryResult inserted = processor.insertArrow("target", &schema, &array);
+    assert(inserted.success && inserted.affectedRows == 100);
+    assert(schema.release == nullptr && array.release == nullptr && "Import did not release its input");
+
+    QueryResult copy = processor.executeQuery("SELECT * FROM target WHERE id = 37;");
+    assert(copy.rows.size() == 1 && copy.rows[0][1] == "item37" && copy.rows[0][2] == "37.125");
+    assert(isNull(processor.executeQuery("SELECT label FROM target WHERE id = 40;").rows[0][0]));
+
+    // The primary key is enforced as for INSERT statements
+    exportToArrow(processor.executeColumnar("SELECT id FROM source LIMIT 1;"), &schema, &array);
+    assert(!processor.insertArrow("target", &schema, &array).success);
+
+    std::cout << "Round trip test passed!" << std::endl;
+}
+
+// Arrays as another producer would build them: int32, utf8, date32 and bool with an offset
+void testImportFormats() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE events (id INT, kind TEXT, day DATE, flag INT);");
+
+    static int32_t ids[] = {10, 11, 12, 13};
+    static uint8_t idValidity[] = {0x0D};  // Row 1 is NULL
+    static int32_t kindOffsets[] = {0, 1, 2, 4, 7};
+    static const char kindData[] = "abcddef";
+    static int32_t days[] = {0, 19723, -1, 11016};
+    static uint8_t flags[] = {0x05};
+    const void* idBuffers[] = {idValidity, ids};
+    const void* kindBuffers[] = {nullptr, kindOffsets, kindData};
+    const void* dayBuffers[] = {nullptr, days};
+    const void* flagBuffers[] = {nullptr, flags};
+    auto noRelease = [](ArrowArray* array) { array->release = nullptr; };
+    auto noReleaseSchema = [](ArrowSchema* schema) { schema->release = nullptr; };
+
+    ArrowArray children[4] = {
+        {4, 1, 0, 2, 0, idBuffers, nullptr, nullptr, noRelease, nullptr},
+        {4, 0, 0, 3, 0, kindBuffers, nullptr, nullptr, noRelease, nullptr},
+        {4, 0, 0, 2, 0, dayBuffers, nullptr, nullptr, noRelease, nullptr},
+        {4, 0, 0, 2, 0, flagBuffers, nullptr, nullptr, noRelease, nullptr},
+    };
+    ArrowArray* childPointers[] = {&children[0], &children[1], &children[2], &children[3]};
+    const void* structBuffers[] = {nullptr};
+    ArrowArray batch = {3, 0, 1, 1, 4, structBuffers, childPointers, nullptr, noRelease, nullptr};  // Rows 1-3
+
+    ArrowSchema fields[4] = {
+        {"i", "id", nullptr, ARROW_FLAG_NULLABLE, 0, nullptr, nullptr, noReleaseSchema, nullptr},
+        {"u", "kind", nullptr, 0, 0, nullptr, nullptr, noReleaseSchema, nullptr},
+        {"tdD", "day", nullptr, 0, 0, nullptr, nullptr, noReleaseSchema, nullptr},
+        {"b", "flag", nullptr, 0, 0, nullptr, nullptr, noReleaseSchema, nullptr},
+    };
+    ArrowSchema* fieldPointers[] = {&fields[0], &fields[1], &fields[2], &fields[3]};
+    ArrowSchema batchSchema = {"+s", "", nullptr, 0, 4, fieldPointers, nullptr, noReleaseSchema, nullptr};
+
+    QueryResult inserted = processor.insertArrow("events", &batchSchema, &batch);
+    assert(inserted.success && inserted.affectedRows == 3);
+    QueryResult rows = processor.executeQuery("SELECT * FROM events;");
+    assert(isNull(rows.rows[0][0]) && rows.rows[0][1] == "b" && rows.rows[0][2] == "2024-01-01" && rows.rows[0][3] == "0");
+    assert(rows.rows[1][0] == "12" && rows.rows[1][1] == "cd" && rows.rows[1][2] == "1969-12-31" && rows.rows[1][3] == "1");
+    assert(rows.rows[2][1] == "def" && rows.rows[2][2] == "2000-02-29");
+
+    // Unsupported formats are rejected before anything is inserted
+    fields[3].format = "+l";
+    fields[3].release = noReleaseSchema;
+    batchSchema.release = noReleaseSchema;
+    batch.release = noRelease;
+    assert(!processor.insertArrow("events", &batchSchema, &batch).success);
+    assert(storage.getRowCount("events") == 3);
+
+    std::cout << "Import formats test passed!" << std::endl;
+}
+
+// null_count -1 (not counted by the producer) defers to the validity bitmaps
+void testUnknownNullCount() {
+    static int64_t ids[] = {1, 2, 3};
+    static uint8_t idValidity[] = {0x05};  // Row 1 is NULL
+    static uint8_t rowValidity[] = {0x07};
+    const void* idBuffers[] = {idValidity, ids};
+    const void* structBuffers[] = {rowValidity};
+    auto release = [](ArrowArray*) {};
+    auto releaseSchema = [](ArrowSchema*) {};
+
+    ArrowArray child = {3, -1, 0, 2, 0, idBuffers, nullptr, nullptr, release, nullptr};
+    ArrowArray* childPointers[] = {&child};
+    ArrowArray batch = {3, -1, 0, 1, 1, structBuffers, childPointers, nullptr, release, nullptr};
+    ArrowSchema field = {"l", "id", nullptr, ARROW_FLAG_NULLABLE, 0, nullptr, nullptr, releaseSchema, nullptr};
+    ArrowSchema* fieldPointers[] = {&field};
+    ArrowSchema batchSchema = {"+s", "", nullptr, 0, 1, fieldPointers, nullptr, releaseSchema, nullptr};
+
+    std::vector<std::string> columns;
+    std::vector<Row> rows;
+    std::string error;
+    assert(arrowToRows(&batchSchema, &batch, columns, rows, error));
+    assert(rows.size() == 3 && rows[0][0] == "1" && isNull(rows[1][0]) && rows[2][0] == "3");
+
+    // A NULL row in the struct's own bitmap is still rejected
+    rowValidity[0] = 0x03;
+    rows.clear();
+    assert(!arrowToRows(&batchSchema, &batch, columns, rows, error) && error == "Arrow record batch has NULL rows");
+    std::cout << "Unknown null count test passed!" << std::endl;
+}
+
+int main() {
+    testExport();
+    testRoundTrip();
+    testImportFormats();
+    testUnknownNullCount();
+    return 0;
+}
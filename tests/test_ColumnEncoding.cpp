@@ -0,0 +1,256 @@
+#include "ColumnEncoding.hpp"
+#include "StorageEngine.hpp"
+#include "TestHelpers.hpp"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+
+std::vector<Row> columnRows(const std::vector<std::string>& values) {
+    std::vector<Row> rows;
+    for (const std::string& value : values) {
+        rows.push_back({value});
+    }
+    return rows;
+}
+
+// Every value decodes to its text, and filters keep exactly the positions a row-by-row check keeps
+void checkColumn(const std::vector<std::string>& values, ColumnType type, Encoding expected,
+                 const std::vector<BoundCondition>& conditions) {
+    EncodedColumn column(columnRows(values), 0, type);
+    assert(column.getEncoding() == expected && column.size() == values.size());
+    std::vector<uint32_t> all;
+    for (size_t position = 0; position < values.size(); ++position) {
+        assert(column.get(position) == values[position]);
+        all.push_back(static_cast<uint32_t>(position));
+    }
+    for (const BoundCondition& bound : conditions) {
+        std::vector<uint32_t> selection = all;
+        column.filter(bound, selection);
+        std::vector<uint32_t> expectedSelection;
+        for (uint32_t position : all) {
+            if (bound.matchesValue(values[position])) {
+                expectedSelection.push_back(position);
+            }
+        }
+        assert(selection == expectedSelection);
+
+        // Gathering the survivors gives their values back
+        std::vector<Row> gathered(selection.size() + 1, Row(1));
+        column.gather(selection, gathered, 1, 0);
+        for (size_t i = 0; i < selection.size(); ++i) {
+            assert(gathered[i + 1][0] == values[selection[i]]);
+        }
+    }
+}
+
+void testBitPacking() {
+    std::mt19937_64 random(7);
+    for (int bits : {0, 1, 7, 13, 33, 63, 64}) {
+        std::vector<uint64_t> values(1000);
+        for (uint64_t& value : values) {
+            value = bits == 0 ? 0 : (bits == 64 ? random() : random() & ((1ULL << bits) - 1));
+        }
+        BitPackedArray packed(values, bits);
+        for (size_t position = 0; position < values.size(); ++position) {
+            assert(packed.get(position) == values[position]);
+        }
+        assert(packed.getBytes() <= (values.size() * bits + 63) / 64 * 8 + 8);
+    }
+    std::cout << "Bit packing test passed!" << std::endl;
+}
+
+void testEncodingChoice() {
+    std::vector<std::string> ids;
+    std::vector<std::string> quantities;
+    std::vector<std::string> statuses;
+    std::vector<std::string> dates;
+    std::vector<std::string> comments;
+    std::vector<std::string> padded;
+    std::vector<std::string> nullable;
+    std::mt19937 random(11);
+    for (int i = 0; i < 4096; ++i) {
+        ids.push_back(std::to_string(10100 + i));
+        quantities.push_back(std::to_string(20 + random() % 50));
+        statuses.push_back(i % 97 == 0 ? "On Hold" : (i % 5 == 0 ? "Cancelled" : "Shipped"));
+        dates.push_back("2004-0" + std::to_string(1 + i / 512) + "-15");
+        comments.push_back("Customer " + std::to_string(random()) + " asked for express delivery");
+        padded.push_back(i % 2 ? "007" : std::to_string(i % 10));
+        nullable.push_back(i % 3 == 0 ? NULL_VALUE : std::to_string(i % 10));
+    }
+    auto all = [](ColumnType type, const std::string& value, const std::string& bad) {
+        return std::vector<BoundCondition>{
+            condition(0, type, CompareOp::Equal, value), condition(0, type, CompareOp::NotEqual, value),
+            condition(0, type, CompareOp::Less, value), condition(0, type, CompareOp::GreaterEqual, value),
+            condition(0, type, CompareOp::In, "", {value, bad, NULL_VALUE}), condition(0, type, CompareOp::IsNull, ""),
+            condition(0, type, CompareOp::IsNotNull, ""), condition(0, type, CompareOp::Greater, bad),
+            condition(0, type, CompareOp::Equal, NULL_VALUE)};
+    };
+    checkColumn(ids, ColumnType::Integer, Encoding::FrameOfReference, all(ColumnType::Integer, "12000", "x"));
+    checkColumn(quantities, ColumnType::Integer, Encoding::FrameOfReference, all(ColumnType::Integer, "42.5", "x"));
+    checkColumn(statuses, ColumnType::Text, Encoding::Dictionary, all(ColumnType::Text, "Shipped", "Resolved"));
+    checkColumn(dates, ColumnType::Date, Encoding::RunLength, all(ColumnType::Date, "2004-05-15", "2004-13"));
+    checkColumn(comments, ColumnType::Text, Encoding::Plain, all(ColumnType::Text, comments[9], "Customer 5"));
+    checkColumn(padded, ColumnType::Integer, Encoding::Dictionary, all(ColumnType::Integer, "7", "abc"));
+    checkColumn(nullable, ColumnType::Integer, Encoding::Dictionary, all(ColumnType::Integer, "5", "1e3"));
+
+    // One value, or the extremes of the integers
+    checkColumn(std::vector<std::string>(4096, "5"), ColumnType::Integer, Encoding::FrameOfReference,
+                all(ColumnType::Integer, "5", "-"));
+    std::vector<std::string> extremes;
+    for (int i = 0; i < 4096; ++i) {
+        extremes.push_back(std::to_string(i % 2 ? std::numeric_limits<int64_t>::max() - i
+                                                : std::numeric_limits<int64_t>::min() + i));
+    }
+    EncodedColumn wide(columnRows(extremes), 0, ColumnType::Integer);
+    assert(wide.getEncoding() == Encoding::FrameOfReference);
+    for (size_t position = 0; position < extremes.size(); ++position) {
+        assert(wide.get(position) == extremes[position]);
+    }
+    assert(std::string(encodingName(Encoding::RunLength)) == "run-length");
+    std::cout << "Encoding choice test passed!" << std::endl;
+}
+
+// Values the encoding can hold are patched in place; the column then reads and filters like the new values
+void testPatching() {
+    std::vector<std::string> ids;
+    std::vector<std::string> statuses;
+    std::vector<std::string> dates;
+    std::vector<std::string> codes;
+    for (int i = 0; i < 4096; ++i) {
+        ids.push_back(std::to_string(1000 + i));
+        statuses.push_back(i % 3 == 0 ? "Cancelled" : (i % 3 == 1 ? "Shipped" : "On Hold"));
+        dates.push_back(i == 0 ? "2003-01-01" : "2004-0" + std::to_string(1 + i / 512) + "-15");
+        codes.push_back("S" + std::to_string(10000 + i));
+    }
+    auto patched = [](std::vector<std::string>& values, ColumnType type, Encoding expected,
+                      const std::vector<std::pair<size_t, std::string>>& patches, const std::vector<bool>& fits) {
+        EncodedColumn column(columnRows(values), 0, type);
+        assert(column.getEncoding() == expected);
+        for (size_t i = 0; i < patches.size(); ++i) {
+            assert(column.patch(patches[i].first, patches[i].second) == fits[i]);
+            if (fits[i]) {
+                values[patches[i].first] = patches[i].second;
+            }
+        }
+        std::vector<uint32_t> selection;
+        for (size_t position = 0; position < values.size(); ++position) {
+            assert(column.get(position) == values[position]);
+            selection.push_back(static_cast<uint32_t>(position));
+        }
+        column.filter(condition(0, type, CompareOp::Equal, patches[0].second), selection);
+        for (uint32_t position : selection) {
+            assert(values[position] == patches[0].second);
+        }
+        assert(!selection.empty());
+    };
+    patched(ids, ColumnType::Integer, Encoding::FrameOfReference,
+            {{7, "1010"}, {8, "999"}, {9, "9999"}, {10, "1.5"}, {11, "5095"}}, {true, false, false, false, true});
+    patched(statuses, ColumnType::Text, Encoding::Dictionary,
+            {{5, "Resolved"}, {6, "Disputed"}, {7, "Shipped"}}, {true, false, true});
+    patched(dates, ColumnType::Date, Encoding::RunLength,
+            {{0, "2003-06-30"}, {1, "2003-06-30"}, {2, "2004-01-15"}}, {true, false, true});
+    patched(codes, ColumnType::Text, Encoding::Plain, {{3, "S99999"}, {4, "S1"}}, {true, false});
+    std::cout << "Patching test passed!" << std::endl;
+}
+
+// Full blocks are compressed; reads, scans and updates see the same rows as before
+void testCompressedHeap() {
+    TableHeap heap({ColumnType::Integer, ColumnType::Text, ColumnType::Integer});
+    std::vector<Row> rows;
+    const size_t count = 2 * TableHeap::blockRows + 100;
+    for (size_t i = 0; i < count; ++i) {
+        rows.push_back({std::to_string(i), i % 4 == 0 ? "Disputed" : "Shipped", std::to_string(i % 50)});
+    }
+    std::vector<Row> copy = rows;
+    assert(heap.insertRows(copy) == 0 && heap.getRowCount() == count);
+    assert((heap.getBlockEncodings(0) == std::vector<Encoding>{Encoding::FrameOfReference, Encoding::Dictionary,
+                                                                Encoding::FrameOfReference}));
+    assert(heap.getBlockEncodings(2).empty());  // Still filling
+    size_t rowBytes = 0;
+    for (size_t i = 0; i < 2 * TableHeap::blockRows; ++i) {
+        rowBytes += sizeof(Row) + rows[i].size() * sizeof(std::string);
+    }
+    assert(heap.getEncodedBytes() * 10 < rowBytes);
+
+    std::vector<Row> read;
+    assert(heap.readRows(TableHeap::blockRows - 10, 20, read) == 20);
+    assert(read[0] == rows[TableHeap::blockRows - 10] && read[19] == rows[TableHeap::blockRows + 9]);
+    Row row;
+    assert(heap.fetchRow(5000, row) && row == rows[5000]);
+
+    // Filtered, projected scan across encoded and row blocks
+    ScanSpec spec;
+    BoundCondition status = condition(0, ColumnType::Text, CompareOp::Equal, "Disputed");
+    status.column = 1;
+    BoundCondition quantity = condition(0, ColumnType::Integer, CompareOp::Less, "10");
+    quantity.column = 2;
+    spec.filter = {status, quantity};
+    spec.allColumns = false;
+    spec.columns = {0};
+    std::vector<Row> out;
+    std::vector<int> rowIds;
+    size_t start = 100;
+    while (size_t examined = heap.scanRows(start, 1000, spec, out, &rowIds, nullptr)) {
+        start += examined;
+    }
+    std::vector<int> expected;
+    for (size_t i = 100; i < count; ++i) {
+        if (i % 4 == 0 && i % 50 < 10) {
+            expected.push_back(static_cast<int>(i));
+        }
+    }
+    assert(rowIds == expected && out.size() == expected.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        assert(out[i][0] == std::to_string(expected[i]) && out[i][1].empty() && out[i][2].empty());
+    }
+
+    // An update the encodings can hold leaves its block compressed
+    Row previous;
+    assert(heap.updateRow(10, {{1, "Disputed"}, {2, "49"}}, previous) && previous == rows[10]);
+    assert(heap.getBlockEncodings(0).size() == 3);
+    rows[10] = {"10", "Disputed", "49"};
+    assert(heap.fetchRow(10, row) && row == rows[10]);
+
+    // Otherwise its block turns back into rows...
+    assert(heap.updateRow(4100, {{1, "Resolved"}, {2, "7"}}, previous) && previous == rows[4100]);
+    assert(heap.getBlockEncodings(1).empty() && heap.getBlockEncodings(0).size() == 3);
+    rows[4100] = {"4100", "Resolved", "7"};
+    assert(heap.fetchRow(4100, row) && row == rows[4100]);
+    assert(heap.fetchRow(4101, row) && row == rows[4101]);
+
+    // ...until blockRows writes go by without touching it
+    std::vector<Row> more;
+    for (size_t i = count; i < count + TableHeap::blockRows - 1; ++i) {
+        more.push_back({std::to_string(i), "Shipped", std::to_string(i % 50)});
+    }
+    rows.insert(rows.end(), more.begin(), more.end());
+    heap.insertRows(more);
+    assert(heap.getBlockEncodings(1).empty());
+    assert(heap.updateRow(0, {{2, "3"}}, previous));
+    rows[0][2] = "3";
+    assert((heap.getBlockEncodings(1) == std::vector<Encoding>{Encoding::FrameOfReference, Encoding::Dictionary,
+                                                                Encoding::FrameOfReference}));
+    std::vector<Row> all;
+    assert(heap.readRows(0, rows.size(), all) == rows.size() && all == rows);
+    spec.filter = {condition(0, ColumnType::Text, CompareOp::Equal, "Resolved")};
+    spec.filter[0].column = 1;
+    out.clear();
+    rowIds.clear();
+    size_t skipped = 0;
+    start = 0;
+    while (size_t examined = heap.scanRows(start, 100000, spec, out, &rowIds, &skipped)) {
+        start += examined;
+    }
+    assert(rowIds == std::vector<int>{4100} && skipped > 0);
+    std::cout << "Compressed heap test passed!" << std::endl;
+}
+
+int main() {
+    testBitPacking();
+    testEncodingChoice();
+    testPatching();
+    testCompressedHeap();
+    return 0;
+}
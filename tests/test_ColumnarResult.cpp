@@ -0,0 +1,108 @@
+#include "ColumnarResult.hpp"
+#include "Session.hpp"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+void testColumnLayout() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE products (id INT, name TEXT, price DECIMAL(10,2), added DATE, PRIMARY KEY (id));");
+    processor.executeQuery("INSERT INTO products VALUES (1, 'bolt', 0.25, '2024-01-02'), (2, NULL, 3.5, NULL), "
+                           "(3, 'nut', NULL, '2024-03-04');");
+    for (int i = 4; i <= 20; ++i) {
+        processor.executeQuery("INSERT INTO products VALUES (" + std::to_string(i) + ", 'part', 1, '2024-05-06');");
+    }
+
+    ColumnarResult result = processor.executeColumnar("SELECT id, name, price, added FROM products;");
+    assert(result.success && result.rowCount == 20 && result.columns.size() == 4);
+
+    // Integer and Decimal values are stored as int64 / float64 arrays
+    const ResultColumn& id = result.columns[0];
+    assert(id.type == ColumnType::Integer && id.integers.size() == 20 && id.nullCount == 0);
+    for (int i = 0; i < 20; ++i) {
+        assert(id.integers[i] == i + 1);
+    }
+    const ResultColumn& price = result.columns[2];
+    assert(price.type == ColumnType::Decimal && price.decimals[0] == 0.25 && price.decimals[1] == 3.5);
+    assert(!price.isValid(2) && price.decimals[2] == 0.0 && price.nullCount == 1);
+
+    // Text is one byte buffer with offsets; NULL is an empty, invalid value
+    const ResultColumn& name = result.columns[1];
+    assert(name.offsets.size() == 21 && name.offsets[0] == 0);
+    assert(name.getText(0) == "bolt" && name.getText(2) == "nut");
+    assert(!name.isValid(1) && name.offsets[1] == name.offsets[2]);
+    assert(std::memcmp(name.data.data(), "boltnutpart", 11) == 0);
+
+    // Validity bitmaps are bit-packed, least significant bit first
+    assert(name.validity.size() == 3 && name.validity[0] == 0xFD && name.validity[2] == 0x0F);
+    assert(result.columns[3].getText(0) == "2024-01-02" && !result.columns[3].isValid(1));
+    assert(result.getColumnIndex("PRICE") == 2 && result.getColumnIndex("missing") == -1);
+
+    std::cout << "Column layout test passed!" << std::endl;
+}
+
+void testStatements() {
+    StorageEngine storage("memory");
+    QueryStats stats;
+    Session session(0, &storage, nullptr, &stats);
+    session.executeQuery("CREATE TABLE items (id INT, label TEXT, PRIMARY KEY (id));");
+
+    // Non-SELECT statements report their effect; errors carry the message
+    ColumnarResult inserted = session.executeColumnar("INSERT INTO items VALUES (1, 'a'), (2, 'b');");
+    assert(inserted.success && inserted.affectedRows == 2 && inserted.rowCount == 0);
+    ColumnarResult failed = session.executeColumnar("SELECT * FROM missing;");
+    assert(!failed.success && !failed.message.empty());
+
+    // Projection and index access paths behave as in executeQuery
+    ColumnarResult lookup = session.executeColumnar("SELECT label FROM items WHERE id = 2;");
+    assert(lookup.rowCount == 1 && lookup.columns.size() == 1 && lookup.columns[0].getText(0) == "b");
+
+    // EXPLAIN returns its plan as a text column
+    ColumnarResult plan = session.executeColumnar("EXPLAIN SELECT * FROM items;");
+    assert(plan.success && plan.columns[0].name == "QUERY PLAN" && plan.columns[0].getText(0) == "SeqScan on items");
+
+    // Columnar statements feed the statement statistics too
+    bool found = false;
+    for (const QueryStatsEntry& entry : stats.snapshot()) {
+        found = found || (entry.fingerprint == "select label from items where id = ?" && entry.rows == 1);
+    }
+    assert(found);
+
+    std::cout << "Statements test passed!" << std::endl;
+}
+
+void testParallelSessions() {
+    StorageEngine storage("memory");
+    Session setup(0, &storage);
+    setup.executeQuery("CREATE TABLE items (id INT, label TEXT, PRIMARY KEY (id));");
+    for (int i = 0; i < 1000; ++i) {
+        setup.executeQuery("INSERT INTO items VALUES (" + std::to_string(i) + ", 'item');");
+    }
+
+    // Sessions on different threads build their results independently
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&storage, t]() {
+            Session session(t + 1, &storage);
+            for (int i = 0; i < 20; ++i) {
+                ColumnarResult result = session.executeColumnar("SELECT id FROM items;");
+                assert(result.rowCount == 1000 && result.columns[0].integers[999] == 999);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::cout << "Parallel sessions test passed!" << std::endl;
+}
+
+int main() {
+    testColumnLayout();
+    testStatements();
+    testParallelSessions();
+    return 0;
+}
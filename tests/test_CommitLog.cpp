@@ -0,0 +1,237 @@
+#include "ArrowInterface.hpp"
+#include "CommitLog.hpp"
+#include "Session.hpp"
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int countCommitRecords(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    int commits = 0;
+    while (std::getline(in, line)) {
+        if (line.find("\tCOMMIT") != std::string::npos) {
+            ++commits;
+        }
+    }
+    return commits;
+}
+
+void testGroupCommit() {
+    const std::string path = "test_group_commit.wal";
+    std::remove(path.c_str());
+    StorageEngine storage("memory");
+    Session(0, &storage).executeQuery("CREATE TABLE users (id INT, name TEXT, age INT);");
+    const int threadCount = 4;
+    const int commitsPerThread = 25;
+
+    {
+        CommitLog log(path);
+        assert(log.isOpen());
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threadCount; ++t) {
+            workers.emplace_back([&storage, &log, t]() {
+                Session session(t + 1, &storage, &log);
+                for (int i = 0; i < commitsPerThread; ++i) {
+                    session.startTransaction();
+                    session.insertData("INSERT INTO users VALUES (" + std::to_string(i) + ", 'x', 1);");
+                    session.commitTransaction();  // Durable on return
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        assert(log.getCommitCount() == threadCount * commitsPerThread);
+        assert(log.getSyncCount() <= log.getCommitCount() && "Group commit issued more fsyncs than commits");
+        assert(countCommitRecords(path) == threadCount * commitsPerThread && "Synchronous commit not durable on return");
+    }
+
+    std::remove(path.c_str());
+    std::cout << "Group commit test passed!" << std::endl;
+}
+
+void testAsynchronousCommit() {
+    const std::string path = "test_async_commit.wal";
+    std::remove(path.c_str());
+    StorageEngine storage("memory");
+    Session(0, &storage).executeQuery("CREATE TABLE users (id INT, name TEXT, age INT);");
+
+    {
+        CommitLog log(path);
+        log.setSynchronousCommit(false);
+        log.setFlushInterval(std::chrono::milliseconds(50));
+
+        Session session(1, &storage, &log);
+        session.startTransaction();
+        session.insertData("INSERT INTO users VALUES (1, 'Alice', 30);");
+        std::future<void> acknowledged = session.commitAsync();
+
+        // synchronous_commit=off: acknowledged before the fsync happens
+        assert(acknowledged.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        assert(storage.getRowCount("users") == 1);
+
+        log.flush();
+        assert(countCommitRecords(path) == 1 && "Flush did not make the commit durable");
+    }
+
+    std::remove(path.c_str());
+    std::cout << "Asynchronous commit test passed!" << std::endl;
+}
+
+std::vector<std::string> readLog(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// The log holds what took effect: autocommit statements, and the statements of
+// a transaction that succeeded. A statement over several lines stays one record.
+void testLoggedChanges() {
+    const std::string path = "test_logged_changes.wal";
+    std::remove(path.c_str());
+    StorageEngine storage("memory");
+
+    {
+        CommitLog log(path);
+        Session session(1, &storage, &log);
+        assert(session.executeQuery("CREATE TABLE users (id INT, name TEXT, PRIMARY KEY (id));").success);
+        assert(session.executeQuery("SELECT * FROM users;").success);
+        assert(!session.executeQuery("INSERT INTO missing VALUES (1);").success);
+
+        session.startTransaction();
+        session.insertData("INSERT INTO users\nVALUES (1, 'back\\slash');");
+        session.insertData("INSERT INTO users VALUES (1, 'duplicate');");
+        session.commitTransaction();
+        assert(storage.getRowCount("users") == 1);
+    }
+
+    std::vector<std::string> lines = readLog(path);
+    assert(lines.size() == 4);
+    assert(lines[0] == "1\tCREATE TABLE users (id INT, name TEXT, PRIMARY KEY (id));" && lines[1] == "1\tCOMMIT");
+    assert(lines[2] == "2\tINSERT INTO users\\nVALUES (1, 'back\\\\slash');" && lines[3] == "2\tCOMMIT");
+    std::remove(path.c_str());
+    std::cout << "Logged changes test passed!" << std::endl;
+}
+
+// A log record with the writer's escapes (\\, \n, \r) undone and the LSN cut off
+std::string recordText(const std::string& line) {
+    std::string text;
+    for (size_t i = line.find('\t') + 1; i < line.size(); ++i) {
+        if (line[i] == '\\' && i + 1 < line.size()) {
+            char escaped = line[++i];
+            text += escaped == 'n' ? '\n' : (escaped == 'r' ? '\r' : escaped);
+        } else {
+            text += line[i];
+        }
+    }
+    return text;
+}
+
+// A row batch is logged as an INSERT that gives back the same rows when replayed
+void testLoggedRowBatch() {
+    const std::string path = "test_logged_rows.wal";
+    std::remove(path.c_str());
+    StorageEngine storage("memory");
+    const std::string create = "CREATE TABLE notes (id INT, body TEXT, PRIMARY KEY (id));";
+
+    {
+        CommitLog log(path);
+        Session session(1, &storage, &log);
+        assert(session.executeQuery(create).success);
+        std::vector<Row> rows = {{"1", "it's"}, {"2", "back\\slash\nline"}, {"3", NULL_VALUE}};
+        assert(session.insertRows("notes", {"id", "body"}, rows).success);
+        assert(!session.insertRows("notes", {}, {{"1", "duplicate"}}).success);
+    }
+
+    std::vector<std::string> lines = readLog(path);
+    assert(lines.size() == 4);
+    StorageEngine replayed("memory");
+    Session replay(2, &replayed);
+    assert(replay.executeQuery(recordText(lines[0])).success);
+    assert(replay.executeQuery(recordText(lines[2])).success);
+    QueryResult original = Session(3, &storage).executeQuery("SELECT * FROM notes ORDER BY id;");
+    QueryResult copy = replay.executeQuery("SELECT * FROM notes ORDER BY id;");
+    assert(copy.rows.size() == 3 && copy.rows == original.rows);
+    assert(copy.rows[1][1] == "back\\slash\nline" && isNull(copy.rows[2][1]));
+    std::remove(path.c_str());
+    std::cout << "Logged row batch test passed!" << std::endl;
+}
+
+// An Arrow batch is logged like a row batch, before insertArrow returns
+void testLoggedArrowBatch() {
+    const std::string path = "test_logged_arrow.wal";
+    std::remove(path.c_str());
+    StorageEngine storage("memory");
+
+    {
+        CommitLog log(path);
+        Session session(1, &storage, &log);
+        assert(session.executeQuery("CREATE TABLE source (id INT, name TEXT);").success);
+        assert(session.executeQuery("CREATE TABLE target (id INT, name TEXT);").success);
+        assert(session.executeQuery("INSERT INTO source VALUES (1, 'O''Brien'), (2, NULL);").success);
+        ArrowSchema schema;
+        ArrowArray array;
+        exportToArrow(session.executeColumnar("SELECT * FROM source;"), &schema, &array);
+        assert(session.insertArrow("target", &schema, &array).success);
+        assert(countCommitRecords(path) == 4 && "Arrow batch not durable on return");
+    }
+
+    std::vector<std::string> lines = readLog(path);
+    assert(lines.size() == 8);
+    assert(recordText(lines[6]) == "INSERT INTO `target` (`id`, `name`) VALUES ('1', 'O''Brien'), ('2', NULL);");
+    std::remove(path.c_str());
+    std::cout << "Logged Arrow batch test passed!" << std::endl;
+}
+
+// A reopened log continues its LSNs after the last complete record; a torn line is ended, not continued
+void testReopen() {
+    const std::string path = "test_reopen.wal";
+    std::remove(path.c_str());
+    StorageEngine storage("memory");
+
+    {
+        CommitLog log(path);
+        Session session(1, &storage, &log);
+        assert(session.executeQuery("CREATE TABLE users (id INT, name TEXT);").success);
+        assert(session.executeQuery("INSERT INTO users VALUES (1, 'Ann');").success);
+    }
+    {
+        std::ofstream torn(path, std::ios::app);
+        torn << "2\tINSERT INTO users VALUES (2, 'Bo";  // A crash in the middle of a write
+    }
+    {
+        CommitLog log(path);
+        Session session(1, &storage, &log);
+        assert(session.executeQuery("INSERT INTO users VALUES (3, 'Cy');").success);
+        log.flush();
+    }
+
+    std::vector<std::string> lines = readLog(path);
+    assert(lines.size() == 7);
+    assert(lines[3] == "2\tCOMMIT" && lines[4] == "2\tINSERT INTO users VALUES (2, 'Bo");
+    assert(lines[5] == "3\tINSERT INTO users VALUES (3, 'Cy');" && lines[6] == "3\tCOMMIT");
+    std::remove(path.c_str());
+    std::cout << "Reopen test passed!" << std::endl;
+}
+
+int main() {
+    testGroupCommit();
+    testAsynchronousCommit();
+    testLoggedChanges();
+    testLoggedRowBatch();
+    testLoggedArrowBatch();
+    testReopen();
+    return 0;
+}
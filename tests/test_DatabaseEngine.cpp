@@ -1,19 +1,78 @@
-#include "DatabaseEngine.h"
+#include "DatabaseEngine.hpp"
 #include <cassert>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 
-void testSingleton() {
-    // Get two instances of DatabaseEngine
-    DatabaseEngine& db1 = DatabaseEngine::getInstance();
-    DatabaseEngine& db2 = DatabaseEngine::getInstance();
+void testInitializationAndCatalog() {
+    DatabaseEngine engine;
+    engine.initializeDatabase(":memory:");
+    engine.setStorageEngine("memory");
 
-    // Ensure that both instances are the same (Singleton pattern)
-    assert(&db1 == &db2 && "Singleton failed: Instances are not the same");
+    engine.createTable("CREATE TABLE users (id INT, name TEXT, age INT);");
+    assert(engine.hasTable("users") && "Table missing from the catalog");
+    assert(!engine.hasTable("orders"));
+    assert(engine.getTableDefinition("users").find("name TEXT") != std::string::npos);
 
-    std::cout << "Singleton test passed!" << std::endl;
+    std::cout << "Initialization and catalog test passed!" << std::endl;
+}
+
+void testDefaultSessionTransactions() {
+    DatabaseEngine engine;
+    engine.initializeDatabase(":memory:");
+    engine.setStorageEngine("memory");
+    engine.createTable("CREATE TABLE users (id INT, name TEXT, age INT);");
+
+    engine.startTransaction();
+    engine.insertData("INSERT INTO users VALUES (1, 'Alice', 30);");
+    engine.commitTransaction();
+
+    engine.startTransaction();
+    engine.insertData("INSERT INTO users VALUES (2, 'Bob', 25);");
+    engine.rollbackTransaction();
+
+    // The engine hands out sessions once storage is configured
+    auto session = engine.openSession();
+    assert(session != nullptr);
+
+    // Only the committed row is stored
+    QueryResult result = session->executeQuery("SELECT name FROM users;");
+    assert(result.rows.size() == 1 && result.rows[0][0] == "Alice" && "Rollback applied changes");
+    std::cout << "Default session transactions test passed!" << std::endl;
+}
+
+// Storage set up before the database is opened: commits still reach the log
+void testSetupOrder() {
+    const std::string path = "test_setup_order.db";
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    {
+        DatabaseEngine engine;
+        engine.setStorageEngine("memory");
+        assert(engine.openSession() == nullptr && "Session opened before the commit log exists");
+        engine.initializeDatabase(path);
+        engine.createTable("CREATE TABLE users (id INT, name TEXT, age INT);");
+        engine.startTransaction();
+        engine.insertData("INSERT INTO users VALUES (1, 'Alice', 30);");
+        engine.commitTransaction();
+        assert(engine.openSession() != nullptr);
+    }
+
+    std::ifstream in(path + "-wal");
+    std::string line;
+    bool committed = false;
+    while (std::getline(in, line)) {
+        committed = committed || line.find("\tCOMMIT") != std::string::npos;
+    }
+    assert(committed && "Default session committed without the log");
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::cout << "Setup order test passed!" << std::endl;
 }
 
 int main() {
-    testSingleton();
+    testInitializationAndCatalog();
+    testDefaultSessionTransactions();
+    testSetupOrder();
     return 0;
 }
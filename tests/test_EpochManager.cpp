@@ -0,0 +1,88 @@
+#include "EpochManager.hpp"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+struct Tracked {
+    static std::atomic<int> liveCount;
+    int value;
+    explicit Tracked(int v) : value(v) { ++liveCount; }
+    ~Tracked() { value = -1; --liveCount; }
+};
+std::atomic<int> Tracked::liveCount{0};
+
+void testPinnedReaderBlocksReclaim() {
+    EpochManager& epochs = EpochManager::getInstance();
+    Tracked* object = new Tracked(42);
+    int before = Tracked::liveCount;
+
+    std::atomic<bool> pinned{false};
+    std::atomic<bool> release{false};
+    std::thread reader([&]() {
+        EpochGuard guard;
+        pinned = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    while (!pinned) {
+        std::this_thread::yield();
+    }
+
+    epochs.retire(object);
+    for (int i = 0; i < 10; ++i) {
+        epochs.tryReclaim();
+    }
+    assert(Tracked::liveCount == before && "Object freed while a reader was pinned");
+
+    release = true;
+    reader.join();
+    for (int i = 0; i < 10; ++i) {
+        epochs.tryReclaim();
+    }
+    assert(Tracked::liveCount == before - 1 && "Object not reclaimed after the reader left");
+
+    std::cout << "Pinned reader test passed!" << std::endl;
+}
+
+void testConcurrentReadersAndWriters() {
+    EpochManager& epochs = EpochManager::getInstance();
+    std::atomic<Tracked*> shared{new Tracked(0)};
+    std::atomic<bool> stop{false};
+
+    // Readers never lock; they only pin the epoch while dereferencing
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&]() {
+            while (!stop) {
+                EpochGuard guard;
+                Tracked* current = shared.load(std::memory_order_acquire);
+                assert(current->value >= 0 && "Read a freed object");
+            }
+        });
+    }
+
+    for (int i = 1; i <= 2000; ++i) {
+        Tracked* old = shared.exchange(new Tracked(i), std::memory_order_acq_rel);
+        epochs.retire(old);
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    delete shared.load();
+    for (int i = 0; i < 10; ++i) {
+        epochs.tryReclaim();
+    }
+    assert(Tracked::liveCount == 0 && "Retired objects leaked");
+    std::cout << "Concurrent readers and writers test passed!" << std::endl;
+}
+
+int main() {
+    testPinnedReaderBlocksReclaim();
+    testConcurrentReadersAndWriters();
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include "ExternalSort.hpp"
+#include "QueryProcessor.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <string>
+
+static std::string sortKey(const std::string& value, ColumnType type, bool descending = false) {
+    std::string key;
+    appendSortKey(value, type, descending, key);
+    return key;
+}
+
+// Payments with repeated amounts, a few NULL amounts and customers in scrambled order
+static void loadPayments(QueryProcessor& processor, int count) {
+    processor.executeQuery("CREATE TABLE payments (customerNumber INT, checkNumber TEXT, amount DECIMAL(10,2), "
+                           "PRIMARY KEY (customerNumber, checkNumber));");
+    std::vector<Row> rows;
+    for (int i = 0; i < count; ++i) {
+        int customer = (i * 7919) % count;
+        std::string amount = i % 97 == 0 ? NULL_VALUE : std::to_string((i * 31) % 500) + ".25";
+        rows.push_back({std::to_string(customer), "CH" + std::to_string(i % 13), amount});
+    }
+    assert(processor.insertRows("payments", {}, rows).success);
+}
+
+// amount DESC (NULL last), then checkNumber
+static bool inReportOrder(const QueryResult& result) {
+    for (size_t i = 1; i < result.rows.size(); ++i) {
+        const Row& previous = result.rows[i - 1];
+        const Row& row = result.rows[i];
+        int order = -compareValues(previous[2], row[2], ColumnType::Decimal);
+        if (order == 0) {
+            order = compareValues(previous[1], row[1], ColumnType::Text);
+        }
+        if (order > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testSortKeys() {
+    // Numbers by value, -0 with 0, NULL first, text by bytes with prefixes first
+    assert(sortKey("-1.5", ColumnType::Decimal) < sortKey("0", ColumnType::Decimal));
+    assert(sortKey("-0", ColumnType::Decimal) == sortKey("0", ColumnType::Integer));
+    assert(sortKey("2", ColumnType::Integer) < sortKey("10", ColumnType::Integer));
+    assert(sortKey(NULL_VALUE, ColumnType::Integer) < sortKey("-1e300", ColumnType::Decimal));
+    assert(sortKey(NULL_VALUE, ColumnType::Text) < sortKey("", ColumnType::Text));
+    assert(sortKey("a", ColumnType::Text) < sortKey(std::string("a\0b", 3), ColumnType::Text));
+    assert(sortKey(std::string("a\0b", 3), ColumnType::Text) < sortKey("ab", ColumnType::Text));
+    assert(sortKey("10", ColumnType::Text) < sortKey("2", ColumnType::Text));
+
+    // Descending reverses everything, NULL included; column keys concatenate
+    assert(sortKey("ab", ColumnType::Text, true) < sortKey("a", ColumnType::Text, true));
+    assert(sortKey("5", ColumnType::Integer, true) < sortKey(NULL_VALUE, ColumnType::Integer, true));
+    std::string first = sortKey("a", ColumnType::Text) + sortKey("9", ColumnType::Integer);
+    std::string second = sortKey("ab", ColumnType::Text) + sortKey("1", ColumnType::Integer);
+    assert(first < second);
+    std::cout << "Sort keys test passed!" << std::endl;
+}
+
+void testOrderBy() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    loadPayments(processor, 20000);
+    const std::string query = "SELECT * FROM payments ORDER BY amount DESC, checkNumber;";
+
+    QueryResult inMemory = processor.executeQuery(query);
+    assert(inMemory.success && inMemory.rows.size() == 20000 && inReportOrder(inMemory));
+    assert(isNull(inMemory.rows.back()[2]));
+    QueryResult plan = processor.executeQuery("EXPLAIN " + query);
+    assert(plan.rows[0][0] == "Sort by amount DESC, checkNumber" && plan.rows[1][0] == "-> SeqScan on payments");
+
+    // A few runs, then more runs than one merge takes: equal keys keep their input order either way
+    for (size_t budget : {512 * 1024, 16 * 1024}) {
+        processor.setWorkMemory(budget);
+        QueryResult spilled = processor.executeQuery(query);
+        assert(spilled.success && spilled.rows == inMemory.rows);
+        plan = processor.executeQuery("EXPLAIN ANALYZE " + query);
+        assert(plan.rows[0][0].find("(spilled runs=") != std::string::npos);
+    }
+
+    // Top-N keeps only the first rows of each run
+    QueryResult top = processor.executeQuery("SELECT * FROM payments ORDER BY amount DESC, checkNumber LIMIT 25;");
+    assert(top.rows.size() == 25 && std::equal(top.rows.begin(), top.rows.end(), inMemory.rows.begin()));
+    processor.setWorkMemory(64 * 1024 * 1024);
+    top = processor.executeQuery("SELECT checkNumber FROM payments WHERE amount >= 490 ORDER BY amount DESC, checkNumber ASC LIMIT 3;");
+    assert(top.rows.size() == 3 && top.rows[0][0] == inMemory.rows[0][1]);
+    plan = processor.executeQuery("EXPLAIN SELECT * FROM payments ORDER BY amount DESC LIMIT 3;");
+    assert(plan.rows[1][0] == "-> Sort by amount DESC (top 3)");
+
+    assert(!processor.executeQuery("SELECT * FROM payments ORDER BY missing;").success);
+    assert(!processor.executeQuery("SELECT * FROM payments ORDER amount;").success);
+    std::cout << "ORDER BY test passed!" << std::endl;
+}
+
+// ORDER BY an indexed column reads the B-tree in order instead of sorting
+void testIndexOrder() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    loadPayments(processor, 5000);
+
+    QueryResult plan = processor.executeQuery("EXPLAIN SELECT * FROM payments ORDER BY customerNumber LIMIT 5;");
+    assert(plan.rows[0][0] == "Limit 5" && plan.rows[1][0] == "-> IndexScan on payments using PRIMARY");
+    QueryResult first = processor.executeQuery("SELECT customerNumber FROM payments ORDER BY customerNumber LIMIT 5;");
+    assert(first.rows == (std::vector<Row>{{"0"}, {"1"}, {"2"}, {"3"}, {"4"}}));
+
+    // A moved row leaves a stale index entry behind; it still comes exactly once, in order
+    assert(processor.executeQuery("UPDATE payments SET customerNumber = 9000 WHERE customerNumber = 2;").success);
+    QueryResult all = processor.executeQuery("SELECT customerNumber FROM payments ORDER BY customerNumber LIMIT 9999;");
+    assert(all.rows.size() == 5000 && all.rows[2][0] == "3" && all.rows.back()[0] == "9000");
+    QueryResult range = processor.executeQuery("SELECT customerNumber FROM payments WHERE customerNumber >= 1 "
+                                               "ORDER BY customerNumber;");
+    assert(range.rows.size() == 4999 && range.rows[1][0] == "3");
+    plan = processor.executeQuery("EXPLAIN SELECT * FROM payments WHERE customerNumber >= 1 ORDER BY customerNumber;");
+    assert(plan.rows[0][0].find("IndexRangeScan") == 0);
+
+    // Without a LIMIT, scanning and sorting is cheaper unless the sort would spill
+    plan = processor.executeQuery("EXPLAIN SELECT * FROM payments ORDER BY customerNumber;");
+    assert(plan.rows[0][0] == "Sort by customerNumber");
+    processor.setWorkMemory(64 * 1024);
+    plan = processor.executeQuery("EXPLAIN SELECT * FROM payments ORDER BY customerNumber;");
+    assert(plan.rows[0][0] == "IndexScan on payments using PRIMARY");
+    std::cout << "Index order test passed!" << std::endl;
+}
+
+void testMergeJoin() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE orders (orderNumber INT, status TEXT, PRIMARY KEY (orderNumber));");
+    processor.executeQuery("CREATE TABLE details (orderNumber INT, line INT, quantity INT, "
+                           "PRIMARY KEY (orderNumber, line));");
+    std::vector<Row> orders;
+    std::vector<Row> details;
+    for (int i = 0; i < 3000; ++i) {
+        int number = (i * 1237) % 3000;
+        orders.push_back({std::to_string(number), i % 5 == 0 ? "Shipped" : "Open"});
+        for (int line = 0; line < number % 3; ++line) {
+            details.push_back({std::to_string(number + line % 2 * 5000), std::to_string(line), std::to_string(i)});
+        }
+    }
+    assert(processor.insertRows("orders", {}, orders).success);
+    assert(processor.insertRows("details", {}, details).success);
+    const std::string query = "SELECT o.orderNumber, d.line, d.quantity, o.status FROM orders o JOIN details d "
+                              "ON o.orderNumber = d.orderNumber";
+
+    // Hash join while the inputs fit in memory, merge join over the primary keys once they do not
+    QueryResult hashed = processor.executeQuery(query + ";");
+    assert(processor.executeQuery("EXPLAIN " + query + ";").rows[1][0].find("-> HashJoin") == 0);
+    processor.setWorkMemory(16 * 1024);
+    QueryResult merged = processor.executeQuery(query + ";");
+    QueryResult plan = processor.executeQuery("EXPLAIN " + query + ";");
+    assert(plan.rows[1][0] == "-> MergeJoin on o.orderNumber = d.orderNumber");
+    assert(plan.rows[2][0] == "  -> IndexScan on orders using PRIMARY");
+    std::vector<Row> expected = hashed.rows;
+    std::sort(expected.begin(), expected.end());
+    std::vector<Row> actual = merged.rows;
+    std::sort(actual.begin(), actual.end());
+    assert(expected.size() == 2000 && actual == expected);
+
+    // The first rows by join key come from a merge join without a sort, whatever the memory
+    processor.setWorkMemory(64 * 1024 * 1024);
+    const std::string first = query + " WHERE o.status = 'Shipped' ORDER BY o.orderNumber LIMIT 100;";
+    plan = processor.executeQuery("EXPLAIN " + first);
+    assert(plan.rows[1][0] == "-> Limit 100" && plan.rows[2][0].find("  -> MergeJoin") == 0);
+    QueryResult ordered = processor.executeQuery(first);
+    assert(ordered.rows.size() == 100);
+    for (size_t i = 1; i < ordered.rows.size(); ++i) {
+        assert(std::stoi(ordered.rows[i - 1][0]) <= std::stoi(ordered.rows[i][0]));
+        assert(ordered.rows[i][3] == "Shipped");
+    }
+
+    // Duplicate keys on both sides and NULL keys, through secondary B-tree indexes
+    processor.executeQuery("CREATE TABLE a (x INT, y TEXT);");
+    processor.executeQuery("CREATE TABLE b (x INT, z INT);");
+    processor.executeQuery("CREATE INDEX ax ON a (x);");
+    processor.executeQuery("CREATE INDEX bx ON b (x);");
+    processor.executeQuery("INSERT INTO a VALUES (2, 'u'), (1, 'u'), (NULL, 'n'), (1, 'v'), (3, 'w'), (1, 'w');");
+    processor.executeQuery("INSERT INTO b VALUES (1, 10), (NULL, 13), (2, 12), (1, 11), (4, 14);");
+    QueryResult duplicates = processor.executeQuery("SELECT a.x, b.z FROM a JOIN b ON a.x = b.x ORDER BY a.x LIMIT 10;");
+    assert(processor.executeQuery("EXPLAIN SELECT * FROM a JOIN b ON a.x = b.x ORDER BY b.x LIMIT 10;").rows[1][0]
+               .find("-> MergeJoin") == 0);
+    assert(duplicates.rows.size() == 7 && duplicates.rows.back() == (Row{"2", "12"}));
+    std::cout << "Merge join test passed!" << std::endl;
+}
+
+int main() {
+    testSortKeys();
+    testOrderBy();
+    testIndexOrder();
+    testMergeJoin();
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include "QueryProcessor.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <string>
+
+// Products in five lines and order lines referencing them; every 50th line has no price
+static void loadOrderDetails(QueryProcessor& processor, int count) {
+    processor.executeQuery("CREATE TABLE products (productCode TEXT, productLine TEXT, PRIMARY KEY (productCode));");
+    processor.executeQuery("CREATE TABLE orderdetails (orderNumber INT, productCode TEXT, quantityOrdered INT, "
+                           "priceEach DECIMAL(10,2));");
+    std::vector<Row> products;
+    for (int i = 0; i < 110; ++i) {
+        products.push_back({"S" + std::to_string(i), "Line" + std::to_string(i % 5)});
+    }
+    std::vector<Row> details;
+    for (int i = 0; i < count; ++i) {
+        std::string price = i % 50 == 0 ? NULL_VALUE : std::to_string(i % 200) + ".5";
+        details.push_back({std::to_string(i / 4), "S" + std::to_string((i * 37) % 110), std::to_string(i % 90 + 10),
+                           price});
+    }
+    assert(processor.insertRows("products", {}, products).success);
+    assert(processor.insertRows("orderdetails", {}, details).success);
+}
+
+void testGroupBy() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    const int count = 100000;
+    loadOrderDetails(processor, count);
+
+    // The same figures computed directly
+    std::map<std::string, std::vector<double>> expected;  // line -> rows, units, priced rows, min, max
+    for (int i = 0; i < count; ++i) {
+        std::vector<double>& line = expected["Line" + std::to_string((i * 37) % 110 % 5)];
+        line.resize(5, 0);
+        line[0] += 1;
+        line[1] += i % 90 + 10;
+        if (i % 50 != 0) {
+            double price = i % 200 + 0.5;
+            line[3] = line[2] == 0 ? price : std::min(line[3], price);
+            line[4] = std::max(line[4], price);
+            line[2] += 1;
+        }
+    }
+
+    QueryResult result = processor.executeQuery(
+        "SELECT p.productLine, COUNT(*), SUM(d.quantityOrdered) AS units, COUNT(d.priceEach), MIN(d.priceEach), "
+        "MAX(d.priceEach), AVG(d.quantityOrdered) FROM orderdetails d JOIN products p ON d.productCode = p.productCode "
+        "GROUP BY p.productLine ORDER BY p.productLine;");
+    assert(result.success && result.rows.size() == 5);
+    assert(result.columns[0] == "productLine" && result.columns[1] == "COUNT(*)" && result.columns[2] == "units");
+    assert(result.columnTypes[2] == ColumnType::Integer && result.columnTypes[6] == ColumnType::Decimal);
+    size_t i = 0;
+    for (const auto& [line, figures] : expected) {
+        const Row& row = result.rows[i++];
+        assert(row[0] == line && std::stod(row[1]) == figures[0] && std::stod(row[2]) == figures[1]);
+        assert(std::stod(row[3]) == figures[2] && std::stod(row[4]) == figures[3] && std::stod(row[5]) == figures[4]);
+        assert(std::abs(std::stod(row[6]) - figures[1] / figures[0]) < 1e-9);
+    }
+
+    QueryResult plan = processor.executeQuery("EXPLAIN SELECT productLine, COUNT(*) FROM products GROUP BY productLine;");
+    assert(plan.rows[0][0] == "Project productLine, COUNT(*)");
+    assert(plan.rows[1][0] == "-> HashAggregate by productLine: COUNT(*)");
+    plan = processor.executeQuery("EXPLAIN ANALYZE SELECT productLine FROM products GROUP BY productLine;");
+    assert(plan.rows[1][0].find("(workers=") != std::string::npos);
+    std::cout << "GROUP BY test passed!" << std::endl;
+}
+
+void testNullsAndEmptyInput() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE t (a INT, b TEXT);");
+    processor.executeQuery("INSERT INTO t VALUES (1, 'x'), (NULL, 'y'), (NULL, NULL), (2, 'x'), (5, NULL);");
+
+    // NULL is a group of its own; aggregates over a column skip its NULLs
+    QueryResult result = processor.executeQuery("SELECT b, COUNT(*), COUNT(a), SUM(a), MIN(a) FROM t GROUP BY b ORDER BY b;");
+    assert(result.success && result.rows.size() == 3);
+    assert(isNull(result.rows[0][0]) && result.rows[0][1] == "2" && result.rows[0][3] == "5");
+    assert(result.rows[1] == (Row{"x", "2", "2", "3", "1"}));
+    assert(result.rows[2][0] == "y" && result.rows[2][2] == "0" && isNull(result.rows[2][3]) && isNull(result.rows[2][4]));
+
+    // Without GROUP BY there is one row even for no input; with it, none
+    result = processor.executeQuery("SELECT COUNT(*), SUM(a), MAX(b) FROM t WHERE a > 100;");
+    assert(result.rows.size() == 1 && result.rows[0][0] == "0" && isNull(result.rows[0][1]) && isNull(result.rows[0][2]));
+    assert(processor.executeQuery("SELECT b, COUNT(*) FROM t WHERE a > 100 GROUP BY b;").rows.empty());
+    result = processor.executeQuery("SELECT AVG(a), MAX(b) FROM t;");
+    assert(result.rows == (std::vector<Row>{{"2.6666666666666665", "y"}}));
+
+    // GROUP BY alone lists the distinct values
+    assert(processor.executeQuery("SELECT b FROM t GROUP BY b;").rows.size() == 3);
+    std::cout << "NULL and empty input test passed!" << std::endl;
+}
+
+// Sums are exact past 2^53 and do not pick up binary fractions
+void testExactSums() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE t (a INT, d DECIMAL(10,2));");
+    processor.executeQuery("INSERT INTO t VALUES (9007199254740993, 0.1), (1, 0.2), (-2, 0.30);");
+
+    QueryResult result = processor.executeQuery("SELECT SUM(a), SUM(d), AVG(d) FROM t;");
+    assert(result.rows == (std::vector<Row>{{"9007199254740992", "0.60", "0.2"}}));
+    result = processor.executeQuery("SELECT SUM(d) FROM t WHERE a > 0;");
+    assert(result.rows[0][0] == "0.3");
+
+    // A total past the int64 range falls back to floating point instead of wrapping
+    processor.executeQuery("INSERT INTO t VALUES (9223372036854775807, NULL);");
+    result = processor.executeQuery("SELECT SUM(a) FROM t;");
+    assert(std::stod(result.rows[0][0]) > 9.2e18);
+    std::cout << "Exact sums test passed!" << std::endl;
+}
+
+void testOrderByAggregate() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    loadOrderDetails(processor, 20000);
+
+    const std::string query = "SELECT orderNumber, SUM(quantityOrdered) AS units FROM orderdetails "
+                              "GROUP BY orderNumber ORDER BY units DESC, orderNumber LIMIT 3;";
+    QueryResult top = processor.executeQuery(query);
+    assert(top.success && top.rows.size() == 3);
+    assert(std::stoi(top.rows[0][1]) >= std::stoi(top.rows[1][1]) && std::stoi(top.rows[1][1]) >= std::stoi(top.rows[2][1]));
+    QueryResult all = processor.executeQuery("SELECT orderNumber, SUM(quantityOrdered) FROM orderdetails "
+                                             "GROUP BY orderNumber ORDER BY SUM(quantityOrdered) DESC, orderNumber;");
+    assert(all.rows.size() == 5000 && std::equal(top.rows.begin(), top.rows.end(), all.rows.begin()));
+
+    QueryResult plan = processor.executeQuery("EXPLAIN " + query);
+    assert(plan.rows[1][0] == "-> Limit 3" && plan.rows[2][0] == "  -> Sort by units DESC, orderNumber (top 3)");
+    assert(plan.rows[3][0] == "    -> HashAggregate by orderNumber: SUM(quantityOrdered)");
+    assert(plan.rows[4][0] == "      -> SeqScan on orderdetails");
+
+    // An aggregate only in ORDER BY is computed but not returned
+    QueryResult busiest = processor.executeQuery("SELECT productCode FROM orderdetails GROUP BY productCode "
+                                                 "ORDER BY COUNT(*) DESC, productCode LIMIT 1;");
+    assert(busiest.columns.size() == 1 && busiest.rows.size() == 1);
+    std::cout << "ORDER BY aggregate test passed!" << std::endl;
+}
+
+// Groups that do not fit the work memory spill by partition and merge to the same result
+void testSpill() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    loadOrderDetails(processor, 40000);
+    const std::string query = "SELECT orderNumber, productCode, COUNT(*), SUM(priceEach), MAX(priceEach) "
+                              "FROM orderdetails GROUP BY orderNumber, productCode ORDER BY orderNumber, productCode;";
+
+    QueryResult inMemory = processor.executeQuery(query);
+    assert(inMemory.success && inMemory.rows.size() == 40000);
+    processor.setWorkMemory(64 * 1024);
+    QueryResult spilled = processor.executeQuery(query);
+    assert(spilled.success && spilled.rows == inMemory.rows);
+    QueryResult plan = processor.executeQuery("EXPLAIN ANALYZE " + query);
+    assert(plan.rows[2][0].find("spilled partitions=64") != std::string::npos);
+    std::cout << "Aggregate spill test passed!" << std::endl;
+}
+
+void testErrors() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE t (a INT, b TEXT);");
+
+    QueryResult result = processor.executeQuery("SELECT a, COUNT(*) FROM t GROUP BY b;");
+    assert(!result.success && result.message == "Column a must appear in GROUP BY or in an aggregate");
+    assert(!processor.executeQuery("SELECT SUM(b) FROM t;").success);
+    assert(!processor.executeQuery("SELECT * FROM t GROUP BY a;").success);
+    assert(!processor.executeQuery("SELECT MEDIAN(a) FROM t;").success);
+    assert(!processor.executeQuery("SELECT COUNT(c) FROM t;").success);
+    std::cout << "Aggregate errors test passed!" << std::endl;
+}
+
+int main() {
+    testGroupBy();
+    testNullsAndEmptyInput();
+    testExactSums();
+    testOrderByAggregate();
+    testSpill();
+    testErrors();
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "HashJoin.hpp"
+#include "QueryProcessor.hpp"
+#include "TestHelpers.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+// Orders with 0-3 lines each, a few order lines pointing at no order, and some NULL keys
+static void loadOrders(QueryProcessor& processor, int orders) {
+    processor.executeQuery("CREATE TABLE orders (orderNumber INT, customer TEXT, PRIMARY KEY (orderNumber));");
+    processor.executeQuery("CREATE TABLE lines (orderNumber INT, product TEXT, quantity INT);");
+    std::vector<Row> orderRows;
+    std::vector<Row> lineRows;
+    for (int i = 0; i < orders; ++i) {
+        orderRows.push_back({std::to_string(i), "c" + std::to_string(i % 7)});
+        for (int line = 0; line < i % 4; ++line) {
+            lineRows.push_back({std::to_string(i), "p" + std::to_string(line), std::to_string(i + line)});
+        }
+    }
+    for (int i = 0; i < 50; ++i) {
+        lineRows.push_back({std::to_string(orders + i), "orphan", "1"});
+        lineRows.push_back({NULL_VALUE, "unknown", "1"});
+    }
+    assert(processor.insertRows("orders", {}, orderRows).success);
+    assert(processor.insertRows("lines", {}, lineRows).success);
+}
+
+void testJoinSyntax() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    loadOrders(processor, 100);
+
+    // Every line with a matching order, in either ON order, with aliases and qualified columns
+    QueryResult joined = processor.executeQuery(
+        "SELECT orders.orderNumber, lines.product, orders.customer FROM orders JOIN lines "
+        "ON orders.orderNumber = lines.orderNumber;");
+    assert(joined.success && joined.rows.size() == 150);  // 0+1+2+3 lines per 4 orders
+    assert(joined.columns.size() == 3 && joined.columns[2] == "customer");
+    QueryResult aliased = processor.executeQuery(
+        "SELECT o.orderNumber, l.product, customer FROM lines AS l INNER JOIN orders o ON l.orderNumber = o.orderNumber;");
+    assert(sortedRows(aliased) == sortedRows(joined));
+
+    // WHERE terms reach the scans of both tables
+    QueryResult filtered = processor.executeQuery(
+        "SELECT l.quantity FROM orders o JOIN lines l ON o.orderNumber = l.orderNumber "
+        "WHERE o.orderNumber = 7 AND l.product = 'p2';");
+    assert(filtered.rows.size() == 1 && filtered.rows[0][0] == "9");
+
+    // SELECT * returns the columns of every table in FROM order
+    QueryResult all = processor.executeQuery("SELECT * FROM orders JOIN lines ON orders.orderNumber = lines.orderNumber "
+                                             "WHERE orders.orderNumber = 3 LIMIT 2;");
+    assert(all.rows.size() == 2 && all.columns.size() == 5 && all.rows[0][0] == "3" && all.rows[0][2] == "3");
+
+    // Name errors
+    assert(!processor.executeQuery("SELECT orderNumber FROM orders JOIN lines ON orders.orderNumber = lines.orderNumber;").success);
+    assert(!processor.executeQuery("SELECT * FROM orders o JOIN lines ON orders.orderNumber = lines.orderNumber;").success);
+    assert(!processor.executeQuery("SELECT * FROM orders JOIN lines ON lines.product = lines.product;").success);
+
+    // EXPLAIN shows the join, ANALYZE what it did
+    QueryResult plan = processor.executeQuery("EXPLAIN ANALYZE SELECT * FROM orders o JOIN lines l "
+                                              "ON o.orderNumber = l.orderNumber WHERE o.customer = 'c1';");
+    assert(plan.rows[0][0].find("HashJoin on o.orderNumber = l.orderNumber (partitions=1 bloom filtered=") == 0);
+    std::cout << "Join syntax test passed!" << std::endl;
+}
+
+void testMultiTableJoin() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    loadOrders(processor, 40);
+    processor.executeQuery("CREATE TABLE products (code TEXT, price DECIMAL(10,2));");
+    processor.executeQuery("INSERT INTO products VALUES ('p0', 1.5), ('p1', 2), ('p2', 10.25);");
+
+    QueryResult result = processor.executeQuery(
+        "SELECT o.orderNumber, p.price FROM orders o JOIN lines l ON l.orderNumber = o.orderNumber "
+        "JOIN products p ON p.code = l.product WHERE o.orderNumber = 39;");
+    assert(sortedRows(result) == (std::vector<Row>{{"39", "1.5"}, {"39", "10.25"}, {"39", "2"}}));
+
+    // Numeric keys match across INT and DECIMAL columns
+    processor.executeQuery("CREATE TABLE rates (orderNumber DECIMAL(10,2), rate INT);");
+    processor.executeQuery("INSERT INTO rates VALUES (5.0, 1), (5.5, 2);");
+    assert(processor.executeQuery("SELECT rate FROM orders JOIN rates ON orders.orderNumber = rates.orderNumber;").rows.size() == 1);
+    std::cout << "Multi-table join test passed!" << std::endl;
+}
+
+// Large enough for several radix partitions and a parallel build, then again over a tiny budget
+void testPartitionsAndSpill() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    loadOrders(processor, 80000);
+    const std::string query = "SELECT lines.product, orders.customer FROM lines JOIN orders "
+                              "ON orders.orderNumber = lines.orderNumber;";
+
+    QueryResult inMemory = processor.executeQuery(query);
+    assert(inMemory.success && inMemory.rows.size() == 120000);
+    QueryResult plan = processor.executeQuery("EXPLAIN ANALYZE " + query);
+    assert(plan.rows[1][0].find("partitions=8 bloom filtered=50)") != std::string::npos);
+
+    processor.setWorkMemory(256 * 1024);
+    QueryResult spilled = processor.executeQuery(query);
+    assert(spilled.success && sortedRows(spilled) == sortedRows(inMemory));
+    plan = processor.executeQuery("EXPLAIN ANALYZE " + query);
+    assert(plan.rows[1][0].find("spilled partitions=64") != std::string::npos);
+    std::cout << "Partitions and spill test passed!" << std::endl;
+}
+
+// Duplicate keys on both sides and multi-column keys, directly on the operator
+void testDuplicateAndCompositeKeys() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE a (x INT, y TEXT);");
+    processor.executeQuery("CREATE TABLE b (x INT, y TEXT, z INT);");
+    processor.executeQuery("INSERT INTO a VALUES (1, 'u'), (1, 'u'), (1, 'v'), (2, 'u');");
+    processor.executeQuery("INSERT INTO b VALUES (1, 'u', 10), (1, 'u', 11), (2, 'v', 12), (NULL, 'u', 13);");
+
+    assert(processor.executeQuery("SELECT * FROM a JOIN b ON a.x = b.x;").rows.size() == 7);
+    QueryResult composite = processor.executeQuery("SELECT b.z FROM a JOIN b ON a.x = b.x AND a.y = b.y;");
+    assert(sortedRows(composite) == (std::vector<Row>{{"10"}, {"10"}, {"11"}, {"11"}}));
+    std::cout << "Duplicate and composite keys test passed!" << std::endl;
+}
+
+int main() {
+    testJoinSyntax();
+    testMultiTableJoin();
+    testPartitionsAndSpill();
+    testDuplicateAndCompositeKeys();
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include "Indexing.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+std::string makeKey(int i) {
+    return "key" + std::to_string(i);
+}
+
+void testHashIndex() {
+    Index index("name", std::make_unique<HashIndex>());
+    index.addIndexEntry("Alice", 1);
+    index.addIndexEntry("Alice", 2);
+
+    assert(index.hasIndexEntry("Alice"));
+    assert(!index.hasIndexEntry("Bob"));
+    assert(index.getIndexEntries("Alice").size() == 2);
+
+    std::cout << "Hash index test passed!" << std::endl;
+}
+
+void testBTreeIndexManyKeys() {
+    BTreeIndex index;
+    const int keyCount = 20000;
+
+    // Random insertion order exercises leaf and inner splits at every level
+    std::vector<int> order(keyCount);
+    for (int i = 0; i < keyCount; ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+    for (int i : order) {
+        index.addIndexEntry(makeKey(i), i);
+    }
+
+    for (int i = 0; i < keyCount; ++i) {
+        std::vector<int> rows = index.getIndexEntries(makeKey(i));
+        assert(rows.size() == 1 && rows[0] == i && "B-tree lost a key");
+    }
+    assert(!index.hasIndexEntry("missing"));
+
+    // Duplicate keys append row IDs to the same entry
+    index.addIndexEntry(makeKey(5), 100);
+    assert(index.getIndexEntries(makeKey(5)).size() == 2);
+
+    std::cout << "B-tree many keys test passed!" << std::endl;
+}
+
+void testBTreeRangeScan() {
+    BTreeIndex index;
+    const int keyCount = 5000;
+    std::vector<int> order(keyCount);
+    for (int i = 0; i < keyCount; ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(11));
+    for (int i : order) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "k%05d", i);
+        index.addIndexEntry(key, i);
+    }
+
+    // Scans follow the leaf chain in key order across leaf boundaries
+    std::vector<int> rows = index.rangeScan("k01000", true, 300);
+    assert(rows.size() == 300);
+    for (int i = 0; i < 300; ++i) {
+        assert(rows[i] == 1000 + i && "Range scan out of order");
+    }
+    assert(index.rangeScan("k01000", false, 1)[0] == 1001 && "Exclusive start returned the start key");
+    assert(index.rangeScan("k04990", true, 100).size() == 10);
+    assert(index.rangeScan("z", true, 100).empty());
+
+    // Hash strategies do not support ordered scans
+    assert(index.supportsRangeScan() && !HashIndex().supportsRangeScan());
+
+    std::cout << "B-tree range scan test passed!" << std::endl;
+}
+
+void testBTreeIndexConcurrent() {
+    BTreeIndex index;
+    const int threadCount = 4;
+    const int keysPerThread = 5000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&index, t]() {
+            for (int i = 0; i < keysPerThread; ++i) {
+                int key = i * threadCount + t;  // Interleaved keys: threads hit the same leaves
+                index.addIndexEntry(makeKey(key), key);
+                assert(index.hasIndexEntry(makeKey(key)) && "Own insert not visible");
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (int key = 0; key < threadCount * keysPerThread; ++key) {
+        std::vector<int> rows = index.getIndexEntries(makeKey(key));
+        assert(rows.size() == 1 && rows[0] == key && "Concurrent insert lost");
+    }
+    std::cout << "B-tree concurrent test passed!" << std::endl;
+}
+
+void testShardedHashIndex() {
+    ShardedHashIndex index(8);
+    assert(index.getShardCount() == 8);
+
+    const int keyCount = 10000;
+    for (int i = 0; i < keyCount; ++i) {
+        index.addIndexEntry(makeKey(i), i);
+    }
+    index.addIndexEntry(makeKey(3), 42);
+
+    for (int i = 0; i < keyCount; ++i) {
+        assert(index.hasIndexEntry(makeKey(i)) && "Sharded hash index lost a key");
+    }
+    assert(index.getIndexEntries(makeKey(3)).size() == 2);
+    assert(index.getIndexEntries("missing").empty());
+
+    // Every shard grew on its own from its initial table
+    for (size_t s = 0; s < index.getShardCount(); ++s) {
+        assert(index.getShardCapacity(s) > 16);
+    }
+
+    std::cout << "Sharded hash index test passed!" << std::endl;
+}
+
+void testShardedHashIndexConcurrent() {
+    ShardedHashIndex index(4);
+    const int threadCount = 4;
+    const int keysPerThread = 5000;
+
+    // Writers race with readers probing keys while shards resize underneath
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&index, t]() {
+            for (int i = 0; i < keysPerThread; ++i) {
+                int key = i * threadCount + t;
+                index.addIndexEntry(makeKey(key), key);
+                index.addIndexEntry(makeKey(i * threadCount), key);  // Shared hot keys
+                assert(index.hasIndexEntry(makeKey(key)) && "Own insert not visible");
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (int i = 0; i < keysPerThread; ++i) {
+        std::vector<int> rows = index.getIndexEntries(makeKey(i * threadCount));
+        assert(rows.size() == 1 + threadCount && "Concurrent append lost");
+    }
+    std::cout << "Sharded hash index concurrent test passed!" << std::endl;
+}
+
+int main() {
+    testHashIndex();
+    testBTreeIndexManyKeys();
+    testBTreeRangeScan();
+    testBTreeIndexConcurrent();
+    testShardedHashIndex();
+    testShardedHashIndexConcurrent();
+    return 0;
+}
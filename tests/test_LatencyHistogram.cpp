@@ -0,0 +1,53 @@
+#include "LatencyHistogram.hpp"
+#include <cassert>
+#include <iostream>
+
+void testPercentiles() {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100000; ++value) {
+        histogram.record(value);
+    }
+    assert(histogram.getCount() == 100000);
+    assert(histogram.getMin() == 1 && histogram.getMax() == 100000);
+
+    // Log-linear buckets keep every percentile within 1%
+    uint64_t p50 = histogram.getValueAtPercentile(50);
+    uint64_t p99 = histogram.getValueAtPercentile(99);
+    assert(p50 >= 49500 && p50 <= 50500);
+    assert(p99 >= 98010 && p99 <= 99990);
+    assert(histogram.getValueAtPercentile(100) == 100000);
+
+    // Small values are exact
+    LatencyHistogram small;
+    small.record(3);
+    small.record(7);
+    assert(small.getValueAtPercentile(50) == 3 && small.getValueAtPercentile(100) == 7);
+
+    std::cout << "Histogram percentiles test passed!" << std::endl;
+}
+
+void testMergeAndJson() {
+    LatencyHistogram first;
+    LatencyHistogram second;
+    first.record(1000);
+    second.record(5000);
+    second.record(9000);
+    first.merge(second);
+    assert(first.getCount() == 3 && first.getMax() == 9000 && first.getMin() == 1000);
+    assert(first.getMean() == 5000);
+
+    std::string json = first.toJson();
+    assert(json.find("\"count\": 3") != std::string::npos);
+    assert(json.find("\"buckets\": [[") != std::string::npos);
+
+    first.reset();
+    assert(first.getCount() == 0 && first.getValueAtPercentile(99) == 0);
+
+    std::cout << "Histogram merge test passed!" << std::endl;
+}
+
+int main() {
+    testPercentiles();
+    testMergeAndJson();
+    return 0;
+}
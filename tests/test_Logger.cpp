@@ -0,0 +1,74 @@
+#include "Logger.hpp"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int countLines(const std::string& path, const std::string& needle) {
+    std::ifstream in(path);
+    std::string line;
+    int count = 0;
+    while (std::getline(in, line)) {
+        if (line.find(needle) != std::string::npos) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void testCompileTimeRemoval() {
+    int evaluated = 0;
+    // Below the compile-time floor the arguments are not even evaluated
+    LOG_TRACE("trace " << ++evaluated);
+    assert(evaluated == 0 && "Trace statement was compiled in");
+    std::cout << "Compile-time removal test passed!" << std::endl;
+}
+
+void testAsyncSinkFromManyThreads() {
+    const std::string path = "test_logger.log";
+    std::remove(path.c_str());
+
+    Logger& logger = Logger::getInstance();
+    logger.setOutputFile(path);
+    logger.setLevel(LogLevel::Info);
+
+    const int threadCount = 4;
+    const int messagesPerThread = 200;  // Fits in each thread's ring, nothing is dropped
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([t]() {
+            for (int i = 0; i < messagesPerThread; ++i) {
+                LOG_INFO("worker " << t << " message " << i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Filtered at runtime
+    logger.setLevel(LogLevel::Error);
+    LOG_INFO("worker filtered");
+    LOG_ERROR("worker error");
+
+    logger.flush();
+    logger.setOutputFile("");
+
+    assert(logger.getDroppedCount() == 0);
+    assert(countLines(path, "[INFO] worker") == threadCount * messagesPerThread && "Lost log messages");
+    assert(countLines(path, "worker filtered") == 0);
+    assert(countLines(path, "[ERROR] worker error") == 1);
+
+    logger.setLevel(LogLevel::Info);
+    std::remove(path.c_str());
+    std::cout << "Async sink test passed!" << std::endl;
+}
+
+int main() {
+    testCompileTimeRemoval();
+    testAsyncSinkFromManyThreads();
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "Metrics.hpp"
+#include "QueryProcessor.hpp"
+#include <cassert>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+void testCountersAcrossThreads() {
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    uint64_t before = metrics.snapshot().getCounter(Counter::IndexInserts);
+
+    // Every thread records into its own block; exited threads keep their counts
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&metrics]() {
+            for (int i = 0; i < 10000; ++i) {
+                metrics.add(Counter::IndexInserts);
+            }
+            metrics.add(Counter::IndexInserts, 5);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    assert(metrics.snapshot().getCounter(Counter::IndexInserts) - before == 4 * 10005);
+
+    std::cout << "Counters across threads test passed!" << std::endl;
+}
+
+void testHistograms() {
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    uint64_t before = metrics.snapshot().getHistogram(Histogram::FsyncLatency).getCount();
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        metrics.record(Histogram::FsyncLatency, value * 1000);
+    }
+    const LatencyHistogram fsyncs = metrics.snapshot().getHistogram(Histogram::FsyncLatency);
+    assert(fsyncs.getCount() - before == 1000);
+    uint64_t p50 = fsyncs.getValueAtPercentile(50);
+    assert(p50 >= 495000 && p50 <= 505000 && "Percentile off by more than 1%");
+
+    std::string json = metrics.snapshot().toJson();
+    assert(json.find("\"fsync_latency_ns\": {\"count\": ") != std::string::npos);
+    assert(json.find("\"rows_scanned\": ") != std::string::npos);
+
+    std::cout << "Histograms test passed!" << std::endl;
+}
+
+void testEngineInstrumentation() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE t (id INT, v TEXT, PRIMARY KEY (id));");
+    processor.executeQuery("INSERT INTO t VALUES (1, 'a'), (2, 'b'), (3, 'c');");
+
+    MetricsSnapshot before = MetricsRegistry::getInstance().snapshot();
+    processor.executeQuery("SELECT * FROM t WHERE v = 'b';");   // Full scan
+    processor.executeQuery("SELECT * FROM t WHERE id = 3;");    // Index lookup
+    processor.executeQuery("SELECT * FROM missing;");
+    MetricsSnapshot after = MetricsRegistry::getInstance().snapshot();
+
+    assert(after.getCounter(Counter::QueriesExecuted) - before.getCounter(Counter::QueriesExecuted) == 3);
+    assert(after.getCounter(Counter::QueryErrors) - before.getCounter(Counter::QueryErrors) == 1);
+    assert(after.getCounter(Counter::RowsReturned) - before.getCounter(Counter::RowsReturned) == 2);
+    assert(after.getCounter(Counter::RowsScanned) - before.getCounter(Counter::RowsScanned) == 4);
+    assert(after.getCounter(Counter::IndexProbes) - before.getCounter(Counter::IndexProbes) == 1);
+    assert(after.getHistogram(Histogram::QueryLatency).getCount() -
+           before.getHistogram(Histogram::QueryLatency).getCount() == 3);
+
+    // A contended lock is counted and timed
+    std::mutex mutex;
+    std::unique_lock<std::mutex> held(mutex);
+    std::thread waiter([&mutex]() {
+        std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+        lockCounted(lock);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    held.unlock();
+    waiter.join();
+    MetricsSnapshot waited = MetricsRegistry::getInstance().snapshot();
+    assert(waited.getCounter(Counter::LockWaits) > after.getCounter(Counter::LockWaits));
+    assert(waited.getHistogram(Histogram::LockWaitTime).getMax() >= 10000000 && "Lock wait not timed");
+
+    std::cout << "Engine instrumentation test passed!" << std::endl;
+}
+
+int main() {
+    testCountersAcrossThreads();
+    testHistograms();
+    testEngineInstrumentation();
+    return 0;
+}
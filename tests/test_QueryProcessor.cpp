@@ -1,19 +1,271 @@
-#include "QueryProcessor.h"
+#include "QueryProcessor.hpp"
+#include "EpochManager.hpp"
+#include <atomic>
+#include <cassert>
 #include <iostream>
+#include <thread>
 
-void testQueryProcessor() {
-    QueryProcessor processor;
+void testInsertAndSelect() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
 
-    // Add query components
-    processor.addComponent(std::make_shared<SelectQuery>());
-    processor.addComponent(std::make_shared<WhereClause>());
-    processor.addComponent(std::make_shared<JoinQuery>());
+    assert(processor.executeQuery("CREATE TABLE users (id INT, name TEXT, age INT, PRIMARY KEY (id));").success);
+    assert(!processor.executeQuery("CREATE TABLE users (id INT);").success && "Duplicate table accepted");
 
-    // Execute query (should print all query components)
-    processor.executeQuery();
+    // INSERT statements reach the table
+    QueryResult inserted = processor.executeQuery("INSERT INTO users VALUES (1, 'Alice', 30), (2, 'Bob', 25);");
+    assert(inserted.success && inserted.affectedRows == 2);
+    assert(processor.executeQuery("INSERT INTO users (name, id) VALUES ('Carol', 3);").success);
+    assert(storage.getRowCount("users") == 3 && "INSERT did not reach storage");
+
+    // SELECT * returns every column in table order
+    QueryResult all = processor.executeQuery("SELECT * FROM users;");
+    assert(all.success && all.rows.size() == 3);
+    assert(all.columns.size() == 3 && all.columns[1] == "name");
+    assert(all.rows[2][1] == "Carol" && isNull(all.rows[2][2]) && "Missing column not NULL");
+
+    // Projection, filters and LIMIT
+    QueryResult adults = processor.executeQuery("SELECT name FROM users WHERE age >= 26;");
+    assert(adults.rows.size() == 1 && adults.rows[0].size() == 1 && adults.rows[0][0] == "Alice");
+    assert(processor.executeQuery("SELECT * FROM users LIMIT 2;").rows.size() == 2);
+    assert(processor.executeQuery("SELECT * FROM users WHERE age != 30;").rows.size() == 1 && "NULL compared as a value");
+
+    // Numeric columns compare as numbers, not strings
+    assert(processor.executeQuery("INSERT INTO users VALUES (10, 'Dave', 9);").success);
+    assert(processor.executeQuery("SELECT * FROM users WHERE age < 10;").rows.size() == 1);
+
+    // SELECT statements do not modify storage
+    assert(storage.getRowCount("users") == 4);
+
+    std::cout << "Insert and select test passed!" << std::endl;
+}
+
+void testInsertRows() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE items (id INT, label TEXT, price DECIMAL(10,2), PRIMARY KEY (id));");
+
+    // Rows without SQL text, for all columns or a subset in any order
+    QueryResult inserted = processor.insertRows("items", {}, {{"1", "bolt", "0.25"}, {"2", "nut", NULL_VALUE}});
+    assert(inserted.success && inserted.affectedRows == 2);
+    assert(processor.insertRows("items", {"label", "id"}, {{"washer", "3"}}).success);
+    QueryResult washer = processor.executeQuery("SELECT * FROM items WHERE id = 3;");
+    assert(washer.rows.size() == 1 && washer.rows[0][1] == "washer" && isNull(washer.rows[0][2]));
+
+    // A batch is all or nothing: duplicates against the table or within the batch insert no row
+    assert(!processor.insertRows("items", {}, {{"4", "a", "1"}, {"1", "b", "2"}}).success);
+    assert(!processor.insertRows("items", {}, {{"5", "a", "1"}, {"5", "b", "2"}}).success);
+    assert(!processor.executeQuery("INSERT INTO items VALUES (6, 'c', 1), (6, 'd', 2);").success);
+    assert(!processor.insertRows("items", {"id", "missing"}, {{"7", "x"}}).success);
+    assert(!processor.insertRows("items", {}, {{"8", "x"}}).success);
+    assert(storage.getRowCount("items") == 3);
+
+    std::cout << "Insert rows test passed!" << std::endl;
+}
+
+void testIndexAccessPaths() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE items (id INT, label TEXT, PRIMARY KEY (id));");
+    for (int i = 0; i < 500; ++i) {
+        processor.executeQuery("INSERT INTO items VALUES (" + std::to_string(i) + ", 'item" + std::to_string(i) + "');");
+    }
+
+    // Point lookup through the primary key
+    std::vector<std::string> columns;
+    SelectStatement lookup;
+    lookup.table = "items";
+    lookup.where.push_back(Condition{"id", CompareOp::Equal, "42"});
+    std::unique_ptr<PlanNode> plan = processor.planSelect(lookup, columns);
+    assert(plan->describe().find("IndexLookup") == 0 && "Primary key lookup not used");
+    QueryResult point = processor.executeQuery("SELECT label FROM items WHERE id = 42;");
+    assert(point.rows.size() == 1 && point.rows[0][0] == "item42");
+
+    // Range scans walk the index in key order (numerically for INT keys)
+    QueryResult range = processor.executeQuery("SELECT id FROM items WHERE id >= 95 LIMIT 10;");
+    assert(range.rows.size() == 10);
+    for (int i = 0; i < 10; ++i) {
+        assert(range.rows[i][0] == std::to_string(95 + i) && "Range scan out of order");
+    }
+    assert(processor.executeQuery("SELECT id FROM items WHERE id > 489;").rows.size() == 10);
+
+    // Secondary indexes are built over existing rows and maintained afterwards
+    assert(processor.executeQuery("CREATE INDEX items_label ON items (label) USING HASH;").success);
+    processor.executeQuery("INSERT INTO items VALUES (500, 'item7');");
+    assert(processor.executeQuery("SELECT id FROM items WHERE label = 'item7';").rows.size() == 2);
+
+    // Duplicate primary keys are rejected
+    QueryResult duplicate = processor.executeQuery("INSERT INTO items VALUES (42, 'again');");
+    assert(!duplicate.success && storage.getRowCount("items") == 501);
+
+    std::cout << "Index access paths test passed!" << std::endl;
+}
+
+void testUpdate() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE accounts (id INT, owner TEXT, balance DECIMAL(10,2), PRIMARY KEY (id));");
+    processor.executeQuery("INSERT INTO accounts VALUES (1, 'Alice', 10.50), (2, 'Bob', 3), (3, 'Carol', 7);");
+
+    QueryResult updated = processor.executeQuery("UPDATE accounts SET balance = 0 WHERE balance < 8;");
+    assert(updated.success && updated.affectedRows == 2);
+    assert(processor.executeQuery("SELECT * FROM accounts WHERE balance = 0;").rows.size() == 2);
+
+    // Updating an indexed column keeps index lookups correct
+    processor.executeQuery("UPDATE accounts SET id = 7 WHERE owner = 'Alice';");
+    assert(processor.executeQuery("SELECT * FROM accounts WHERE id = 1;").rows.empty() && "Stale index entry returned");
+    assert(processor.executeQuery("SELECT owner FROM accounts WHERE id = 7;").rows[0][0] == "Alice");
+
+    // A value changed and changed back is found once
+    processor.executeQuery("CREATE TABLE t (id INT, v TEXT, PRIMARY KEY (id));");
+    processor.executeQuery("INSERT INTO t VALUES (1, 'a'), (2, 'b');");
+    assert(processor.executeQuery("CREATE INDEX t_v ON t (v) USING HASH;").success);
+    processor.executeQuery("UPDATE t SET v = 'y' WHERE id = 2;");
+    processor.executeQuery("UPDATE t SET v = 'b' WHERE id = 2;");
+    assert(processor.executeQuery("SELECT * FROM t WHERE v = 'b';").rows.size() == 1);
+    assert(processor.executeQuery("SELECT * FROM t WHERE v = 'y';").rows.empty());
+
+    // Index lookups and walks return a row listed twice under its key once
+    {
+        EpochGuard guard;
+        storage.getTableInfo("t")->findIndex(0)->index->addIndexEntry(encodeIndexKey("2", ColumnType::Integer), 1);
+    }
+    assert(processor.executeQuery("SELECT * FROM t WHERE id = 2;").rows.size() == 1);
+    assert(processor.executeQuery("SELECT * FROM t WHERE id >= 2;").rows.size() == 1);
+    assert(processor.executeQuery("SELECT id FROM t ORDER BY id LIMIT 5;").rows.size() == 2);
+
+    // An update may not give a row the primary key of another
+    processor.executeQuery("INSERT INTO t VALUES (5, 'c');");
+    assert(!processor.executeQuery("UPDATE t SET id = 2 WHERE id = 5;").success);
+    assert(!processor.executeQuery("UPDATE t SET id = 9 WHERE id > 1;").success);
+    assert(processor.executeQuery("SELECT * FROM t WHERE id = 2;").rows.size() == 1);
+    assert(processor.executeQuery("SELECT * FROM t WHERE id = 9;").rows.empty());
+    assert(processor.executeQuery("UPDATE t SET id = 5 WHERE id = 5;").success);
+    assert(processor.executeQuery("UPDATE t SET id = 6 WHERE id = 5;").affectedRows == 1);
+
+    // The key an update gave up can be inserted again
+    assert(processor.executeQuery("INSERT INTO t VALUES (5, 'd');").success);
+    assert(!processor.executeQuery("INSERT INTO t VALUES (6, 'e');").success);
+    assert(processor.executeQuery("SELECT v FROM t WHERE id = 5;").rows[0][0] == "d");
+
+    std::cout << "Update test passed!" << std::endl;
+}
+
+// Sessions inserting the same keys at once: each key is taken exactly once
+void testConcurrentInserts() {
+    StorageEngine storage("memory");
+    QueryProcessor setup(&storage);
+    setup.executeQuery("CREATE TABLE t (id INT, v TEXT, PRIMARY KEY (id));");
+    std::atomic<int> inserted{0};
+    std::vector<std::thread> writers;
+    for (int writer = 0; writer < 4; ++writer) {
+        writers.emplace_back([&storage, &inserted]() {
+            QueryProcessor processor(&storage);
+            for (int i = 0; i < 200; ++i) {
+                if (processor.insertRows("t", {}, {{std::to_string(i), "x"}}).success) {
+                    ++inserted;
+                }
+            }
+        });
+    }
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+    assert(inserted == 200 && storage.getRowCount("t") == 200);
+    std::cout << "Concurrent inserts test passed!" << std::endl;
+}
+
+void testExplain() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE items (id INT, label TEXT, PRIMARY KEY (id));");
+    for (int i = 0; i < 100; ++i) {
+        processor.executeQuery("INSERT INTO items VALUES (" + std::to_string(i) + ", 'item" + std::to_string(i) + "');");
+    }
+
+    // EXPLAIN prints the operator tree without running it
+    QueryResult plan = processor.executeQuery("EXPLAIN SELECT label FROM items WHERE id >= 95 LIMIT 3;");
+    assert(plan.success && plan.columns.size() == 1 && plan.columns[0] == "QUERY PLAN");
+    assert(plan.rows.size() == 3);
+    assert(plan.rows[0][0] == "Project label");
+    assert(plan.rows[1][0] == "-> Limit 3");
+    assert(plan.rows[2][0].find("  -> IndexRangeScan on items using") == 0);
+    assert(plan.rows[0][0].find("actual") == std::string::npos);
+
+    // EXPLAIN ANALYZE annotates every operator with what it did
+    QueryResult analyzed = processor.executeQuery("EXPLAIN ANALYZE SELECT * FROM items WHERE label = 'item7';");
+    assert(analyzed.success);
+    assert(analyzed.rows[0][0].find("SeqScan on items filter: label = 'item7'  (actual rows=1 loops=1 time=") == 0);
+    assert(analyzed.rows[0][0].find("rows read=100)") != std::string::npos);
+    assert(analyzed.rows.back()[0] == "Rows: 1");
+
+    QueryResult lookup = processor.executeQuery("EXPLAIN ANALYZE SELECT id FROM items WHERE id = 4;");
+    assert(lookup.rows[1][0].find("rows read=1 index probes=1)") != std::string::npos);
+
+    assert(!processor.executeQuery("EXPLAIN INSERT INTO items VALUES (200, 'x');").success);
+    assert(storage.getRowCount("items") == 100);
+
+    std::cout << "Explain test passed!" << std::endl;
+}
+
+// IN and IS [NOT] NULL terms; scans hand up only the columns the query uses
+void testPushdown() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.setParallelism(1);
+    processor.executeQuery("CREATE TABLE items (id INT, label TEXT, price DECIMAL(10,2), PRIMARY KEY (id));");
+    processor.executeQuery("CREATE TABLE tags (item INT, tag TEXT);");
+    processor.executeQuery("INSERT INTO items VALUES (1, 'a', 1.5), (2, NULL, 2.5), (3, 'c', NULL), (4, 'd', 4.5);");
+    processor.executeQuery("INSERT INTO tags VALUES (1, 'x'), (3, 'y'), (4, 'z');");
+
+    QueryResult result = processor.executeQuery("SELECT id FROM items WHERE label IN ('a', 'd', 'q');");
+    assert(result.rows == (std::vector<Row>{{"1"}, {"4"}}));
+    result = processor.executeQuery("SELECT id, price FROM items WHERE label IS NULL;");
+    assert(result.rows == (std::vector<Row>{{"2", "2.5"}}));
+    result = processor.executeQuery("SELECT id FROM items WHERE price IS NOT NULL AND id IN (2, 3, 4) "
+                                    "ORDER BY price DESC;");
+    assert(result.rows == (std::vector<Row>{{"4"}, {"2"}}));
+    assert(processor.executeQuery("EXPLAIN SELECT id FROM items WHERE id IN (1, 2);").rows[1][0] ==
+           "-> SeqScan on items filter: id IN (1, 2)");
+
+    // Join keys and ORDER BY columns are read even when not selected
+    result = processor.executeQuery("SELECT t.tag, i.label FROM items i JOIN tags t ON i.id = t.item "
+                                    "WHERE i.price IS NOT NULL ORDER BY i.id DESC;");
+    assert(result.rows == (std::vector<Row>{{"z", "d"}, {"x", "a"}}));
+    result = processor.executeQuery("SELECT COUNT(*), MAX(price) FROM items WHERE label IS NOT NULL;");
+    assert(result.rows == (std::vector<Row>{{"3", "4.5"}}));
+
+    // UPDATE still writes back whole rows
+    assert(processor.executeQuery("UPDATE items SET price = 9 WHERE label IN ('c');").affectedRows == 1);
+    result = processor.executeQuery("SELECT * FROM items WHERE id = 3;");
+    assert(result.rows == (std::vector<Row>{{"3", "c", "9"}}));
+    std::cout << "Pushdown test passed!" << std::endl;
+}
+
+void testErrors() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE users (id INT NOT NULL, name TEXT);");
+
+    assert(!processor.executeQuery("SELEKT * FROM users;").success && "Syntax error accepted");
+    assert(!processor.executeQuery("SELECT * FROM missing;").success && "Unknown table accepted");
+    assert(!processor.executeQuery("SELECT age FROM users;").success && "Unknown column accepted");
+    assert(!processor.executeQuery("INSERT INTO users VALUES (1);").success && "Short row accepted");
+    assert(!processor.executeQuery("INSERT INTO users VALUES (NULL, 'x');").success && "NOT NULL ignored");
+    assert(!processor.executeInsert("SELECT * FROM users;").success);
+    assert(storage.getRowCount("users") == 0);
+
+    std::cout << "Error handling test passed!" << std::endl;
 }
 
 int main() {
-    testQueryProcessor();
+    testInsertAndSelect();
+    testInsertRows();
+    testIndexAccessPaths();
+    testUpdate();
+    testConcurrentInserts();
+    testExplain();
+    testPushdown();
+    testErrors();
     return 0;
 }
@@ -0,0 +1,135 @@
+#include "QueryStats.hpp"
+#include "Session.hpp"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+void testFingerprints() {
+    // Literals, case, spacing and comments do not change the fingerprint
+    assert(fingerprintQuery("SELECT * FROM users WHERE id = 7;") == "select * from users where id = ?");
+    assert(fingerprintQuery("select *  from users\n where id=8 -- point lookup") == "select * from users where id = ?");
+    assert(fingerprintQuery("SELECT name FROM users WHERE name = 'O''Brien' AND age >= -3.5e2") ==
+           "select name from users where name = ? and age >= ?");
+
+    // Value lists of any length share one fingerprint
+    std::string single = fingerprintQuery("INSERT INTO users VALUES (1, 'Alice', 30);");
+    assert(single == "insert into users values (...)");
+    assert(fingerprintQuery("INSERT INTO users VALUES (2, 'Bob', NULL), (3, 'Carol', 41);") == single);
+    assert(fingerprintQuery("INSERT INTO users (id, name) VALUES (4, 'Dave');") == "insert into users(id, name) values (...)");
+
+    // Identifiers stay apart
+    assert(fingerprintQuery("SELECT * FROM users WHERE id = 1") != fingerprintQuery("SELECT * FROM orders WHERE id = 1"));
+    assert(fingerprintQuery("SELECT * FROM t1 WHERE c2 = 3") == "select * from t1 where c2 = ?");
+
+    std::cout << "Fingerprint test passed!" << std::endl;
+}
+
+void testAggregation() {
+    StorageEngine storage("memory");
+    QueryStats stats;
+    Session session(0, &storage, nullptr, &stats);
+    session.executeQuery("CREATE TABLE items (id INT, label TEXT, PRIMARY KEY (id));");
+
+    // Every session of an engine records into the same table
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&storage, &stats, t]() {
+            Session worker(t + 1, &storage, nullptr, &stats);
+            for (int i = 0; i < 100; ++i) {
+                worker.executeQuery("INSERT INTO items VALUES (" + std::to_string(t * 100 + i) + ", 'x');");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int i = 0; i < 10; ++i) {
+        session.executeQuery("SELECT label FROM items WHERE id = " + std::to_string(i) + ";");
+    }
+    session.executeQuery("SELECT * FROM items;");
+    session.executeQuery("SELECT * FROM missing;");
+
+    std::vector<QueryStatsEntry> entries = stats.snapshot();
+    auto find = [&entries](const std::string& fingerprint) -> const QueryStatsEntry* {
+        for (const QueryStatsEntry& entry : entries) {
+            if (entry.fingerprint == fingerprint) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    };
+    const QueryStatsEntry* inserts = find("insert into items values (...)");
+    assert(inserts && inserts->calls == 400 && inserts->rows == 400 && inserts->errors == 0);
+    assert(inserts->maxNs > 0 && inserts->totalNs >= inserts->maxNs);
+
+    const QueryStatsEntry* lookups = find("select label from items where id = ?");
+    assert(lookups && lookups->calls == 10 && lookups->rows == 10);
+    assert(lookups->indexProbes == 10 && lookups->rowsRead == 10);
+
+    const QueryStatsEntry* scans = find("select * from items");
+    assert(scans && scans->rowsRead == 400 && scans->rows == 400);
+    assert(find("select * from missing")->errors == 1);
+
+    for (size_t i = 1; i < entries.size(); ++i) {
+        assert(entries[i - 1].totalNs >= entries[i].totalNs && "Not sorted by total time");
+    }
+
+    stats.reset();
+    assert(stats.snapshot().empty());
+
+    std::cout << "Aggregation test passed!" << std::endl;
+}
+
+void testFullTable() {
+    // Fingerprints that find no free slot are counted, not stored
+    QueryStats stats(16);
+    QueryExecution execution;
+    for (int i = 0; i < 100; ++i) {
+        stats.record("SELECT * FROM table" + std::to_string(i), execution);
+    }
+    assert(stats.snapshot().size() == 16);
+    assert(stats.getDroppedCount() == 84);
+
+    std::cout << "Full table test passed!" << std::endl;
+}
+
+void testSlowQueryLog() {
+    const std::string path = "test_slow_query.log";
+    std::remove(path.c_str());
+    QueryStats stats;
+    stats.setSlowQueryLog(path, 5.0);
+
+    QueryExecution fast;
+    fast.elapsedNs = 1000000;
+    stats.record("SELECT * FROM fast_table WHERE id = 1", fast);
+    QueryExecution slow;
+    slow.elapsedNs = 12000000;
+    slow.rows = 3;
+    stats.record("SELECT * FROM slow_table WHERE id = 1", slow);
+    stats.setSlowQueryLog("", 0);
+    stats.record("SELECT * FROM slow_table WHERE id = 2", slow);
+
+    std::ifstream log(path);
+    std::stringstream contents;
+    contents << log.rdbuf();
+    std::string text = contents.str();
+    assert(text.find("# Query_time: 0.012  Rows: 3") != std::string::npos);
+    assert(text.find("SELECT * FROM slow_table WHERE id = 1;") != std::string::npos);
+    assert(text.find("fast_table") == std::string::npos && "Fast statement logged");
+    assert(text.find("id = 2") == std::string::npos && "Logged after turning the log off");
+    std::remove(path.c_str());
+
+    std::cout << "Slow query log test passed!" << std::endl;
+}
+
+int main() {
+    testFingerprints();
+    testAggregation();
+    testFullTable();
+    testSlowQueryLog();
+    return 0;
+}
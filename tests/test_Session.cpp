@@ -0,0 +1,94 @@
+#include "DatabaseEngine.hpp"
+#include "EpochManager.hpp"
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+void testSessionsAreIndependent() {
+    DatabaseEngine engine;
+    engine.initializeDatabase(":memory:");
+    engine.setStorageEngine("memory");
+
+    auto first = engine.openSession();
+    auto second = engine.openSession();
+    assert(first && second && first->getId() != second->getId());
+
+    // A transaction in one session does not leak into the other
+    first->startTransaction();
+    assert(first->inTransaction());
+    assert(!second->inTransaction());
+
+    first->insertData("INSERT INTO users VALUES (1, 'Alice', 30);");
+    first->rollbackTransaction();
+    assert(!first->inTransaction());
+
+    std::cout << "Session independence test passed!" << std::endl;
+}
+
+void testConcurrentSessions() {
+    StorageEngine storage("memory");
+    const int threadCount = 4;
+    const int insertsPerThread = 50;
+    Session setup(0, &storage);
+    assert(setup.executeQuery("CREATE TABLE users (id INT, name TEXT, age INT, PRIMARY KEY (id));").success);
+
+    // Each thread commits through its own session into the shared storage
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&storage, t]() {
+            Session session(t + 1, &storage);
+            session.startTransaction();
+            for (int i = 0; i < insertsPerThread; ++i) {
+                session.insertData("INSERT INTO users VALUES (" + std::to_string(t * insertsPerThread + i) + ", 'x', 1);");
+            }
+            session.commitTransaction();
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    assert(storage.getRowCount("users") == threadCount * insertsPerThread && "Lost inserts across sessions");
+
+    // Every committed row is visible through the primary key index
+    QueryResult result = setup.executeQuery("SELECT name FROM users WHERE id = 123;");
+    assert(result.success && result.rows.size() == 1 && result.rows[0][0] == "x");
+    std::cout << "Concurrent sessions test passed!" << std::endl;
+}
+
+// A transaction begun on one thread may end on another; its epoch pin goes with it
+void testTransactionAcrossThreads() {
+    StorageEngine storage("memory");
+    Session session(1, &storage);
+    session.executeQuery("CREATE TABLE users (id INT, name TEXT, age INT);");
+    EpochManager& epochs = EpochManager::getInstance();
+
+    std::thread([&session]() {
+        session.startTransaction();
+        session.insertData("INSERT INTO users VALUES (1, 'Alice', 30);");
+    }).join();
+    assert(!epochs.inCriticalSection());
+
+    // The pin holds the epoch back until the transaction ends
+    uint64_t pinned = epochs.getGlobalEpoch();
+    for (int i = 0; i < 4; ++i) {
+        epochs.tryReclaim();
+    }
+    assert(epochs.getGlobalEpoch() <= pinned + 1);
+
+    std::thread([&session]() { session.commitTransaction(); }).join();
+    assert(!session.inTransaction() && storage.getRowCount("users") == 1);
+    for (int i = 0; i < 4; ++i) {
+        epochs.tryReclaim();
+    }
+    assert(epochs.getGlobalEpoch() > pinned + 1 && "Transaction pin never released");
+    std::cout << "Transaction across threads test passed!" << std::endl;
+}
+
+int main() {
+    testSessionsAreIndependent();
+    testConcurrentSessions();
+    testTransactionAcrossThreads();
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "SqlParser.hpp"
+#include <cassert>
+#include <iostream>
+
+void testCreateTable() {
+    auto statement = SqlParser::parse(
+        "CREATE TABLE payments (\n"
+        "  customerNumber int,\n"
+        "  checkNumber varchar(50) NOT NULL,\n"
+        "  paymentDate date NOT NULL,\n"
+        "  amount decimal(10,2) DEFAULT NULL,\n"
+        "  PRIMARY KEY (customerNumber,checkNumber),\n"
+        "  FOREIGN KEY (customerNumber) REFERENCES customers (customerNumber)\n"
+        ");");
+    assert(statement->type == StatementType::CreateTable);
+    const TableSchema& schema = static_cast<CreateTableStatement&>(*statement).schema;
+    assert(schema.name == "payments" && schema.columns.size() == 4);
+    assert(schema.columns[0].type == ColumnType::Integer);
+    assert(schema.columns[1].type == ColumnType::Text && schema.columns[1].notNull);
+    assert(schema.columns[2].type == ColumnType::Date);
+    assert(schema.columns[3].type == ColumnType::Decimal && !schema.columns[3].notNull);
+    assert(schema.primaryKey.size() == 2 && schema.primaryKey[1] == 1);
+    assert(schema.getColumnIndex("CHECKNUMBER") == 1 && "Column names are case-insensitive");
+
+    std::cout << "CREATE TABLE parsing test passed!" << std::endl;
+}
+
+void testStatements() {
+    // Lower-case keywords, column lists, escapes and NULL
+    auto insert = SqlParser::parse("insert  into t(a,b) values (1,'it''s'),(-2.5,NULL)");
+    const InsertStatement& rows = static_cast<InsertStatement&>(*insert);
+    assert(rows.table == "t" && rows.columns.size() == 2 && rows.rows.size() == 2);
+    assert(rows.rows[0][1] == "it's" && rows.rows[1][0] == "-2.5" && isNull(rows.rows[1][1]));
+
+    auto select = SqlParser::parse("SELECT a, b FROM t WHERE a >= 3 AND b <> 'x' LIMIT 5;");
+    const SelectStatement& query = static_cast<SelectStatement&>(*select);
+    assert(query.columns.size() == 2 && query.where.size() == 2 && query.limit == 5);
+    assert(query.where[0].op == CompareOp::GreaterEqual && query.where[1].op == CompareOp::NotEqual);
+
+    // Joins, aliases and qualified columns
+    auto join = SqlParser::parse("SELECT o.a, d.b FROM orders AS o JOIN details d ON o.id = d.id AND o.x = d.y "
+                                 "INNER JOIN items ON items.k = d.k WHERE o.a = 1");
+    const SelectStatement& joined = static_cast<SelectStatement&>(*join);
+    assert(joined.alias == "o" && joined.columns[1].column == "d.b" && joined.joins.size() == 2);
+    assert(joined.joins[0].alias == "d" && joined.joins[0].on.size() == 2 && joined.joins[0].on[1].second == "d.y");
+    assert(joined.joins[1].table == "items" && joined.joins[1].alias.empty() && joined.where[0].column == "o.a");
+
+    auto ordered = SqlParser::parse("SELECT * FROM t o ORDER BY o.b DESC, a ASC, c LIMIT 3");
+    const SelectStatement& sorted = static_cast<SelectStatement&>(*ordered);
+    assert(sorted.alias == "o" && sorted.orderBy.size() == 3 && sorted.limit == 3);
+    assert(sorted.orderBy[0].column == "o.b" && sorted.orderBy[0].descending && !sorted.orderBy[1].descending);
+
+    // Aggregates, SELECT aliases, GROUP BY and ORDER BY an aggregate
+    auto grouped = SqlParser::parse("SELECT o.b, count(*) n, SUM(a) AS total FROM t o WHERE a > 1 GROUP BY o.b "
+                                    "ORDER BY MAX(a) DESC, n");
+    const SelectStatement& aggregate = static_cast<SelectStatement&>(*grouped);
+    assert(aggregate.columns.size() == 3 && aggregate.columns[1].aggregate == AggregateFunction::Count);
+    assert(aggregate.columns[1].column == "*" && aggregate.columns[1].alias == "n");
+    assert(aggregate.columns[2].text() == "SUM(a)" && aggregate.columns[2].alias == "total");
+    assert(aggregate.groupBy == std::vector<std::string>{"o.b"} && aggregate.orderBy.size() == 2);
+    assert(aggregate.orderBy[0].aggregate == AggregateFunction::Max && aggregate.orderBy[0].descending);
+    assert(aggregate.orderBy[1].column == "n" && aggregate.orderBy[1].aggregate == AggregateFunction::None);
+
+    // IN lists and NULL tests
+    auto tests = SqlParser::parse("SELECT a FROM t WHERE b IN ('x', 'y', NULL) AND c is not null AND d IS NULL");
+    const SelectStatement& predicates = static_cast<SelectStatement&>(*tests);
+    assert(predicates.where.size() == 3 && predicates.where[0].op == CompareOp::In);
+    assert(predicates.where[0].values.size() == 3 && isNull(predicates.where[0].values[2]));
+    assert(predicates.where[1].op == CompareOp::IsNotNull && predicates.where[2].op == CompareOp::IsNull);
+
+    auto update = SqlParser::parse("UPDATE t SET b = 'y', a = 4 WHERE a = 3");
+    assert(static_cast<UpdateStatement&>(*update).assignments.size() == 2);
+
+    auto index = SqlParser::parse("CREATE INDEX t_b ON t (b) USING hash;");
+    assert(static_cast<CreateIndexStatement&>(*index).method == "HASH");
+
+    // Syntax errors throw
+    bool threw = false;
+    try {
+        SqlParser::parse("SELECT FROM t");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw && "Syntax error accepted");
+
+    std::cout << "Statement parsing test passed!" << std::endl;
+}
+
+void testSplitStatements() {
+    auto statements = SqlParser::splitStatements(
+        "/* header; */ CREATE TABLE a (x INT);\n-- comment;\nINSERT INTO a VALUES ('1;2');\n");
+    assert(statements.size() == 2 && "Semicolons in comments or strings split statements");
+    assert(statements[1].find("'1;2'") != std::string::npos);
+
+    std::cout << "Script splitting test passed!" << std::endl;
+}
+
+void testValueOrdering() {
+    // Index keys compare like the values they encode
+    assert(encodeIndexKey("9", ColumnType::Integer) < encodeIndexKey("10", ColumnType::Integer));
+    assert(encodeIndexKey("-5", ColumnType::Integer) < encodeIndexKey("-1", ColumnType::Integer));
+    assert(encodeIndexKey("1.5", ColumnType::Decimal) < encodeIndexKey("2", ColumnType::Decimal));
+    assert(encodeIndexKey("1", ColumnType::Integer) == encodeIndexKey("1.0", ColumnType::Integer));
+    assert(compareValues("9", "10", ColumnType::Integer) < 0);
+    assert(compareValues("9", "10", ColumnType::Text) > 0);
+    assert(compareValues(NULL_VALUE, "a", ColumnType::Text) < 0);
+
+    std::cout << "Value ordering test passed!" << std::endl;
+}
+
+int main() {
+    testCreateTable();
+    testStatements();
+    testSplitStatements();
+    testValueOrdering();
+    return 0;
+}
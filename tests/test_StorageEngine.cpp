@@ -1,24 +1,163 @@
-#include "StorageEngine.h"
+#include "StorageEngine.hpp"
+#include "EpochManager.hpp"
 #include <cassert>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
 
-void testStorageEngineFactory() {
-    StorageEngine* memoryStorage = StorageEngineFactory::createStorageEngine("memory");
-    assert(memoryStorage != nullptr && "Factory failed to create memory storage engine");
+void testStorageBackends() {
+    StorageEngine memoryStorage("memory");
+    memoryStorage.storeData("row 1");
+    memoryStorage.storeData("row 2");
+    assert(memoryStorage.retrieveData().size() == 2 && "Memory backend lost data");
 
-    StorageEngine* fileStorage = StorageEngineFactory::createStorageEngine("file");
-    assert(fileStorage != nullptr && "Factory failed to create file storage engine");
+    const std::string path = "test_storage.txt";
+    std::remove(path.c_str());
+    FileStorage fileStorage(path);
+    fileStorage.storeData("row 1");
+    assert(fileStorage.retrieveData().size() == 1 && "File backend lost data");
+    std::remove(path.c_str());
 
-    // Test that the correct types are created (memory or file storage)
-    // You can expand this check further to validate behavior, if needed.
+    // Unknown backend types are rejected
+    bool threw = false;
+    try {
+        StorageEngine unknown("tape");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw && "Unknown backend type accepted");
 
-    std::cout << "Factory pattern test passed!" << std::endl;
+    std::cout << "Storage backends test passed!" << std::endl;
+}
+
+void testTablesAndIndexes() {
+    StorageEngine storage("memory");
+    TableSchema schema;
+    schema.name = "users";
+    schema.columns = {{"id", ColumnType::Integer, true}, {"name", ColumnType::Text, false}};
+    schema.primaryKey = {0};
+    assert(storage.createTable(schema));
+    assert(!storage.createTable(schema) && "Table created twice");
+    assert(storage.hasTable("users") && storage.getSchema("users")->columns.size() == 2);
+
+    // Rows are addressed by row ID; rows of the wrong width are rejected
+    assert(storage.insertRow("users", {"1", "Alice"}) == 0);
+    assert(storage.insertRow("users", {"2", "Bob"}) == 1);
+    assert(storage.insertRow("users", {"3"}) == -1);
+    assert(storage.insertRow("missing", {"1", "x"}) == -1);
+    Row row;
+    assert(storage.fetchRow("users", 1, row) && row[1] == "Bob");
+    assert(storage.updateRow("users", 1, {{1, "Robert"}}));
+    assert(storage.fetchRow("users", 1, row) && row[1] == "Robert");
+
+    std::vector<Row> rows;
+    assert(storage.readRows("users", 0, 10, rows) == 2 && rows[0][1] == "Alice");
+
+    // The primary key is indexed; secondary indexes are backfilled
+    assert(storage.createIndex("users", "name", IndexKind::Hash));
+    {
+        EpochGuard guard;
+        const TableInfo* info = storage.getTableInfo("users");
+        assert(info && info->indexes.size() == 2);
+        assert(info->findIndex(0)->index->hasIndexEntry(encodeIndexKey("2", ColumnType::Integer)));
+        assert(info->findIndex(1)->index->getIndexEntries("Robert").size() == 1);
+    }
+    assert(!storage.createIndex("users", "age"));
+
+    // Batches get consecutive row IDs and index entries; a bad row rejects the whole batch
+    std::vector<Row> batch = {{"9", "Zed"}, {"5", "Eve"}, {"7", "Eve"}};
+    assert(storage.insertRows("users", batch) == 2 && storage.getRowCount("users") == 5);
+    {
+        EpochGuard guard;
+        const TableInfo* info = storage.getTableInfo("users");
+        assert(info->findIndex(0)->index->getIndexEntries(encodeIndexKey("7", ColumnType::Integer)) == std::vector<int>{4});
+        assert((info->findIndex(1)->index->getIndexEntries("Eve") == std::vector<int>{3, 4}));
+    }
+    std::vector<Row> invalid = {{"10", "Ok"}, {"11"}};
+    assert(storage.insertRows("users", invalid) == -1 && storage.getRowCount("users") == 5);
+
+    std::cout << "Tables and indexes test passed!" << std::endl;
+}
+
+// Filter and projection are applied inside the backend; rows keep their width
+void testScanPushdown() {
+    StorageEngine storage("memory");
+    TableSchema schema;
+    schema.name = "items";
+    schema.columns = {{"id", ColumnType::Integer, true}, {"label", ColumnType::Text, false},
+                      {"price", ColumnType::Decimal, false}};
+    assert(storage.createTable(schema));
+    std::vector<Row> rows;
+    for (int i = 0; i < 10; ++i) {
+        rows.push_back({std::to_string(i), i % 3 == 0 ? NULL_VALUE : "item" + std::to_string(i), std::to_string(i)});
+    }
+    assert(storage.insertRows("items", rows) == 0);
+
+    ScanSpec spec;
+    BoundCondition label;
+    label.column = 1;
+    label.op = CompareOp::IsNotNull;
+    BoundCondition id;
+    id.column = 0;
+    id.op = CompareOp::In;
+    id.values = {"2", "3", "4", "8", NULL_VALUE};
+    id.type = ColumnType::Integer;
+    spec.filter = {label, id};
+    spec.allColumns = false;
+    spec.columns = {2};
+
+    std::vector<Row> out;
+    std::vector<int> rowIds;
+    assert(storage.scanRows("items", 0, 6, spec, out, &rowIds) == 6);
+    assert(storage.scanRows("items", 6, 100, spec, out, &rowIds) == 4);
+    assert(storage.scanRows("items", 10, 100, spec, out, &rowIds) == 0);
+    assert((rowIds == std::vector<int>{2, 4, 8}));
+    assert(out.size() == 3 && out[1].size() == 3 && out[1][2] == "4" && out[1][0].empty() && out[1][1].empty());
+
+    // IS NULL, comparisons and every column
+    spec.filter[0].op = CompareOp::IsNull;
+    spec.filter[1].op = CompareOp::Less;
+    spec.filter[1].value = "7";
+    spec.allColumns = true;
+    out.clear();
+    assert(storage.scanRows("items", 0, 100, spec, out) == 10);
+    assert(out.size() == 3 && out[2][0] == "6" && isNull(out[2][1]) && out[2][2] == "6");
+    std::cout << "Scan pushdown test passed!" << std::endl;
+}
+
+void testFileRowLog() {
+    const std::string path = "test_rows.txt";
+    std::remove((path + ".rows").c_str());
+    {
+        FileStorage storage(path);
+        assert(storage.createTable("t", {ColumnType::Text, ColumnType::Text}));
+        assert(storage.insertRow("t", {"a\tb", NULL_VALUE}) == 0);
+        Row previous;
+        assert(storage.updateRow("t", 0, {{1, "c"}}, previous) && isNull(previous[1]));
+        Row row;
+        assert(storage.fetchRow("t", 0, row) && row[1] == "c");
+        std::vector<Row> batch = {{"x", "1"}, {"y", NULL_VALUE}};
+        assert(storage.insertRows("t", batch) == 1);
+    }
+
+    // Every row write left a redo record
+    std::ifstream log(path + ".rows");
+    std::string line;
+    int records = 0;
+    while (std::getline(log, line)) {
+        ++records;
+    }
+    assert(records == 5);
+    std::remove((path + ".rows").c_str());
 
-    delete memoryStorage;
-    delete fileStorage;
+    std::cout << "File row log test passed!" << std::endl;
 }
 
 int main() {
-    testStorageEngineFactory();
+    testStorageBackends();
+    testTablesAndIndexes();
+    testScanPushdown();
+    testFileRowLog();
     return 0;
 }
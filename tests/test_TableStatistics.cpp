@@ -0,0 +1,177 @@
+#include "TableStatistics.hpp"
+#include "QueryProcessor.hpp"
+#include "TestHelpers.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+// The whole plan as one string, one line per operator
+std::string explain(QueryProcessor& processor, const std::string& query) {
+    QueryResult plan = processor.executeQuery("EXPLAIN " + query);
+    assert(plan.success);
+    std::string text;
+    for (const Row& row : plan.rows) {
+        text += row[0] + "\n";
+    }
+    return text;
+}
+
+void testHyperLogLog() {
+    HyperLogLog small;
+    HyperLogLog large;
+    for (int i = 0; i < 200000; ++i) {
+        small.add(std::to_string(i % 100));
+        large.add("value" + std::to_string(i));
+    }
+    assert(std::fabs(small.estimate() - 100) < 3);
+    assert(std::fabs(large.estimate() - 200000) < 200000 * 0.05);
+    assert(HyperLogLog().estimate() == 0);
+    std::cout << "HyperLogLog test passed!" << std::endl;
+}
+
+void testColumnStatistics() {
+    TableSchema schema;
+    schema.name = "t";
+    schema.columns = {{"amount", ColumnType::Integer, false}, {"status", ColumnType::Text, false}};
+    StatisticsBuilder builder(schema);
+    const int count = 100000;
+    for (int i = 0; i < count; ++i) {
+        // Half of the statuses are "hot", the rest spread over 1000 values; every tenth amount is NULL
+        builder.add({i % 10 == 0 ? NULL_VALUE : std::to_string(i % 1000),
+                     i % 2 == 0 ? "hot" : "s" + std::to_string(i % 1999)});
+    }
+    TableStatistics statistics = builder.finish();
+    assert(statistics.rowCount == count && statistics.sampledRows == StatisticsBuilder::sampleSize);
+
+    const ColumnStatistics& amount = statistics.columns[0];
+    assert(std::fabs(amount.nullFraction - 0.1) < 1e-9);
+    assert(std::fabs(amount.distinct - 900) < 900 * 0.05);
+    assert(amount.histogram.size() == StatisticsBuilder::histogramBuckets + 1);
+    double below = statistics.selectivity(condition(0, ColumnType::Integer, CompareOp::Less, "250"));
+    assert(std::fabs(below - 0.9 * 0.25) < 0.03);
+    double above = statistics.selectivity(condition(0, ColumnType::Integer, CompareOp::GreaterEqual, "250"));
+    assert(std::fabs(below + above - 0.9) < 0.01);
+    assert(statistics.selectivity(condition(0, ColumnType::Integer, CompareOp::Greater, "5000")) < 1e-9);
+    assert(statistics.selectivity(condition(0, ColumnType::Integer, CompareOp::Equal, NULL_VALUE)) == 0);
+
+    // The skewed value is the most common one; the others share what is left
+    const ColumnStatistics& status = statistics.columns[1];
+    assert(!status.mostCommon.empty() && status.mostCommon[0].first == "hot");
+    assert(std::fabs(statistics.selectivity(condition(1, ColumnType::Text, CompareOp::Equal, "hot")) - 0.5) < 0.02);
+    double other = statistics.selectivity(condition(1, ColumnType::Text, CompareOp::Equal, "s7"));
+    assert(other > 0.0002 && other < 0.0008);
+    std::cout << "Column statistics test passed!" << std::endl;
+}
+
+void testAnalyzeStatement() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE a (id INT, PRIMARY KEY (id));");
+    processor.executeQuery("CREATE TABLE b (id INT, PRIMARY KEY (id));");
+    processor.executeQuery("INSERT INTO a VALUES (1), (2), (3);");
+    assert(!storage.getStatistics("a"));
+
+    assert(processor.executeQuery("ANALYZE TABLE a;").success);
+    assert(storage.getStatistics("a")->rowCount == 3 && storage.getStatistics("a")->columns[0].distinct == 3);
+    assert(!storage.getStatistics("b"));
+    assert(processor.executeQuery("ANALYZE;").success && storage.getStatistics("b")->rowCount == 0);
+    QueryResult unknown = processor.executeQuery("ANALYZE missing;");
+    assert(!unknown.success && unknown.message == "Unknown table: missing");
+    std::cout << "ANALYZE statement test passed!" << std::endl;
+}
+
+// With statistics the selective index wins, whatever the order of the WHERE terms
+void testAccessPaths() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.setParallelism(1);
+    processor.executeQuery("CREATE TABLE orders (id INT, status TEXT, customer INT, PRIMARY KEY (id));");
+    processor.executeQuery("CREATE INDEX orders_status ON orders (status) USING HASH;");
+    processor.executeQuery("CREATE INDEX orders_customer ON orders (customer);");
+    std::vector<Row> rows;
+    for (int i = 0; i < 20000; ++i) {
+        rows.push_back({std::to_string(i), i % 20 == 0 ? "open" : "shipped", std::to_string(i % 1000)});
+    }
+    assert(processor.insertRows("orders", {}, rows).success);
+
+    const std::string both = "SELECT id FROM orders WHERE status = 'shipped' AND customer = 5;";
+    const std::string common = "SELECT id FROM orders WHERE status = 'shipped';";
+    const std::string rare = "SELECT id FROM orders WHERE status = 'open';";
+    const std::string wide = "SELECT id FROM orders WHERE customer >= 10;";
+    const std::string narrow = "SELECT id FROM orders WHERE customer >= 995;";
+    std::vector<std::vector<Row>> before;
+    for (const std::string& query : {both, common, rare, wide, narrow}) {
+        before.push_back(sortedRows(processor.executeQuery(query)));
+    }
+    // Without statistics the first indexed term decides
+    assert(explain(processor, both).find("-> IndexLookup on orders using orders_status") != std::string::npos);
+    assert(explain(processor, wide).find("-> IndexRangeScan on orders using orders_customer") != std::string::npos);
+
+    assert(processor.executeQuery("ANALYZE orders;").success);
+    assert(explain(processor, both).find("-> IndexLookup on orders using orders_customer") != std::string::npos);
+    assert(explain(processor, common).find("-> SeqScan on orders") != std::string::npos);
+    assert(explain(processor, rare).find("-> IndexLookup on orders using orders_status") != std::string::npos);
+    assert(explain(processor, wide).find("-> SeqScan on orders") != std::string::npos);
+    assert(explain(processor, narrow).find("-> IndexRangeScan on orders using orders_customer") != std::string::npos);
+
+    // A different path, the same rows
+    size_t i = 0;
+    for (const std::string& query : {both, common, rare, wide, narrow}) {
+        assert(sortedRows(processor.executeQuery(query)) == before[i++]);
+    }
+    std::cout << "Access path test passed!" << std::endl;
+}
+
+// The filtered dimension table is joined first, so no join has to build or probe every order
+void testJoinOrder() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.setParallelism(1);
+    processor.executeQuery("CREATE TABLE orders (id INT, customer INT, PRIMARY KEY (id));");
+    processor.executeQuery("CREATE TABLE customers (id INT, country TEXT, PRIMARY KEY (id));");
+    processor.executeQuery("CREATE TABLE countries (code TEXT, name TEXT, PRIMARY KEY (code));");
+    std::vector<Row> orders;
+    std::vector<Row> customers;
+    std::vector<Row> countries;
+    for (int i = 0; i < 30000; ++i) {
+        orders.push_back({std::to_string(i), std::to_string(i % 1000)});
+    }
+    for (int i = 0; i < 1000; ++i) {
+        customers.push_back({std::to_string(i), "c" + std::to_string(i % 50)});
+    }
+    for (int i = 0; i < 50; ++i) {
+        countries.push_back({"c" + std::to_string(i), "Country " + std::to_string(i)});
+    }
+    assert(processor.insertRows("orders", {}, orders).success);
+    assert(processor.insertRows("customers", {}, customers).success);
+    assert(processor.insertRows("countries", {}, countries).success);
+
+    const std::string query = "SELECT * FROM orders o JOIN customers c ON o.customer = c.id "
+                              "JOIN countries n ON c.country = n.code WHERE n.name = 'Country 7';";
+    QueryResult before = processor.executeQuery(query);
+    assert(explain(processor, query).find("HashJoin on c.country = n.code") == 0);
+
+    assert(processor.executeQuery("ANALYZE;").success);
+    std::string plan = explain(processor, query);
+    assert(plan.find("HashJoin on c.id = o.customer") < plan.find("HashJoin on c.country = n.code"));
+    assert(plan.find("HashJoin on c.country = n.code") != std::string::npos);
+    QueryResult after = processor.executeQuery(query);
+    assert(after.columns == before.columns && after.columns.size() == 6 && after.columns[0] == "id");
+    assert(sortedRows(after) == sortedRows(before) && after.rows.size() == 600);
+
+    // Columns and ORDER BY still refer to the FROM tables
+    QueryResult names = processor.executeQuery("SELECT n.name, o.id FROM orders o JOIN customers c ON o.customer = c.id "
+                                               "JOIN countries n ON c.country = n.code WHERE n.name = 'Country 7' "
+                                               "ORDER BY o.id LIMIT 2;");
+    assert(names.rows == (std::vector<Row>{{"Country 7", "7"}, {"Country 7", "57"}}));
+    std::cout << "Join order test passed!" << std::endl;
+}
+
+int main() {
+    testHyperLogLog();
+    testColumnStatistics();
+    testAnalyzeStatement();
+    testAccessPaths();
+    testJoinOrder();
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "TaskScheduler.hpp"
+#include "QueryProcessor.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+void testEveryMorselOnce() {
+    TaskScheduler scheduler(3);
+    std::vector<std::atomic<int>> runs(1000);
+    std::vector<std::atomic<bool>> lanesBusy(4);
+    std::atomic<bool> shared{false};
+    scheduler.run(runs.size(), 4, [&](size_t lane, size_t morsel) {
+        // A lane is only ever held by one thread
+        shared = shared || lanesBusy[lane].exchange(true);
+        ++runs[morsel];
+        lanesBusy[lane] = false;
+    });
+    assert(!shared);
+    for (const auto& count : runs) {
+        assert(count == 1);
+    }
+
+    // Without workers the caller runs everything, spread over the lanes
+    TaskScheduler callerOnly(0);
+    std::vector<size_t> lanes;
+    callerOnly.run(6, 3, [&](size_t lane, size_t) { lanes.push_back(lane); });
+    assert(lanes == (std::vector<size_t>{0, 1, 2, 0, 1, 2}));
+    std::cout << "Every morsel once test passed!" << std::endl;
+}
+
+// Lanes that run dry take morsels from the back of a slow lane
+void testStealing() {
+    TaskScheduler scheduler(3);
+    std::vector<std::atomic<size_t>> lanes(40);
+    scheduler.run(lanes.size(), 4, [&](size_t lane, size_t morsel) {
+        lanes[morsel] = lane;
+        if (morsel < 10) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(3));
+        }
+    });
+    assert(scheduler.getStolenMorsels() > 0);
+    assert(lanes[0] == 0 && "The owner starts at the front of its block");
+    std::cout << "Work stealing test passed!" << std::endl;
+}
+
+void testExceptions() {
+    TaskScheduler scheduler(2);
+    std::atomic<int> ran{0};
+    bool threw = false;
+    try {
+        scheduler.run(100, 3, [&](size_t, size_t morsel) {
+            if (morsel == 7) {
+                throw std::runtime_error("morsel failed");
+            }
+            ++ran;
+        });
+    } catch (const std::runtime_error& error) {
+        threw = std::string(error.what()) == "morsel failed";
+    }
+    assert(threw && ran < 100);
+
+    // The pool keeps working afterwards
+    ran = 0;
+    scheduler.run(50, 3, [&](size_t, size_t) { ++ran; });
+    assert(ran == 50);
+    std::cout << "Task exceptions test passed!" << std::endl;
+}
+
+// Workers serve concurrent jobs round-robin, so neither waits for the other to finish
+void testConcurrentJobs() {
+    TaskScheduler scheduler(2);
+    std::atomic<int> helped[2] = {{0}, {0}};
+    auto query = [&](int id) {
+        std::thread::id caller = std::this_thread::get_id();
+        scheduler.run(40, 3, [&](size_t, size_t) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (std::this_thread::get_id() != caller) {
+                ++helped[id];
+            }
+        });
+    };
+    std::thread first(query, 0);
+    std::thread second(query, 1);
+    first.join();
+    second.join();
+    assert(helped[0] > 0 && helped[1] > 0);
+    std::cout << "Concurrent jobs test passed!" << std::endl;
+}
+
+void testParallelQueries() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.executeQuery("CREATE TABLE events (id INT, kind TEXT, amount INT, PRIMARY KEY (id));");
+    std::vector<Row> rows;
+    const int count = 2 * static_cast<int>(morselRows) + 5000;
+    for (int i = 0; i < count; ++i) {
+        rows.push_back({std::to_string(i), "k" + std::to_string(i % 7), std::to_string(i % 1000)});
+    }
+    assert(processor.insertRows("events", {}, rows).success);
+
+    const std::string scan = "SELECT id, kind FROM events WHERE amount >= 990;";
+    const std::string grouped = "SELECT kind, COUNT(*), SUM(amount) FROM events WHERE amount < 500 GROUP BY kind;";
+    processor.setParallelism(1);
+    QueryResult serialScan = processor.executeQuery(scan);
+    QueryResult serialGroups = processor.executeQuery(grouped);
+    assert(processor.executeQuery("EXPLAIN " + scan).rows[1][0].find("-> SeqScan on events") == 0);
+
+    // Rows come out in the same order; groups are the same
+    processor.setParallelism(4);
+    QueryResult plan = processor.executeQuery("EXPLAIN ANALYZE " + scan);
+    assert(plan.rows[1][0].find("-> Parallel SeqScan on events (workers=4) filter: amount >= 990") == 0);
+    assert(plan.rows[1][0].find("rows read=" + std::to_string(count)) != std::string::npos);
+    assert(processor.executeQuery(scan).rows == serialScan.rows && serialScan.rows.size() == 1360);
+    QueryResult parallelGroups = processor.executeQuery(grouped);
+    std::sort(serialGroups.rows.begin(), serialGroups.rows.end());
+    std::sort(parallelGroups.rows.begin(), parallelGroups.rows.end());
+    assert(parallelGroups.rows == serialGroups.rows && parallelGroups.rows.size() == 7);
+    plan = processor.executeQuery("EXPLAIN ANALYZE " + grouped);
+    assert(plan.rows[1][0].find("(workers=4)") != std::string::npos);
+    assert(plan.rows[2][0].find("actual rows=68072") != std::string::npos);
+
+    // UPDATE finds its rows through a parallel scan too
+    assert(processor.executeQuery("UPDATE events SET kind = 'big' WHERE amount >= 999;").affectedRows == 136);
+    assert(processor.executeQuery("SELECT id FROM events WHERE kind = 'big';").rows.size() == 136);
+    std::cout << "Parallel queries test passed!" << std::endl;
+}
+
+int main() {
+    testEveryMorselOnce();
+    testStealing();
+    testExceptions();
+    testConcurrentJobs();
+    testParallelQueries();
+    return 0;
+}
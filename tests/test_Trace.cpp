@@ -0,0 +1,110 @@
+#include "Trace.hpp"
+#include "Session.hpp"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static size_t countOccurrences(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+void testSpansAcrossThreads() {
+    Tracer& tracer = Tracer::getInstance();
+    {
+        TRACE_SPAN("test", "before start");  // Tracing is off: not recorded
+    }
+    tracer.start();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 100; ++i) {
+                TRACE_SPAN("test", "outer");
+                TRACE_SPAN("test", "inner");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    tracer.stop();
+    {
+        TRACE_SPAN("test", "after stop");
+    }
+
+    assert(tracer.getEventCount() == 4 * 200);
+    std::string json = tracer.toChromeJson();
+    assert(json.find("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [") == 0);
+    assert(countOccurrences(json, "\"name\": \"outer\"") == 400);
+    // One track per buffer; a thread that exited hands its buffer to the next one
+    size_t tracks = countOccurrences(json, "\"name\": \"thread_name\"");
+    assert(tracks >= 1 && tracks <= 4);
+    assert(json.find("before start") == std::string::npos && json.find("after stop") == std::string::npos);
+
+    // A new trace discards the previous one
+    tracer.start();
+    tracer.stop();
+    assert(tracer.getEventCount() == 0);
+
+    std::cout << "Spans across threads test passed!" << std::endl;
+}
+
+void testFullBuffer() {
+    Tracer& tracer = Tracer::getInstance();
+    tracer.start();
+    std::thread worker([]() {
+        for (size_t i = 0; i < Tracer::ThreadBuffer::capacity + 10; ++i) {
+            TRACE_SPAN("test", "span");
+        }
+    });
+    worker.join();
+    tracer.stop();
+    assert(tracer.getEventCount() == Tracer::ThreadBuffer::capacity);
+    assert(tracer.getDroppedCount() == 10);
+
+    std::cout << "Full buffer test passed!" << std::endl;
+}
+
+void testEngineSpans() {
+    const std::string logPath = "test_trace.wal";
+    std::remove(logPath.c_str());
+    StorageEngine storage("memory");
+    CommitLog log(logPath);
+    Session session(0, &storage, &log);
+    session.executeQuery("CREATE TABLE users (id INT, name TEXT, PRIMARY KEY (id));");
+
+    Tracer& tracer = Tracer::getInstance();
+    tracer.start();
+    session.startTransaction();
+    session.insertData("INSERT INTO users VALUES (1, 'Alice');");
+    session.commitTransaction();
+    session.executeQuery("SELECT name FROM users WHERE id = 1;");
+    tracer.stop();
+
+    // Parse, plan, execute, index probe, row fetch, WAL append and the writer thread's fsync
+    std::string json = tracer.toChromeJson();
+    for (const char* name : {"\"parse\"", "\"plan\"", "\"execute\"", "\"probe\"", "\"fetch row\"", "\"append\"",
+                             "\"fsync\"", "\"commit\""}) {
+        assert(json.find(name) != std::string::npos && "Engine span missing");
+    }
+
+    const std::string tracePath = "test_trace.json";
+    assert(tracer.writeChromeTrace(tracePath));
+    std::remove(tracePath.c_str());
+    std::remove(logPath.c_str());
+
+    std::cout << "Engine spans test passed!" << std::endl;
+}
+
+int main() {
+    testSpansAcrossThreads();
+    testFullBuffer();
+    testEngineSpans();
+    return 0;
+}
@@ -1,20 +1,35 @@
-#include "TransactionManager.h"
+#include "TransactionManager.hpp"
+#include <cassert>
 #include <iostream>
 
 void testTransactionManager() {
-    TransactionManager transactionManager;
+    StorageEngine storage("memory");
+    TransactionManager transactionManager(&storage);
 
-    ActiveState activeState;
-    transactionManager.setState(&activeState);
-    transactionManager.handleTransaction();  // Should print "Transaction is Active"
+    transactionManager.beginTransaction();
+    assert(transactionManager.isInTransaction());
 
-    CommittedState committedState;
-    transactionManager.setState(&committedState);
-    transactionManager.handleTransaction();  // Should print "Transaction is Committed"
+    // Active: buffer a change in the transaction data
+    transactionManager.setState(new ActiveState());
+    transactionManager.setTransactionData(new TransactionData());
+    transactionManager.getTransactionData()->addChange("INSERT INTO users VALUES (1, 'Alice', 30);");
 
-    RolledBackState rolledBackState;
-    transactionManager.setState(&rolledBackState);
-    transactionManager.handleTransaction();  // Should print "Transaction is Rolled Back"
+    // Committed: the change is applied to storage
+    transactionManager.setState(new CommittedState());
+    transactionManager.handleTransaction();
+    assert(storage.retrieveData().size() == 1 && "Commit did not apply changes");
+
+    // Aborted: nothing else reaches storage
+    transactionManager.setTransactionData(new TransactionData());
+    transactionManager.getTransactionData()->addChange("INSERT INTO users VALUES (2, 'Bob', 25);");
+    transactionManager.setState(new AbortedState());
+    transactionManager.handleTransaction();
+    assert(storage.retrieveData().size() == 1 && "Rollback applied changes");
+
+    transactionManager.endTransaction();
+    assert(!transactionManager.isInTransaction());
+
+    std::cout << "Transaction manager test passed!" << std::endl;
 }
 
 int main() {
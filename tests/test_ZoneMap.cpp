@@ -0,0 +1,149 @@
+#include "ZoneMap.hpp"
+#include "Metrics.hpp"
+#include "QueryProcessor.hpp"
+#include "TestHelpers.hpp"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+
+// Day number as a date, with every month 28 days long
+std::string date(int day) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%04d-%02d-%02d", 2003 + day / 336, day / 28 % 12 + 1, day % 28 + 1);
+    return text;
+}
+
+void testColumnZones() {
+    ZoneMap zone({ColumnType::Integer, ColumnType::Text, ColumnType::Date});
+    zone.add({"10", "Shipped", "2004-03-01"});
+    zone.add({"25", "Shipped", NULL_VALUE});
+    zone.add({"7.5", "On Hold", "2004-05-31"});
+    auto mayMatch = [&](int column, ColumnType type, CompareOp op, const std::string& value) {
+        return zone.mayMatch({condition(column, type, op, value)});
+    };
+
+    // Numbers compare as numbers, dates and text as text
+    assert(mayMatch(0, ColumnType::Integer, CompareOp::Equal, "25"));
+    assert(!mayMatch(0, ColumnType::Integer, CompareOp::Equal, "26"));
+    assert(!mayMatch(0, ColumnType::Integer, CompareOp::Less, "7.5"));
+    assert(mayMatch(0, ColumnType::Integer, CompareOp::LessEqual, "7.5"));
+    assert(!mayMatch(0, ColumnType::Integer, CompareOp::Greater, "100"));
+    assert(mayMatch(0, ColumnType::Integer, CompareOp::Greater, "9"));
+    assert(mayMatch(0, ColumnType::Integer, CompareOp::NotEqual, "10"));
+    assert(!mayMatch(2, ColumnType::Date, CompareOp::GreaterEqual, "2004-06-01"));
+    assert(mayMatch(2, ColumnType::Date, CompareOp::GreaterEqual, "2004-05-31"));
+    assert(!mayMatch(2, ColumnType::Date, CompareOp::Less, "2004-03-01"));
+
+    // Equality on text inside [min, max] is answered by the bloom filter
+    assert(mayMatch(1, ColumnType::Text, CompareOp::Equal, "Shipped"));
+    assert(!mayMatch(1, ColumnType::Text, CompareOp::Equal, "Resolved"));
+    assert(!mayMatch(1, ColumnType::Text, CompareOp::Equal, "Cancelled"));  // Below min
+    BoundCondition in = condition(1, ColumnType::Text, CompareOp::In, "");
+    in.values = {"Disputed", NULL_VALUE};
+    assert(!zone.mayMatch({in}));
+    in.values.push_back("On Hold");
+    assert(zone.mayMatch({in}));
+
+    // NULLs: only IS NULL can match them
+    assert(mayMatch(2, ColumnType::Date, CompareOp::IsNull, ""));
+    assert(!mayMatch(1, ColumnType::Text, CompareOp::IsNull, ""));
+    assert(!mayMatch(0, ColumnType::Integer, CompareOp::Equal, NULL_VALUE));
+    ZoneMap nulls({ColumnType::Integer});
+    nulls.add({NULL_VALUE});
+    assert(!nulls.mayMatch({condition(0, ColumnType::Integer, CompareOp::IsNotNull, "")}));
+    assert(!nulls.mayMatch({condition(0, ColumnType::Integer, CompareOp::NotEqual, "1")}));
+
+    // One term ruled out rules out the block
+    assert(!zone.mayMatch({condition(0, ColumnType::Integer, CompareOp::Equal, "10"),
+                           condition(1, ColumnType::Text, CompareOp::Equal, "Resolved")}));
+
+    // A value of a numeric column that is no number makes the range unusable
+    zone.add(0, "n/a");
+    assert(mayMatch(0, ColumnType::Integer, CompareOp::Greater, "100"));
+    std::cout << "Column zones test passed!" << std::endl;
+}
+
+// Rows inserted in date order: a date range scan reads only the blocks that overlap it
+void testBlockSkipping() {
+    StorageEngine storage("memory");
+    TableSchema schema;
+    schema.name = "orders";
+    schema.columns = {{"id", ColumnType::Integer, true}, {"orderDate", ColumnType::Date, false},
+                      {"status", ColumnType::Text, false}};
+    assert(storage.createTable(schema));
+    const int count = 10 * TableHeap::blockRows;
+    std::vector<Row> rows;
+    for (int i = 0; i < count; ++i) {
+        rows.push_back({std::to_string(i), date(i / 10), i == 12345 ? "Disputed" : "Shipped"});
+    }
+    assert(storage.insertRows("orders", rows) == 0);
+
+    ScanSpec spec;
+    spec.filter = {condition(1, ColumnType::Date, CompareOp::GreaterEqual, date(3700))};
+    auto scan = [&](size_t& skipped) {
+        std::vector<Row> out;
+        size_t start = 0;
+        while (size_t examined = storage.scanRows("orders", start, 1000, spec, out, nullptr, &skipped)) {
+            start += examined;
+        }
+        assert(start == static_cast<size_t>(count));
+        return out;
+    };
+    size_t skipped = 0;
+    std::vector<Row> recent = scan(skipped);
+    assert(recent.size() == static_cast<size_t>(count - 37000) && recent[0][0] == "37000");
+    assert(skipped == 9 * TableHeap::blockRows);
+
+    // Equality on a status found in one block only
+    spec.filter = {condition(2, ColumnType::Text, CompareOp::Equal, "Disputed")};
+    skipped = 0;
+    assert(scan(skipped).size() == 1 && skipped == 9 * TableHeap::blockRows);
+
+    // An update widens its block's zone map
+    assert(storage.updateRow("orders", 5, {{1, date(4000)}}));
+    spec.filter = {condition(1, ColumnType::Date, CompareOp::GreaterEqual, date(3700))};
+    skipped = 0;
+    recent = scan(skipped);
+    assert(recent.size() == static_cast<size_t>(count - 37000 + 1) && recent[0][0] == "5");
+    assert(skipped == 8 * TableHeap::blockRows);
+    std::cout << "Block skipping test passed!" << std::endl;
+}
+
+void testSkippingQueries() {
+    StorageEngine storage("memory");
+    QueryProcessor processor(&storage);
+    processor.setParallelism(1);
+    processor.executeQuery("CREATE TABLE payments (id INT, paymentDate DATE, amount DECIMAL, PRIMARY KEY (id));");
+    std::vector<Row> rows;
+    for (int i = 0; i < 50000; ++i) {
+        rows.push_back({std::to_string(i), date(i / 20), std::to_string(i % 100)});
+    }
+    assert(processor.insertRows("payments", {}, rows).success);
+
+    const std::string range = "FROM payments WHERE paymentDate >= '" + date(2400) + "' AND paymentDate < '" +
+                              date(2410) + "'";
+    MetricsSnapshot before = MetricsRegistry::getInstance().snapshot();
+    QueryResult result = processor.executeQuery("SELECT id " + range + " ORDER BY id;");
+    MetricsSnapshot after = MetricsRegistry::getInstance().snapshot();
+    assert(result.success && result.rows.size() == 200 && result.rows[0][0] == "48000");
+    assert(after.getCounter(Counter::RowsSkipped) - before.getCounter(Counter::RowsSkipped) == 45904);
+
+    QueryResult plan = processor.executeQuery("EXPLAIN ANALYZE SELECT COUNT(*), SUM(amount) " + range + ";");
+    assert(plan.success);
+    bool skipped = false;
+    for (const Row& line : plan.rows) {
+        skipped = skipped || (line[0].find("SeqScan on payments") != std::string::npos &&
+                              line[0].find("rows read=4096 rows skipped=45904") != std::string::npos);
+    }
+    assert(skipped);
+    QueryResult totals = processor.executeQuery("SELECT COUNT(*), SUM(amount) " + range + ";");
+    assert(totals.success && totals.rows[0][0] == "200" && totals.rows[0][1] == "9900");
+    std::cout << "Skipping queries test passed!" << std::endl;
+}
+
+int main() {
+    testColumnZones();
+    testBlockSkipping();
+    testSkippingQueries();
+    return 0;
+}